@@ -72,7 +72,11 @@
 #include "SWStats.h"
 #include "DrawDebugHelpers.h"
 #include "Component/SWSeedGenerator.h"
+#include "Component/SWHeightGenerator.h"
 #include "Data/SWCacheManager.h"
+#include "Data/SWGridTopologyCache.h"
+#include "Storage/SWTileDiskCache.h"
+#include "Misc/Paths.h"
 
 #if INTEL_ISPC
 #include "ShaderWorldActorISPC.ispc.generated.h"
@@ -91,6 +95,16 @@ static TAutoConsoleVariable<int32> CVarSWCollBatchUpdateCount(
 	75,
 	TEXT("Number of history frames to use for stats."));
 
+static TAutoConsoleVariable<int32> CVarSWHeightQueryBatchDimension(
+	TEXT("sw.HeightQuery.BatchDimension"),
+	32,
+	TEXT("Height retrieval requests are packed into square batches of BatchDimension x BatchDimension unique samples."));
+
+static TAutoConsoleVariable<int32> CVarSWHeightQueryMaxInFlight(
+	TEXT("sw.HeightQuery.MaxInFlight"),
+	4,
+	TEXT("Maximum amount of height retrieval batches being evaluated/read back from the GPU at once."));
+
 
 /** Single global instance of the SWClipMapBuffersHolder. */
 TGlobalResource< FSWSimpleReadbackManager > GSWSimpleReadbackManager;
@@ -105,6 +119,74 @@ DEFINE_LOG_CATEGORY(LogShaderWorld);
 /*
  * Computing the heightmaps and data layers
  */
+static TAutoConsoleVariable<int32> CVarSWCollisionFloatHeightRead(
+	TEXT("sw.Collision.FloatHeightRead"),
+	1,
+	TEXT("CPU evaluated collision tiles store R32F heights and R8 material indices instead of packing them as 24bit integer RGBA8 texels."));
+
+static TAutoConsoleVariable<int32> CVarSWCollisionDoublePrecisionPositions(
+	TEXT("sw.Collision.DoublePrecisionPositions"),
+	1,
+	TEXT("Collision tiles also store their vertices in double precision. 0 only keeps the float positions used for physics and rendering."));
+
+static TAutoConsoleVariable<int32> CVarSWCollisionAtlasTilesPerSide(
+	TEXT("sw.Collision.AtlasTilesPerSide"),
+	4,
+	TEXT("When batching collision generation, an atlas holds AtlasTilesPerSide x AtlasTilesPerSide collision tiles evaluated by a single draw."));
+
+static TAutoConsoleVariable<int32> CVarSWSpawnableDecodeChunkSize(
+	TEXT("sw.Spawnables.DecodeChunkSize"),
+	4096,
+	TEXT("Number of spawnable instances decoded per parallel task when processing spawnables readbacks."));
+
+static TAutoConsoleVariable<int32> CVarSWClipmapScrollCache(
+	TEXT("sw.Clipmap.ScrollCache"),
+	1,
+	TEXT("When a ring moves, scroll its heightmap, normalmap and data layers and only generate the newly exposed texels. 0 regenerates the whole ring."));
+
+/*
+ * Clipmap update scheduling: camera moves are always processed, time and brush driven ring refreshes are granted
+ * by priority until the budget is spent. The GPU cost of an update is estimated by the number of texels it writes.
+ */
+static TAutoConsoleVariable<float> CVarSWClipmapUpdateBudget(
+	TEXT("sw.Clipmap.UpdateBudgetMTexels"),
+	8.f,
+	TEXT("Millions of clipmap texels (heightmap, normalmap, data layers) allowed to be generated per frame. At least one refresh is always granted. 0 disables the scheduling: every pending refresh is processed."));
+
+static TAutoConsoleVariable<float> CVarSWClipmapMaxRefreshDeferral(
+	TEXT("sw.Clipmap.MaxRefreshDeferral"),
+	0.5f,
+	TEXT("Seconds after which a deferred ring refresh is processed regardless of the update budget."));
+
+static TAutoConsoleVariable<float> CVarSWClipmapUpdateLookAhead(
+	TEXT("sw.Clipmap.UpdateLookAhead"),
+	1.f,
+	TEXT("Seconds of camera travel anticipated when prioritizing ring refreshes: a fast camera raises the priority of the coarser rings."));
+
+/*
+ * Runtime stats, see SWStats.h
+ */
+SW_DECLARE_COUNTER(PendingReadbacks)
+SW_DECLARE_COUNTER(CollisionWorkQueue)
+SW_DECLARE_COUNTER(CollisionReadToProcess)
+SW_DECLARE_COUNTER(CollisionTilesUsed)
+SW_DECLARE_COUNTER(HeightQueryQueue)
+SW_DECLARE_COUNTER(SpawnableReadToProcess)
+SW_DECLARE_COUNTER(SpawnableWorkQueue)
+SW_DECLARE_COUNTER(CollisionBudgetOverruns)
+SW_DECLARE_COUNTER(TileDiskCacheHits)
+SW_DECLARE_COUNTER(TileDiskCacheMisses)
+SW_DECLARE_COUNTER(FinalizeBudgetOverruns)
+SW_DECLARE_COUNTER(ClipmapUpdateKTexels)
+SW_DECLARE_COUNTER(ClipmapDeferredRefreshes)
+SW_DECLARE_COUNTER(ClipmapMaxStalenessMs)
+SW_DECLARE_COUNTER(HeadlessSpawnableCells)
+
+static TAutoConsoleVariable<float> CVarSWBoundedWorldSplitDistance(
+	TEXT("sw.BoundedWorld.SplitDistance"),
+	1.5f,
+	TEXT("Bounded worlds: a quadtree node is subdivided while the closest viewer is within SplitDistance times the node size."));
+
 static TAutoConsoleVariable<float> SWGameThreadBudgetSegmentedprocess_ms(
 	TEXT("sw.GTStartSpawnablesBudget"),
 	1.25,
@@ -124,6 +206,39 @@ static TAutoConsoleVariable<float> SWGameThreadBudgetFinalize_ms(
 	1.5,
 	TEXT("Gamethread Time in ms allowed to spend updating Hierachical Instanced Static Meshes of spawnables, most expensive being collisions enabled ones."));
 
+static TAutoConsoleVariable<int32> CVarSWFinalizePrioritize(
+	TEXT("sw.Finalize.Prioritize"),
+	1,
+	TEXT("1: spawnable cells are sent to their HISM by decreasing screen coverage (cell size over distance to the closest viewer). 0: queue order."));
+
+static TAutoConsoleVariable<int32> CVarSWFinalizeAutoBatchSize(
+	TEXT("sw.Finalize.AutoBatchSize"),
+	1,
+	TEXT("1: the segmented HISM update batch size of each spawnable is derived from its measured cost per instance. 0: always use sw.BatchUpdateCount."));
+
+static TAutoConsoleVariable<float> CVarSWFinalizeBatchBudgetFraction(
+	TEXT("sw.Finalize.BatchBudgetFraction"),
+	0.25f,
+	TEXT("Fraction of sw.GTEndSpawnablesBudget a single automatically sized HISM update batch should take."));
+
+/*
+ * Headless processes (dedicated server, -nullrhi): CPU generation budgets
+ */
+static TAutoConsoleVariable<float> CVarSWServerCollisionTilesPerSecond(
+	TEXT("sw.Server.CollisionTilesPerSecond"),
+	400.f,
+	TEXT("Headless processes: collision tiles evaluated per second on worker threads."));
+
+static TAutoConsoleVariable<float> CVarSWServerSpawnableCellsPerSecond(
+	TEXT("sw.Server.SpawnableCellsPerSecond"),
+	400.f,
+	TEXT("Headless processes: spawnable grid cells placed per second on worker threads."));
+
+static TAutoConsoleVariable<float> CVarSWServerGameThreadBudget(
+	TEXT("sw.Server.GTBudget"),
+	4.f,
+	TEXT("Headless processes: Gamethread Time in ms allowed to spend updating collision meshes and spawnable instances, each."));
+
 static int32 GSWMaxInstancesPerComponent = 16000;//36864;
 static FAutoConsoleVariableRef CVarMaxInstancesPerComponent(
 	TEXT("sw.Spawn.MaxInstancesPerComponent"),
@@ -225,6 +340,8 @@ void FSWSimpleReadbackManager::TickReadBack()
 			PendingReads.RemoveAt(RB_Index);
 		}
 	}
+
+	NumPendingReads.Set(PendingReads.Num());
 }
 
 void FSWSimpleReadbackManager::AddPendingReadBack(int32 InBlockSize, int32 InExtentX, int32 InExtentY, TSharedPtr<FRHIGPUTextureReadback>& InReadStage,
@@ -240,6 +357,8 @@ void FSWSimpleReadbackManager::AddPendingReadBack(int32 InBlockSize, int32 InExt
 		InDest,
 		InProc
 	};
+
+	NumPendingReads.Set(PendingReads.Num());
 }
 
 void AShaderWorldActor::PostInitializeComponents()
@@ -393,9 +512,19 @@ void AShaderWorldActor::AddReferencedObjects(UObject* InThis, FReferenceCollecto
 	SW_TOCOLLECTOR(This->SpawnablesMat)
 	SW_TOCOLLECTOR(This->CollisionMat)
 
-	SW_TOCOLLECTOR(This->ReadRequestLocation)
-	SW_TOCOLLECTOR(This->ReadRequestLocationHeightmap)
-	SW_TOCOLLECTOR(This->GeneratorDynamicForReadBack)
+	for (const FSWHeightQueryBatch& Batch : This->HeightQueryBatches)
+	{
+		SW_TOCOLLECTOR(Batch.LocationsRT)
+		SW_TOCOLLECTOR(Batch.HeightmapRT)
+		SW_TOCOLLECTOR(Batch.GeneratorDyn)
+	}
+
+	for (const FSWCollisionAtlasBatch& Batch : This->CollisionAtlasBatches)
+	{
+		SW_TOCOLLECTOR(Batch.LocationsRT)
+		SW_TOCOLLECTOR(Batch.HeightmapRT)
+		SW_TOCOLLECTOR(Batch.GeneratorDyn)
+	}
 
 	SW_TOCOLLECTOR(This->CollisionSampleLocation)
 
@@ -533,9 +662,17 @@ void AShaderWorldActor::RebuildCleanup()
 
 	CollisionShareable = nullptr;
 
-	ReadRequestLocation	=	nullptr;
-	ReadRequestLocationHeightmap = nullptr;
-	GeneratorDynamicForReadBack = nullptr;
+	// In-flight batches are dropped: pending height queries are dispatched again from scratch on the rebuilt world
+	HeightQueryBatches.Empty();
+	HeightQueryDispatchQueue.Empty();
+
+	for (TPair<uint32, FSWHeightQuery>& Query : HeightQueries)
+	{
+		Query.Value.NextLocationToDispatch = 0;
+		Query.Value.PendingSamples = 0;
+		HeightQueryDispatchQueue.Add(Query.Key);
+	}
+	HeightQueryDispatchQueue.Sort();
 	
 	CollisionSampleLocation = nullptr;
 
@@ -569,6 +706,10 @@ void AShaderWorldActor::RebuildCleanup()
 	for (int i = CollisionMesh.Num() - 1; i >= 0; i--)
 	{
 		FCollisionMeshElement& Elem = CollisionMesh[i];
+
+		if (Elem.Cancellation.IsValid())
+			Elem.Cancellation->Cancel();
+
 		if (Elem.Mesh)
 		{
 			Elem.Mesh->ClearAllMeshSections();
@@ -597,15 +738,18 @@ void AShaderWorldActor::RebuildCleanup()
 			Elem.Mesh = nullptr;
 			Elem.CollisionRT = nullptr;
 			Elem.CollisionRT_Duplicate = nullptr;
-			Elem.DynCollisionCompute = nullptr;
+			ReleaseMaterialInstance(Elem.DynCollisionCompute);
 
 		}
 
 	}
 
+	ReleaseMaterialInstance(CollisionDisplayMaterial);
+
 	CollisionShareable = nullptr;
 	CollisionMesh.Empty();
 	UsedCollisionMesh.Empty();
+	CollisionGridTopology = nullptr;
 
 	if (Shareable_ID.IsValid())
 	{
@@ -665,6 +809,8 @@ void AShaderWorldActor::RebuildCleanup()
 
 	rebuildVegetationOnly = false;
 
+	CleanUpHeadlessSpawnables();
+
 	CollisionToSpawnable.Empty();
 	if (BrushManager)
 		BrushManager->ResetB();
@@ -673,7 +819,12 @@ void AShaderWorldActor::RebuildCleanup()
 	{
 		BoundedWorldTree = nullptr;
 	}
+	BoundedWorldVisit = nullptr;
 	BoundedWorldVisitorProcessing = false;
+	BoundedWorldVisitViewers.Empty();
+	BoundedWorldVisitRevision = INDEX_NONE;
+	BoundedWorldLeafBounds.Empty();
+	BoundedWorldLeafRevision = INDEX_NONE;
 
 	rebuild = false;
 	GenerateCollision_last = GenerateCollision;
@@ -935,24 +1086,48 @@ bool AShaderWorldActor::ProcessSegmentedComputation()
 	
 
 	{
-		for (int i = 0; i < Meshes.Num(); i++)
+		ensure(Meshes.Num() <= NeedSegmentedUpdate.Num());
+
+		/*
+		 * Pending rings by decreasing priority, as many as the update budget allows.
+		 * Without budget, every pending ring.
+		 */
+		const double BudgetTexels = CVarSWClipmapUpdateBudget.GetValueOnGameThread() * 1000000.0;
+		int64 SpentTexels = 0;
+		bool bComputedAny = false;
+
+		while (true)
 		{
-			ensure(i < NeedSegmentedUpdate.Num());
+			int32 Best = INDEX_NONE;
+			for (int i = 0; i < Meshes.Num() && i < NeedSegmentedUpdate.Num(); i++)
+			{
+				if (NeedSegmentedUpdate[i] && (Best == INDEX_NONE || Meshes[i].UpdatePriority > Meshes[Best].UpdatePriority))
+					Best = i;
+			}
 
-			if(NeedSegmentedUpdate[i])
-			{	
-				
-				ComputeHeight_Segmented_MapForClipMap(i);
-				ComputeSegmentedNormalForClipMap(i);
-				ComputeDataLayersSegmentedForClipMap(i);
+			if (Best == INDEX_NONE)
+				break;
 
-				NeedSegmentedUpdate[i]=false;
+			const int64 Texels = EstimateClipMapUpdateTexels(Best, false);
 
-				SegmentedFence.BeginFence();
+			if (bComputedAny && BudgetTexels > 0.0 && SpentTexels + Texels > BudgetTexels)
+				break;
 
-				return false;
-			}
-		}		
+			ComputeHeight_Segmented_MapForClipMap(Best);
+			ComputeSegmentedNormalForClipMap(Best);
+			ComputeDataLayersSegmentedForClipMap(Best);
+
+			NeedSegmentedUpdate[Best] = false;
+			SpentTexels += Texels;
+			bComputedAny = true;
+		}
+
+		if (bComputedAny)
+		{
+			SegmentedFence.BeginFence();
+
+			return false;
+		}
 		
 
 		for (int i = Meshes.Num()-1; i >=0; i--)
@@ -1061,9 +1236,14 @@ void AShaderWorldActor::Tick(float DeltaTime)
 	SW_FCT_CYCLE("Geo World Tick")
 
 	/*
-	 * Can we use "DrawMaterialToRenderTarget" ?
+	 * Can we use "DrawMaterialToRenderTarget" ? Otherwise only CPU evaluated collisions and spawnables are available
 	 */
-	if (!FApp::CanEverRender())	{return;}
+	if (IsHeadlessProcess())
+	{
+		HeadlessTick(DeltaTime);
+		ReportRuntimeStats();
+		return;
+	}
 
 	/*
 	 * Can we use Compute Shaders ?
@@ -1114,6 +1294,52 @@ void AShaderWorldActor::Tick(float DeltaTime)
 	SpawnablesManagement(DeltaTime);
 
 	TerrainAndSpawnablesManagement(DeltaTime);
+
+	BoundedWorldUpdate(DeltaTime);
+
+	ReportRuntimeStats();
+}
+
+void AShaderWorldActor::ReportRuntimeStats()
+{
+	SW_SET_COUNTER(PendingReadbacks, GSWSimpleReadbackManager.GetNumPendingReads())
+	SW_SET_COUNTER(CollisionWorkQueue, CollisionWorkQueue.Num())
+	SW_SET_COUNTER(CollisionReadToProcess, CollisionReadToProcess.Num())
+	SW_SET_COUNTER(CollisionTilesUsed, UsedCollisionMesh.Num())
+	SW_SET_COUNTER(HeightQueryQueue, HeightQueryDispatchQueue.Num())
+
+	int32 SpawnableReadToProcess = 0;
+	int32 SpawnableWorkQueue = 0;
+
+	for (const FSWBiom& elB : Bioms)
+	{
+		for (const FSpawnableMesh& Spawn : elB.Spawnables)
+		{
+			SpawnableReadToProcess += Spawn.SpawnablesElemReadToProcess.Num();
+			SpawnableWorkQueue += Spawn.SpawnableWorkQueue.Num();
+		}
+	}
+
+	SW_SET_COUNTER(SpawnableReadToProcess, SpawnableReadToProcess)
+	SW_SET_COUNTER(SpawnableWorkQueue, SpawnableWorkQueue)
+
+	if (TileDiskCache.IsValid())
+	{
+		SW_SET_COUNTER(TileDiskCacheHits, TileDiskCache->GetNumHits())
+		SW_SET_COUNTER(TileDiskCacheMisses, TileDiskCache->GetNumMisses())
+	}
+
+	float MaxStaleness = 0.f;
+	for (int32 LOD = 0; LOD < Meshes.Num(); LOD++)
+		MaxStaleness = FMath::Max(MaxStaleness, GetClipMapStaleness(LOD));
+
+	SW_SET_COUNTER(ClipmapMaxStalenessMs, FMath::RoundToInt(MaxStaleness * 1000.f))
+
+	int32 HeadlessSpawnableCells = 0;
+	for (const FSWHeadlessSpawnable& Spawnable : HeadlessSpawnables)
+		HeadlessSpawnableCells += Spawnable.CellTransforms.Num();
+
+	SW_SET_COUNTER(HeadlessSpawnableCells, HeadlessSpawnableCells)
 }
 
 bool AShaderWorldActor::UpdateCollisionInRegion(const FBox Area)
@@ -1126,154 +1352,349 @@ bool AShaderWorldActor::UpdateCollisionInRegion(const FBox Area)
 
 void AShaderWorldActor::ReadbacksManagement()
 {
-	if(!bProcessingHeightRetrieval.IsValid())
-		bProcessingHeightRetrieval = MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>();
-	if (!bProcessingHeightRetrievalRT.IsValid())
-		bProcessingHeightRetrievalRT = MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>();
+	SW_FCT_CYCLE()
+	SW_STAGE_SCOPE(ReadbacksManagement)
 
-	if((*bProcessingHeightRetrieval.Get()) && (*bProcessingHeightRetrievalRT.Get()) && HeightReadBackFence.IsFenceComplete() && PointsPendingReadBacks.IsValid())
+	for (FSWCollisionAtlasBatch& Batch : CollisionAtlasBatches)
 	{
-		
-		if (!ReadBackHeightData.IsValid())
-			return;
+		if (Batch.bInFlight && Batch.ReadCompletion.IsValid() && (*Batch.ReadCompletion.Get()))
+			CompleteCollisionAtlasBatch(Batch);
+	}
 
-		//For now we do Compute samples on a rendertarget 5x5, therefore 25 positions evaluated per request.
-		const int NumOfVertex = 25;
+	/*
+	 * Callbacks can issue new queries or rebuild the world, both touching HeightQueryBatches:
+	 * they only run once every completed batch has been decoded.
+	 */
+	TArray<FSWCompletedHeightQuery> CompletedQueries;
 
-		PositionsOfReadBacks.Empty();
-		PositionsOfReadBacks.AddUninitialized(25);
+	for (FSWHeightQueryBatch& Batch : HeightQueryBatches)
+	{
+		if (Batch.bInFlight && Batch.ReadCompletion.IsValid() && (*Batch.ReadCompletion.Get()))
+			CompleteHeightQueryBatch(Batch, CompletedQueries);
+	}
 
-		uint8* ReadData8 = (uint8*)ReadBackHeightData->ReadData.GetData();
+	for (FSWCompletedHeightQuery& Completed : CompletedQueries)
+		Completed.Callback.ExecuteIfBound(Completed.Results);
 
-		uint16 MaterialIndice = 0;
+	CompletedQueries.Empty();
 
-		for (int32 k = 0; k < NumOfVertex; k++)
-		{			
-			FVector3f& PositionSample = PositionsOfReadBacks[k];
+	if (HeightQueryDispatchQueue.Num() <= 0 || !Generator || !SWorldSubsystem)
+		return;
 
-			if (RendererAPI == EGeoRenderingAPI::OpenGL)
-			{
-				int X = k % 5;
-				int Y = k / 5;
+	const int32 MaxInFlight = FMath::Max(1, CVarSWHeightQueryMaxInFlight.GetValueOnGameThread());
 
-				int index = X + Y * 5;
+	for (int32 BatchID = 0; BatchID < MaxInFlight && HeightQueryDispatchQueue.Num() > 0; BatchID++)
+	{
+		if (BatchID >= HeightQueryBatches.Num())
+			HeightQueryBatches.AddDefaulted();
 
-				Y = (5 - 1) - Y;
+		FSWHeightQueryBatch& Batch = HeightQueryBatches[BatchID];
 
-				index = X + Y * 5;
+		if (!Batch.bInFlight && !DispatchHeightQueryBatch(Batch))
+			break;
+	}
+}
 
-				PositionSample = FVector3f(PointsPendingReadBacks->PositionsXY[2 * k], PointsPendingReadBacks->PositionsXY[2 * k + 1], GetHeightFromGPURead(&ReadData8[index*4], MaterialIndice) / HeightScale);
-			}
-			else
-				PositionSample = FVector3f(PointsPendingReadBacks->PositionsXY[2 * k], PointsPendingReadBacks->PositionsXY[2 * k + 1], GetHeightFromGPURead(&ReadData8[k*4], MaterialIndice) / HeightScale);
+UMaterialInstanceDynamic* AShaderWorldActor::AcquireMaterialInstance(UMaterialInterface* Parent)
+{
+	if (SWorldSubsystem)
+		return SWorldSubsystem->AcquireMaterialInstance(Parent);
 
-		}
+	return Parent ? UMaterialInstanceDynamic::Create(Parent, this) : nullptr;
+}
+
+void AShaderWorldActor::ReleaseMaterialInstance(UMaterialInstanceDynamic*& MID)
+{
+	if (MID && SWorldSubsystem)
+		SWorldSubsystem->ReleaseMaterialInstance(MID);
 
-		HeightRetrieveDelegate.ExecuteIfBound(PositionsOfReadBacks);
+	MID = nullptr;
+}
 
-		bProcessingHeightRetrieval->AtomicSet(false);
-		bProcessingHeightRetrievalRT->AtomicSet(false);
+UMaterialInstanceDynamic* AShaderWorldActor::CreateHeightReadBackMaterial(UTextureRenderTarget2D* LocationsRT)
+{
+	if (!Generator)
+	{
+#if SWDEBUG
+		SW_LOG("Generator Material not available for Shader World %s", *GetName())
+#endif
+		return nullptr;
 	}
 
+	UMaterialInstanceDynamic* GeneratorDynamicForReadBack = UMaterialInstanceDynamic::Create(Generator.Get(), this);
 
-}
+	GeneratorDynamicForReadBack->SetScalarParameterValue("HeightReadBack", 1.f);
+	GeneratorDynamicForReadBack->SetTextureParameterValue("SpecificLocationsRT", LocationsRT);
 
-bool AShaderWorldActor::RetrieveHeightAt(const TArray<FVector>& Origin, const FSWHeightRetrievalDelegate& Callback)
-{
-	if(!GeneratorDynamicForReadBack || !SWorldSubsystem)
-		return false;
+	GeneratorDynamicForReadBack->SetScalarParameterValue("NoMargin", 0.f);
+	GeneratorDynamicForReadBack->SetScalarParameterValue("N", N);
+	GeneratorDynamicForReadBack->SetScalarParameterValue("LOD0GridSpacing", pow(2.0, -(LOD_Num - 1))* GridSpacing);
+
+	GeneratorDynamicForReadBack->SetScalarParameterValue("NormalMapSelect", 0.f);
+	GeneratorDynamicForReadBack->SetScalarParameterValue("HeightMapToggle", 1.f);
 
-	if (!bProcessingHeightRetrieval.IsValid())
+	TSet<FName> UsedNames;
+	for (const FInstancedStruct& Seed : CurrentSeedsArray.SeedsArray)
 	{
-		bProcessingHeightRetrieval = MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>();
-		bProcessingHeightRetrieval->AtomicSet(false);
+		if (Seed.IsValid())
+		{
+			const UScriptStruct* Type = Seed.GetScriptStruct();
+			CA_ASSUME(Type);
+			if (Type->IsChildOf(FTextureSeed::StaticStruct()))
+			{
+				FTextureSeed& TypedSeed = Seed.GetMutable<FTextureSeed>();
+				if (!UsedNames.Contains(TypedSeed.SeedName))
+				{
+					UsedNames.Add(TypedSeed.SeedName);
+					GeneratorDynamicForReadBack->SetTextureParameterValue(TypedSeed.SeedName, TypedSeed.Value);
+				}
+			}
+			else if (Type->IsChildOf(FLinearColorSeed::StaticStruct()))
+			{
+				FLinearColorSeed& TypedSeed = Seed.GetMutable<FLinearColorSeed>();
+				if (!UsedNames.Contains(TypedSeed.SeedName))
+				{
+					UsedNames.Add(TypedSeed.SeedName);
+					GeneratorDynamicForReadBack->SetVectorParameterValue(TypedSeed.SeedName, TypedSeed.Value);
+				}
+			}
+			else if (Type->IsChildOf(FScalarSeed::StaticStruct()))
+			{
+				FScalarSeed& TypedSeed = Seed.GetMutable<FScalarSeed>();
+				if (!UsedNames.Contains(TypedSeed.SeedName))
+				{
+					UsedNames.Add(TypedSeed.SeedName);
+					GeneratorDynamicForReadBack->SetScalarParameterValue(TypedSeed.SeedName, TypedSeed.Value);
+				}
+			}
+			else
+			{
+#if SWDEBUG
+				SW_LOG("Invalid Seed type found: '%s'", *GetPathNameSafe(Type));
+#endif
+				
+			}
+		}
 	}
-	if (!bProcessingHeightRetrievalRT.IsValid())
+
+	return GeneratorDynamicForReadBack;
+}
+
+bool AShaderWorldActor::DispatchHeightQueryBatch(FSWHeightQueryBatch& Batch)
+{
+	UWorld* World = GetWorld();
+
+	const int32 BatchDim = FMath::Clamp(CVarSWHeightQueryBatchDimension.GetValueOnGameThread(), 5, 256);
+	const int32 MaxSamples = BatchDim * BatchDim;
+
+	if (!Batch.LocationsRT || !Batch.HeightmapRT || Batch.LocationsRT->SizeX != BatchDim)
 	{
-		bProcessingHeightRetrievalRT = MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>();
-		bProcessingHeightRetrievalRT->AtomicSet(false);
+		if (Batch.LocationsRT && Batch.HeightmapRT)
+			RendertargetMemoryBudgetMB -= (4 * 2 + 4) * Batch.LocationsRT->SizeX * Batch.LocationsRT->SizeX / 1000000.0f;
+
+		RendertargetMemoryBudgetMB += (4 * 2 + 4) * MaxSamples / 1000000.0f;
+		SW_RT(Batch.LocationsRT, World, BatchDim, TF_Nearest, RTF_RG32f)
+		SW_RT(Batch.HeightmapRT, World, BatchDim, TF_Nearest, RTF_RGBA8)
+
+		Batch.GeneratorDyn = CreateHeightReadBackMaterial(Batch.LocationsRT);
 	}
-			
 
-	if(!(*bProcessingHeightRetrieval.Get()) && ReadRequestLocation && ReadRequestLocationHeightmap && GeneratorDynamicForReadBack)
-	{
-		bProcessingHeightRetrieval->AtomicSet(true);
-		bProcessingHeightRetrievalRT->AtomicSet(false);
-		HeightRetrieveDelegate = Callback;
+	if (!Batch.GeneratorDyn)
+		return false;
+
+	Batch.SampleRefs.Reset();
+	Batch.Samples = MakeShared<FSWShareableSamplePoints, ESPMode::ThreadSafe>();
+	Batch.Samples->PositionsXY.Reserve(MaxSamples * 2);
+
+	/*
+	 * Coalesce the queued queries, oldest first, until the batch is full.
+	 * Identical locations share a single sample.
+	 */
+	TMap<FVector2D, int32> SampleIndexOfLocation;
+	FBox BoundingBoxRead(ForceInit);
 
-		PointsPendingReadBacks = MakeShared<FSWShareableSamplePoints, ESPMode::ThreadSafe>();
-		TSharedPtr<FSWShareableSamplePoints>& Samples = PointsPendingReadBacks;
+	int32 QueueIndex = 0;
+	for (; QueueIndex < HeightQueryDispatchQueue.Num(); QueueIndex++)
+	{
+		const uint32 QueryID = HeightQueryDispatchQueue[QueueIndex];
+		FSWHeightQuery* Query = HeightQueries.Find(QueryID);
 
-		FBox BoundingBoxRead(Origin);		
+		if (!Query)
+			continue;
 
-		Samples->PositionsXY.SetNum(25*2);
-		for(int i=0; i<25;i++)
+		for (; Query->NextLocationToDispatch < Query->Locations.Num(); Query->NextLocationToDispatch++)
 		{
-			if(i< Origin.Num())
+			const FVector& Location = Query->Locations[Query->NextLocationToDispatch];
+			const FVector2D Location2D(Location);
+
+			int32 SampleIndex = INDEX_NONE;
+
+			if (const int32* ExistingSample = SampleIndexOfLocation.Find(Location2D))
 			{
-				Samples->PositionsXY[i*2] = Origin[i].X;
-				Samples->PositionsXY[i*2+1] = Origin[i].Y;
+				SampleIndex = *ExistingSample;
 			}
 			else
 			{
-				Samples->PositionsXY[i*2] = 0.f;
-				Samples->PositionsXY[i*2+1] = 0.f;
+				if (SampleIndexOfLocation.Num() >= MaxSamples)
+					break;
+
+				SampleIndex = SampleIndexOfLocation.Num();
+				SampleIndexOfLocation.Add(Location2D, SampleIndex);
+
+				Batch.Samples->PositionsXY.Add(Location.X);
+				Batch.Samples->PositionsXY.Add(Location.Y);
+				BoundingBoxRead += Location;
 			}
+
+			Batch.SampleRefs.Add({ QueryID, Query->NextLocationToDispatch, SampleIndex });
+			Query->PendingSamples++;
 		}
 
-		if (USWorldSubsystem* ShaderWorldSubsystem = SWorldSubsystem)
-		{
-			ShaderWorldSubsystem->LoadSampleLocationsInRT(ReadRequestLocation, Samples);
+		// Batch is full, remaining samples of this query go to the next batch
+		if (Query->NextLocationToDispatch < Query->Locations.Num())
+			break;
+	}
+
+	HeightQueryDispatchQueue.RemoveAt(0, QueueIndex, false);
+
+	if (Batch.SampleRefs.Num() <= 0)
+		return true;
+
+	Batch.Samples->PositionsXY.SetNumZeroed(MaxSamples * 2);
+
+	if (USWorldSubsystem* ShaderWorldSubsystem = SWorldSubsystem)
+	{
+		TSharedPtr<FSWShareableSamplePoints>& Samples = Batch.Samples;
+		ShaderWorldSubsystem->LoadSampleLocationsInRT(Batch.LocationsRT, Samples);
+	}
 
 #if SW_COMPUTE_GENERATION
-			
+
 #else
-			UKismetRenderingLibrary::DrawMaterialToRenderTarget(this, ReadRequestLocationHeightmap, GeneratorDynamicForReadBack);
+	UKismetRenderingLibrary::DrawMaterialToRenderTarget(this, Batch.HeightmapRT, Batch.GeneratorDyn);
 #endif
 
-			int32 Size_RT_Readback = ReadRequestLocationHeightmap.Get()->SizeX;
+	if (BrushManager)
+	{
+		int32 BatchN = BatchDim;
+		const FVector Extent = BoundingBoxRead.GetExtent();
+		const int32 BrushGridSpacing = FMath::CeilToInt(FMath::Max(Extent.X, Extent.Y) * 2.0 / (BatchDim - 1));
+
+		BrushManager->ApplyBrushStackToHeightMap(this, 0, Batch.HeightmapRT.Get(), BoundingBoxRead.GetCenter(), BrushGridSpacing, BatchN, false, true, Batch.LocationsRT.Get());
+	}
 
-			FVector Barycentre = BoundingBoxRead.GetCenter();
-			FVector Extent = BoundingBoxRead.GetExtent();
-			float gridspacing = Extent.X*2.0/ (Size_RT_Readback-1);
+	if (!Batch.ReadData.IsValid())
+		Batch.ReadData = MakeShared<FSWColorRead, ESPMode::ThreadSafe>();
 
-			if (BrushManager)
-				BrushManager->ApplyBrushStackToHeightMap(this, 0, ReadRequestLocationHeightmap.Get(), Barycentre, gridspacing, Size_RT_Readback, false,true, ReadRequestLocation.Get());
+	Batch.ReadData->ReadData.SetNum(MaxSamples);
 
+	if (!Batch.ReadCompletion.IsValid())
+		Batch.ReadCompletion = MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>();
 
-			ReadBackHeightData = MakeShared<FSWColorRead, ESPMode::ThreadSafe>();
-			ReadBackHeightData->ReadData.SetNum(25);
+	Batch.ReadCompletion->AtomicSet(false);
+	Batch.bInFlight = true;
 
-			ENQUEUE_RENDER_COMMAND(ReadGeoClipMapRTCmd)(
-				[InRT = ReadRequestLocationHeightmap, HeightData = ReadBackHeightData, Completion = bProcessingHeightRetrievalRT](FRHICommandListImmediate& RHICmdList)
-				{
-					check(IsInRenderingThread());
+	ENQUEUE_RENDER_COMMAND(ReadGeoClipMapRTCmd)(
+		[InRT = Batch.HeightmapRT, HeightData = Batch.ReadData, Completion = Batch.ReadCompletion](FRHICommandListImmediate& RHICmdList)
+		{
+			check(IsInRenderingThread());
 
-					if (HeightData.IsValid() && InRT->GetResource())
-					{						
-						FRDGBuilder GraphBuilder(RHICmdList);
+			if (HeightData.IsValid() && InRT->GetResource())
+			{
+				FRDGBuilder GraphBuilder(RHICmdList);
 
-						TSharedPtr<FRHIGPUTextureReadback> ReadBackStaging = MakeShared<FRHIGPUTextureReadback>(TEXT("SWGPUTextureReadback"));
+				TSharedPtr<FRHIGPUTextureReadback> ReadBackStaging = MakeShared<FRHIGPUTextureReadback>(TEXT("SWGPUTextureReadback"));
 
-						FRDGTextureRef RDGSourceTexture = RegisterExternalTexture(GraphBuilder, InRT->GetResource()->TextureRHI, TEXT("SWSourceTextureToReadbackTexture"));
+				FRDGTextureRef RDGSourceTexture = RegisterExternalTexture(GraphBuilder, InRT->GetResource()->TextureRHI, TEXT("SWSourceTextureToReadbackTexture"));
 
-						AddEnqueueCopyPass(GraphBuilder, ReadBackStaging.Get(), RDGSourceTexture);
+				AddEnqueueCopyPass(GraphBuilder, ReadBackStaging.Get(), RDGSourceTexture);
 
-						GraphBuilder.Execute();
+				GraphBuilder.Execute();
 
-						GSWSimpleReadbackManager.AddPendingReadBack(GPixelFormats[RDGSourceTexture->Desc.Format].BlockBytes, RDGSourceTexture->Desc.Extent.X, RDGSourceTexture->Desc.Extent.Y,ReadBackStaging, const_cast<TSharedPtr<FSWColorRead, ESPMode::ThreadSafe>&>(HeightData), const_cast<TSharedPtr < FThreadSafeBool, ESPMode::ThreadSafe>&>(Completion));
+				GSWSimpleReadbackManager.AddPendingReadBack(GPixelFormats[RDGSourceTexture->Desc.Format].BlockBytes, RDGSourceTexture->Desc.Extent.X, RDGSourceTexture->Desc.Extent.Y, ReadBackStaging, const_cast<TSharedPtr<FSWColorRead, ESPMode::ThreadSafe>&>(HeightData), const_cast<TSharedPtr < FThreadSafeBool, ESPMode::ThreadSafe>&>(Completion));
+			}
+		});
 
-					}
+	return true;
+}
 
-				});
+void AShaderWorldActor::CompleteHeightQueryBatch(FSWHeightQueryBatch& Batch, TArray<FSWCompletedHeightQuery>& OutCompletedQueries)
+{
+	Batch.bInFlight = false;
+
+	if (!Batch.ReadData.IsValid() || !Batch.HeightmapRT)
+		return;
+
+	const int32 BatchDim = Batch.HeightmapRT->SizeX;
+	uint8* ReadData8 = (uint8*)Batch.ReadData->ReadData.GetData();
+	uint16 MaterialIndice = 0;
+
+	for (const FSWHeightQuerySampleRef& Ref : Batch.SampleRefs)
+	{
+		FSWHeightQuery* Query = HeightQueries.Find(Ref.QueryID);
+
+		if (!Query)
+			continue;
+
+		int32 Texel = Ref.SampleIndex;
 
-			HeightReadBackFence.BeginFence();
+		if (RendererAPI == EGeoRenderingAPI::OpenGL)
+			Texel = Ref.SampleIndex % BatchDim + (BatchDim - 1 - Ref.SampleIndex / BatchDim) * BatchDim;
+
+		const FVector& Location = Query->Locations[Ref.LocationIndex];
+		Query->Results[Ref.LocationIndex] = FVector3f(Location.X, Location.Y, GetHeightFromGPURead(&ReadData8[Texel * 4], MaterialIndice) / HeightScale);
+
+		Query->PendingSamples--;
+
+		if (Query->PendingSamples <= 0 && Query->NextLocationToDispatch >= Query->Locations.Num())
+		{
+			OutCompletedQueries.Add({ MoveTemp(Query->Callback), MoveTemp(Query->Results) });
+
+			HeightQueries.Remove(Ref.QueryID);
 		}
+	}
+
+	Batch.SampleRefs.Reset();
+}
+
+bool AShaderWorldActor::RetrieveHeightAt(const TArray<FVector>& Origin, const FSWHeightRetrievalDelegate& Callback)
+{
+	if (CanUseCPUHeightEvaluation())
+	{
+		// Same locations as the ones sent to the generator material
+		TArray<FVector3f> Positions;
+		Positions.SetNumUninitialized(Origin.Num());
+
+		ParallelFor(Origin.Num(), [&](int32 k)
+			{
+				uint16 MaterialIndice = 0;
+				Positions[k] = FVector3f(Origin[k].X, Origin[k].Y, HeightEvaluator->ComputeWorldHeight(FVector2D(Origin[k]), MaterialIndice));
+			});
+
+		Callback.ExecuteIfBound(Positions);
 
 		return true;
 	}
 
-	return false;	
+	if (!Generator || !SWorldSubsystem)
+		return false;
+
+	if (Origin.Num() <= 0)
+	{
+		Callback.ExecuteIfBound(TArray<FVector3f>());
+		return true;
+	}
+
+	const uint32 QueryID = HeightQueryNextID++;
+
+	FSWHeightQuery& Query = HeightQueries.Add(QueryID);
+	Query.Locations = Origin;
+	Query.Results.SetNumZeroed(Origin.Num());
+	Query.Callback = Callback;
+
+	HeightQueryDispatchQueue.Add(QueryID);
+
+	return true;
 }
 
 float AShaderWorldActor::Get_TerrainPatchSize(int LOD)
@@ -1452,6 +1873,14 @@ void AShaderWorldActor::ReceiveExternalDataUpdate(AShaderWorldActor* Source, int
 	}
 }
 
+float AShaderWorldActor::GetClipMapStaleness(int32 LOD) const
+{
+	if (!Meshes.IsValidIndex(LOD) || Meshes[LOD].StaleSince <= 0.0 || Meshes[LOD].bHidden)
+		return 0.f;
+
+	return FMath::Max(0.f, static_cast<float>(FPlatformTime::Seconds() - Meshes[LOD].StaleSince));
+}
+
 FBox2D AShaderWorldActor::GetHighestLOD_FootPrint()
 {
 	if(GetMeshNum()>0)
@@ -1573,6 +2002,8 @@ void AShaderWorldActor::PreEditChange(FProperty* PropertyThatWillChange)
 			PropName == TEXT("RootComp") ||
 
 			PropName == TEXT("WorldHasBounds") ||
+			PropName == TEXT("WorldBounds") ||
+			PropName == TEXT("TileSizeGeneration") ||
 
 			PropName == TEXT("ShadowCastingRange") ||
 			PropName == TEXT("DrawDistance") ||
@@ -1581,6 +2012,7 @@ void AShaderWorldActor::PreEditChange(FProperty* PropertyThatWillChange)
 			PropName == TEXT("GenerateCollision") ||
 			PropName == TEXT("CollisionChannel") ||
 			PropName == TEXT("TopologyFixUnderLOD") ||
+			PropName == TEXT("TransientCacheMemoryBudgetMB") ||
 			PropName == TEXT("EnableWorldPositionOffsetUnderLOD") ||
 			
 
@@ -1595,6 +2027,11 @@ void AShaderWorldActor::PreEditChange(FProperty* PropertyThatWillChange)
 
 			PropName == TEXT("CollisionResolution") ||
 			PropName == TEXT("CollisionVerticesPerPatch") ||
+			PropName == TEXT("bUseHeightfieldCollision") ||
+			PropName == TEXT("bUseTileDiskCache") ||
+			PropName == TEXT("TileDiskCacheMaxSizeMB") ||
+			PropName == TEXT("TileDiskCacheVersion") ||
+			PropName == TEXT("bBatchCollisionGeneration") ||
 
 			PropName == TEXT("ExportMaterial") ||
 			PropName == TEXT("DataLayerWithMaterialID") ||
@@ -1608,6 +2045,7 @@ void AShaderWorldActor::PreEditChange(FProperty* PropertyThatWillChange)
 			PropName == TEXT("TransitionWidth") ||
 			PropName == TEXT("AltitudeToLODTransition") ||
 			PropName == TEXT("SeedGenerator") ||
+			PropName == TEXT("HeightGenerator") ||
 			PropName == TEXT("SeedRange")
 			)
 		{
@@ -1706,7 +2144,9 @@ void AShaderWorldActor::PostEditChangeProperty(FPropertyChangedEvent& PropertyCh
 			PropName == TEXT("PlanetRadiusKm") ||
 			PropName == TEXT("RootComp") ||
 
-			PropName == TEXT("WorldHasBounds") ||			
+			PropName == TEXT("WorldHasBounds") ||
+			PropName == TEXT("WorldBounds") ||
+			PropName == TEXT("TileSizeGeneration") ||
 
 			PropName == TEXT("ShadowCastingRange") ||
 			PropName == TEXT("DrawDistance") ||
@@ -1715,6 +2155,7 @@ void AShaderWorldActor::PostEditChangeProperty(FPropertyChangedEvent& PropertyCh
 			PropName == TEXT("GenerateCollision") ||
 			PropName == TEXT("CollisionChannel") ||
 			PropName == TEXT("TopologyFixUnderLOD") ||
+			PropName == TEXT("TransientCacheMemoryBudgetMB") ||
 			PropName == TEXT("EnableWorldPositionOffsetUnderLOD") ||
 
 			PropName == TEXT("BrushManager") ||
@@ -1728,6 +2169,10 @@ void AShaderWorldActor::PostEditChangeProperty(FPropertyChangedEvent& PropertyCh
 
 			PropName == TEXT("CollisionResolution") ||
 			PropName == TEXT("CollisionVerticesPerPatch") ||
+			PropName == TEXT("bUseHeightfieldCollision") ||
+			PropName == TEXT("bUseTileDiskCache") ||
+			PropName == TEXT("TileDiskCacheMaxSizeMB") ||
+			PropName == TEXT("TileDiskCacheVersion") ||
 
 			PropName == TEXT("ExportMaterial") ||
 			PropName == TEXT("DataLayerWithMaterialID") ||
@@ -1754,6 +2199,13 @@ void AShaderWorldActor::PostEditChangeProperty(FPropertyChangedEvent& PropertyCh
 
 		}
 
+		if (Property->GetFName() == GET_MEMBER_NAME_CHECKED(AShaderWorldActor, HeightGenerator))
+		{
+			// CPU mirror only feeds collision and height retrieval: refresh evaluator and collision, the rendered terrain is unchanged
+			UpdateHeightEvaluator();
+			CollisionUpdateRequest.Enqueue(FBox2D(FVector2D(-HALF_WORLD_MAX), FVector2D(HALF_WORLD_MAX)));
+		}
+
 		if (PropName == TEXT("TransitionWidth"))
 		{
 			UpdatePatchData.AtomicSet(true);
@@ -1800,42 +2252,141 @@ bool AShaderWorldActor::CanUpdateSpawnables()
 	return false;
 }
 
-void AShaderWorldActor::FinalizeAsyncWork()
+/** Smoothed cost per written instance of the segmented HISM updates of a spawnable, batches writing nothing are skipped */
+static void AccumulateFinalizeCost(FSpawnableMesh& Spawn, double Seconds, int32 NumInstances)
+{
+	if (NumInstances <= 0)
+		return;
+
+	const double Sample = Seconds / NumInstances;
+	Spawn.FinalizeSecondsPerInstance = Spawn.FinalizeSecondsPerInstance > 0.0 ? FMath::Lerp(Spawn.FinalizeSecondsPerInstance, Sample, 0.2) : Sample;
+}
+
+void AShaderWorldActor::GatherSpawnableFinalizeOrder(TArray<FSpawnableMesh*, TInlineAllocator<64>>& OutOrder)
 {
 	SW_FCT_CYCLE()
 
-	if(rebuild)
-	{
-		return;
-	}
-		
+	OutOrder.Reset();
 
+	struct FSpawnableOrder
 	{
-		double VegetationStart = FPlatformTime::Seconds();
+		FSpawnableMesh* Spawn = nullptr;
+		double Priority = -1.0;
+	};
+	TArray<FSpawnableOrder, TInlineAllocator<64>> Order;
 
-		const double GameThreadBudget_ms = SWGameThreadBudgetFinalize_ms.GetValueOnGameThread();
+	const bool bPrioritize = CVarSWFinalizePrioritize.GetValueOnGameThread() > 0;
 
+	TArray<FVector, TInlineAllocator<8>> Viewers;
+	const FVector Origin = FVector(GetWorld()->OriginLocation);
 
-		const uint32 HISMStaggerUpdateBy = InstanceCountUpdate;
-		uint32 LocalHISMWorkCounter = 0;
+	for (const FVector& Camera : CameraLocations)
+		Viewers.Add(Camera + Origin);
+
+	if (Viewers.Num() == 0)
+		Viewers.Add(CamLocation + Origin);
 
 	for (FSWBiom& elB : Bioms)
 	{
-		
-	for (FSpawnableMesh& Spawn : elB.Spawnables)
-	{		
-
-		if (Spawn.SpawnType == ESpawnableType::Undefined)
+		for (FSpawnableMesh& Spawn : elB.Spawnables)
 		{
-			continue;
-		}
+			double BestPriority = -1.0;
 
-		if (LocalHISMWorkCounter > HISMStaggerUpdateBy)
-			continue;
+			if (bPrioritize && Spawn.SpawnType != ESpawnableType::Undefined && Spawn.SpawnableWorkQueue.Num() > 0)
+			{
+				const double CellSize = FMath::Max(1.0, Spawn.GridSizeMeters * 100.0);
 
-		if ((FPlatformTime::Seconds() - VegetationStart)*1000.0 > GameThreadBudget_ms)
-		{
-			return;
+				for (FSpawnableMesh::FSpawnableProcessingWork& W : Spawn.SpawnableWorkQueue)
+				{
+					if (W.bCollisionProcessingOverflow || W.SentToHISM)
+						continue;
+
+					double ClosestViewerSquared = TNumericLimits<double>::Max();
+
+					for (const FVector& Viewer : Viewers)
+						ClosestViewerSquared = FMath::Min(ClosestViewerSquared, FVector::DistSquared2D(W.MeshLocCompute, Viewer));
+
+					// The cell holding the viewer ranks 1, then coverage decreases with distance
+					W.FinalizePriority = CellSize / FMath::Max(FMath::Sqrt(ClosestViewerSquared), CellSize);
+					BestPriority = FMath::Max(BestPriority, W.FinalizePriority);
+				}
+
+				Spawn.SpawnableWorkQueue.StableSort([](const FSpawnableMesh::FSpawnableProcessingWork& A, const FSpawnableMesh::FSpawnableProcessingWork& B)
+				{
+					return A.FinalizePriority > B.FinalizePriority;
+				});
+			}
+
+			Order.Add({ &Spawn, BestPriority });
+		}
+	}
+
+	// Spawnables without pending cells keep their relative order, after the ones with pending cells
+	if (bPrioritize)
+	{
+		Order.StableSort([](const FSpawnableOrder& A, const FSpawnableOrder& B)
+		{
+			return A.Priority > B.Priority;
+		});
+	}
+
+	for (const FSpawnableOrder& Entry : Order)
+		OutOrder.Add(Entry.Spawn);
+}
+
+int32 AShaderWorldActor::ComputeSpawnableFinalizeBatchSize(const FSpawnableMesh& Spawn, double GameThreadBudget_ms) const
+{
+	const int32 DefaultBatchSize = FMath::Max(1, CVarSWBatchUpdateCount.GetValueOnGameThread());
+
+	if (CVarSWFinalizeAutoBatchSize.GetValueOnGameThread() <= 0 || Spawn.FinalizeSecondsPerInstance <= 0.0)
+		return DefaultBatchSize;
+
+	const double BatchBudget_s = GameThreadBudget_ms / 1000.0 * FMath::Clamp(CVarSWFinalizeBatchBudgetFraction.GetValueOnGameThread(), 0.01f, 1.f);
+	const double BatchSize = BatchBudget_s / Spawn.FinalizeSecondsPerInstance;
+
+	return static_cast<int32>(FMath::Clamp(BatchSize, 32.0, 16.0 * DefaultBatchSize));
+}
+
+void AShaderWorldActor::FinalizeAsyncWork()
+{
+	SW_FCT_CYCLE()
+
+	if(rebuild)
+	{
+		return;
+	}
+		
+
+	{
+		double VegetationStart = FPlatformTime::Seconds();
+
+		const double GameThreadBudget_ms = SWGameThreadBudgetFinalize_ms.GetValueOnGameThread();
+
+
+		const uint32 HISMStaggerUpdateBy = InstanceCountUpdate;
+		uint32 LocalHISMWorkCounter = 0;
+		bool bSentBatchThisFrame = false;
+
+		// Near cells first: far foliage never holds the budget while close foliage waits
+		TArray<FSpawnableMesh*, TInlineAllocator<64>> FinalizeOrder;
+		GatherSpawnableFinalizeOrder(FinalizeOrder);
+
+	for (FSpawnableMesh* SpawnPtr : FinalizeOrder)
+	{
+		FSpawnableMesh& Spawn = *SpawnPtr;
+
+		if (Spawn.SpawnType == ESpawnableType::Undefined)
+		{
+			continue;
+		}
+
+		if (LocalHISMWorkCounter > HISMStaggerUpdateBy)
+			continue;
+
+		if ((FPlatformTime::Seconds() - VegetationStart)*1000.0 > GameThreadBudget_ms)
+		{
+			SW_INC_COUNTER(FinalizeBudgetOverruns)
+			return;
 		}
 
 		if(!Spawn.SpawnablesElemReadToProcess.IsEmpty())
@@ -1860,7 +2411,10 @@ void AShaderWorldActor::FinalizeAsyncWork()
 				UE_LOG(LogTemp,Warning,TEXT("ElementToUpdateData %d ElemReadToProcess %d"), Spawn.SegmentedOnly_ElementToUpdateData.Num(), Spawn.SpawnablesElemReadToProcess.Num())
 			}
 #if 1
-			int32 BudgetElementPerUpdate = CVarSWBatchUpdateCount.GetValueOnGameThread();
+			if (Spawn.FinalizeBatchSize <= 0)
+				Spawn.FinalizeBatchSize = ComputeSpawnableFinalizeBatchSize(Spawn, GameThreadBudget_ms);
+
+			const int32 BudgetElementPerUpdate = Spawn.FinalizeBatchSize;
 
 			TArray<int32> Iters;			
 			TArray<int32> Reminders;
@@ -1907,6 +2461,7 @@ void AShaderWorldActor::FinalizeAsyncWork()
 
 				if ((FPlatformTime::Seconds() - VegetationStart) * 1000.0 > GameThreadBudget_ms)
 				{
+					SW_INC_COUNTER(FinalizeBudgetOverruns)
 					AllSentToHISM = false;
 					return;
 				}
@@ -1987,8 +2542,12 @@ void AShaderWorldActor::FinalizeAsyncWork()
 									return;
 								}
 
-								if ((FPlatformTime::Seconds() - VegetationStart) * 1000.0 > GameThreadBudget_ms)
+								// Once a batch went through this frame, stop before one expected to overrun the budget
+								const double ExpectedBatch_ms = bSentBatchThisFrame ? Spawn.FinalizeSecondsPerInstance * BudgetElementPerUpdate * 1000.0 : 0.0;
+
+								if ((FPlatformTime::Seconds() - VegetationStart) * 1000.0 + ExpectedBatch_ms > GameThreadBudget_ms)
 								{
+									SW_INC_COUNTER(FinalizeBudgetOverruns)
 									return;
 								}
 
@@ -2008,7 +2567,11 @@ void AShaderWorldActor::FinalizeAsyncWork()
 										{
 											LocalHISMWorkCounter = Spawn.HIM_Mesh[i]->GetNumRenderInstances();
 										}
-										Spawn.HIM_Mesh[i]->SWNewBatchUpdateCountInstanceData(Mesh.InstanceOffset[i] + Iteration * BudgetElementPerUpdate, BudgetElementPerUpdate, W.InstancesT->Transforms[i], false, false, true, Iteration * BudgetElementPerUpdate);
+										const double BatchStart = FPlatformTime::Seconds();
+										int32 NumWritten = 0;
+										Spawn.HIM_Mesh[i]->SWNewBatchUpdateCountInstanceData(Mesh.InstanceOffset[i] + Iteration * BudgetElementPerUpdate, BudgetElementPerUpdate, W.InstancesT->Transforms[i], false, false, true, Iteration * BudgetElementPerUpdate, &NumWritten);
+										AccumulateFinalizeCost(Spawn, FPlatformTime::Seconds() - BatchStart, NumWritten);
+										bSentBatchThisFrame = true;
 										Mesh.OffsetOfSegmentedUpdate[i]++;
 
 										if ((Reminders[i] > 0) || ((Reminders[i] == 0) && (Mesh.OffsetOfSegmentedUpdate[i] < Iters[i])))
@@ -2016,7 +2579,11 @@ void AShaderWorldActor::FinalizeAsyncWork()
 									}
 									else if (Reminders[i] > 0)
 									{
-										Spawn.HIM_Mesh[i]->SWNewBatchUpdateCountInstanceData(Mesh.InstanceOffset[i] + Iters[i] * BudgetElementPerUpdate, Reminders[i], W.InstancesT->Transforms[i], false, false, true, Iters[i] * BudgetElementPerUpdate);
+										const double BatchStart = FPlatformTime::Seconds();
+										int32 NumWritten = 0;
+										Spawn.HIM_Mesh[i]->SWNewBatchUpdateCountInstanceData(Mesh.InstanceOffset[i] + Iters[i] * BudgetElementPerUpdate, Reminders[i], W.InstancesT->Transforms[i], false, false, true, Iters[i] * BudgetElementPerUpdate, &NumWritten);
+										AccumulateFinalizeCost(Spawn, FPlatformTime::Seconds() - BatchStart, NumWritten);
+										bSentBatchThisFrame = true;
 										Mesh.OffsetOfSegmentedUpdate[i]++;
 									}
 								}
@@ -2169,6 +2736,7 @@ void AShaderWorldActor::FinalizeAsyncWork()
 				SW_FCT_CYCLE("UpdateSpawnableCollisions")
 
 				Spawn.SpawnableWorkQueue.Empty();
+				Spawn.FinalizeBatchSize = 0;
 
 				if(!UpdateSpawnableCollisions(Spawn, VegetationStart))
 				{
@@ -2247,7 +2815,6 @@ void AShaderWorldActor::FinalizeAsyncWork()
 			}			
 		}
 	}
-	}
 
 	}
 
@@ -2257,6 +2824,7 @@ void AShaderWorldActor::FinalizeAsyncWork()
 
 void AShaderWorldActor::TerrainAndSpawnablesManagement(float& DeltaT)
 {
+	SW_STAGE_SCOPE(TerrainAndSpawnablesManagement)
 
 	TimeAcu += DeltaT;	
 
@@ -2299,7 +2867,7 @@ void AShaderWorldActor::TerrainAndSpawnablesManagement(float& DeltaT)
 	UpdateSpawnables();
 
 	/*
-	 * Currently just having BrushManagerRedrawScopes will force redraw of every LOD visible, no point keeping those scopes
+	 * The rings overlapping BrushManagerRedrawScopes were flagged by ScheduleClipMapUpdates(), no point keeping those scopes
 	 * Scope are mostly interesting for costly spawnables and collisions recomputations
 	 */
 	BrushManagerRedrawScopes.Empty();
@@ -2310,32 +2878,427 @@ void AShaderWorldActor::BoundedWorldUpdate(float& DeltaT)
 {
 	SW_FCT_CYCLE()
 
-	if(!BoundedWorldTree.IsValid())
-	{		
+	if (!WorldHasBounds)
 		return;
+
+	if(!BoundedWorldTree.IsValid())
+	{
+		/*
+		 * Root covers WorldBounds, leaves are TileSizeGeneration meters wide
+		 */
+		const double RootExtent = 50.0 * FMath::Max(WorldBounds.X, WorldBounds.Y);
+		const double LeafExtent = 50.0 * FMath::Max(TileSizeGeneration, 1);
+		const uint8 Depth = FMath::Clamp(FMath::CeilToInt(FMath::Log2(FMath::Max(RootExtent / LeafExtent, 1.0))), 0, 15) + 1;
+
+		BoundedWorldTree = MakeShared<FSW_PointerTree<FSWQuadElement>>(RootExtent, Depth, GetActorLocation());
+		BoundedWorldTree->GetData(FSW_PointerTree<FSWQuadElement>::RootIndex).QuadID = NextQuadID++;
+		TreeID++;
+
+		BoundedWorldVisit = nullptr;
+		BoundedWorldVisitorProcessing = false;
+		BoundedWorldVisitViewers.Empty();
+		BoundedWorldVisitRevision = INDEX_NONE;
+	}
+
+	if (BoundedWorldVisitorProcessing)
+	{
+		if (!BoundedWorldVisit.IsValid() || !BoundedWorldVisit->Completed)
+			return;
+
+		ProcessBoundedWorldVisit(*BoundedWorldVisit.Get());
 	}
 
+	if (BoundedWorldLeafRevision != BoundedWorldTree->GetRevision())
+	{
+		using FTreeNode = FSW_PointerTree<FSWQuadElement>::FNode;
+
+		BoundedWorldLeafBounds.Reset();
+		BoundedWorldTree->Traverse([this](int32 NodeIndex, const FTreeNode& Node)
+		{
+			if (Node.IsLeaf())
+				BoundedWorldLeafBounds.Add(FBox2D(FVector2D(Node.Bounds.Min), FVector2D(Node.Bounds.Max)));
+			return true;
+		});
+		BoundedWorldLeafRevision = BoundedWorldTree->GetRevision();
+	}
+
+	TArray<FVector> Viewers = CameraLocations;
+	if (Viewers.Num() <= 0)
+		Viewers.Add(CamLocation);
+
+	const float SplitDistance = CVarSWBoundedWorldSplitDistance.GetValueOnGameThread();
+
+	/*
+	 * A visit is only launched if the previous one modified the tree, or if the viewers moved by half a leaf:
+	 * a converged tree with static viewers costs nothing
+	 */
+	bool bNeedsVisit = BoundedWorldVisitRevision != BoundedWorldTree->GetRevision()
+		|| BoundedWorldVisitSplitDistance != SplitDistance
+		|| BoundedWorldVisitViewers.Num() != Viewers.Num();
+
+	const double MoveToleranceSquared = FMath::Square(25.0 * FMath::Max(TileSizeGeneration, 1));
+	for (int32 ViewerID = 0; !bNeedsVisit && ViewerID < Viewers.Num(); ViewerID++)
+		bNeedsVisit = FVector::DistSquared(Viewers[ViewerID], BoundedWorldVisitViewers[ViewerID]) > MoveToleranceSquared;
+
+	if (!bNeedsVisit)
+		return;
+
+	BoundedWorldVisitViewers = Viewers;
+	BoundedWorldVisitSplitDistance = SplitDistance;
+	BoundedWorldVisitRevision = BoundedWorldTree->GetRevision();
+
+	BoundedWorldVisit = MakeShared<FSWBoundedWorldVisit, ESPMode::ThreadSafe>();
+	BoundedWorldVisit->TreeID = TreeID;
+	BoundedWorldVisit->TreeRevision = BoundedWorldTree->GetRevision();
+	BoundedWorldVisitorProcessing = true;
+
+	/*
+	 * LOD selection: a node is split while the closest viewer is within SplitDistance times its size.
+	 * Each visit refines or coarsens by one level, working on a snapshot so the tree itself is never shared.
+	 */
+	Async(EAsyncExecution::TaskGraph, [Visit = BoundedWorldVisit, Tree = BoundedWorldTree->MakeSnapshot(), Viewers = MoveTemp(Viewers), SplitDistance]
+	{
+		using FTreeNode = FSW_PointerTree<FSWQuadElement>::FNode;
+
+		Tree->Traverse([&](int32 NodeIndex, const FTreeNode& Node)
+		{
+			const double Size = 2.0 * Node.Bounds.GetExtent().X;
+
+			double ClosestViewerSquared = TNumericLimits<double>::Max();
+			for (const FVector& Viewer : Viewers)
+				ClosestViewerSquared = FMath::Min(ClosestViewerSquared, Node.Bounds.ComputeSquaredDistanceToPoint(Viewer));
+
+			const bool bWantsSplit = (Node.Depth + 1 < Tree->GetMaxDepth()) && ClosestViewerSquared < FMath::Square(SplitDistance * Size);
+
+			if (Node.IsLeaf())
+			{
+				if (bWantsSplit)
+					Visit->ToSubdivide.Add(NodeIndex);
+
+				return false;
+			}
+
+			if (!bWantsSplit)
+			{
+				Visit->ToCollapse.Add(NodeIndex);
+				return false;
+			}
+
+			return true;
+		});
+
+		Visit->Completed = true;
+	});
 }
 
-void AShaderWorldActor::ProcessBoundedWorldVisit(const uint64 TreeID_, const TArray<TStaticArray<TSharedPtr < FSW_PointerTree<FSWQuadElement>::FPointerNode>, 4 >>& ToCreate, const TArray<TStaticArray<TSharedPtr < FSW_PointerTree<FSWQuadElement>::FPointerNode>, 4 >>& ToCleanUp)
+void AShaderWorldActor::ProcessBoundedWorldVisit(const FSWBoundedWorldVisit& Visit)
 {
-	if(TreeID_!= TreeID)
-	return;
-	
+	BoundedWorldVisitorProcessing = false;
 
-	if(!BoundedWorldTree.IsValid())
-	{		
+	if(Visit.TreeID != TreeID || !BoundedWorldTree.IsValid() || Visit.TreeRevision != BoundedWorldTree->GetRevision())
 		return;
+
+	// Collapsed subtrees never contain a leaf to subdivide: the visit stops at the first node of either list
+	for (const int32 NodeIndex : Visit.ToCollapse)
+		BoundedWorldTree->Collapse(NodeIndex);
+
+	for (const int32 NodeIndex : Visit.ToSubdivide)
+	{
+		if (!BoundedWorldTree->Subdivide(NodeIndex))
+			continue;
+
+		const int32 FirstChild = BoundedWorldTree->GetNode(NodeIndex).FirstChild;
+		for (int32 Child = 0; Child < 4; Child++)
+			BoundedWorldTree->GetData(FirstChild + Child).QuadID = NextQuadID++;
 	}
+}
 
-	BoundedWorldVisitorProcessing = false;
+bool AShaderWorldActor::IsClipMapRingInBoundedWorld(const FClipMapMeshElement& Ring, const FClipMapMeshElement* InnerRing) const
+{
+	if (!WorldHasBounds || BoundedWorldLeafBounds.Num() <= 0)
+		return true;
+
+	const FIntVector Origin = GetWorld() ? GetWorld()->OriginLocation : FIntVector(0);
+	auto RingFootprint = [&](const FClipMapMeshElement& Elem)
+	{
+		const FVector2D Center = FVector2D(FVector(Elem.Location - Origin));
+		const double Extent = (N - 1) * Elem.GridSpacing * 0.5;
+		return FBox2D(Center - FVector2D(Extent), Center + FVector2D(Extent));
+	};
+
+	const FBox2D Footprint = RingFootprint(Ring);
+	const FBox2D InnerFootprint = InnerRing ? RingFootprint(*InnerRing) : FBox2D(ForceInit);
+
+	/*
+	 * Leaves are finer close to the viewers, where the finer rings are: the test gets more accurate where it matters
+	 */
+	for (const FBox2D& Leaf : BoundedWorldLeafBounds)
+	{
+		if (Footprint.Intersect(Leaf) && !(InnerRing && InnerFootprint.IsInside(Leaf)))
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * Reference for sw.BoundedWorld.BenchmarkTree: the quadtree as it was before the flat arena,
+ * one heap allocated node per quad linked by shared pointers, cloned node by node to be read from another thread
+ */
+struct FSWSharedPtrQuadNode : public TSharedFromThis<FSWSharedPtrQuadNode>
+{
+	TWeakPtr<FSWSharedPtrQuadNode> Parent;
+	TStaticArray<TSharedPtr<FSWSharedPtrQuadNode>, 4> Children;
+	uint8 Depth = 0;
+	FVector Center = FVector(0);
+	FBox Bounds = FBox(ForceInit);
+	FSWQuadElement Data;
+
+	bool IsLeaf() const { return !Children[0].IsValid(); }
+};
+
+static TSharedPtr<FSWSharedPtrQuadNode> CloneSharedPtrQuadNode(const TSharedPtr<FSWSharedPtrQuadNode>& Node, const TSharedPtr<FSWSharedPtrQuadNode>& Parent)
+{
+	TSharedPtr<FSWSharedPtrQuadNode> Clone = MakeShared<FSWSharedPtrQuadNode>(*Node);
+	Clone->Parent = Parent;
+	if (!Node->IsLeaf())
+	{
+		for (int32 Child = 0; Child < 4; Child++)
+			Clone->Children[Child] = CloneSharedPtrQuadNode(Node->Children[Child], Clone);
+	}
+	return Clone;
+}
+
+/*
+ * Both trees follow the same viewer path with the LOD selection of BoundedWorldUpdate, one level per visit,
+ * each visit working on a copy of the tree as the asynchronous visit does. Box queries follow the viewer.
+ * The trees are compared leaf by leaf at the end.
+ */
+void AShaderWorldActor::BenchmarkBoundedWorldTree(const TArray<FString>& Args)
+{
+	const double WorldSizeMeters = Args.Num() > 0 ? FMath::Max(FCString::Atod(*Args[0]), 100.0) : 8000.0;
+	const int32 TileSizeMeters = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 64;
+	const int32 Steps = Args.Num() > 2 ? FMath::Max(FCString::Atoi(*Args[2]), 1) : 256;
+	const float SplitDistance = CVarSWBoundedWorldSplitDistance.GetValueOnGameThread();
+
+	const double RootExtent = 50.0 * WorldSizeMeters;
+	const double LeafExtent = 50.0 * TileSizeMeters;
+	const uint8 Depth = FMath::Clamp(FMath::CeilToInt(FMath::Log2(FMath::Max(RootExtent / LeafExtent, 1.0))), 0, 15) + 1;
+
+	TArray<double> Extents;
+	for (int32 LOD = 0; LOD < Depth; LOD++)
+		Extents.Add(RootExtent * (1.0 / (1 << LOD)));
+
+	auto WantsSplit = [&](const FBox& Bounds, uint8 NodeDepth, const FVector& Viewer)
+	{
+		return (NodeDepth + 1 < Depth) && Bounds.ComputeSquaredDistanceToPoint(Viewer) < FMath::Square(SplitDistance * 2.0 * Bounds.GetExtent().X);
+	};
+
+	// Viewer crossing the world diagonally, back and forth
+	TArray<FVector> ViewerPath;
+	for (int32 Step = 0; Step < Steps; Step++)
+	{
+		const double Alpha = FMath::Sin(PI * Step / Steps);
+		ViewerPath.Add(FVector(FMath::Lerp(-0.9, 0.9, Alpha) * RootExtent, FMath::Lerp(-0.7, 0.8, Alpha) * RootExtent, 0.0));
+	}
+
+	const FVector QueryExtent = FVector(4.0 * LeafExtent);
+
+	// Flat arena
+	int64 FlatQueryLeaves = 0;
+	double FlatVisitSeconds = 0.0;
+	double FlatQuerySeconds = 0.0;
+	using FFlatTree = FSW_PointerTree<FSWQuadElement>;
+	FFlatTree FlatTree(RootExtent, Depth, FVector(0));
+	{
+		TArray<int32> ToSubdivide;
+		TArray<int32> ToCollapse;
+		TArray<int32> Leaves;
+
+		for (const FVector& Viewer : ViewerPath)
+		{
+			double Start = FPlatformTime::Seconds();
+			for (uint8 Level = 0; Level < Depth; Level++)
+			{
+				const TSharedRef<const FFlatTree, ESPMode::ThreadSafe> Snapshot = FlatTree.MakeSnapshot();
+
+				ToSubdivide.Reset();
+				ToCollapse.Reset();
+				Snapshot->Traverse([&](int32 NodeIndex, const FFlatTree::FNode& Node)
+				{
+					const bool bWantsSplit = WantsSplit(Node.Bounds, Node.Depth, Viewer);
+					if (Node.IsLeaf())
+					{
+						if (bWantsSplit)
+							ToSubdivide.Add(NodeIndex);
+						return false;
+					}
+					if (!bWantsSplit)
+					{
+						ToCollapse.Add(NodeIndex);
+						return false;
+					}
+					return true;
+				});
+
+				if (ToSubdivide.Num() <= 0 && ToCollapse.Num() <= 0)
+					break;
+
+				for (const int32 NodeIndex : ToCollapse)
+					FlatTree.Collapse(NodeIndex);
+				for (const int32 NodeIndex : ToSubdivide)
+					FlatTree.Subdivide(NodeIndex);
+			}
+			FlatVisitSeconds += FPlatformTime::Seconds() - Start;
+
+			Start = FPlatformTime::Seconds();
+			Leaves.Reset();
+			FlatTree.QueryBox(FBox(Viewer - QueryExtent, Viewer + QueryExtent), Leaves);
+			FlatQuerySeconds += FPlatformTime::Seconds() - Start;
+			FlatQueryLeaves += Leaves.Num();
+		}
+	}
+
+	// Shared pointer nodes
+	int64 SharedQueryLeaves = 0;
+	double SharedVisitSeconds = 0.0;
+	double SharedQuerySeconds = 0.0;
+	TSharedPtr<FSWSharedPtrQuadNode> SharedRoot = MakeShared<FSWSharedPtrQuadNode>();
+	SharedRoot->Bounds = FBox(FVector(-RootExtent), FVector(RootExtent));
+	{
+		TArray<FSWSharedPtrQuadNode*> ToSubdivide;
+		TArray<FSWSharedPtrQuadNode*> ToCollapse;
+		TArray<FSWSharedPtrQuadNode*> Stack;
+		int32 Leaves = 0;
+
+		for (const FVector& Viewer : ViewerPath)
+		{
+			double Start = FPlatformTime::Seconds();
+			for (uint8 Level = 0; Level < Depth; Level++)
+			{
+				// The selection runs on the copy and is applied by path to the original nodes
+				const TSharedPtr<FSWSharedPtrQuadNode> Snapshot = CloneSharedPtrQuadNode(SharedRoot, nullptr);
+
+				ToSubdivide.Reset();
+				ToCollapse.Reset();
+				TArray<TPair<FSWSharedPtrQuadNode*, FSWSharedPtrQuadNode*>> PairStack;
+				PairStack.Add({ Snapshot.Get(), SharedRoot.Get() });
+				while (PairStack.Num() > 0)
+				{
+					const TPair<FSWSharedPtrQuadNode*, FSWSharedPtrQuadNode*> Current = PairStack.Pop(false);
+					const bool bWantsSplit = WantsSplit(Current.Key->Bounds, Current.Key->Depth, Viewer);
+					if (Current.Key->IsLeaf())
+					{
+						if (bWantsSplit)
+							ToSubdivide.Add(Current.Value);
+						continue;
+					}
+					if (!bWantsSplit)
+					{
+						ToCollapse.Add(Current.Value);
+						continue;
+					}
+					for (int32 Child = 3; Child >= 0; Child--)
+						PairStack.Add({ Current.Key->Children[Child].Get(), Current.Value->Children[Child].Get() });
+				}
+
+				if (ToSubdivide.Num() <= 0 && ToCollapse.Num() <= 0)
+					break;
+
+				for (FSWSharedPtrQuadNode* Node : ToCollapse)
+				{
+					for (int32 Child = 0; Child < 4; Child++)
+						Node->Children[Child] = nullptr;
+				}
+				for (FSWSharedPtrQuadNode* Node : ToSubdivide)
+				{
+					const uint8 ChildDepth = Node->Depth + 1;
+					const double ChildExtent = Extents[ChildDepth];
+					for (int32 Child = 0; Child < 4; Child++)
+					{
+						TSharedPtr<FSWSharedPtrQuadNode> ChildNode = MakeShared<FSWSharedPtrQuadNode>();
+						ChildNode->Parent = Node->AsShared();
+						ChildNode->Depth = ChildDepth;
+						ChildNode->Center = Node->Center + ChildExtent * FVector((Child & 1) ? 1.0 : -1.0, (Child & 2) ? 1.0 : -1.0, 0.0);
+						ChildNode->Bounds = FBox(ChildNode->Center - ChildExtent * FVector(1.0), ChildNode->Center + ChildExtent * FVector(1.0));
+						Node->Children[Child] = ChildNode;
+					}
+				}
+			}
+			SharedVisitSeconds += FPlatformTime::Seconds() - Start;
+
+			Start = FPlatformTime::Seconds();
+			const FBox QueryBox(Viewer - QueryExtent, Viewer + QueryExtent);
+			Leaves = 0;
+			Stack.Reset();
+			Stack.Add(SharedRoot.Get());
+			while (Stack.Num() > 0)
+			{
+				FSWSharedPtrQuadNode* Current = Stack.Pop(false);
+				if (!Current->Bounds.Intersect(QueryBox))
+					continue;
+				if (Current->IsLeaf())
+				{
+					Leaves++;
+					continue;
+				}
+				for (int32 Child = 3; Child >= 0; Child--)
+					Stack.Add(Current->Children[Child].Get());
+			}
+			SharedQuerySeconds += FPlatformTime::Seconds() - Start;
+			SharedQueryLeaves += Leaves;
+		}
+	}
+
+	// Both trees must hold the same leaves, in the same depth first order
+	TArray<FBox> FlatLeaves;
+	FlatTree.Traverse([&FlatLeaves](int32 NodeIndex, const FFlatTree::FNode& Node)
+	{
+		if (Node.IsLeaf())
+			FlatLeaves.Add(Node.Bounds);
+		return true;
+	});
+
+	TArray<FBox> SharedLeaves;
+	TArray<FSWSharedPtrQuadNode*> Stack;
+	Stack.Add(SharedRoot.Get());
+	while (Stack.Num() > 0)
+	{
+		FSWSharedPtrQuadNode* Current = Stack.Pop(false);
+		if (Current->IsLeaf())
+		{
+			SharedLeaves.Add(Current->Bounds);
+			continue;
+		}
+		for (int32 Child = 3; Child >= 0; Child--)
+			Stack.Add(Current->Children[Child].Get());
+	}
 
+	int32 Mismatches = FMath::Abs(FlatLeaves.Num() - SharedLeaves.Num()) + FMath::Abs(int32(FlatQueryLeaves - SharedQueryLeaves));
+	for (int32 Leaf = 0; Leaf < FMath::Min(FlatLeaves.Num(), SharedLeaves.Num()); Leaf++)
+	{
+		if (!FlatLeaves[Leaf].Equals(SharedLeaves[Leaf], 1.0))
+			Mismatches++;
+	}
 
+	UE_LOG(LogShaderWorld, Display, TEXT("SW bounded world tree | %.0fm world, %dm tiles, depth %d, %d viewer steps | %d leaves at the end"),
+		WorldSizeMeters, TileSizeMeters, Depth, Steps, FlatLeaves.Num());
+	UE_LOG(LogShaderWorld, Display, TEXT("SW bounded world tree | LOD selection | shared pointers %8.3fms | flat arena %8.3fms | x%.2f"),
+		SharedVisitSeconds * 1000.0, FlatVisitSeconds * 1000.0, FlatVisitSeconds > 0.0 ? SharedVisitSeconds / FlatVisitSeconds : 0.0);
+	UE_LOG(LogShaderWorld, Display, TEXT("SW bounded world tree | box queries   | shared pointers %8.3fms | flat arena %8.3fms | x%.2f | %d mismatches"),
+		SharedQuerySeconds * 1000.0, FlatQuerySeconds * 1000.0, FlatQuerySeconds > 0.0 ? SharedQuerySeconds / FlatQuerySeconds : 0.0, Mismatches);
 }
 
+static FAutoConsoleCommand BenchmarkBoundedWorldTreeCmd(
+	TEXT("sw.BoundedWorld.BenchmarkTree"),
+	TEXT("Logs LOD selection and box query timings of the flat arena bounded world quadtree against a shared pointer node quadtree, and checks both agree. Optional arguments: world size in meters (default 8000), tile size in meters (default 64), viewer steps (default 256)."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&AShaderWorldActor::BenchmarkBoundedWorldTree)
+);
+
 void AShaderWorldActor::CollisionManagement(float& DeltaT)
 {
 	SW_FCT_CYCLE()
+	SW_STAGE_SCOPE(CollisionManagement)
 
 	/*
 	 * Can we execute compute shader?
@@ -2389,6 +3352,8 @@ void AShaderWorldActor::CollisionManagement(float& DeltaT)
 
 void AShaderWorldActor::SpawnablesManagement(float& DeltaT)
 {
+	SW_STAGE_SCOPE(SpawnablesManagement)
+
 	/*
 	 * Update HISM
 	 */
@@ -2407,6 +3372,373 @@ void AShaderWorldActor::SpawnablesManagement(float& DeltaT)
 }
 
 
+bool AShaderWorldActor::IsHeadlessProcess() const
+{
+	return !FApp::CanEverRender();
+}
+
+void AShaderWorldActor::HeadlessTick(float DeltaT)
+{
+	SW_FCT_CYCLE()
+
+	if (!bHeadlessServerMode || !GetWorld())
+		return;
+
+	if (!HeadlessSetup())
+		return;
+
+	UpdateHeadlessVisitors();
+
+	// Credits let low tile rates spread over several frames, while capping the burst after a hitch
+	const float TileRate = FMath::Max(0.f, CVarSWServerCollisionTilesPerSecond.GetValueOnGameThread());
+	HeadlessCollisionTileCredit = FMath::Min(HeadlessCollisionTileCredit + DeltaT * TileRate, FMath::Max(1.f, TileRate * 0.25f));
+
+	const float CellRate = FMath::Max(0.f, CVarSWServerSpawnableCellsPerSecond.GetValueOnGameThread());
+	HeadlessSpawnableCellCredit = FMath::Min(HeadlessSpawnableCellCredit + DeltaT * CellRate, FMath::Max(1.f, CellRate * 0.25f));
+
+	CollisionManagement(DeltaT);
+
+	HeadlessSpawnablesManagement(DeltaT);
+}
+
+bool AShaderWorldActor::HeadlessSetup()
+{
+	if (!RootComponent || !GetWorld()->bIsWorldInitialized)
+		return false;
+
+	if (EditRebuild)
+	{
+		EditRebuild.AtomicSet(false);
+		rebuild = true;
+	}
+
+	if (Shareable_ID.IsValid() && (GenerateCollision_last != GenerateCollision || VerticalRangeMeters_last != VerticalRangeMeters || (GetActorLocation() - WorldLocationLastBuild).Length() > 0.f))
+		rebuild = true;
+
+	if (rebuild)
+	{
+		RedbuildCollisionContext = true;
+		RebuildCleanup();
+		bHeadlessGenerationUnavailable = false;
+	}
+
+	if (Shareable_ID.IsValid())
+		return true;
+
+	if (bHeadlessGenerationUnavailable)
+		return false;
+
+	if (GetWorld()->OriginLocation.Size() == 0)
+		HeightOnStart = GetActorLocation().Z;
+
+	WorldLocationLastBuild = GetActorLocation();
+	GenerateCollision_last = GenerateCollision;
+	VerticalRangeMeters_last = VerticalRangeMeters;
+	bExportPhysicalMaterialID_cached = bExportPhysicalMaterialID;
+
+	ProcessSeeds();
+
+	if (!CanUseCPUHeightEvaluation())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ShaderWorld %s : headless process without GPU, collisions and spawnables require a Height Generator mirroring every active brush, and no physical material export"), *GetName());
+		bHeadlessGenerationUnavailable = true;
+		return false;
+	}
+
+	Shareable_ID = MakeShared<FSWShareableID, ESPMode::ThreadSafe>();
+	bHadGeneratorAtRebuildTime = true;
+
+	HeadlessCollisionTileCredit = 0.f;
+	HeadlessSpawnableCellCredit = 0.f;
+
+	InitiateHeadlessSpawnables();
+
+	return true;
+}
+
+void AShaderWorldActor::UpdateHeadlessVisitors()
+{
+	// Player pawns and tracked components: there are no rendered views to track on a headless process
+	if (!SWorldSubsystem)
+		SWorldSubsystem = GetWorld()->GetSubsystem<USWorldSubsystem>();
+
+	CameraLocations.Empty();
+
+	if (SWorldSubsystem)
+		SWorldSubsystem->GetVisitors(CameraLocations);
+
+	CameraSet = CameraLocations.Num() > 0;
+
+	if (CameraSet)
+		CamLocation = CameraLocations[0];
+}
+
+void AShaderWorldActor::InitiateHeadlessSpawnables()
+{
+	CleanUpHeadlessSpawnables();
+
+	// CPU placement does not match the client density material: opt-in only
+	if (!bHeadlessSpawnables)
+		return;
+
+	for (int32 BiomIndex = 0; BiomIndex < Bioms.Num(); BiomIndex++)
+	{
+		for (int32 SpawnableIndex = 0; SpawnableIndex < Bioms[BiomIndex].Spawnables.Num(); SpawnableIndex++)
+		{
+			const FSpawnableMesh& Spawnable = Bioms[BiomIndex].Spawnables[SpawnableIndex];
+
+			// Only spawnables which gameplay can collide with matter to a server
+			if (!Spawnable.CollisionEnabled || (Spawnable.SpawnType != ESpawnableType::Mesh && Spawnable.SpawnType != ESpawnableType::Foliage))
+				continue;
+
+			TArray<UStaticMesh*> Variants;
+			for (UStaticMesh* Sm : Spawnable.Mesh)
+			{
+				if (Sm)
+					Variants.Add(Sm);
+			}
+
+			if (Variants.Num() == 0 || Spawnable.GridSizeMeters <= 0)
+				continue;
+
+			FSWHeadlessSpawnable& Headless = HeadlessSpawnables.AddDefaulted_GetRef();
+
+			FSWCPUSpawnableSettings& Settings = Headless.Settings;
+			Settings.GridSize = Spawnable.GridSizeMeters * 100.0;
+			Settings.InstanceCount = FMath::Clamp(FMath::RoundToInt(Spawnable.Density * (Spawnable.GridSizeMeters * Spawnable.GridSizeMeters) / (10.f * 10.f)), 0, GSWMaxCollisionInstancesPerComponent);
+			Settings.NumVariants = Variants.Num();
+			Settings.Seed = HashCombine(GetTypeHash(BiomIndex), GetTypeHash(SpawnableIndex));
+			Settings.GroundAltitude = HeightOnStart;
+			Settings.AltitudeRange = Spawnable.AltitudeRange;
+			Settings.GroundSlopeAngle = Spawnable.GroundSlopeAngle;
+			Settings.ScaleRange = Spawnable.ScaleRange;
+			Settings.VerticalOffsetRange = Spawnable.VerticalOffsetRange;
+			Settings.bAlignToTerrainSlope = Spawnable.AlignToTerrainSlope;
+			Settings.YawOffsetAlignToTerrainSlope = Spawnable.YawOffsetAlignToTerrainSlope;
+			Settings.AlignMaxAngle = Spawnable.AlignMaxAngle;
+
+			for (UStaticMesh* Sm : Variants)
+			{
+				USWHISMComponent* NHISM = NewObject<USWHISMComponent>(this, USWHISMComponent::StaticClass(), NAME_None, RF_Transient);
+
+				NHISM->bHasPerInstanceHitProxies = false;
+				NHISM->SetCanEverAffectNavigation(true);
+				NHISM->bUseTranslatedInstanceSpace = false;
+				NHISM->bAutoRebuildTreeOnInstanceChanges = false;
+				NHISM->bHiddenInGame = true;
+				NHISM->ComponentTags = Spawnable.ComponentTags;
+				NHISM->Mobility = EComponentMobility::Static;
+
+				NHISM->SetupAttachment(GetRootComponent());
+				NHISM->RegisterComponent();
+				NHISM->SetStaticMesh(Sm);
+				NHISM->SetRelativeLocation(FVector(0.f, 0.f, 0.f));
+
+				NHISM->SetUsingAbsoluteLocation(true);
+				NHISM->SetUsingAbsoluteRotation(true);
+
+				NHISM->SetCastShadow(false);
+
+				NHISM->SetCollisionObjectType(Spawnable.CollisionChannel);
+				NHISM->SetCollisionResponseToChannels(Spawnable.CollisionProfile);
+				NHISM->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+
+				Headless.Components.Add(NHISM);
+			}
+		}
+	}
+}
+
+void AShaderWorldActor::CleanUpHeadlessSpawnables()
+{
+	for (FSWHeadlessSpawnable& Headless : HeadlessSpawnables)
+	{
+		for (USWHISMComponent* Comp : Headless.Components)
+		{
+			if (!IsValid(Comp))
+				continue;
+
+			if (Comp->IsRegistered())
+				Comp->UnregisterComponent();
+
+			Comp->DestroyComponent();
+		}
+	}
+
+	// In-flight batches only hold shared pointers: they complete without consequence
+	HeadlessSpawnables.Empty();
+}
+
+void AShaderWorldActor::HeadlessSpawnablesManagement(float DeltaT)
+{
+	SW_FCT_CYCLE()
+
+	if (HeadlessSpawnables.Num() == 0 || !HeightEvaluator.IsValid())
+		return;
+
+	const FIntVector LocalOriginLocation = GetWorld()->OriginLocation;
+
+	const double GameThreadBudget_ms = CVarSWServerGameThreadBudget.GetValueOnGameThread();
+	const double TimeStart = FPlatformTime::Seconds();
+
+	for (FSWHeadlessSpawnable& Headless : HeadlessSpawnables)
+	{
+		const double GridSize = Headless.Settings.GridSize;
+
+		/*
+		 * Cells relevant to at least one visitor, in absolute world coordinates
+		 */
+		TSet<FIntPoint> WantedCells;
+		TArray<FVector2D> AbsoluteVisitors;
+
+		for (const FVector& Visitor : CameraLocations)
+		{
+			const FVector2D Absolute = FVector2D(Visitor) + FVector2D(LocalOriginLocation.X, LocalOriginLocation.Y);
+			AbsoluteVisitors.Add(Absolute);
+
+			const FIntPoint Center(FMath::RoundToInt(Absolute.X / GridSize), FMath::RoundToInt(Absolute.Y / GridSize));
+
+			for (int32 y = -HeadlessSpawnableRings; y <= HeadlessSpawnableRings; y++)
+			{
+				for (int32 x = -HeadlessSpawnableRings; x <= HeadlessSpawnableRings; x++)
+				{
+					WantedCells.Add(Center + FIntPoint(x, y));
+				}
+			}
+		}
+
+		/*
+		 * Release cells no visitor needs anymore
+		 */
+		for (auto It = Headless.CellTransforms.CreateIterator(); It; ++It)
+		{
+			if (WantedCells.Contains(It.Key()))
+				continue;
+
+			It.RemoveCurrent();
+			Headless.bRebuildInstances = true;
+		}
+
+		/*
+		 * Apply computed cells
+		 */
+		if (Headless.Batch.IsValid() && Headless.Batch->bCompleted)
+		{
+			FSWHeadlessSpawnableBatch& Batch = *Headless.Batch.Get();
+
+			for (; Batch.NextCellToApply < Batch.Cells.Num(); Batch.NextCellToApply++)
+			{
+				if ((FPlatformTime::Seconds() - TimeStart) * 1000.0 > GameThreadBudget_ms)
+					break;
+
+				const FIntPoint& Cell = Batch.Cells[Batch.NextCellToApply];
+
+				// Visitors moved away while the cell was computed
+				if (!WantedCells.Contains(Cell) || Headless.CellTransforms.Contains(Cell))
+					continue;
+
+				const TArray<TArray<FTransform>>& Transforms = Headless.CellTransforms.Add(Cell, MoveTemp(Batch.Transforms[Batch.NextCellToApply]));
+
+				// A pending rebuild adds every placed cell at once
+				if (!Headless.bRebuildInstances)
+					AddHeadlessSpawnableInstances(Headless, Transforms);
+			}
+
+			if (Batch.NextCellToApply >= Batch.Cells.Num())
+				Headless.Batch = nullptr;
+		}
+
+		if (Headless.bRebuildInstances)
+			RebuildHeadlessSpawnableInstances(Headless);
+
+		if (Headless.Batch.IsValid())
+			continue;
+
+		/*
+		 * Compute missing cells, closest to a visitor first
+		 */
+		TArray<FIntPoint> MissingCells;
+		for (const FIntPoint& Cell : WantedCells)
+		{
+			if (!Headless.CellTransforms.Contains(Cell))
+				MissingCells.Add(Cell);
+		}
+
+		const int32 CellBudget = FMath::Min(MissingCells.Num(), FMath::FloorToInt(HeadlessSpawnableCellCredit));
+
+		if (CellBudget <= 0)
+			continue;
+
+		MissingCells.Sort([&AbsoluteVisitors, GridSize](const FIntPoint& A, const FIntPoint& B)
+			{
+				auto DistanceToVisitors = [&AbsoluteVisitors, GridSize](const FIntPoint& Cell)
+				{
+					double Closest = TNumericLimits<double>::Max();
+					for (const FVector2D& Visitor : AbsoluteVisitors)
+						Closest = FMath::Min(Closest, FVector2D::DistSquared(FVector2D(Cell) * GridSize, Visitor));
+					return Closest;
+				};
+				return DistanceToVisitors(A) < DistanceToVisitors(B);
+			});
+
+		MissingCells.SetNum(CellBudget);
+		HeadlessSpawnableCellCredit -= CellBudget;
+
+		Headless.Batch = MakeShared<FSWHeadlessSpawnableBatch, ESPMode::ThreadSafe>();
+		Headless.Batch->Cells = MoveTemp(MissingCells);
+		Headless.Batch->Transforms.SetNum(Headless.Batch->Cells.Num());
+
+		Async(EAsyncExecution::TaskGraph, [Evaluator = HeightEvaluator, Batch = Headless.Batch, Settings = Headless.Settings]
+			{
+				ParallelFor(Batch->Cells.Num(), [&](int32 k)
+					{
+						Evaluator->ComputeSpawnableTransforms(Settings, Batch->Cells[k], Batch->Transforms[k]);
+					});
+
+				Batch->bCompleted = true;
+			});
+	}
+}
+
+void AShaderWorldActor::AddHeadlessSpawnableInstances(FSWHeadlessSpawnable& Spawnable, const TArray<TArray<FTransform>>& Transforms)
+{
+	const FIntVector LocalOriginLocation = GetWorld()->OriginLocation;
+	const FVector Rebase = FVector(LocalOriginLocation);
+
+	TArray<FTransform> Local;
+
+	for (int32 Variant = 0; Variant < Spawnable.Components.Num() && Variant < Transforms.Num(); Variant++)
+	{
+		USWHISMComponent* Comp = Spawnable.Components[Variant];
+		if (!IsValid(Comp) || Transforms[Variant].Num() == 0)
+			continue;
+
+		Local.Reset(Transforms[Variant].Num());
+
+		for (const FTransform& T : Transforms[Variant])
+			Local.Add(FTransform(T.GetRotation(), T.GetLocation() - Rebase, T.GetScale3D()));
+
+		Comp->AddInstances(Local, false, true);
+	}
+}
+
+void AShaderWorldActor::RebuildHeadlessSpawnableInstances(FSWHeadlessSpawnable& Spawnable)
+{
+	SW_FCT_CYCLE()
+
+	// Released cells are removed rather than hidden: no collision is left behind and the components shrink with the visitors
+	for (USWHISMComponent* Comp : Spawnable.Components)
+	{
+		if (IsValid(Comp))
+			Comp->ClearInstances();
+	}
+
+	for (const auto& Cell : Spawnable.CellTransforms)
+		AddHeadlessSpawnableInstances(Spawnable, Cell.Value);
+
+	Spawnable.bRebuildInstances = false;
+}
+
 bool AShaderWorldActor::SetupCollisions()
 {
 	SW_FCT_CYCLE()
@@ -2415,13 +3747,11 @@ bool AShaderWorldActor::SetupCollisions()
 		return false;
 
 
-	if(!Shareable_ID.IsValid() || Meshes.Num() <= 0)
-		return false;
+	// Headless processes have no clipmap
+	const bool bHeadless = IsHeadlessProcess();
 
-	if(!bProcessingGroundCollision.IsValid())
-		bProcessingGroundCollision = MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>();
-	if(!bPreprocessingCollisionUpdate.IsValid())
-		bPreprocessingCollisionUpdate = MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>();
+	if(!Shareable_ID.IsValid() || (Meshes.Num() <= 0 && !bHeadless))
+		return false;
 
 	if(EditRebuild)
 	{
@@ -2434,7 +3764,7 @@ bool AShaderWorldActor::SetupCollisions()
 
 	if (RedbuildCollisionContext)
 	{
-		if (!(*bProcessingGroundCollision.Get()) && !(*bPreprocessingCollisionUpdate.Get())
+		if (CollisionDecodeTask.IsCompleted() && CollisionSelectTask.IsCompleted()
 			&& CollisionProcess.IsFenceComplete()
 			&& (CollisionMesh.Num() <= 0)
 			&& (UsedCollisionMesh.Num() <= 0))
@@ -2444,6 +3774,13 @@ bool AShaderWorldActor::SetupCollisions()
 
 			CollisionWorkQueue.Empty();
 			CollisionReadToProcess.Empty();
+			CollisionDecodePrerequisites.Empty();
+
+			CollisionAtlasBatches.Empty();
+			CollisionAtlasFillingBatch = INDEX_NONE;
+
+			// Settings may have changed: recomputed along the new context
+			TileDiskCache = nullptr;
 			
 			RedbuildCollisionContext = false;
 
@@ -2459,11 +3796,14 @@ bool AShaderWorldActor::SetupCollisions()
 	if (!CollisionShareable.IsValid())
 		CollisionShareable = MakeShared<FSWCollisionManagementShareableData, ESPMode::ThreadSafe>(CollisionResolution, CollisionVerticesPerPatch);
 
-	if ((*bProcessingGroundCollision.Get()) || (*bPreprocessingCollisionUpdate.Get()) || !CameraSet || (Meshes.Num()==0))
+	if (bUseTileDiskCache && !TileDiskCache.IsValid())
+		SetupTileDiskCache();
+
+	if (CollisionDecodeTask.IsPending() || CollisionSelectTask.IsPending() || !CameraSet || (Meshes.Num()==0 && !bHeadless))
 		return false;
 
 	//Let the data layer be computed before generating collisions and trying to extract material IDs
-	if(WorldCycle<2)
+	if(WorldCycle<2 && !bHeadless)
 		return false;
 
 
@@ -2500,17 +3840,26 @@ bool AShaderWorldActor::CollisionFinalizeWork()
 	if(!CollisionReadToProcess.IsEmpty())
 		return true;
 
-	const double GameThreadBudget_ms = SWGameThreadBudgetCollision_ms.GetValueOnGameThread();
+	const double GameThreadBudget_ms = IsHeadlessProcess() ? CVarSWServerGameThreadBudget.GetValueOnGameThread() : SWGameThreadBudgetCollision_ms.GetValueOnGameThread();
 
 	double TimeStart = FPlatformTime::Seconds();
 
 	for (int i = CollisionWorkQueue.Num()-1; i>=0; i--)
 	{
 		if ((FPlatformTime::Seconds() - TimeStart) * 1000.0 > GameThreadBudget_ms)
+		{
+			SW_INC_COUNTER(CollisionBudgetOverruns)
 			return false;
+		}
 
 		FCollisionProcessingWork& Work = CollisionWorkQueue[i];
 
+		if (Work.Cancellation.IsValid() && Work.Cancellation->IsCancelled())
+		{
+			CollisionWorkQueue.RemoveAt(i);
+			continue;
+		}
+
 		ensure(Work.MeshID < CollisionMesh.Num());
 
 		FCollisionMeshElement& Mesh = CollisionMesh[Work.MeshID];
@@ -2529,6 +3878,8 @@ bool AShaderWorldActor::CollisionPreprocessGPU()
 {
 	SW_FCT_CYCLE()
 
+	const bool bDoublePrecisionPositions = CVarSWCollisionDoublePrecisionPositions.GetValueOnGameThread() > 0;
+
 	for (int32 CollID = CollisionReadToProcess.Num() - 1; CollID >= 0; CollID--)
 	{
 		const int32& ElID = CollisionReadToProcess[CollID];
@@ -2537,14 +3888,31 @@ bool AShaderWorldActor::CollisionPreprocessGPU()
 		if (ElID >= CollisionMesh.Num())
 		{
 			CollisionWorkQueue.Empty();
+			CollisionDecodePrerequisites.Empty();
 			return false;
 		}
 
 		FCollisionMeshElement& Mesh = CollisionMesh[ElID];
 
-		if ((*Mesh.ReadBackCompletion.Get()))
+		// CPU evaluated heights are awaited by the decode job itself. Disk cache loads are checked here, a failed load is generated again
+		const bool bAwaitedByDecode = !Mesh.bFromDiskCache && Mesh.ReadBackTask.IsValid();
+
+		if (bAwaitedByDecode || (*Mesh.ReadBackCompletion.Get()))
 		{
 			ensure(Mesh.Mesh);
+
+			if (Mesh.ReadBackTask.IsPending())
+				CollisionDecodePrerequisites.Add(Mesh.ReadBackTask);
+
+			if (Mesh.bFromDiskCache && Mesh.HeightData32->Heights.Num() != CollisionVerticesPerPatch * CollisionVerticesPerPatch)
+			{
+				// The cache entry could not be read: generate the tile
+				CollisionReadToProcess.RemoveAt(CollID);
+				UpdateCollisionMeshData(Mesh, false);
+				FlushCollisionAtlas();
+				CollisionProcess.BeginFence();
+				continue;
+			}
 		
 			FGeoCProcMeshSection* Section = Mesh.Mesh->GetProcMeshSection(0);
 
@@ -2555,12 +3923,15 @@ bool AShaderWorldActor::CollisionPreprocessGPU()
 			TSharedPtr<FSWShareableVerticePositionBuffer, ESPMode::ThreadSafe>& SourceVertices = CollisionMesh[0].Mesh->VerticesTemplate;
 
 			TSharedPtr<FSWShareableVerticePositionBuffer, ESPMode::ThreadSafe> Vertices = MakeShared<FSWShareableVerticePositionBuffer, ESPMode::ThreadSafe>();
-			Vertices->Positions.SetNum(NumOfVertex);
+			if (bDoublePrecisionPositions)
+				Vertices->Positions.SetNum(NumOfVertex);
 			Vertices->Positions3f.SetNum(NumOfVertex);
 			Vertices->MaterialIndices.SetNum(NumOfVertex);
 			Vertices->Bound = FBox(EForceInit::ForceInit);
 
-			FCollisionProcessingWork CollisionElementWork(ElID, SourceRead, SourceVertices, Vertices);
+			FCollisionProcessingWork CollisionElementWork(ElID, SourceRead, SourceVertices, Vertices, Mesh.bFloatHeightData ? Mesh.HeightData32 : nullptr);
+			CollisionElementWork.DiskCacheKey = Mesh.bFromDiskCache ? 0 : Mesh.DiskCacheKey;
+			CollisionElementWork.Cancellation = Mesh.Cancellation;
 
 			CollisionWorkQueue.Add(CollisionElementWork);
 
@@ -2578,12 +3949,17 @@ bool AShaderWorldActor::CollisionPreprocessGPU()
 
 	if (CollisionWorkQueue.Num() > 0)
 	{
-		(*bProcessingGroundCollision.Get()) = true;
+		FSWTaskDesc DecodeDesc;
+		DecodeDesc.DebugName = TEXT("SWCollisionDecode");
+		DecodeDesc.Stage = ESWTaskStage::Decode;
+		DecodeDesc.Priority = ESWTaskPriority::High;
+		DecodeDesc.Prerequisites.Append(CollisionDecodePrerequisites);
 
-		AShaderWorldActor* SWContext = this;
+		CollisionDecodePrerequisites.Empty();
 
-		Async(EAsyncExecution::TaskGraph, [Completion = bProcessingGroundCollision,RenderAPI= RendererAPI,VerticesPerPatch = CollisionVerticesPerPatch,Work = CollisionWorkQueue]
+		CollisionDecodeTask = FSWTaskGraph::Get().Launch(DecodeDesc, [RenderAPI= RendererAPI,VerticesPerPatch = CollisionVerticesPerPatch,Work = CollisionWorkQueue, DiskCache = TileDiskCache]
 			{
+				SW_STAGE_SCOPE(CollisionTileDecode)
 
 				const int NumOfPatch = Work.Num();
 
@@ -2593,44 +3969,88 @@ bool AShaderWorldActor::CollisionPreprocessGPU()
 						{
 							const FCollisionProcessingWork& WorkEl = Work[j];
 
+							if (WorkEl.Cancellation.IsValid() && WorkEl.Cancellation->IsCancelled())
+								return;
+
 
-							if (!WorkEl.Read.IsValid() || !WorkEl.SourceB.IsValid() || !WorkEl.DestB.IsValid())
+							if (!(WorkEl.Read.IsValid() || WorkEl.Read32.IsValid()) || !WorkEl.SourceB.IsValid() || !WorkEl.DestB.IsValid())
 								return;
 
-							const int NumOfVertex = WorkEl.SourceB->Positions.Num();
+							const int NumOfVertex = WorkEl.SourceB->Positions3f.Num();
 
-							FVector LocationfVertice_WS(0);
-							uint16 MaterialIndice = 0;
+							if (NumOfVertex != VerticesPerPatch * VerticesPerPatch)
+								return;
 
-							uint8* ReadData8 = (uint8*)WorkEl.Read->ReadData.GetData();
+							const bool bStoreDouble = WorkEl.DestB->Positions.Num() == NumOfVertex;
 
-							for (int32 k = 0; k < NumOfVertex; k++)
-							{								
+							TArray<float, TInlineAllocator<512>> RowHeights;
+							RowHeights.SetNumUninitialized(VerticesPerPatch);
 
-								if (RenderAPI == EGeoRenderingAPI::OpenGL)
+							float MinZ = MAX_flt;
+							float MaxZ = -MAX_flt;
+
+							for (int32 Y = 0; Y < VerticesPerPatch; Y++)
+							{
+								const int32 RowStart = Y * VerticesPerPatch;
+								uint16* RowMaterials = &WorkEl.DestB->MaterialIndices[RowStart];
+
+								if (WorkEl.Read32.IsValid())
+								{
+									FMemory::Memcpy(RowHeights.GetData(), &WorkEl.Read32->Heights[RowStart], VerticesPerPatch * sizeof(float));
+
+									for (int32 X = 0; X < VerticesPerPatch; X++)
+										RowMaterials[X] = WorkEl.Read32->MaterialIndices[RowStart + X];
+								}
+								else
 								{
-									const int index = k % VerticesPerPatch + (VerticesPerPatch - 1 - (k / VerticesPerPatch)) * VerticesPerPatch;
+									const int32 SourceRow = RenderAPI == EGeoRenderingAPI::OpenGL ? VerticesPerPatch - 1 - Y : Y;
+									const uint8* ReadData8 = (const uint8*)&WorkEl.Read->ReadData[SourceRow * VerticesPerPatch];
 
-									LocationfVertice_WS = FVector(WorkEl.SourceB->Positions[k].X, WorkEl.SourceB->Positions[k].Y,  GetHeightFromGPURead(&ReadData8[4*index], MaterialIndice));
+									DecodeGPUReadTexels(ReadData8, VerticesPerPatch, RowHeights.GetData(), RowMaterials);
 								}
-								else									
-									LocationfVertice_WS = FVector(WorkEl.SourceB->Positions[k].X, WorkEl.SourceB->Positions[k].Y, GetHeightFromGPURead(&ReadData8[4*k], MaterialIndice));
 
-								WorkEl.DestB->Positions[k] = LocationfVertice_WS;
-								WorkEl.DestB->Positions3f[k] = FVector3f(LocationfVertice_WS);
-								WorkEl.DestB->MaterialIndices[k] = MaterialIndice;
+								for (int32 X = 0; X < VerticesPerPatch; X++)
+								{
+									const int32 k = RowStart + X;
+									const FVector3f& Source = WorkEl.SourceB->Positions3f[k];
+									const float Height = RowHeights[X];
+
+									WorkEl.DestB->Positions3f[k] = FVector3f(Source.X, Source.Y, Height);
+
+									if (bStoreDouble)
+										WorkEl.DestB->Positions[k] = FVector(Source.X, Source.Y, Height);
+
+									MinZ = FMath::Min(MinZ, Height);
+									MaxZ = FMath::Max(MaxZ, Height);
+								}
+							}
+
+							// The grid footprint does not change, only the vertical range needs to be gathered
+							const FBox& SourceBound = WorkEl.SourceB->Bound;
+							WorkEl.DestB->Bound = FBox(FVector(SourceBound.Min.X, SourceBound.Min.Y, MinZ), FVector(SourceBound.Max.X, SourceBound.Max.Y, MaxZ));
+
+							if (DiskCache.IsValid() && WorkEl.DiskCacheKey != 0)
+							{
+								// Same layout as LoadCollisionTileFromDiskCache reads: heights then material indices
+								TArray<uint8> Payload;
+								Payload.SetNumUninitialized(NumOfVertex * (sizeof(float) + sizeof(uint8)));
+
+								float* PayloadHeights = reinterpret_cast<float*>(Payload.GetData());
+								uint8* PayloadMaterials = Payload.GetData() + NumOfVertex * sizeof(float);
+
+								for (int32 k = 0; k < NumOfVertex; k++)
+								{
+									PayloadHeights[k] = WorkEl.DestB->Positions3f[k].Z;
+									PayloadMaterials[k] = static_cast<uint8>(WorkEl.DestB->MaterialIndices[k]);
+								}
 
+								DiskCache->Store(WorkEl.DiskCacheKey, Payload);
 							}
-							WorkEl.DestB->Bound = FBox(WorkEl.DestB->Positions);
 
 
 						}
 					}
 					);
-				
-				if(Completion.IsValid())
-					Completion->AtomicSet(false);				
-				
 			});
 	}
 
@@ -2641,7 +4061,7 @@ void AShaderWorldActor::CollisionCPU()
 {
 	SW_FCT_CYCLE()
 
-	if ((*bPreprocessingCollisionUpdate.Get()) ||
+	if (CollisionSelectTask.IsPending() ||
 		CollisionShareable->CollisionMeshToUpdate.Num() > 0 ||
 		CollisionShareable->CollisionMeshToRenameMoveUpdate.Num() > 0 ||
 		CollisionShareable->CollisionMeshToCreate > 0)
@@ -2660,6 +4080,12 @@ void AShaderWorldActor::CollisionCPU()
 	{
 		BrushRedrawScope = MoveTemp(BrushManagerRedrawScopes_collision);
 		BrushManagerRedrawScopes_collision.Empty();
+
+		// Brushes moved or changed: refresh the CPU brush stack before recomputing the tiles
+		UpdateHeightEvaluator();
+
+		if (TileDiskCache.IsValid())
+			UpdateBrushFootprintHashes();
 	}
 		
 
@@ -2668,7 +4094,10 @@ void AShaderWorldActor::CollisionCPU()
 	FBox2D BPCollisionRebuildRequest(ForceInit);
 
 	if(bExternalCollisionRebuildRequest)
-		 CollisionUpdateRequest.Dequeue(BPCollisionRebuildRequest);
+	{
+		CollisionUpdateRequest.Dequeue(BPCollisionRebuildRequest);
+		bBypassTileDiskCacheForUpdates = true;
+	}
 
 	TArray<FVector> VisitorLocations;
 
@@ -2687,16 +4116,15 @@ void AShaderWorldActor::CollisionCPU()
 		VisitorLocations.Add(It->GetComponentLocation());
 	}
 
-	(*bPreprocessingCollisionUpdate.Get()) = true;
+	FSWTaskDesc SelectDesc;
+	SelectDesc.DebugName = TEXT("SWCollisionSelect");
+	SelectDesc.Stage = ESWTaskStage::Select;
+	SelectDesc.Priority = ESWTaskPriority::Critical;
 
-	Async(EAsyncExecution::TaskGraph, [Completion = bPreprocessingCollisionUpdate, CollData = CollisionShareable, VisitorLocations, bBrushManagerAskedRedraw, BrushScope = MoveTemp(BrushRedrawScope), bExternalCollisionRebuildRequest, BPRecomputeScope = BPCollisionRebuildRequest, ColRingCount = CollisionGridRingNumber, LocalActorLocation, LocalOriginLocation, Height0 = HeightOnStart, Cameras = CameraLocations, External_Actors = External_Actors_Tracked]
+	CollisionSelectTask = FSWTaskGraph::Get().Launch(SelectDesc, [CollData = CollisionShareable, VisitorLocations, bBrushManagerAskedRedraw, BrushScope = MoveTemp(BrushRedrawScope), bExternalCollisionRebuildRequest, BPRecomputeScope = BPCollisionRebuildRequest, ColRingCount = CollisionGridRingNumber, LocalActorLocation, LocalOriginLocation, Height0 = HeightOnStart, Cameras = CameraLocations, External_Actors = External_Actors_Tracked]
 		{
 			if (!CollData.IsValid())
-			{
-				if(Completion.IsValid())
-					(*Completion.Get()) = false;
 				return;
-			}
 
 			TMap<FIntVector,FVector> BrushRedraws;
 
@@ -2758,22 +4186,12 @@ void AShaderWorldActor::CollisionCPU()
 				if (BeyondCriteria_local)
 				{
 
-					CollData->AvailableCollisionMesh.Add(El.ID);
-					CollData->UsedCollisionMesh.RemoveAt(i);
+					// El.Location is the grid cell the mesh was registered under: no need to scan the layout.
+					// Swap-remove only moves already visited entries into slot i.
+					if (const int32* LayoutID = CollData->GroundCollisionLayout.Find(El.Location); LayoutID && *LayoutID == El.ID)
+						CollData->GroundCollisionLayout.Remove(El.Location);
 
-					for (auto It = CollData->GroundCollisionLayout.CreateConstIterator(); It; ++It)
-					{
-
-						if (It->Value < CollData->CollisionMeshData.Num())
-						{
-							if (CollData->CollisionMeshData[It->Value] == El)
-							{
-								CollData->GroundCollisionLayout.Remove(It->Key);
-								break;
-							}
-						}
-
-					}
+					CollData->ReleaseCollisionMesh(El.ID);
 
 				}
 				else
@@ -2842,12 +4260,10 @@ void AShaderWorldActor::CollisionCPU()
 
 							if (ContainCriteria)
 							{
-								if (CollData->AvailableCollisionMesh.Num() > 0)
+								const int32 AvailableID = CollData->AcquireCollisionMesh();
+								if (AvailableID != INDEX_NONE)
 								{
-									FSWCollisionMeshElemData& ElemData = CollData->CollisionMeshData[CollData->AvailableCollisionMesh[CollData->AvailableCollisionMesh.Num() - 1]];
-
-									CollData->UsedCollisionMesh.Add(ElemData.ID);
-									CollData->AvailableCollisionMesh.RemoveAt(CollData->AvailableCollisionMesh.Num() - 1);
+									FSWCollisionMeshElemData& ElemData = CollData->CollisionMeshData[AvailableID];
 
 									ElemData.Location = LocMeshInt;
 									ElemData.MeshLocation = FVector(MeshLoc);
@@ -2865,7 +4281,7 @@ void AShaderWorldActor::CollisionCPU()
 									NewElem.Location = LocMeshInt;
 									NewElem.MeshLocation = FVector(MeshLoc);
 
-									CollData->UsedCollisionMesh.Add(NewElem.ID);
+									CollData->AddUsedCollisionMesh(NewElem.ID);
 									CollData->CollisionMeshData.Add(NewElem);
 
 									CollData->CollisionMeshToRenameMoveUpdate.Add(NewElem.ID);
@@ -2878,10 +4294,6 @@ void AShaderWorldActor::CollisionCPU()
 				}
 			}
 
-			
-
-			if (Completion.IsValid())
-				(*Completion.Get()) = false;
 		});
 }
 
@@ -2889,7 +4301,7 @@ void AShaderWorldActor::CollisionGPU()
 {
 	SW_FCT_CYCLE()
 
-	if (!(!(*bPreprocessingCollisionUpdate.Get()) && (
+	if (!(CollisionSelectTask.IsCompleted() && (
 		CollisionShareable->CollisionMeshToUpdate.Num() > 0 ||
 		CollisionShareable->CollisionMeshToRenameMoveUpdate.Num() > 0 ||
 		CollisionShareable->CollisionMeshToCreate > 0)))
@@ -2898,8 +4310,23 @@ void AShaderWorldActor::CollisionGPU()
 
 	UWorld* World = GetWorld();
 
-	bool RequireRenderFence = false;
-	int32 CollisionDrawCallCount = 0;
+	bool RequireRenderFence = false;
+	int32 CollisionDrawCallCount = 0;
+	const bool bCPUHeightEvaluation = CanUseCPUHeightEvaluation();
+	const bool bAtlasBatching = !bCPUHeightEvaluation && UseCollisionAtlasBatching();
+
+	// Headless processes count evaluated tiles against their tiles per second budget instead of draw calls
+	const bool bHeadless = IsHeadlessProcess();
+	const int32 MaxCollisionWorkPerFrame = bHeadless ? FMath::FloorToInt(HeadlessCollisionTileCredit) : CollisionMaxDrawCallPerFrame;
+
+	if (MaxCollisionWorkPerFrame <= 0)
+		return;
+
+	// The partially filled atlas flushed at the end of the frame costs a draw call as well
+	auto CollisionDrawCallsIssued = [&]()
+	{
+		return CollisionDrawCallCount + ((bAtlasBatching && CollisionAtlasFillingBatch != INDEX_NONE) ? 1 : 0);
+	};
 
 
 	UsedCollisionMesh = CollisionShareable->UsedCollisionMesh;
@@ -2919,17 +4346,23 @@ void AShaderWorldActor::CollisionGPU()
 	for(int i = CollisionShareable->CollisionMeshToUpdate.Num()-1;i>=0;i--)
 	{
 		FCollisionMeshElement& El = CollisionMesh[CollisionShareable->CollisionMeshToUpdate[i]];
-		UpdateCollisionMeshData(El);
+		UpdateCollisionMeshData(El, !bBypassTileDiskCacheForUpdates);
 
 		CollisionShareable->CollisionMeshToUpdate.RemoveAt(i);
 
 		RequireRenderFence = true;
-		CollisionDrawCallCount++;
 
-		if(CollisionDrawCallCount >= CollisionMaxDrawCallPerFrame)
+		// CPU evaluated tiles do not consume draw calls, batched tiles only do once their atlas is full and drawn
+		if (bHeadless || (bAtlasBatching ? CollisionAtlasFillingBatch == INDEX_NONE : !bCPUHeightEvaluation))
+			CollisionDrawCallCount++;
+
+		if(CollisionDrawCallsIssued() >= MaxCollisionWorkPerFrame)
 			break;
 	}
 
+	if (CollisionShareable->CollisionMeshToUpdate.Num() == 0)
+		bBypassTileDiskCacheForUpdates = false;
+
 	for (int i = CollisionShareable->CollisionMeshToRenameMoveUpdate.Num()-1;i>=0;i--)
 	{
 		
@@ -2949,59 +4382,37 @@ void AShaderWorldActor::CollisionGPU()
 		CollisionShareable->CollisionMeshToRenameMoveUpdate.RemoveAt(i);
 
 		RequireRenderFence = true;
-		CollisionDrawCallCount++;
 
-		if (CollisionDrawCallCount >= CollisionMaxDrawCallPerFrame)
+		if (bHeadless || (bAtlasBatching ? CollisionAtlasFillingBatch == INDEX_NONE : !bCPUHeightEvaluation))
+			CollisionDrawCallCount++;
+
+		if (CollisionDrawCallsIssued() >= MaxCollisionWorkPerFrame)
 			break;
 	}
 
+	if (bHeadless)
+		HeadlessCollisionTileCredit -= CollisionDrawCallCount;
+
+	// Partially filled atlas are drawn right away rather than waiting for more tiles
+	FlushCollisionAtlas();
+
 	if(RequireRenderFence)
 		CollisionProcess.BeginFence();
 }
 
 void AShaderWorldActor::CreateGridMeshWelded(int32 NumX, int32 NumY, TSharedPtr<FSWShareableIndexBuffer>& Triangles, TSharedPtr<FSWShareableVerticePositionBuffer>& Vertices, TArray<FVector2f>& UVs, int32 GridSpac)
 {
-	Triangles->Indices.Empty();
-	Vertices->Positions.Empty();
-	Vertices->Positions3f.Empty();
-	Vertices->MaterialIndices.Empty();
-	Vertices->Bound=FBox(EForceInit::ForceInit);
-	UVs.Empty();
-
-	if (NumX >= 2 && NumY >= 2)
-	{
-		FVector2D Extent = FVector2D((NumX - 1) * GridSpac, (NumY - 1) * GridSpac) / 2;
-
-		for (int i = 0; i < NumY; i++)
-		{
-			for (int j = 0; j < NumX; j++)
-			{
-				FVector Pos = FVector((float)j * GridSpac - Extent.X, (float)i * GridSpac - Extent.Y, 0);
-				Vertices->Positions.Add(Pos);
-				Vertices->Positions3f.Add(FVector3f(Pos));
-				Vertices->Bound+= Pos;
+	const TSharedRef<const FSWGridTopology, ESPMode::ThreadSafe> Grid = FSWGridTopologyCache::Get().FindOrCreateGrid(NumX, NumY, GridSpac);
 
-				Vertices->MaterialIndices.Add(0);
-				
-				UVs.Add(FVector2f((float)j / ((float)NumX - 1), (float)i / ((float)NumY - 1)));
-			}
-		}
+	// Indices are never modified: shared. Positions receive the heights of each mesh: copied
+	Triangles = Grid->Triangles;
 
-		for (int i = 0; i < NumY - 1; i++)
-		{
-			for (int j = 0; j < NumX - 1; j++)
-			{
-				int idx = j + (i * NumX);
-				Triangles->Indices.Add(idx);
-				Triangles->Indices.Add(idx + NumX);
-				Triangles->Indices.Add(idx + 1);
+	Vertices->Positions = Grid->Vertices->Positions;
+	Vertices->Positions3f = Grid->Vertices->Positions3f;
+	Vertices->MaterialIndices = Grid->Vertices->MaterialIndices;
+	Vertices->Bound = Grid->Vertices->Bound;
 
-				Triangles->Indices.Add(idx + 1);
-				Triangles->Indices.Add(idx + NumX);
-				Triangles->Indices.Add(idx + NumX + 1);
-			}
-		}
-	}
+	UVs = Grid->UVs;
 }
 
 void AddIndexToTrianglesList(int Index, TSharedPtr<FSWShareableIndexBuffer>& Triangles, TSharedPtr<FSWShareableIndexBuffer>& TrianglesAlt)
@@ -3079,7 +4490,7 @@ void AddQuadToTrianglesList(int idx, int NumX, TSharedPtr<FSWShareableIndexBuffe
 
 }
 
-void AShaderWorldActor::CreateGridMeshWelded(int Indexoffset, int32 NumX, int32 NumY, TSharedPtr<FSWShareableIndexBuffer>& Triangles, TSharedPtr<FSWShareableIndexBuffer>& TrianglesAlt, TArray<FVector3f>& Vertices, TArray<FVector2f>& UVs,TArray<FVector2f>& UV1s,TArray<FVector2f>& UV2s, int32& GridSpacing_,FVector& Offset, uint8 StitchProfil)
+void AShaderWorldActor::CreateGridMeshWelded(int Indexoffset, int32 NumX, int32 NumY, TSharedPtr<FSWShareableIndexBuffer>& Triangles, TSharedPtr<FSWShareableIndexBuffer>& TrianglesAlt, TArray<FVector3f>& Vertices, TArray<FVector2f>& UVs,TArray<FVector2f>& UV1s,TArray<FVector2f>& UV2s, int32& GridSpacing_,FVector& Offset, uint8 StitchProfil, bool bBuildIndices)
 {
 
 
@@ -3098,18 +4509,32 @@ void AShaderWorldActor::CreateGridMeshWelded(int Indexoffset, int32 NumX, int32
 	{
 		FVector2f Extent = FVector2f(Offset.X,Offset.Y);
 
-		for (int i = 0; i < NumY; i++)
+		// Presized, rows are filled in parallel
+		Vertices.AddUninitialized(NumX * NumY);
+		UVs.AddUninitialized(NumX * NumY);
+		UV1s.AddUninitialized(NumX * NumY);
+		UV2s.AddUninitialized(NumX * NumY);
+
+		const float VerticalRange = VerticalRangeMeters * 100.f;
+
+		ParallelFor(NumY, [&](int32 i)
 		{
 			for (int j = 0; j < NumX; j++)
 			{
+				const int32 VertexID = IDOffset + j + (i * NumX);
+
 				FVector3f PosVertex = FVector3f((float)j * GridSpacing_ + Extent.X, (float)i * GridSpacing_ + Extent.Y, 0);
 
-				Vertices.Add(PosVertex + FVector3f(0.f,0.f,1.f)*VerticalRangeMeters*100.f * ((i+j)%2==0?1.f:-1.f));
-				UVs.Add(FVector2f(PosVertex.X/GridSpacing_, PosVertex.Y/GridSpacing_));
-				UV1s.Add(FVector2f(FMath::Frac(PosVertex.X/400000.f), FMath::Frac(PosVertex.Y/400000.f)));
-				UV2s.Add(FVector2f((i>0 && i<NumY-1)&&(j>0 && j<NumX-1)?1.f:0.f,0.f));	
+				Vertices[VertexID] = PosVertex + FVector3f(0.f,0.f,1.f)*VerticalRange * ((i+j)%2==0?1.f:-1.f);
+				UVs[VertexID] = FVector2f(PosVertex.X/GridSpacing_, PosVertex.Y/GridSpacing_);
+				UV1s[VertexID] = FVector2f(FMath::Frac(PosVertex.X/400000.f), FMath::Frac(PosVertex.Y/400000.f));
+				UV2s[VertexID] = FVector2f((i>0 && i<NumY-1)&&(j>0 && j<NumX-1)?1.f:0.f,0.f);
 			}
-		}
+		});
+
+		// Index buffers are shared through FSWGridTopologyCache, they do not depend on the grid spacing
+		if (!bBuildIndices)
+			return;
 
 	
 		for (int i = 0; i < NumY - 1; i++)
@@ -3576,6 +5001,9 @@ void AShaderWorldActor::ComputeHeight_Segmented_MapForClipMap(int index)
 	if (BrushManager)
 		BrushManager->ApplyBrushStackToHeightMap(this, Elem.Level, Elem.HeightMap_Segmented, FVector(RemoveAnySphereAdjust), Elem.GridSpacing, N, false);
 
+	Elem.bPendingBrushRefresh = false;
+	Elem.StaleSince = 0.0;
+
 	/*
 	 * Let's apply our local cache on top
 	 */
@@ -3654,6 +5082,185 @@ void AShaderWorldActor::ComputeHeightMapForClipMap(int index)
 	//if (Subsystem)
 	//	Subsystem->CopyAtoB(Elem.HeightMap_Segmented, Elem.HeightMap, nullptr, index > 0 ? (Meshes[index - 1].DrawingThisFrame ? 0 : 2) : 0);
 
+	Elem.CacheLocation = Elem.Location;
+	Elem.bCacheLocationValid = true;
+	Elem.bPendingBrushRefresh = false;
+	Elem.StaleSince = 0.0;
+}
+
+/*
+ * Texels of a Size x Size cache left without content once scrolled by Offset, widened by Pad texels toward the inside.
+ * At most two rects: a full height column strip then a row strip excluding the column.
+ */
+static void GetScrollExposedRects(int32 Size, const FIntPoint& Offset, int32 Pad, TArray<FIntRect, TInlineAllocator<2>>& OutRects)
+{
+	FIntRect Remaining(0, 0, Size, Size);
+
+	if (Offset.X != 0)
+	{
+		const int32 Width = FMath::Min(FMath::Abs(Offset.X) + Pad, Size);
+
+		if (Offset.X > 0)
+		{
+			OutRects.Add(FIntRect(Size - Width, 0, Size, Size));
+			Remaining.Max.X = Size - Width;
+		}
+		else
+		{
+			OutRects.Add(FIntRect(0, 0, Width, Size));
+			Remaining.Min.X = Width;
+		}
+	}
+
+	if (Offset.Y != 0 && Remaining.Width() > 0)
+	{
+		const int32 Height = FMath::Min(FMath::Abs(Offset.Y) + Pad, Size);
+
+		if (Offset.Y > 0)
+			OutRects.Add(FIntRect(Remaining.Min.X, Size - Height, Remaining.Max.X, Size));
+		else
+			OutRects.Add(FIntRect(Remaining.Min.X, 0, Remaining.Max.X, Height));
+	}
+}
+
+/*
+ * DrawMaterialToRenderTarget restricted to Rects, the material UVs match a whole target draw.
+ */
+static void DrawMaterialToRects(UObject* WorldContextObject, UMaterialInterface* Material, UTextureRenderTarget2D* RenderTarget, TConstArrayView<FIntRect> Rects)
+{
+	UCanvas* Canvas = nullptr;
+	FVector2D CanvasSize;
+	FDrawToRenderTargetContext Context;
+	UKismetRenderingLibrary::BeginDrawCanvasToRenderTarget(WorldContextObject, RenderTarget, Canvas, CanvasSize, Context);
+
+	if (Canvas)
+	{
+		const FVector2D Size(RenderTarget->SizeX, RenderTarget->SizeY);
+
+		for (const FIntRect& Rect : Rects)
+		{
+			const FVector2D RectMin(Rect.Min);
+			const FVector2D RectSize(Rect.Size());
+			Canvas->K2_DrawMaterial(Material, RectMin, RectSize, RectMin / Size, RectSize / Size);
+		}
+	}
+
+	UKismetRenderingLibrary::EndDrawCanvasToRenderTarget(WorldContextObject, Context);
+}
+
+UTextureRenderTarget2D* AShaderWorldActor::GetScrollScratchRT(int32 Dimension)
+{
+	if (UTextureRenderTarget2D** Found = ScrollScratchRT.Find(Dimension))
+		return *Found;
+
+	UTextureRenderTarget2D* NewRT = nullptr;
+	SW_RT(NewRT, GetWorld(), Dimension, TF_Nearest, RTF_RGBA8)
+
+	ScrollScratchRT.Add(Dimension, NewRT);
+	return NewRT;
+}
+
+bool AShaderWorldActor::ScrollClipMapCaches(int index)
+{
+	if (index >= Meshes.Num() || !SWorldSubsystem || CVarSWClipmapScrollCache.GetValueOnGameThread() <= 0)
+		return false;
+
+	FClipMapMeshElement& Elem = Meshes[index];
+
+	/*
+	 * The generator output has to only depend on the texel world location:
+	 * not the case when reading another Shader World or when projecting on a sphere
+	 */
+	if (!Elem.bCacheLocationValid || DataSource || WorldShape != EWorldShape::Flat || !Elem.HeightMap || !Elem.NormalMap || !Elem.CacheMatDyn)
+		return false;
+
+	const FIntVector Delta = Elem.Location - Elem.CacheLocation;
+	const int32 CacheRes = Elem.NormalMap->SizeX;
+	const int64 PatchFullSize = (int64)(N - 1) * Elem.GridSpacing;
+
+	// Texels are PatchFullSize / (CacheRes - 1) apart: only scroll by whole texels
+	const int64 ScaledX = (int64)Delta.X * (CacheRes - 1);
+	const int64 ScaledY = (int64)Delta.Y * (CacheRes - 1);
+
+	if (PatchFullSize <= 0 || Elem.HeightMap->SizeX != CacheRes + 2 || ScaledX % PatchFullSize != 0 || ScaledY % PatchFullSize != 0)
+		return false;
+
+	const FIntPoint Offset(ScaledX / PatchFullSize, ScaledY / PatchFullSize);
+
+	// Large jumps: the strips would cover most of the ring
+	if (FMath::Abs(Offset.X) > CacheRes / 4 || FMath::Abs(Offset.Y) > CacheRes / 4)
+		return false;
+
+	SW_FCT_CYCLE()
+
+	Elem.DrawingThisFrame = true;
+
+	if (Offset == FIntPoint::ZeroValue)
+		return true;
+
+	const FIntVector RemoveAnySphereAdjust = FIntVector(Elem.Location.X, Elem.Location.Y, HeightOnStart);
+
+	/*
+	 * Heightmap: scroll, draw the generator over the exposed strips then apply the brushes touching them
+	 */
+	UTextureRenderTarget2D* HeightScratch = GetScrollScratchRT(Elem.HeightMap->SizeX);
+
+	if (!HeightScratch || !SWorldSubsystem->ScrollAtoB(Elem.HeightMap, HeightScratch, Offset))
+		return false;
+
+	SWorldSubsystem->CopyAtoB(HeightScratch, Elem.HeightMap);
+
+	TArray<FIntRect, TInlineAllocator<2>> HeightRects;
+	GetScrollExposedRects(Elem.HeightMap->SizeX, Offset, 1, HeightRects);
+
+	Elem.CacheMatDyn->SetVectorParameterValue("PatchLocation", FVector(RemoveAnySphereAdjust));
+	DrawMaterialToRects(this, Elem.CacheMatDyn, Elem.HeightMap, HeightRects);
+
+	if (BrushManager)
+		BrushManager->ApplyBrushStackToHeightMap(this, Elem.Level, Elem.HeightMap, FVector(RemoveAnySphereAdjust), Elem.GridSpacing, N, false, false, nullptr, HeightRects);
+
+	/*
+	 * Normalmap: normals read their direct neighbors, recompute a slightly wider strip
+	 */
+	UTextureRenderTarget2D* Scratch = GetScrollScratchRT(CacheRes);
+
+	if (Scratch && SWorldSubsystem->ScrollAtoB(Elem.NormalMap, Scratch, Offset))
+		SWorldSubsystem->CopyAtoB(Scratch, Elem.NormalMap);
+
+	TArray<FIntRect, TInlineAllocator<2>> NormalRects;
+	GetScrollExposedRects(CacheRes, Offset, 2, NormalRects);
+
+	for (const FIntRect& Rect : NormalRects)
+		SWorldSubsystem->ComputeNormalForHeightmap(Elem.HeightMap, Elem.NormalMap, N, Elem.GridSpacing, HeightScale, Rect);
+
+	/*
+	 * Data layers: layers reading their parent ring are regenerated
+	 */
+	TArray<FIntRect, TInlineAllocator<2>> LayerRects;
+	GetScrollExposedRects(CacheRes, Offset, 1, LayerRects);
+
+	for (int k = 0; k < Elem.LandLayers.Num(); k++)
+	{
+		if (Elem.LandLayers_NeedParent[k] || !Elem.LandLayers[k] || Elem.LandLayers[k]->SizeX != CacheRes)
+		{
+			ComputeDataLayerForClipMap(index, k);
+			continue;
+		}
+
+		if (Scratch && SWorldSubsystem->ScrollAtoB(Elem.LandLayers[k], Scratch, Offset))
+		{
+			SWorldSubsystem->CopyAtoB(Scratch, Elem.LandLayers[k]);
+			ComputeDataLayerForClipMap(index, k, LayerRects);
+		}
+		else
+		{
+			ComputeDataLayerForClipMap(index, k);
+		}
+	}
+
+	Elem.CacheLocation = Elem.Location;
+
+	return true;
 }
 
 void AShaderWorldActor::TopologyUpdate(int index)
@@ -3804,26 +5411,40 @@ void AShaderWorldActor::ComputeDataLayersForClipMap(int index)
 
 	for (int k = 0; k < Elem.LandLayers.Num(); k++)
 	{
-		if (!Elem.LayerMatDyn[k] || !Elem.LandLayers[k])
-		{
-			UE_LOG(LogTemp, Warning, TEXT("ERROR drawing layers: !Elem.LayerMatDyn[%d] || !Elem.LandLayers[%d]"), k, k);
-			continue;
-		}
+		ComputeDataLayerForClipMap(index, k);
+	}
+}
 
-		Elem.LayerMatDyn[k]->SetVectorParameterValue("PatchLocation", FVector(Elem.Location));
+void AShaderWorldActor::ComputeDataLayerForClipMap(int index, int k, TConstArrayView<FIntRect> DirtyRects)
+{
+	FClipMapMeshElement& Elem = Meshes[index];
+
+	if (!Elem.LayerMatDyn[k] || !Elem.LandLayers[k])
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ERROR drawing layers: !Elem.LayerMatDyn[%d] || !Elem.LandLayers[%d]"), k, k);
+		return;
+	}
 
-		if(Elem.LandLayers_NeedParent[k])
+	Elem.LayerMatDyn[k]->SetVectorParameterValue("PatchLocation", FVector(Elem.Location));
+
+	if(Elem.LandLayers_NeedParent[k])
+	{
+		if(Elem.Level>0)
 		{
-			if(Elem.Level>0)
-			{
-				Elem.LayerMatDyn[k]->SetVectorParameterValue("RingLocation_Parent", FVector(Meshes[Elem.Level-1].Location));
-			}
-			else
-			{
-				Elem.LayerMatDyn[k]->SetVectorParameterValue("RingLocation_Parent", FVector(Elem.Location));
-			}
+			Elem.LayerMatDyn[k]->SetVectorParameterValue("RingLocation_Parent", FVector(Meshes[Elem.Level-1].Location));
 		}
-		
+		else
+		{
+			Elem.LayerMatDyn[k]->SetVectorParameterValue("RingLocation_Parent", FVector(Elem.Location));
+		}
+	}
+
+	if (DirtyRects.Num() > 0)
+	{
+		DrawMaterialToRects(this, Elem.LayerMatDyn[k], Elem.LandLayers[k], DirtyRects);
+	}
+	else
+	{
 		UKismetRenderingLibrary::ClearRenderTarget2D(this, Elem.LandLayers[k], FLinearColor::Black);
 		
 #if 0 //SW_COMPUTE_GENERATION
@@ -3831,10 +5452,11 @@ void AShaderWorldActor::ComputeDataLayersForClipMap(int index)
 #else
 		UKismetRenderingLibrary::DrawMaterialToRenderTarget(this, Elem.LandLayers[k], Elem.LayerMatDyn[k]);
 #endif
-		FString LocalLayerName = Elem.LandLayers_names[k].ToString();
-		if (BrushManager)
-			BrushManager->ApplyBrushStackToLayer(this, Elem.Level, Elem.LandLayers[k], FVector(Elem.Location), Elem.GridSpacing, N, LocalLayerName);
 	}
+
+	FString LocalLayerName = Elem.LandLayers_names[k].ToString();
+	if (BrushManager)
+		BrushManager->ApplyBrushStackToLayer(this, Elem.Level, Elem.LandLayers[k], FVector(Elem.Location), Elem.GridSpacing, N, LocalLayerName, DirtyRects);
 }
 
 int32 AShaderWorldActor::SphericalProjection(FIntVector Destination)
@@ -3847,8 +5469,208 @@ int32 AShaderWorldActor::SphericalProjection(FIntVector Destination)
 
 	Z_square = (int32)FMath::Sqrt((float)FMath::Max(0.f,(float)Z_square));
 
-	return (-PlanetRadiusKm + Z_square-Destination.Z)*100000;
+	return (-PlanetRadiusKm + Z_square-Destination.Z)*100000;
+
+}
+
+int64 AShaderWorldActor::EstimateClipMapUpdateTexels(int index, bool bMove) const
+{
+	if (!Meshes.IsValidIndex(index))
+		return 0;
+
+	const FClipMapMeshElement& Elem = Meshes[index];
+
+	TArray<const UTextureRenderTarget2D*, TInlineAllocator<8>> Targets;
+	Targets.Add(Elem.HeightMap);
+	Targets.Add(Elem.NormalMap);
+	for (const UTextureRenderTarget2D* Layer : Elem.LandLayers)
+		Targets.Add(Layer);
+
+	/*
+	 * A camera step moves a ring by two grid spacings: a scrolled ring only generates the exposed strips,
+	 * the scroll itself being two copies of the whole target.
+	 */
+	const bool bScroll = bMove && Elem.bCacheLocationValid && CVarSWClipmapScrollCache.GetValueOnGameThread() > 0;
+
+	int64 Texels = 0;
+	for (const UTextureRenderTarget2D* Target : Targets)
+	{
+		if (!Target)
+			continue;
+
+		const int64 Size = Target->SizeX;
+
+		if (bScroll && N > 1)
+		{
+			const int64 Step = 2 * (Size - 1) / (N - 1) + 2;
+			Texels += 2 * Step * Size;
+		}
+		else
+			Texels += Size * Size;
+	}
+
+	return Texels;
+}
+
+float AShaderWorldActor::ComputeClipMapPriority(const FClipMapMeshElement& Elem, float CameraHeight, double CurrentTime) const
+{
+	/*
+	 * Screen space error of a stale ring, seen from its closest visible texel: a ring starts where its child ring ends,
+	 * the most detailed ring lies right under the camera. A moving camera will reach the coarser rings sooner.
+	 */
+	const bool bInnermost = Elem.Level >= Meshes.Num() - 1;
+	const double InnerRadius = bInnermost ? 0.0 : Elem.GridSpacing * (N - 1) / 4.0;
+	const double LookAhead = ScheduleCameraSpeed * FMath::Max(0.f, CVarSWClipmapUpdateLookAhead.GetValueOnGameThread());
+	const double Distance = FMath::Max3(static_cast<double>(CameraHeight), InnerRadius - LookAhead, static_cast<double>(FMath::Max(Elem.GridSpacing, 1.f)));
+
+	// Aging: a deferred refresh gains priority over time, no ring can be starved
+	const double Staleness = Elem.StaleSince > 0.0 ? FMath::Max(0.0, CurrentTime - Elem.StaleSince) : 0.0;
+
+	return static_cast<float>(Elem.GridSpacing / Distance * (1.0 + Staleness));
+}
+
+void AShaderWorldActor::ScheduleClipMapUpdates(float CameraHeight, double CurrentTime)
+{
+	SW_FCT_CYCLE()
+
+	const FVector CamAbsolute = CamLocation + FVector(GetWorld()->OriginLocation);
+
+	if (ScheduleLastTime > 0.0 && CurrentTime > ScheduleLastTime)
+		ScheduleCameraSpeed = (CamAbsolute - ScheduleLastCamLocation).Size2D() / (CurrentTime - ScheduleLastTime);
+
+	ScheduleLastCamLocation = CamAbsolute;
+	ScheduleLastTime = CurrentTime;
+
+	const double BudgetTexels = CVarSWClipmapUpdateBudget.GetValueOnGameThread() * 1000000.0;
+	const double MaxDeferral = CVarSWClipmapMaxRefreshDeferral.GetValueOnGameThread();
+
+	struct FRefreshCandidate
+	{
+		int32 Index;
+		float Priority;
+		int64 Texels;
+		bool bMandatory;
+	};
+
+	TArray<FRefreshCandidate, TInlineAllocator<16>> Candidates;
+	int64 SpentTexels = 0;
+
+	for (int i = 0; i < Meshes.Num(); i++)
+	{
+		FClipMapMeshElement& Elem = Meshes[i];
+
+		Elem.bRefreshGranted = false;
+
+		if (!Elem.Mesh)
+			continue;
+
+		/*
+		 * Only the rings overlapping a brush redraw scope need a refresh, hidden rings included:
+		 * the scopes are discarded at the end of the frame.
+		 */
+		if (BrushManager && !Elem.bPendingBrushRefresh && BrushManagerRedrawScopes.Num() > 0)
+		{
+			const FVector2D RingLocation(Elem.Location.X, Elem.Location.Y);
+			const double Extent = Elem.GridSpacing * (N - 1) / 2.0 + Elem.GridSpacing;
+			const FBox2D RingFootprint(RingLocation - FVector2D(Extent), RingLocation + FVector2D(Extent));
+
+			for (const FBox2D& Scope : BrushManagerRedrawScopes)
+			{
+				if (RingFootprint.Intersect(Scope))
+				{
+					Elem.bPendingBrushRefresh = true;
+					if (Elem.StaleSince <= 0.0)
+						Elem.StaleSince = CurrentTime;
+					break;
+				}
+			}
+		}
+
+		/*
+		 * Hidden rings keep their pending refresh for when they show up again, but nobody sees them being stale:
+		 * their clock restarts every frame so that neither the metric nor the aging grows while hidden
+		 */
+		if (Elem.bHidden || (CameraHeight > Elem.GridSpacing * AltitudeToLODTransition * N && Elem.Level > 0))
+		{
+			if (Elem.StaleSince > 0.0)
+				Elem.StaleSince = CurrentTime;
+			continue;
+		}
+
+		const bool bTimeDue = (Elem.UpdateDelay > 0.0) && ((CurrentTime - Elem.LatestUpdateTime) >= Elem.UpdateDelay);
+
+		if (bTimeDue && Elem.StaleSince <= 0.0)
+			Elem.StaleSince = Elem.LatestUpdateTime + Elem.UpdateDelay;
+
+		Elem.UpdatePriority = ComputeClipMapPriority(Elem, CameraHeight, CurrentTime);
+
+		// Camera moves are not deferrable, they consume the budget first
+		const FVector CompToCam = CamLocation - FVector(Elem.Location - GetWorld()->OriginLocation);
+		if (FMath::Max(FMath::Abs(CompToCam.X), FMath::Abs(CompToCam.Y)) > Elem.GridSpacing)
+			SpentTexels += EstimateClipMapUpdateTexels(i, true);
+
+		if (!bTimeDue && !Elem.bPendingBrushRefresh)
+			continue;
+
+		const bool bMandatory = BudgetTexels <= 0.0 || (Elem.StaleSince > 0.0 && (CurrentTime - Elem.StaleSince) >= MaxDeferral);
+
+		Candidates.Add({ i, Elem.UpdatePriority, EstimateClipMapUpdateTexels(i, false), bMandatory });
+	}
+
+	Candidates.Sort([](const FRefreshCandidate& A, const FRefreshCandidate& B)
+	{
+		if (A.bMandatory != B.bMandatory)
+			return A.bMandatory;
+		return A.Priority > B.Priority;
+	});
+
+	int32 Deferred = 0;
+	bool bGrantedAny = false;
+
+	for (const FRefreshCandidate& Candidate : Candidates)
+	{
+		FClipMapMeshElement& Elem = Meshes[Candidate.Index];
+
+		if (Elem.bRefreshGranted)
+			continue;
+
+		int64 Texels = Candidate.Texels;
+
+		// Redrawing a ring over time redraws its children as well
+		if (UpdateHOverTime)
+		{
+			for (int j = Candidate.Index + 1; j < Meshes.Num(); j++)
+			{
+				if (!Meshes[j].bRefreshGranted)
+					Texels += EstimateClipMapUpdateTexels(j, false);
+			}
+		}
+
+		if (Candidate.bMandatory || !bGrantedAny || SpentTexels + Texels <= BudgetTexels)
+		{
+			Elem.bRefreshGranted = true;
+			SpentTexels += Texels;
+			bGrantedAny = true;
+
+			if (UpdateHOverTime)
+			{
+				for (int j = Candidate.Index + 1; j < Meshes.Num(); j++)
+					Meshes[j].bRefreshGranted = true;
+			}
+		}
+		else
+		{
+			Deferred++;
+		}
+	}
+
+	SW_SET_COUNTER(ClipmapUpdateKTexels, SpentTexels / 1000)
+	SW_SET_COUNTER(ClipmapDeferredRefreshes, Deferred)
 
+#if SWDEBUG
+	if (Deferred > 0)
+		SW_LOG("Clipmap update budget: %d ring refreshes deferred, %lld texels scheduled", Deferred, SpentTexels)
+#endif
 }
 
 void AShaderWorldActor::UpdateClipMap()
@@ -3914,6 +5736,8 @@ void AShaderWorldActor::UpdateClipMap()
 
 	USWorldSubsystem* ShaderWorldSubsystem = SWorldSubsystem;
 
+	ScheduleClipMapUpdates(Height, CurrentTime);
+
 	for(int i=0; i< Meshes.Num(); i++)
 	{
 		FClipMapMeshElement& Elem = Meshes[i];
@@ -3923,7 +5747,12 @@ void AShaderWorldActor::UpdateClipMap()
 
 		Elem.DrawingThisFrame = false;
 
-		if(Height>Elem.GridSpacing * AltitudeToLODTransition * N && Elem.Level>0)
+		const bool bInnerRingDrawn = !(Height>Elem.GridSpacing * AltitudeToLODTransition * N/2.f || Elem.Level==LOD_Num-1) && Meshes.IsValidIndex(i+1);
+		const bool bOutsideBoundedWorld = !IsClipMapRingInBoundedWorld(Elem, bInnerRingDrawn ? &Meshes[i+1] : nullptr);
+
+		Elem.bHidden = (Height>Elem.GridSpacing * AltitudeToLODTransition * N && Elem.Level>0) || bOutsideBoundedWorld;
+
+		if(Elem.bHidden)
 		{
 			if(Elem.IsSectionVisible(0,Segmented))
 				Elem.SetSectionVisible(0,false,Segmented);
@@ -4002,12 +5831,11 @@ void AShaderWorldActor::UpdateClipMap()
 				}
 
 				const bool bRedrawingBecauseOfCamera = MaxPlanarOffset > Elem.GridSpacing || bForceUpdate;
-				const bool bRedrawingBecauseOfTime = (Elem.UpdateDelay > 0.0) && ((CurrentTime - Elem.LatestUpdateTime) >= Elem.UpdateDelay) || UpdateHOverTime && Elem.DrawingThisFrame;
+				// Time driven refreshes wait for the scheduler to grant them, see ScheduleClipMapUpdates()
+				const bool bRedrawingBecauseOfTime = (Elem.UpdateDelay > 0.0) && ((CurrentTime - Elem.LatestUpdateTime) >= Elem.UpdateDelay) && Elem.bRefreshGranted || UpdateHOverTime && Elem.DrawingThisFrame;
 
 				if(bRedrawingBecauseOfCamera || bRedrawingBecauseOfTime)
 				{
-					Elem.LatestUpdateTime = CurrentTime;
-
 					double X_cam = CamLocation.X + GetWorld()->OriginLocation.X;
 					double Y_cam = CamLocation.Y + GetWorld()->OriginLocation.Y;
 
@@ -4056,16 +5884,28 @@ void AShaderWorldActor::UpdateClipMap()
 
 					if(Segmented)
 					{						
+						Elem.LatestUpdateTime = CurrentTime;
 						SegmentedUpdateProcessed = false;
 						ClipMapToUpdateAndMove[i] = true;
-						NeedSegmentedUpdate[i] = true;				
+						NeedSegmentedUpdate[i] = true;
+						Elem.bCacheLocationValid = false;
 					}
 					else
 					{
 						if(bRedrawingBecauseOfCamera)
 							MoveClipMapMaterialLocation(i);
 
-						if(bHadGeneratorAtRebuildTime)
+						/*
+						 * A plain camera move only exposes strips along the ring borders: scroll the caches and draw those strips.
+						 * Our parent location did not change, its content remains valid.
+						 * A deferred brush refresh stays pending: only the strips are up to date.
+						 */
+						const bool bScrolled = bHadGeneratorAtRebuildTime && bRedrawingBecauseOfCamera && !bRedrawingBecauseOfTime && !bForceUpdate && !(Elem.bPendingBrushRefresh && Elem.bRefreshGranted) && ScrollClipMapCaches(i);
+
+						if (!bScrolled)
+							Elem.LatestUpdateTime = CurrentTime;
+
+						if(bHadGeneratorAtRebuildTime && !bScrolled)
 						{
 							
 							if((i>0) && !Meshes[i-1].DrawingThisFrame)
@@ -4119,7 +5959,7 @@ void AShaderWorldActor::UpdateClipMap()
 				}
 				else
 				{
-					if(BrushManager && BrushManagerRedrawScopes.Num()>0)
+					if(BrushManager && Elem.bPendingBrushRefresh && Elem.bRefreshGranted)
 					{
 						
 
@@ -4283,22 +6123,162 @@ double AShaderWorldActor::GetHeightFromGPUReadOld(FColor& ReadLoc, uint16& Mater
 }
 
 
-double AShaderWorldActor::ComputeWorldHeightAt(FVector WorldLocation)
+void AShaderWorldActor::DecodeGPUReadTexels(const uint8* ReadLoc, int32 Count, float* OutHeights, uint16* OutMaterialIndices)
 {
-	//Implement your noise here // same one as the one in shader
+	int32 k = 0;
 
+	// Four texels at once: a texel read as a little endian int32 holds the 24bit height in its low bytes and the material in its top byte
+	for (; k + 4 <= Count; k += 4)
+	{
+		const VectorRegister4Int Texels = VectorIntLoad(&ReadLoc[4 * k]);
+		const VectorRegister4Int Heights = VectorShiftRightImmArithmetic(VectorShiftLeftImm(Texels, 8), 8);
+		const VectorRegister4Int Materials = VectorShiftRightImmLogical(Texels, 24);
 
+		VectorStore(VectorIntToFloat(Heights), &OutHeights[k]);
 
-	return 0.f;
+		alignas(16) int32 MaterialLanes[4];
+		VectorIntStoreAligned(Materials, MaterialLanes);
 
+		OutMaterialIndices[k] = MaterialLanes[0];
+		OutMaterialIndices[k + 1] = MaterialLanes[1];
+		OutMaterialIndices[k + 2] = MaterialLanes[2];
+		OutMaterialIndices[k + 3] = MaterialLanes[3];
+	}
 
+	for (; k < Count; k++)
+	{
+		OutHeights[k] = GetHeightFromGPURead(const_cast<uint8*>(&ReadLoc[4 * k]), OutMaterialIndices[k]);
+	}
 }
 
-void ReadPixelsFromRT(UTextureRenderTarget2D* InRT, FCollisionMeshElement& Mesh)
+inline void AShaderWorldActor::EncodeHeightForGPURead(double Height, uint16 MaterialIndice, uint8* WriteLoc)
+{
+	// Inverse of GetHeightFromGPURead: 24bit signed integer height, material in alpha
+	const int32 Height24 = FMath::Clamp(FMath::RoundToInt32(Height), -0x800000, 0x7FFFFF);
+
+	WriteLoc[0] = Height24 & 0xFF;
+	WriteLoc[1] = (Height24 >> 8) & 0xFF;
+	WriteLoc[2] = (Height24 >> 16) & 0xFF;
+	WriteLoc[3] = static_cast<uint8>(MaterialIndice);
+}
+
+void AShaderWorldActor::BenchmarkCollisionDecode(const TArray<FString>& Args)
+{
+	const int32 MaxVerticesPerSide = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1024;
+	const int32 Iterations = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 16;
+	const int32 VerticesPerSideList[] = { 63, 127, 255, 511, 1023 };
+
+	for (const int32 VerticesPerPatch : VerticesPerSideList)
+	{
+		if (VerticesPerPatch > MaxVerticesPerSide)
+			break;
+
+		const int32 NumOfVertex = VerticesPerPatch * VerticesPerPatch;
+
+		// Packed RGBA8 texels as written by the generator material, heights over the whole 24bit range
+		TArray<uint8> ReadData;
+		ReadData.SetNumUninitialized(NumOfVertex * 4);
+
+		FRandomStream RandomStream(VerticesPerPatch);
+		for (int32 k = 0; k < NumOfVertex; k++)
+			EncodeHeightForGPURead(RandomStream.FRandRange(-8000000.f, 8000000.f), RandomStream.RandRange(0, 255), &ReadData[4 * k]);
+
+		TArray<float> ScalarHeights;
+		TArray<uint16> ScalarMaterials;
+		ScalarHeights.SetNumUninitialized(NumOfVertex);
+		ScalarMaterials.SetNumUninitialized(NumOfVertex);
+
+		TArray<float> VectorHeights;
+		TArray<uint16> VectorMaterials;
+		VectorHeights.SetNumUninitialized(NumOfVertex);
+		VectorMaterials.SetNumUninitialized(NumOfVertex);
+
+		// The same samples read back as R32F heights and R8 material indices
+		FSWHeightMaterialRead Read32;
+		Read32.Heights.SetNumUninitialized(NumOfVertex);
+		Read32.MaterialIndices.SetNumUninitialized(NumOfVertex);
+		for (int32 k = 0; k < NumOfVertex; k++)
+		{
+			uint16 Material = 0;
+			Read32.Heights[k] = GetHeightFromGPURead(&ReadData[4 * k], Material);
+			Read32.MaterialIndices[k] = static_cast<uint8>(Material);
+		}
+
+		TArray<float> Heights32;
+		TArray<uint16> Materials32;
+		Heights32.SetNumUninitialized(NumOfVertex);
+		Materials32.SetNumUninitialized(NumOfVertex);
+
+		double ScalarSeconds = 0.0;
+		double VectorSeconds = 0.0;
+		double Read32Seconds = 0.0;
+
+		for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			double Start = FPlatformTime::Seconds();
+			for (int32 k = 0; k < NumOfVertex; k++)
+				ScalarHeights[k] = GetHeightFromGPURead(&ReadData[4 * k], ScalarMaterials[k]);
+			ScalarSeconds += FPlatformTime::Seconds() - Start;
+
+			// Row by row, as CollisionPreprocessGPU does
+			Start = FPlatformTime::Seconds();
+			for (int32 Row = 0; Row < VerticesPerPatch; Row++)
+				DecodeGPUReadTexels(&ReadData[4 * Row * VerticesPerPatch], VerticesPerPatch, &VectorHeights[Row * VerticesPerPatch], &VectorMaterials[Row * VerticesPerPatch]);
+			VectorSeconds += FPlatformTime::Seconds() - Start;
+
+			// Row copy and material widening of the R32F + R8 path of CollisionPreprocessGPU
+			Start = FPlatformTime::Seconds();
+			for (int32 Row = 0; Row < VerticesPerPatch; Row++)
+			{
+				const int32 RowStart = Row * VerticesPerPatch;
+				FMemory::Memcpy(&Heights32[RowStart], &Read32.Heights[RowStart], VerticesPerPatch * sizeof(float));
+
+				for (int32 X = 0; X < VerticesPerPatch; X++)
+					Materials32[RowStart + X] = Read32.MaterialIndices[RowStart + X];
+			}
+			Read32Seconds += FPlatformTime::Seconds() - Start;
+		}
+
+		int32 Mismatches = 0;
+		for (int32 k = 0; k < NumOfVertex; k++)
+		{
+			if (ScalarHeights[k] != VectorHeights[k] || ScalarMaterials[k] != VectorMaterials[k] || ScalarHeights[k] != Heights32[k] || ScalarMaterials[k] != Materials32[k])
+				Mismatches++;
+		}
+
+		ScalarSeconds /= Iterations;
+		VectorSeconds /= Iterations;
+		Read32Seconds /= Iterations;
+
+		// Readback size of one tile in each format
+		const double PackedKB = NumOfVertex * sizeof(FColor) / 1024.0;
+		const double Read32KB = NumOfVertex * (sizeof(float) + sizeof(uint8)) / 1024.0;
+
+		UE_LOG(LogShaderWorld, Display, TEXT("SW collision decode | %4dx%4d texels | per texel %8.3fms | vectorized %8.3fms | x%.2f | %8.1fKB per tile | R32F+R8 %8.3fms %8.1fKB per tile | %d mismatches"),
+			VerticesPerPatch, VerticesPerPatch, ScalarSeconds * 1000.0, VectorSeconds * 1000.0, VectorSeconds > 0.0 ? ScalarSeconds / VectorSeconds : 0.0, PackedKB, Read32Seconds * 1000.0, Read32KB, Mismatches);
+	}
+}
+
+static FAutoConsoleCommand BenchmarkCollisionDecodeCmd(
+	TEXT("sw.Collision.BenchmarkDecode"),
+	TEXT("Logs per texel and vectorized decode timings of synthetic packed collision readbacks against the R32F + R8 readback copy, with the readback size of a tile in each format, and checks all agree. Optional arguments: max vertices per side (default 1024), iterations (default 16)."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&AShaderWorldActor::BenchmarkCollisionDecode)
+);
+
+double AShaderWorldActor::ComputeWorldHeightAt(FVector WorldLocation)
+{
+	if (!HeightEvaluator.IsValid())
+		return 0.f;
+
+	uint16 MaterialIndice = 0;
+	return HeightEvaluator->ComputeWorldHeight(FVector2D(WorldLocation), MaterialIndice);
+}
+
+void ReadPixelsFromRT(UTextureRenderTarget2D* InRT, const TSharedPtr<FSWColorRead, ESPMode::ThreadSafe>& ReadData, const TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe>& ReadCompletion)
 {
 
 	ENQUEUE_RENDER_COMMAND(ReadGeoClipMapRTCmd)(
-		[InRT, HeightData = Mesh.HeightData, Completion = Mesh.ReadBackCompletion](FRHICommandListImmediate& RHICmdList)
+		[InRT, HeightData = ReadData, Completion = ReadCompletion](FRHICommandListImmediate& RHICmdList)
 	{		
 		check(IsInRenderingThread());
 
@@ -4322,7 +6302,187 @@ void ReadPixelsFromRT(UTextureRenderTarget2D* InRT, FCollisionMeshElement& Mesh)
 
 }
 
-void AShaderWorldActor::UpdateCollisionMeshData(FCollisionMeshElement& Mesh)
+void ReadPixelsFromRT(UTextureRenderTarget2D* InRT, FCollisionMeshElement& Mesh)
+{
+	ReadPixelsFromRT(InRT, Mesh.HeightData, Mesh.ReadBackCompletion);
+}
+
+bool AShaderWorldActor::UseCollisionAtlasBatching() const
+{
+	return bBatchCollisionGeneration && !bExportPhysicalMaterialID_cached && Generator && SWorldSubsystem;
+}
+
+void AShaderWorldActor::AddTileToCollisionAtlas(FCollisionMeshElement& Mesh, const FVector& PatchLocation)
+{
+	if (CollisionAtlasFillingBatch == INDEX_NONE)
+	{
+		CollisionAtlasFillingBatch = CollisionAtlasBatches.IndexOfByPredicate([](const FSWCollisionAtlasBatch& Batch) { return !Batch.bInFlight; });
+
+		if (CollisionAtlasFillingBatch == INDEX_NONE)
+			CollisionAtlasFillingBatch = CollisionAtlasBatches.AddDefaulted();
+	}
+
+	FSWCollisionAtlasBatch& Batch = CollisionAtlasBatches[CollisionAtlasFillingBatch];
+
+	const int32 VerticesPerPatch = CollisionVerticesPerPatch;
+
+	if (Batch.TileData.Num() == 0)
+	{
+		UWorld* World = GetWorld();
+
+		const int32 TilesPerSide = FMath::Clamp(CVarSWCollisionAtlasTilesPerSide.GetValueOnGameThread(), 1, FMath::Max(1, 4096 / VerticesPerPatch));
+		const int32 AtlasDim = TilesPerSide * VerticesPerPatch;
+
+		if (!Batch.LocationsRT || !Batch.HeightmapRT || Batch.LocationsRT->SizeX != AtlasDim)
+		{
+			if (Batch.LocationsRT && Batch.HeightmapRT)
+				RendertargetMemoryBudgetMB -= (4 * 2 + 4) * Batch.LocationsRT->SizeX * Batch.LocationsRT->SizeX / 1000000.0f;
+
+			RendertargetMemoryBudgetMB += (4 * 2 + 4) * AtlasDim * AtlasDim / 1000000.0f;
+			SW_RT(Batch.LocationsRT, World, AtlasDim, TF_Nearest, RTF_RG32f)
+			SW_RT(Batch.HeightmapRT, World, AtlasDim, TF_Nearest, RTF_RGBA8)
+
+			Batch.GeneratorDyn = CreateHeightReadBackMaterial(Batch.LocationsRT);
+		}
+
+		Batch.TilesPerSide = TilesPerSide;
+		Batch.BoundingBox = FBox(ForceInit);
+		Batch.Samples = MakeShared<FSWShareableSamplePoints, ESPMode::ThreadSafe>();
+		Batch.Samples->PositionsXY.SetNumZeroed(AtlasDim * AtlasDim * 2);
+	}
+
+	const int32 AtlasDim = Batch.TilesPerSide * VerticesPerPatch;
+	const int32 Tile = Batch.TileData.Num();
+	const int32 TileX0 = (Tile % Batch.TilesPerSide) * VerticesPerPatch;
+	const int32 TileY0 = (Tile / Batch.TilesPerSide) * VerticesPerPatch;
+	const double Spacing = CollisionResolution;
+	const double HalfExtent = Spacing * (VerticesPerPatch - 1) / 2.0;
+
+	// Same vertex locations as the per tile generator draw
+	float* PositionsXY = Batch.Samples->PositionsXY.GetData();
+	for (int32 Y = 0; Y < VerticesPerPatch; Y++)
+	{
+		for (int32 X = 0; X < VerticesPerPatch; X++)
+		{
+			const int32 Texel = (TileY0 + Y) * AtlasDim + TileX0 + X;
+			PositionsXY[2 * Texel] = PatchLocation.X + X * Spacing - HalfExtent;
+			PositionsXY[2 * Texel + 1] = PatchLocation.Y + Y * Spacing - HalfExtent;
+		}
+	}
+
+	Batch.BoundingBox += FVector(PatchLocation.X - HalfExtent, PatchLocation.Y - HalfExtent, 0.0);
+	Batch.BoundingBox += FVector(PatchLocation.X + HalfExtent, PatchLocation.Y + HalfExtent, 0.0);
+
+	Batch.TileData.Add(Mesh.HeightData);
+	Batch.TileCompletion.Add(Mesh.ReadBackCompletion);
+
+	if (Batch.TileData.Num() >= Batch.TilesPerSide * Batch.TilesPerSide)
+		FlushCollisionAtlas();
+}
+
+void AShaderWorldActor::FlushCollisionAtlas()
+{
+	if (CollisionAtlasFillingBatch == INDEX_NONE)
+		return;
+
+	FSWCollisionAtlasBatch& Batch = CollisionAtlasBatches[CollisionAtlasFillingBatch];
+	CollisionAtlasFillingBatch = INDEX_NONE;
+
+	if (Batch.TileData.Num() <= 0)
+		return;
+
+	if (!Batch.GeneratorDyn || !SWorldSubsystem)
+	{
+		// Nothing to evaluate the tiles with, hand them back as is rather than stalling collision processing
+		for (TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe>& Completion : Batch.TileCompletion)
+			Completion->AtomicSet(true);
+
+		Batch.TileData.Reset();
+		Batch.TileCompletion.Reset();
+		return;
+	}
+
+	TSharedPtr<FSWShareableSamplePoints>& Samples = Batch.Samples;
+	SWorldSubsystem->LoadSampleLocationsInRT(Batch.LocationsRT, Samples);
+
+#if SW_COMPUTE_GENERATION
+
+#else
+	UKismetRenderingLibrary::DrawMaterialToRenderTarget(this, Batch.HeightmapRT, Batch.GeneratorDyn);
+#endif
+
+	if (BrushManager)
+	{
+		int32 AtlasDim = Batch.HeightmapRT->SizeX;
+		const FVector Extent = Batch.BoundingBox.GetExtent();
+		const int32 BrushGridSpacing = FMath::CeilToInt(FMath::Max(Extent.X, Extent.Y) * 2.0 / (AtlasDim - 1));
+
+		BrushManager->ApplyBrushStackToHeightMap(this, 0, Batch.HeightmapRT.Get(), Batch.BoundingBox.GetCenter(), BrushGridSpacing, AtlasDim, false, true, Batch.LocationsRT.Get());
+	}
+
+	if (!Batch.ReadData.IsValid())
+		Batch.ReadData = MakeShared<FSWColorRead, ESPMode::ThreadSafe>();
+
+	Batch.ReadData->ReadData.SetNum(Batch.HeightmapRT->SizeX * Batch.HeightmapRT->SizeY);
+
+	if (!Batch.ReadCompletion.IsValid())
+		Batch.ReadCompletion = MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>();
+
+	Batch.ReadCompletion->AtomicSet(false);
+	Batch.bInFlight = true;
+
+	ReadPixelsFromRT(Batch.HeightmapRT, Batch.ReadData, Batch.ReadCompletion);
+}
+
+void AShaderWorldActor::CompleteCollisionAtlasBatch(FSWCollisionAtlasBatch& Batch)
+{
+	SW_FCT_CYCLE()
+
+	Batch.bInFlight = false;
+
+	const int32 VerticesPerPatch = CollisionVerticesPerPatch;
+	const int32 AtlasDim = Batch.TilesPerSide * VerticesPerPatch;
+	const bool bFlipY = RendererAPI == EGeoRenderingAPI::OpenGL;
+
+	if (Batch.ReadData.IsValid() && Batch.ReadData->ReadData.Num() == AtlasDim * AtlasDim)
+	{
+		const FColor* AtlasData = Batch.ReadData->ReadData.GetData();
+
+		/*
+		 * Copy each tile rows to its collision mesh, in the texel layout CollisionPreprocessGPU expects.
+		 * With OpenGL both the atlas readback and the tile layout are flipped vertically.
+		 */
+		ParallelFor(Batch.TileData.Num(), [&](int32 Tile)
+			{
+				const TSharedPtr<FSWColorRead, ESPMode::ThreadSafe>& TileData = Batch.TileData[Tile];
+
+				if (!TileData.IsValid() || TileData->ReadData.Num() != VerticesPerPatch * VerticesPerPatch)
+					return;
+
+				const int32 TileX0 = (Tile % Batch.TilesPerSide) * VerticesPerPatch;
+				const int32 TileY0 = (Tile / Batch.TilesPerSide) * VerticesPerPatch;
+
+				for (int32 Y = 0; Y < VerticesPerPatch; Y++)
+				{
+					const int32 AtlasRow = bFlipY ? AtlasDim - 1 - (TileY0 + Y) : TileY0 + Y;
+					const int32 TileRow = bFlipY ? VerticesPerPatch - 1 - Y : Y;
+
+					FMemory::Memcpy(&TileData->ReadData[TileRow * VerticesPerPatch], &AtlasData[AtlasRow * AtlasDim + TileX0], VerticesPerPatch * sizeof(FColor));
+				}
+			});
+	}
+
+	for (TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe>& Completion : Batch.TileCompletion)
+	{
+		if (Completion.IsValid())
+			Completion->AtomicSet(true);
+	}
+
+	Batch.TileData.Reset();
+	Batch.TileCompletion.Reset();
+}
+
+void AShaderWorldActor::UpdateCollisionMeshData(FCollisionMeshElement& Mesh, bool bAllowDiskCacheLoad)
 {
 	// Couple options i see here, either make a readback from a render target applying the same noise than the geoclipmap mesh
 	// or implement the same noise in C++ and compute it in parallel/on another thread
@@ -4331,23 +6491,136 @@ void AShaderWorldActor::UpdateCollisionMeshData(FCollisionMeshElement& Mesh)
 
 	FVector MesgLoc = FVector((Mesh.Location* CollisionResolution*(CollisionVerticesPerPatch-1) + FIntVector(0.f, 0.f, 1) * HeightOnStart));
 
+	Mesh.DiskCacheKey = TileDiskCache.IsValid() ? GetCollisionTileDiskCacheKey(Mesh, MesgLoc) : 0;
+	Mesh.bFromDiskCache = false;
+
+	// Whatever the previous update of this tile still has queued is stale
+	if (Mesh.Cancellation.IsValid())
+		Mesh.Cancellation->Cancel();
+
+	Mesh.Cancellation = MakeShared<FSWTaskCancellation, ESPMode::ThreadSafe>();
+	Mesh.ReadBackTask.Reset();
+
+	//OPTION C : Previously generated tile, from the disk cache
+	if (bAllowDiskCacheLoad && LoadCollisionTileFromDiskCache(Mesh))
+		return;
+
+	if (CanUseCPUHeightEvaluation())
+	{
+		//OPTION B : Evaluate the CPU mirror of the generator on worker threads.
+		// Results are either stored as float heights, or encoded like a GPU readback, CollisionPreprocessGPU handles both.
+
+		Mesh.bFloatHeightData = CVarSWCollisionFloatHeightRead.GetValueOnGameThread() > 0;
+
+		if (!Mesh.HeightData.IsValid())
+		{
+			Mesh.HeightData = MakeShared<FSWColorRead, ESPMode::ThreadSafe>();
+			Mesh.HeightData->ReadData.SetNum(CollisionVerticesPerPatch * CollisionVerticesPerPatch);
+		}
+
+		if (Mesh.bFloatHeightData && !Mesh.HeightData32.IsValid())
+			Mesh.HeightData32 = MakeShared<FSWHeightMaterialRead, ESPMode::ThreadSafe>();
+
+		// A failed disk cache load leaves the arrays empty
+		if (Mesh.bFloatHeightData)
+		{
+			Mesh.HeightData32->Heights.SetNum(CollisionVerticesPerPatch * CollisionVerticesPerPatch);
+			Mesh.HeightData32->MaterialIndices.SetNum(CollisionVerticesPerPatch * CollisionVerticesPerPatch);
+		}
+
+		if (!Mesh.ReadBackCompletion.IsValid())
+		{
+			Mesh.ReadBackCompletion = MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>();
+		}
+
+		Mesh.ReadBackCompletion->AtomicSet(false);
+
+		FSWTaskDesc ReadBackDesc;
+		ReadBackDesc.DebugName = TEXT("SWCollisionHeightEvaluation");
+		ReadBackDesc.Stage = ESWTaskStage::Readback;
+		ReadBackDesc.Priority = ESWTaskPriority::High;
+		ReadBackDesc.Cancellation = Mesh.Cancellation;
+
+		Mesh.ReadBackTask = FSWTaskGraph::Get().Launch(ReadBackDesc, [Evaluator = HeightEvaluator, HeightData = Mesh.HeightData, HeightData32 = Mesh.bFloatHeightData ? Mesh.HeightData32 : nullptr, Completion = Mesh.ReadBackCompletion, PatchLocation = MesgLoc, Spacing = CollisionResolution, VerticesPerPatch = CollisionVerticesPerPatch, bFlipY = (RendererAPI == EGeoRenderingAPI::OpenGL)]
+			{
+				uint8* ReadData8 = (uint8*)HeightData->ReadData.GetData();
+				const double HalfExtent = Spacing * (VerticesPerPatch - 1) / 2.0;
+
+				ParallelFor(VerticesPerPatch, [&](int32 Y)
+					{
+						for (int32 X = 0; X < VerticesPerPatch; X++)
+						{
+							const FVector2D Location(PatchLocation.X + X * Spacing - HalfExtent, PatchLocation.Y + Y * Spacing - HalfExtent);
+
+							uint16 MaterialIndice = 0;
+							const double Height = Evaluator->ComputeHeight(Location, MaterialIndice);
+
+							if (HeightData32.IsValid())
+							{
+								// Float data is never flipped, rows are laid out like the collision vertices
+								HeightData32->Heights[X + Y * VerticesPerPatch] = Height;
+								HeightData32->MaterialIndices[X + Y * VerticesPerPatch] = static_cast<uint8>(MaterialIndice);
+								continue;
+							}
+
+							// Match the texel layout CollisionPreprocessGPU expects for the current RHI
+							const int32 Texel = X + (bFlipY ? (VerticesPerPatch - 1 - Y) : Y) * VerticesPerPatch;
+							EncodeHeightForGPURead(Height, MaterialIndice, &ReadData8[4 * Texel]);
+						}
+					});
+
+				Completion->AtomicSet(true);
+			});
+
+		CollisionReadToProcess.Add(Mesh.ID);
+
+		return;
+	}
+
 	if (!Generator)
 	{
 #if SWDEBUG
 	SW_LOG("Generator Material not available for Shader World %s",*GetName())
 #endif
 	}
+	else if (UseCollisionAtlasBatching())
+	{
+		//OPTION A' : Same GPU evaluation, shared with other tiles in an atlas drawn and read back at once
+
+		Mesh.bFloatHeightData = false;
+
+		if (!Mesh.HeightData.IsValid())
+		{
+			Mesh.HeightData = MakeShared<FSWColorRead, ESPMode::ThreadSafe>();
+			Mesh.HeightData->ReadData.SetNum(CollisionVerticesPerPatch * CollisionVerticesPerPatch);
+		}
+
+		if (!Mesh.ReadBackCompletion.IsValid())
+		{
+			Mesh.ReadBackCompletion = MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>();
+		}
+
+		Mesh.ReadBackCompletion->AtomicSet(false);
+
+		AddTileToCollisionAtlas(Mesh, MesgLoc);
+
+		CollisionReadToProcess.Add(Mesh.ID);
+
+		return;
+	}
 	else
 	{
 		UWorld* World = GetWorld();
 
 		//OPTION A : Compute collision form GPU readback
+		Mesh.bFloatHeightData = false;
+
 		UMaterialInstanceDynamic* DynCollisionMat = Mesh.DynCollisionCompute;
 		
 		if(!DynCollisionMat)
 		{
 			
-			DynCollisionMat = UMaterialInstanceDynamic::Create(Generator.Get(), this);
+			DynCollisionMat = AcquireMaterialInstance(Generator.Get());
 
 			DynCollisionMat->SetScalarParameterValue("NoMargin", 1.f);
 			DynCollisionMat->SetScalarParameterValue("TexelPerSide", CollisionVerticesPerPatch);			
@@ -4501,67 +6774,160 @@ void AShaderWorldActor::UpdateCollisionMeshData(FCollisionMeshElement& Mesh)
 			
 		}
 
-		if(!Mesh.HeightData.IsValid())
+		if(!Mesh.HeightData.IsValid())
+		{
+			Mesh.HeightData = MakeShared<FSWColorRead, ESPMode::ThreadSafe>();
+			Mesh.HeightData->ReadData.SetNum(CollisionVerticesPerPatch * CollisionVerticesPerPatch);
+		}
+
+		if (!Mesh.ReadBackCompletion.IsValid())
+		{
+			Mesh.ReadBackCompletion = MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>();
+		}
+
+		Mesh.ReadBackCompletion->AtomicSet(false);	
+
+
+		ReadPixelsFromRT(Mesh.CollisionRT,Mesh);
+
+		CollisionReadToProcess.Add(Mesh.ID);
+		
+		return;
+	}
+}
+
+void AShaderWorldActor::SetupTileDiskCache()
+{
+	SW_FCT_CYCLE()
+
+	// A single directory for every world and setting: the size limit then also covers entries no configuration uses anymore
+	const FString Directory = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ShaderWorld"), TEXT("TileCache"));
+
+	TileDiskCache = MakeShared<FSWTileDiskCache, ESPMode::ThreadSafe>(Directory, TileDiskCacheMaxSizeMB);
+	TileDiskCacheWorldHash = ComputeTileDiskCacheWorldHash();
+
+	UpdateBrushFootprintHashes();
+
+	// Until the existing entries are listed, tiles are generated and stored as usual
+	Async(EAsyncExecution::TaskGraph, [Cache = TileDiskCache]
+		{
+			Cache->Initialize();
+		});
+}
+
+uint64 AShaderWorldActor::ComputeTileDiskCacheWorldHash() const
+{
+	// Everything a collision tile depends on, besides its location and the brushes over it
+	FString Description = FString::Printf(TEXT("%s|%s|%d|%d|%f|%d|%d|%d|%s|%d|%d"),
+		*GetPathNameSafe(Generator.Get()), *GetPathNameSafe(HeightGenerator), CollisionResolution, CollisionVerticesPerPatch, HeightOnStart,
+		static_cast<int32>(WorldShape), PlanetRadiusKm, bExportPhysicalMaterialID_cached ? 1 : 0, *LayerStoringMaterialID.ToString(),
+		static_cast<int32>(LayerChannelStoringID), TileDiskCacheVersion);
+
+	for (const FInstancedStruct& Seed : CurrentSeedsArray.SeedsArray)
+	{
+		if (!Seed.IsValid())
+			continue;
+
+		Description += TEXT("|") + Seed.GetScriptStruct()->GetName() + TEXT(":");
+		Seed.GetScriptStruct()->ExportText(Description, Seed.GetMemory(), nullptr, nullptr, PPF_None, nullptr);
+	}
+
+	// CPU generator settings (octaves, frequency, material bands...), whatever the generator type
+	if (HeightGenerator)
+	{
+		for (TFieldIterator<FProperty> It(HeightGenerator->GetClass()); It; ++It)
 		{
-			Mesh.HeightData = MakeShared<FSWColorRead, ESPMode::ThreadSafe>();
-			Mesh.HeightData->ReadData.SetNum(CollisionVerticesPerPatch * CollisionVerticesPerPatch);
-		}
+			const FProperty* Property = *It;
 
-		if (!Mesh.ReadBackCompletion.IsValid())
-		{
-			Mesh.ReadBackCompletion = MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>();
+			if (Property->HasAnyPropertyFlags(CPF_Transient) || !Property->GetOwnerClass() || !Property->GetOwnerClass()->IsChildOf(USWHeightGenerator::StaticClass()))
+				continue;
+
+			Description += TEXT("|") + Property->GetName() + TEXT(":");
+			Property->ExportText_InContainer(0, Description, HeightGenerator, nullptr, HeightGenerator, PPF_None);
 		}
+	}
 
-		Mesh.ReadBackCompletion->AtomicSet(false);	
+	return FSWTileDiskCache::HashBytes(*Description, Description.Len() * sizeof(TCHAR));
+}
+
+void AShaderWorldActor::UpdateBrushFootprintHashes()
+{
+	if (BrushManager)
+		BrushManager->GatherBrushFootprintHashes(BrushFootprintHashes);
+	else
+		BrushFootprintHashes.Empty();
+}
 
+uint64 AShaderWorldActor::GetCollisionTileDiskCacheKey(const FCollisionMeshElement& Mesh, const FVector& PatchLocation) const
+{
+	const double HalfExtent = CollisionResolution * (CollisionVerticesPerPatch - 1) / 2.0;
+	const FBox2D TileFootprint(FVector2D(PatchLocation) - FVector2D(HalfExtent), FVector2D(PatchLocation) + FVector2D(HalfExtent));
 
-		ReadPixelsFromRT(Mesh.CollisionRT,Mesh);
+	uint64 Key = FSWTileDiskCache::HashCombine(TileDiskCacheWorldHash, FSWTileDiskCache::HashBytes(&Mesh.Location, sizeof(FIntVector)));
 
-		CollisionReadToProcess.Add(Mesh.ID);
-		
-		return;
+	// Brushes drawn over the tile, in drawing order
+	for (const TPair<FBox2D, uint64>& Brush : BrushFootprintHashes)
+	{
+		if (Brush.Key.Intersect(TileFootprint))
+			Key = FSWTileDiskCache::HashCombine(Key, Brush.Value);
 	}
-	
-	return;
 
-	//OPTION B : Implement in c++ the same noise as the one in Shader graph and evaluate the noise here to generate the collision mesh
-	
-	/*
-	FGeoCProcMeshSection* Section = Mesh.Mesh->GetProcMeshSection(0);
+	// 0 stands for no key
+	return Key != 0 ? Key : 1;
+}
 
-	int NumOfVertex = Section->ProcVertexBuffer.Num();
+bool AShaderWorldActor::LoadCollisionTileFromDiskCache(FCollisionMeshElement& Mesh)
+{
+	if (!TileDiskCache.IsValid() || Mesh.DiskCacheKey == 0 || !TileDiskCache->Probe(Mesh.DiskCacheKey))
+		return false;
 
-	TArray<FVector> Vertices;
-	Vertices.SetNum(NumOfVertex);
-	TArray<FVector> Normals;
-	Normals.SetNum(NumOfVertex);
-	TArray<FVector2D> UV;
-	UV.SetNum(NumOfVertex);
-	TArray<FColor> Colors;
-	Colors.SetNum(NumOfVertex);
+	Mesh.bFloatHeightData = true;
+	Mesh.bFromDiskCache = true;
 
-	
-	ParallelFor(NumOfVertex, [&](int32 k)
-	{
-		FVector LocationfVertice_WS = Section->ProcVertexBuffer[k].Position*FVector(1.f,1.f,0.f) + MesgLoc;
+	if (!Mesh.HeightData32.IsValid())
+		Mesh.HeightData32 = MakeShared<FSWHeightMaterialRead, ESPMode::ThreadSafe>();
 
-		// ComputeWorldHeightAt is empty / not Implemented
+	if (!Mesh.ReadBackCompletion.IsValid())
+		Mesh.ReadBackCompletion = MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>();
 
-		LocationfVertice_WS.Z = ComputeWorldHeightAt(LocationfVertice_WS);
+	Mesh.ReadBackCompletion->AtomicSet(false);
 
-		Vertices[k] = LocationfVertice_WS - Mesh.Mesh->GetComponentLocation();
-		Normals[k] = FVector(0.f,0.f,1.f);
-		UV[k] = FVector2D(0.f,0.f);
-		Colors[k] = FColor::Blue;
-	});
+	FSWTaskDesc ReadBackDesc;
+	ReadBackDesc.DebugName = TEXT("SWCollisionDiskCacheLoad");
+	ReadBackDesc.Stage = ESWTaskStage::Readback;
+	ReadBackDesc.Priority = ESWTaskPriority::High;
+	ReadBackDesc.Cancellation = Mesh.Cancellation;
 
-	TArray<FGeoCProcMeshTangent> Tangents;
-	Tangents.Init(FGeoCProcMeshTangent(FVector(0.f, 0.f, 1.f), false), Vertices.Num());
+	Mesh.ReadBackTask = FSWTaskGraph::Get().Launch(ReadBackDesc, [Cache = TileDiskCache, Key = Mesh.DiskCacheKey, HeightData32 = Mesh.HeightData32, Completion = Mesh.ReadBackCompletion, NumOfVertex = CollisionVerticesPerPatch * CollisionVerticesPerPatch]
+		{
+			SW_STAGE_SCOPE(CollisionTileDiskCacheLoad)
 
+			TArray<uint8> Payload;
+			const bool bLoaded = Cache->Load(Key, Payload);
 
-	Mesh.Mesh->UpdateMeshSection(0,Vertices,Normals,UV,Colors,Tangents);
-	*/
+			if (bLoaded && Payload.Num() == NumOfVertex * (sizeof(float) + sizeof(uint8)))
+			{
+				HeightData32->Heights.SetNumUninitialized(NumOfVertex);
+				HeightData32->MaterialIndices.SetNumUninitialized(NumOfVertex);
+
+				FMemory::Memcpy(HeightData32->Heights.GetData(), Payload.GetData(), NumOfVertex * sizeof(float));
+				FMemory::Memcpy(HeightData32->MaterialIndices.GetData(), Payload.GetData() + NumOfVertex * sizeof(float), NumOfVertex);
+			}
+			else
+			{
+				if (bLoaded)
+					Cache->Remove(Key);
+
+				// CollisionPreprocessGPU generates the tile instead
+				HeightData32->Heights.Empty();
+			}
+
+			Completion->AtomicSet(true);
+		});
+
+	CollisionReadToProcess.Add(Mesh.ID);
 
+	return true;
 }
 
 void AShaderWorldActor::GetLocalTransformOfSpawnable(FInstancedStaticMeshInstanceData& OutTransform, const FVector& CompLoc, FColor& LocX,FColor& LocY,FColor& LocZ,FColor& Rot,/*FColor& Scale, */ FInstancedStaticMeshInstanceData& FromT, const bool& IsAdjustement, const FFloatInterval& AtitudeRange,const FVector& MeshLoc)
@@ -4694,6 +7060,7 @@ bool AShaderWorldActor::UpdateSpawnableCollisions(FSpawnableMesh& Spawn, double&
 
 			if ((FPlatformTime::Seconds() - UpdateStartTime) * 1000.0 > GameThreadBudget_ms)
 			{
+				SW_INC_COUNTER(FinalizeBudgetOverruns)
 				return false;
 			}
 
@@ -4750,6 +7117,7 @@ bool AShaderWorldActor::UpdateSpawnableCollisions(FSpawnableMesh& Spawn, double&
 
 							if ((FPlatformTime::Seconds() - UpdateStartTime) * 1000.0 > GameThreadBudget_ms)
 							{
+								SW_INC_COUNTER(FinalizeBudgetOverruns)
 								return false;
 							}
 
@@ -4888,6 +7256,7 @@ bool AShaderWorldActor::UpdateSpawnableCollisions(FSpawnableMesh& Spawn, double&
 
 			if ((FPlatformTime::Seconds() - UpdateStartTime) * 1000.0 > GameThreadBudget_ms)
 			{
+				SW_INC_COUNTER(FinalizeBudgetOverruns)
 				return false;
 			}
 
@@ -4944,6 +7313,7 @@ bool AShaderWorldActor::UpdateSpawnableCollisions(FSpawnableMesh& Spawn, double&
 
 							if ((FPlatformTime::Seconds() - UpdateStartTime) * 1000.0 > GameThreadBudget_ms)
 							{
+								SW_INC_COUNTER(FinalizeBudgetOverruns)
 								return false;
 							}
 
@@ -5106,6 +7476,84 @@ bool AShaderWorldActor::UpdateSpawnableCollisions(FSpawnableMesh& Spawn, double&
 	return true;
 }
 
+void AShaderWorldActor::BenchmarkSpawnableDecode(const TArray<FString>& Args)
+{
+	const int32 MaxRTDim = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 512;
+	const int32 Iterations = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 4;
+	const int32 DecodeChunkSize = FMath::Max(1, CVarSWSpawnableDecodeChunkSize.GetValueOnGameThread());
+	const int32 RTDims[] = { 64, 128, 256, 512, 1024 };
+
+	const FFloatInterval AltitudeRange(-1000000.f, 1000000.f);
+	const bool bUsePrecomputedTransform = false;
+
+	for (const int32 RTDim : RTDims)
+	{
+		if (RTDim > MaxRTDim)
+			break;
+
+		const int32 NumOfVertex = RTDim * RTDim;
+		const int32 NumChunks = FMath::DivideAndRoundUp(NumOfVertex, DecodeChunkSize);
+
+		// Same layout as the spawnable readbacks: 2x2 texels per instance, location X / Y / Z and rotation-scale
+		TArray<FColor> ReadData;
+		ReadData.SetNumUninitialized(NumOfVertex * 4);
+
+		FRandomStream RandomStream(RTDim);
+		for (FColor& Texel : ReadData)
+			Texel = FColor(RandomStream.RandRange(0, 255), RandomStream.RandRange(0, 255), RandomStream.RandRange(0, 255), RandomStream.RandRange(0, 255));
+
+		TArray<FInstancedStaticMeshInstanceData> Transforms;
+		Transforms.SetNum(NumOfVertex);
+
+		auto DecodeRange = [&](int32 Start, int32 End)
+		{
+			FInstancedStaticMeshInstanceData DefaultT;
+
+			for (int32 k = Start; k < End; k++)
+			{
+				const uint32 x2 = (k % RTDim) * 2;
+				const uint32 y2 = (k / RTDim) * 2;
+
+				const uint32 X_index = y2 * (RTDim * 2) + x2;
+				const uint32 Y_index = y2 * (RTDim * 2) + x2 + 1;
+				const uint32 Z_index = (y2 + 1) * (RTDim * 2) + x2;
+				const uint32 RotScale_index = (y2 + 1) * (RTDim * 2) + x2 + 1;
+
+				GetLocalTransformOfSpawnable(Transforms[k], FVector::ZeroVector, ReadData[X_index], ReadData[Y_index], ReadData[Z_index], ReadData[RotScale_index], DefaultT, bUsePrecomputedTransform, AltitudeRange, FVector::ZeroVector);
+			}
+		};
+
+		double SerialSeconds = 0.0;
+		double ChunkedSeconds = 0.0;
+
+		for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			double Start = FPlatformTime::Seconds();
+			DecodeRange(0, NumOfVertex);
+			SerialSeconds += FPlatformTime::Seconds() - Start;
+
+			Start = FPlatformTime::Seconds();
+			ParallelFor(NumChunks, [&](int32 Chunk)
+			{
+				DecodeRange(Chunk * DecodeChunkSize, FMath::Min(NumOfVertex, (Chunk + 1) * DecodeChunkSize));
+			});
+			ChunkedSeconds += FPlatformTime::Seconds() - Start;
+		}
+
+		SerialSeconds /= Iterations;
+		ChunkedSeconds /= Iterations;
+
+		UE_LOG(LogShaderWorld, Display, TEXT("SW spawnable decode | %7d instances | single thread %8.3fms | %5d chunks of %5d %8.3fms | x%.2f"),
+			NumOfVertex, SerialSeconds * 1000.0, NumChunks, DecodeChunkSize, ChunkedSeconds * 1000.0, ChunkedSeconds > 0.0 ? SerialSeconds / ChunkedSeconds : 0.0);
+	}
+}
+
+static FAutoConsoleCommand BenchmarkSpawnableDecodeCmd(
+	TEXT("sw.Spawnables.BenchmarkDecode"),
+	TEXT("Logs single threaded against chunked (sw.Spawnables.DecodeChunkSize) decode timings of synthetic spawnable readbacks. Optional arguments: max readback dimension (default 512), iterations (default 4)."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&AShaderWorldActor::BenchmarkSpawnableDecode)
+);
+
 bool AShaderWorldActor::ProcessSpawnablePending()
 {	
 	SW_FCT_CYCLE()
@@ -5183,15 +7631,31 @@ bool AShaderWorldActor::ProcessSpawnablePending()
 
 			Spawn.ProcessedRead->bProcessingCompleted = false;
 
-			Async(EAsyncExecution::TaskGraph, [RAPI = RendererAPI, Work = Spawn.SpawnableWorkQueue, CompletionAtomic = Spawn.ProcessedRead]
+			const int32 DecodeChunkSize = FMath::Max(1, CVarSWSpawnableDecodeChunkSize.GetValueOnGameThread());
+
+			if (!Spawn.DecodeCancellation.IsValid())
+				Spawn.DecodeCancellation = MakeShared<FSWTaskCancellation, ESPMode::ThreadSafe>();
+
+			FSWTaskDesc DecodeDesc;
+			DecodeDesc.DebugName = TEXT("SWSpawnableDecode");
+			DecodeDesc.Stage = ESWTaskStage::Decode;
+			DecodeDesc.Priority = Spawn.CollisionEnabled ? ESWTaskPriority::High : ESWTaskPriority::Normal;
+			DecodeDesc.Cancellation = Spawn.DecodeCancellation;
+
+			FSWTaskGraph::Get().Launch(DecodeDesc, [RAPI = RendererAPI, Work = Spawn.SpawnableWorkQueue, CompletionAtomic = Spawn.ProcessedRead, Cancellation = Spawn.DecodeCancellation, DecodeChunkSize]
 			{
+				SW_STAGE_SCOPE(SpawnableDecode)
 
-				FInstancedStaticMeshInstanceData DefaultT;
 				for(auto& W : Work)
 				{
+					// The spawnable was cleaned up, its work queue and completion are discarded
+					if (Cancellation->IsCancelled())
+						return;
+
 					if(W.bCollisionProcessingOverflow)
 						continue;
 
+					// Instance counts per HIM are known up front: size every output once, each instance then owns a unique slot
 					for (int i = 0; i < W.InstancesT->Transforms.Num(); i++)
 					{
 						TArray<FInstancedStaticMeshInstanceData>& T = W.InstancesT->Transforms[i];
@@ -5199,37 +7663,45 @@ bool AShaderWorldActor::ProcessSpawnablePending()
 					}
 
 					const int NumOfVertex = W.RTDim * W.RTDim;
+					const int32 NumChunks = FMath::DivideAndRoundUp(NumOfVertex, DecodeChunkSize);
 
-					for(int32 k=0; k< NumOfVertex;k++)
-					{						
-						FInstancedStaticMeshInstanceData& Tr = W.bUsePrecomputedTransform ? W.InstancesT->Transforms[W.InstanceIndexToHIMIndex->Indexes[k]][W.InstanceIndexToIndexForHIM->Indexes[k]] : DefaultT;
+					ParallelFor(NumChunks, [&](int32 Chunk)
+					{
+						FInstancedStaticMeshInstanceData DefaultT;
+
+						const int32 ChunkEnd = FMath::Min(NumOfVertex, (Chunk + 1) * DecodeChunkSize);
 
-						uint32 x = k % (W.RTDim);
-						uint32 y = k / (W.RTDim);
+						for(int32 k = Chunk * DecodeChunkSize; k < ChunkEnd; k++)
+						{						
+							FInstancedStaticMeshInstanceData& Tr = W.bUsePrecomputedTransform ? W.InstancesT->Transforms[W.InstanceIndexToHIMIndex->Indexes[k]][W.InstanceIndexToIndexForHIM->Indexes[k]] : DefaultT;
 
-						if (RAPI == EGeoRenderingAPI::OpenGL)
-							y = W.RTDim - 1 - y;
+							uint32 x = k % (W.RTDim);
+							uint32 y = k / (W.RTDim);
 
-						uint32 x2 = x * 2;
-						uint32 y2 = y * 2;
+							if (RAPI == EGeoRenderingAPI::OpenGL)
+								y = W.RTDim - 1 - y;
 
-						uint32 X_index = y2 * (W.RTDim * 2) + x2;
-						uint32 Y_index = y2 * (W.RTDim * 2) + x2 + 1;
-						uint32 Z_index = (y2 + 1) * (W.RTDim * 2) + x2;
-						uint32 RotScale_index = (y2 + 1) * (W.RTDim * 2) + x2 + 1;
+							uint32 x2 = x * 2;
+							uint32 y2 = y * 2;
+
+							uint32 X_index = y2 * (W.RTDim * 2) + x2;
+							uint32 Y_index = y2 * (W.RTDim * 2) + x2 + 1;
+							uint32 Z_index = (y2 + 1) * (W.RTDim * 2) + x2;
+							uint32 RotScale_index = (y2 + 1) * (W.RTDim * 2) + x2 + 1;
 
 						
-						if (RAPI == EGeoRenderingAPI::OpenGL)
-						{
-							X_index = (y2 + 1) * (W.RTDim * 2) + x2;
-							Y_index = (y2 + 1) * (W.RTDim * 2) + x2 + 1;
-							Z_index = (y2 ) * (W.RTDim * 2) + x2;
-							RotScale_index = (y2 ) * (W.RTDim * 2) + x2 + 1;
-						}						
+							if (RAPI == EGeoRenderingAPI::OpenGL)
+							{
+								X_index = (y2 + 1) * (W.RTDim * 2) + x2;
+								Y_index = (y2 + 1) * (W.RTDim * 2) + x2 + 1;
+								Z_index = (y2 ) * (W.RTDim * 2) + x2;
+								RotScale_index = (y2 ) * (W.RTDim * 2) + x2 + 1;
+							}						
 				
-						GetLocalTransformOfSpawnable((W.InstancesT->Transforms[W.InstanceIndexToHIMIndex->Indexes[k]])[W.InstanceIndexToIndexForHIM->Indexes[k]] , W.CompLocation, W.Read->ReadData[X_index], W.Read->ReadData[Y_index], W.Read->ReadData[Z_index], W.Read->ReadData[RotScale_index], Tr, W.bUsePrecomputedTransform, W.AltitudeRange, W.MeshLocCompute);
+							GetLocalTransformOfSpawnable((W.InstancesT->Transforms[W.InstanceIndexToHIMIndex->Indexes[k]])[W.InstanceIndexToIndexForHIM->Indexes[k]] , W.CompLocation, W.Read->ReadData[X_index], W.Read->ReadData[Y_index], W.Read->ReadData[Z_index], W.Read->ReadData[RotScale_index], Tr, W.bUsePrecomputedTransform, W.AltitudeRange, W.MeshLocCompute);
 												
-					}
+						}
+					});
 					
 				}
 				if(CompletionAtomic.IsValid())
@@ -5277,15 +7749,112 @@ void AShaderWorldActor::UpdateParentInnerMesh(int ChildLevel,EClipMapInteriorCon
 
 
 
+/*
+ * Collision slot churn: a square of tiles around the camera scrolls one column per step,
+ * every tile of the trailing column is released and reacquired on the leading one, as CollisionCPU does.
+ * The linear reference is the former release path: Remove from the used array and scan of the layout.
+ */
+static void BenchmarkCollisionSlots(const TArray<FString>& Args)
+{
+	const int32 MaxTilesPerSide = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 2) : 128;
+	const int32 Steps = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 256;
+	const int32 TilesPerSideList[] = { 8, 16, 32, 64, 128, 256 };
+
+	for (const int32 TilesPerSide : TilesPerSideList)
+	{
+		if (TilesPerSide > MaxTilesPerSide)
+			break;
+
+		const int32 NumTiles = TilesPerSide * TilesPerSide;
+
+		auto MakeShareable = [&]()
+		{
+			TSharedPtr<FSWCollisionManagementShareableData, ESPMode::ThreadSafe> CollData = MakeShared<FSWCollisionManagementShareableData, ESPMode::ThreadSafe>(100.f, 64);
+
+			for (int32 ID = 0; ID < NumTiles; ID++)
+			{
+				CollData->AddUsedCollisionMesh(ID);
+				CollData->GroundCollisionLayout.Add(FIntVector(ID % TilesPerSide, ID / TilesPerSide, 0), ID);
+			}
+
+			return CollData;
+		};
+
+		// Constant time path: swap-remove through the slot table, layout found from the tile cell
+		TSharedPtr<FSWCollisionManagementShareableData, ESPMode::ThreadSafe> CollData = MakeShareable();
+
+		double Start = FPlatformTime::Seconds();
+		for (int32 Step = 0; Step < Steps; Step++)
+		{
+			for (int32 Y = 0; Y < TilesPerSide; Y++)
+			{
+				const FIntVector Released(Step, Y, 0);
+				const int32 ID = CollData->GroundCollisionLayout.FindAndRemoveChecked(Released);
+				CollData->ReleaseCollisionMesh(ID);
+			}
+
+			for (int32 Y = 0; Y < TilesPerSide; Y++)
+			{
+				const int32 ID = CollData->AcquireCollisionMesh();
+				CollData->GroundCollisionLayout.Add(FIntVector(Step + TilesPerSide, Y, 0), ID);
+			}
+		}
+		const double SlotSeconds = FPlatformTime::Seconds() - Start;
+
+		const bool bConsistent = CollData->UsedCollisionMesh.Num() == NumTiles && CollData->AvailableCollisionMesh.Num() == 0 && CollData->GroundCollisionLayout.Num() == NumTiles;
+
+		// Linear reference
+		CollData = MakeShareable();
+
+		Start = FPlatformTime::Seconds();
+		for (int32 Step = 0; Step < Steps; Step++)
+		{
+			for (int32 Y = 0; Y < TilesPerSide; Y++)
+			{
+				const int32 ID = CollData->GroundCollisionLayout.FindChecked(FIntVector(Step, Y, 0));
+
+				CollData->AvailableCollisionMesh.Add(ID);
+				CollData->UsedCollisionMesh.Remove(ID);
+
+				for (auto It = CollData->GroundCollisionLayout.CreateConstIterator(); It; ++It)
+				{
+					if (It->Value == ID)
+					{
+						CollData->GroundCollisionLayout.Remove(It->Key);
+						break;
+					}
+				}
+			}
+
+			for (int32 Y = 0; Y < TilesPerSide; Y++)
+			{
+				const int32 ID = CollData->AvailableCollisionMesh.Pop(false);
+				CollData->UsedCollisionMesh.Add(ID);
+				CollData->GroundCollisionLayout.Add(FIntVector(Step + TilesPerSide, Y, 0), ID);
+			}
+		}
+		const double LinearSeconds = FPlatformTime::Seconds() - Start;
+
+		const int32 NumOperations = Steps * TilesPerSide;
+
+		UE_LOG(LogShaderWorld, Display, TEXT("SW collision slots | %6d tiles | %7d release+acquire | slot table %8.3fms (%6.1fns/op) | linear %8.3fms (%6.1fns/op)%s"),
+			NumTiles, NumOperations, SlotSeconds * 1000.0, SlotSeconds * 1e9 / NumOperations, LinearSeconds * 1000.0, LinearSeconds * 1e9 / NumOperations, bConsistent ? TEXT("") : TEXT(" | INCONSISTENT POOL"));
+	}
+}
+
+static FAutoConsoleCommand BenchmarkCollisionSlotsCmd(
+	TEXT("sw.Collision.BenchmarkSlots"),
+	TEXT("Logs collision tile release and acquire costs while a square of tiles scrolls, against the former linear release. Optional arguments: max tiles per side (default 128), scroll steps (default 256)."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkCollisionSlots)
+);
+
 FCollisionMeshElement& AShaderWorldActor::GetACollisionMesh()
 {
-	if (CollisionShareable->AvailableCollisionMesh.Num() > 0)
+	const int32 AvailableID = CollisionShareable->AcquireCollisionMesh();
+	if (AvailableID != INDEX_NONE)
 	{
-		FCollisionMeshElement& Elem = CollisionMesh[CollisionShareable->AvailableCollisionMesh[CollisionShareable->AvailableCollisionMesh.Num() - 1]];
+		FCollisionMeshElement& Elem = CollisionMesh[AvailableID];
 		UsedCollisionMesh.Add(Elem.ID);
-
-		CollisionShareable->UsedCollisionMesh.Add(Elem.ID);
-		CollisionShareable->AvailableCollisionMesh.RemoveAt(CollisionShareable->AvailableCollisionMesh.Num() - 1);
 		return Elem;
 	}
 
@@ -5297,15 +7866,19 @@ FCollisionMeshElement& AShaderWorldActor::GetACollisionMesh()
 
 	uint32 SizeT = (uint32)CollisionVerticesPerPatch;
 
-	RendertargetMemoryBudgetMB+=(SizeT*SizeT*4)/1000000.0f;
+	// Headless processes evaluate collision tiles on CPU only
+	if (!IsHeadlessProcess())
+	{
+		RendertargetMemoryBudgetMB+=(SizeT*SizeT*4)/1000000.0f;
 
-	SW_RT(NewElem.CollisionRT, World, SizeT,TF_Nearest, RTF_RGBA8)
+		SW_RT(NewElem.CollisionRT, World, SizeT,TF_Nearest, RTF_RGBA8)
 
-	if(NewElem.ID==0)
-	{
-		RendertargetMemoryBudgetMB += (SizeT * SizeT * 4) / 1000000.0f;
+		if(NewElem.ID==0)
+		{
+			RendertargetMemoryBudgetMB += (SizeT * SizeT * 4) / 1000000.0f;
 
-		SW_RT(NewElem.CollisionRT_Duplicate, World, SizeT, TF_Nearest, RTF_RGBA8)
+			SW_RT(NewElem.CollisionRT_Duplicate, World, SizeT, TF_Nearest, RTF_RGBA8)
+		}
 	}
 
 	NewElem.HeightData = MakeShared<FSWColorRead, ESPMode::ThreadSafe>();
@@ -5315,6 +7888,8 @@ FCollisionMeshElement& AShaderWorldActor::GetACollisionMesh()
 
 	NewElem.Mesh->SetCastShadow(false);
 	NewElem.Mesh->bUseAsyncCooking=true;
+	NewElem.Mesh->bUseHeightfieldCollision = bUseHeightfieldCollision;
+	NewElem.Mesh->SetHeightfieldLayout(CollisionVerticesPerPatch, CollisionVerticesPerPatch, CollisionResolution);
 	NewElem.Mesh->SetCanEverAffectNavigation(true);
 
 	NewElem.Mesh->SetSWWorldVersion(Shareable_ID);
@@ -5358,39 +7933,18 @@ FCollisionMeshElement& AShaderWorldActor::GetACollisionMesh()
 	
 
 	TSharedPtr<FSWShareableVerticePositionBuffer, ESPMode::ThreadSafe> Vertices = MakeShared<FSWShareableVerticePositionBuffer, ESPMode::ThreadSafe>();
-	TSharedPtr<FSWShareableIndexBuffer, ESPMode::ThreadSafe> Triangles = MakeShared<FSWShareableIndexBuffer, ESPMode::ThreadSafe>();
+	TSharedPtr<FSWShareableIndexBuffer, ESPMode::ThreadSafe> Triangles;
 
-	float Spacing = CollisionResolution;
-
-	if (NewElem.ID == 0)
-	{
-		TArray<FVector2f> UV;
-		CreateGridMeshWelded(CollisionVerticesPerPatch, CollisionVerticesPerPatch, Triangles, Vertices, UV, Spacing);
+	// Every collision tile shares the same cached topology, only positions are copied
+	if (!CollisionGridTopology.IsValid())
+		CollisionGridTopology = FSWGridTopologyCache::Get().FindOrCreateGrid(CollisionVerticesPerPatch, CollisionVerticesPerPatch, CollisionResolution);
 
-		//if (Triangles->Triangles_CollisionOnly.Num() != (Triangles->Indices.Num() / 3))
-		{
-			const int32 NumTriangles = Triangles->Indices.Num() / 3;
-			Triangles->Triangles_CollisionOnly.Empty();
-			Triangles->Triangles_CollisionOnly.Reserve(NumTriangles);
-			for (int32 TriIdx = 0; TriIdx < NumTriangles; TriIdx++)
-			{
-				FTriIndices& Triangle = Triangles->Triangles_CollisionOnly.AddDefaulted_GetRef();
-				Triangle.v0 = Triangles->Indices[(TriIdx * 3) + 0] /* + VertexBase */;
-				Triangle.v1 = Triangles->Indices[(TriIdx * 3) + 1] /* + VertexBase */;
-				Triangle.v2 = Triangles->Indices[(TriIdx * 3) + 2] /* + VertexBase */;
-			}
-		}
-	}
-	else
-	{
-		Vertices->Positions = CollisionMesh[0].Mesh->VerticesTemplate->Positions;
-		Vertices->Positions3f = CollisionMesh[0].Mesh->VerticesTemplate->Positions3f;
-		Vertices->MaterialIndices = CollisionMesh[0].Mesh->VerticesTemplate->MaterialIndices;
+	Vertices->Positions = CollisionGridTopology->Vertices->Positions;
+	Vertices->Positions3f = CollisionGridTopology->Vertices->Positions3f;
+	Vertices->MaterialIndices = CollisionGridTopology->Vertices->MaterialIndices;
+	Vertices->Bound = CollisionGridTopology->Vertices->Bound;
 
-		Triangles = CollisionMesh[0].Mesh->TrianglesTemplate;
-		//Triangles->Indices = CollisionMesh[0].Mesh->TrianglesTemplate->Indices;
-		//Triangles->Triangles_CollisionOnly = CollisionMesh[0].Mesh->TrianglesTemplate->Triangles_CollisionOnly;
-	}
+	Triangles = CollisionGridTopology->Triangles;
 
 	NewElem.Mesh->CreateMeshSection(0,Vertices,Triangles,false);
 
@@ -5408,6 +7962,7 @@ FCollisionMeshElement& AShaderWorldActor::GetACollisionMesh()
 		NewElem.Mesh->VerticesTemplate->Positions = Vertices->Positions;
 		NewElem.Mesh->VerticesTemplate->Positions3f = Vertices->Positions3f;
 		NewElem.Mesh->VerticesTemplate->MaterialIndices = Vertices->MaterialIndices;
+		NewElem.Mesh->VerticesTemplate->Bound = Vertices->Bound;
 
 		NewElem.Mesh->TrianglesTemplate = Triangles;
 		/*
@@ -5425,9 +7980,11 @@ FCollisionMeshElement& AShaderWorldActor::GetACollisionMesh()
 	}
 	else
 	{		
-		UMaterialInstanceDynamic* DynColMat = UMaterialInstanceDynamic::Create(CollisionMat.Get(), this);
-		DynColMat->SetScalarParameterValue("MakeCollisionVisible", CollisionVisible?1.f:0.f);
-		NewElem.Mesh->SetMaterialFromOwner(0, DynColMat);		
+		if (!CollisionDisplayMaterial)
+			CollisionDisplayMaterial = AcquireMaterialInstance(CollisionMat.Get());
+
+		CollisionDisplayMaterial->SetScalarParameterValue("MakeCollisionVisible", CollisionVisible?1.f:0.f);
+		NewElem.Mesh->SetMaterialFromOwner(0, CollisionDisplayMaterial);		
 	}
 
 	
@@ -5437,7 +7994,7 @@ FCollisionMeshElement& AShaderWorldActor::GetACollisionMesh()
 	{
 		UsedCollisionMesh.Add(NewElem.ID);
 
-		CollisionShareable->UsedCollisionMesh.Add(NewElem.ID);
+		CollisionShareable->AddUsedCollisionMesh(NewElem.ID);
 
 		CollisionShareable->CollisionMeshData.Add(NewElem);
 	}
@@ -5459,6 +8016,27 @@ void AShaderWorldActor::ProcessSeeds()
 	{
 		SeedGenerator->GenerateSeed(CurrentSeedsArray);
 	}
+
+	UpdateHeightEvaluator();
+}
+
+void AShaderWorldActor::UpdateHeightEvaluator()
+{
+	HeightEvaluator = HeightGenerator ? HeightGenerator->CreateEvaluator(CurrentSeedsArray) : nullptr;
+
+	if (!HeightEvaluator.IsValid())
+		return;
+
+	HeightEvaluator->HeightScale = HeightScale;
+
+	if (BrushManager)
+		HeightEvaluator->bBrushStackComplete = BrushManager->GatherCPUBrushStack(HeightEvaluator->BrushStack);
+}
+
+bool AShaderWorldActor::CanUseCPUHeightEvaluation() const
+{
+	// Physical material IDs read from a data layer are only available on GPU
+	return HeightEvaluator.IsValid() && HeightEvaluator->MirrorsBrushStack() && !(bExportPhysicalMaterialID_cached && (LayerStoringMaterialID != ""));
 }
 
 void AShaderWorldActor::InitiateWorld()
@@ -5561,97 +8139,6 @@ void AShaderWorldActor::InitiateWorld()
 
 	Segmented_Initialized=false;
 
-	{
-		if(ReadRequestLocation)
-		{
-			ReadRequestLocation = nullptr;
-		}
-		if (ReadRequestLocationHeightmap)
-		{
-			ReadRequestLocationHeightmap = nullptr;
-		}
-		if (GeneratorDynamicForReadBack)
-		{
-			GeneratorDynamicForReadBack = nullptr;
-		}
-		
-		RendertargetMemoryBudgetMB += 4 * 2 * (5 * 5) / 1000000.0f;
-		SW_RT(ReadRequestLocation, World, 5, TF_Nearest, RTF_RG32f)
-
-		RendertargetMemoryBudgetMB += 4 * (5 * 5) / 1000000.0f;
-		SW_RT(ReadRequestLocationHeightmap, World, 5, TF_Nearest, RTF_RGBA8)
-
-		if(!Generator)
-		{
-#if SWDEBUG
-			SW_LOG("Generator Material not available for Shader World %s", *GetName())
-#endif
-		}
-		else
-		{
-			
-			GeneratorDynamicForReadBack = UMaterialInstanceDynamic::Create(Generator.Get(), this);
-
-			GeneratorDynamicForReadBack->SetScalarParameterValue("HeightReadBack", 1.f);
-			GeneratorDynamicForReadBack->SetTextureParameterValue("SpecificLocationsRT", ReadRequestLocation);
-
-			GeneratorDynamicForReadBack->SetScalarParameterValue("NoMargin", 0.f);
-			GeneratorDynamicForReadBack->SetScalarParameterValue("N", N);
-			GeneratorDynamicForReadBack->SetScalarParameterValue("LOD0GridSpacing", pow(2.0, -(LOD_Num - 1))* GridSpacing);
-
-			GeneratorDynamicForReadBack->SetScalarParameterValue("NormalMapSelect", 0.f);
-			GeneratorDynamicForReadBack->SetScalarParameterValue("HeightMapToggle", 1.f);
-
-			TSet<FName> UsedNames;
-			for (const FInstancedStruct& Seed : CurrentSeedsArray.SeedsArray)
-			{
-				if (Seed.IsValid())
-				{
-					const UScriptStruct* Type = Seed.GetScriptStruct();
-					CA_ASSUME(Type);
-					if (Type->IsChildOf(FTextureSeed::StaticStruct()))
-					{
-						FTextureSeed& TypedSeed = Seed.GetMutable<FTextureSeed>();
-						if (!UsedNames.Contains(TypedSeed.SeedName))
-						{
-							UsedNames.Add(TypedSeed.SeedName);
-							GeneratorDynamicForReadBack->SetTextureParameterValue(TypedSeed.SeedName, TypedSeed.Value);
-						}
-					}
-					else if (Type->IsChildOf(FLinearColorSeed::StaticStruct()))
-					{
-						FLinearColorSeed& TypedSeed = Seed.GetMutable<FLinearColorSeed>();
-						if (!UsedNames.Contains(TypedSeed.SeedName))
-						{
-							UsedNames.Add(TypedSeed.SeedName);
-							GeneratorDynamicForReadBack->SetVectorParameterValue(TypedSeed.SeedName, TypedSeed.Value);
-						}
-					}
-					else if (Type->IsChildOf(FScalarSeed::StaticStruct()))
-					{
-						FScalarSeed& TypedSeed = Seed.GetMutable<FScalarSeed>();
-						if (!UsedNames.Contains(TypedSeed.SeedName))
-						{
-							UsedNames.Add(TypedSeed.SeedName);
-							GeneratorDynamicForReadBack->SetScalarParameterValue(TypedSeed.SeedName, TypedSeed.Value);
-						}
-					}
-					else
-					{
-#if SWDEBUG
-						SW_LOG("Invalid Seed type found: '%s'", *GetPathNameSafe(Type));
-#endif
-						
-					}
-				}
-			}
-			
-		}
-
-		//CollisionSampleLocation = UKismetRenderingLibrary::CreateRenderTarget2D(GetWorld(), CollisionVerticesPerPatch, CollisionVerticesPerPatch, RTF_RGBA16f, FLinearColor(0, 0, 0, 1), false);
-		//FVector CollisionPatchExtent = CollisionResolution * (CollisionVerticesPerPatch - 1) / 2.f * FVector(1.f, 1.f, 0.f);
-	}
-	
 	bExportPhysicalMaterialID_cached = bExportPhysicalMaterialID;
 
 	for(int i=0; i<LOD_Num;i++)
@@ -5721,6 +8208,9 @@ void AShaderWorldActor::InitiateWorld()
 					CacheGroup.CacheManager = { Optimal };
 					CacheGroup.ManagerInitiated = true;
 				}
+
+				CacheGroup.MemoryBudgetMB = TransientCacheMemoryBudgetMB;
+				RendertargetMemoryBudgetMB += TransientCacheMemoryBudgetMB;
 			}
 
 			/*
@@ -5851,8 +8341,8 @@ void AShaderWorldActor::InitiateWorld()
 		}
 
 		TArray<FVector3f> Vertices;
-		TSharedPtr<FSWShareableIndexBuffer, ESPMode::ThreadSafe> Triangles = MakeShared<FSWShareableIndexBuffer>();
-		TSharedPtr<FSWShareableIndexBuffer, ESPMode::ThreadSafe> TrianglesAlt = MakeShared<FSWShareableIndexBuffer>();
+		TSharedPtr<FSWShareableIndexBuffer, ESPMode::ThreadSafe> Triangles;
+		TSharedPtr<FSWShareableIndexBuffer, ESPMode::ThreadSafe> TrianglesAlt;
 		TArray<FVector2f> UV;
 		TArray<FVector2f> UV1;
 		TArray<FVector2f> UV2;
@@ -5871,7 +8361,29 @@ void AShaderWorldActor::InitiateWorld()
 		uint8 StichingProfile = 1<<3|1<<2|1<<1|1;
 
 		
-		CreateGridMeshWelded(0,N,N,Triangles, TrianglesAlt,Vertices,UV,UV1,UV2,NewElem.GridSpacing,LocalOffset,StichingProfile);
+		/*
+		 * Section index buffers only depend on N and the alternate topology, not on the LOD grid spacing:
+		 * built once, then shared by every LOD through FSWGridTopologyCache.
+		 */
+		bool bBuildIndices = false;
+		auto AcquireSectionIndices = [&](int32 Section)
+		{
+			bBuildIndices = !FSWGridTopologyCache::Get().FindClipMapSection(N, Section, UpdateHOverTime, Triangles, TrianglesAlt);
+
+			if (bBuildIndices)
+			{
+				Triangles = MakeShared<FSWShareableIndexBuffer>();
+				TrianglesAlt = MakeShared<FSWShareableIndexBuffer>();
+			}
+		};
+		auto ShareSectionIndices = [&](int32 Section)
+		{
+			if (bBuildIndices)
+				FSWGridTopologyCache::Get().AddClipMapSection(N, Section, UpdateHOverTime, Triangles, TrianglesAlt);
+		};
+
+		AcquireSectionIndices(0);
+		CreateGridMeshWelded(0,N,N,Triangles, TrianglesAlt,Vertices,UV,UV1,UV2,NewElem.GridSpacing,LocalOffset,StichingProfile, bBuildIndices);
 
 			
 		TArray<FVector> Normals;
@@ -5879,6 +8391,8 @@ void AShaderWorldActor::InitiateWorld()
 		TArray<FGeoCProcMeshTangent> Tangents;
 		Tangents.Init(FGeoCProcMeshTangent(FVector(0.f, 0.f, 1.f), false), Vertices.Num());
 
+		ShareSectionIndices(0);
+
 		if(NewElem.Mesh)
 		NewElem.Mesh->CreateMeshSection(0,Vertices,Triangles, TrianglesAlt, Normals,UV,UV1,UV2,UV_dummy,Color_dummy,Tangents,false);
 		
@@ -5886,54 +8400,54 @@ void AShaderWorldActor::InitiateWorld()
 		{
 		Vertices.Empty();
 		//Triangles.Empty();
-		Triangles = MakeShared<FSWShareableIndexBuffer>();
-		TrianglesAlt = MakeShared<FSWShareableIndexBuffer>();
+		AcquireSectionIndices(1);
 		UV.Empty();
 		UV1.Empty();
 		UV2.Empty();
 		
 		StichingProfile = 1<<3|1<<2|1<<1;
 
-		CreateGridMeshWelded(0,N,3,Triangles, TrianglesAlt, Vertices,UV,UV1,UV2,NewElem.GridSpacing,LocalOffset,StichingProfile);
+		CreateGridMeshWelded(0,N,3,Triangles, TrianglesAlt, Vertices,UV,UV1,UV2,NewElem.GridSpacing,LocalOffset,StichingProfile, bBuildIndices);
 
 		
 		StichingProfile = 0;
 		LocalOffset = FVector(-LocalExtent,-LocalExtent,0.f) + 2.f*NewElem.GridSpacing*FVector(0.f,1.f,0.f)  + (LocalM-1)*NewElem.GridSpacing*FVector(1.f,0.f,0.f);
 
-		CreateGridMeshWelded(1,(LocalM-1)*2+3,(LocalM-1)-2+1, Triangles, TrianglesAlt, Vertices, UV, UV1,UV2, NewElem.GridSpacing, LocalOffset, StichingProfile);
+		CreateGridMeshWelded(1,(LocalM-1)*2+3,(LocalM-1)-2+1, Triangles, TrianglesAlt, Vertices, UV, UV1,UV2, NewElem.GridSpacing, LocalOffset, StichingProfile, bBuildIndices);
 		LocalOffset = FVector(-LocalExtent,-LocalExtent,0.f) + ((LocalM-1)*3 + 2)*NewElem.GridSpacing*FVector(0.f,1.f,0.f)  + (LocalM-1)*NewElem.GridSpacing*FVector(1.f,0.f,0.f);
 
-		CreateGridMeshWelded(0,(LocalM-1)*2+3, (LocalM-1)-2+1, Triangles, TrianglesAlt, Vertices, UV, UV1,UV2, NewElem.GridSpacing, LocalOffset, StichingProfile);
+		CreateGridMeshWelded(0,(LocalM-1)*2+3, (LocalM-1)-2+1, Triangles, TrianglesAlt, Vertices, UV, UV1,UV2, NewElem.GridSpacing, LocalOffset, StichingProfile, bBuildIndices);
 		
 		
 		StichingProfile = 1<<3|1<<2|1;
 		LocalOffset = FVector(-LocalExtent, -LocalExtent, 0.f)+ ((N-1) - 2) *NewElem.GridSpacing*FVector(0.f,1.f,0.f);
 
-		CreateGridMeshWelded(0,N,3,Triangles, TrianglesAlt, Vertices,UV,UV1,UV2,NewElem.GridSpacing,LocalOffset,StichingProfile);
+		CreateGridMeshWelded(0,N,3,Triangles, TrianglesAlt, Vertices,UV,UV1,UV2,NewElem.GridSpacing,LocalOffset,StichingProfile, bBuildIndices);
 		
 		StichingProfile = 1<<3;
 		LocalOffset = FVector(-LocalExtent,-LocalExtent,0.f) + (2) * NewElem.GridSpacing * FVector(0.f, 1.f, 0.f);
 
-		CreateGridMeshWelded(0,LocalM, N-4 /*LocalM*2+1+2*/, Triangles, TrianglesAlt, Vertices, UV,UV1,UV2, NewElem.GridSpacing, LocalOffset,StichingProfile);
+		CreateGridMeshWelded(0,LocalM, N-4 /*LocalM*2+1+2*/, Triangles, TrianglesAlt, Vertices, UV,UV1,UV2, NewElem.GridSpacing, LocalOffset,StichingProfile, bBuildIndices);
 
 		StichingProfile = 1<<2;
 		LocalOffset = FVector(-LocalExtent, -LocalExtent, 0.f) + (2) * NewElem.GridSpacing * FVector(0.f, 1.f, 0.f) + ((LocalM - 1)*3+2) * NewElem.GridSpacing * FVector(1.f, 0.f, 0.f) ;
 
-		CreateGridMeshWelded(1,LocalM, N-4/*LocalM*2+1 +2*/, Triangles, TrianglesAlt, Vertices, UV,UV1,UV2, NewElem.GridSpacing, LocalOffset,StichingProfile);
+		CreateGridMeshWelded(1,LocalM, N-4/*LocalM*2+1 +2*/, Triangles, TrianglesAlt, Vertices, UV,UV1,UV2, NewElem.GridSpacing, LocalOffset,StichingProfile, bBuildIndices);
 
 		Normals.Empty();
 		Normals.Init(FVector(0.f, 0.f, 1.f), Vertices.Num());
 		Tangents.Empty();
 		Tangents.Init(FGeoCProcMeshTangent(FVector(0.f, 0.f, 1.f), false), Vertices.Num());
 
+		ShareSectionIndices(1);
+
 		if(NewElem.Mesh)
 		NewElem.Mesh->CreateMeshSection(1, Vertices, Triangles, TrianglesAlt, Normals, UV, UV1, UV2, UV_dummy, Color_dummy, Tangents, false);
 
 
 		Vertices.Empty();
 		//Triangles.Empty();
-		Triangles = MakeShared<FSWShareableIndexBuffer>();
-		TrianglesAlt = MakeShared<FSWShareableIndexBuffer>();
+		AcquireSectionIndices(2);
 		UV.Empty();
 		UV1.Empty();
 		UV2.Empty();
@@ -5942,11 +8456,11 @@ void AShaderWorldActor::InitiateWorld()
 
 		LocalOffset = FVector(-LocalExtent, -LocalExtent, 0.f) + ((LocalM - 1)) * NewElem.GridSpacing * FVector(1.f, 1.f, 0.f);
 
-		CreateGridMeshWelded(0,LocalM*2+1, 2, Triangles, TrianglesAlt, Vertices, UV,UV1,UV2, NewElem.GridSpacing, LocalOffset,StichingProfile);
+		CreateGridMeshWelded(0,LocalM*2+1, 2, Triangles, TrianglesAlt, Vertices, UV,UV1,UV2, NewElem.GridSpacing, LocalOffset,StichingProfile, bBuildIndices);
 
 		LocalOffset = FVector(-LocalExtent, -LocalExtent, 0.f) + ((LocalM - 1)) * NewElem.GridSpacing * FVector(1.f, 1.f, 0.f) + (1.0) * NewElem.GridSpacing * FVector(0.f, 1.f, 0.f);
 
-		CreateGridMeshWelded(1,2, LocalM * 2, Triangles, TrianglesAlt, Vertices, UV,UV1,UV2, NewElem.GridSpacing, LocalOffset,StichingProfile);
+		CreateGridMeshWelded(1,2, LocalM * 2, Triangles, TrianglesAlt, Vertices, UV,UV1,UV2, NewElem.GridSpacing, LocalOffset,StichingProfile, bBuildIndices);
 
 		Normals.Empty();
 		Normals.Init(FVector(0.f, 0.f, 1.f), Vertices.Num());
@@ -5954,25 +8468,26 @@ void AShaderWorldActor::InitiateWorld()
 		Tangents.Init(FGeoCProcMeshTangent(FVector(0.f, 0.f, 1.f), false), Vertices.Num());
 		
 		// botleft
+		ShareSectionIndices(2);
+
 		if(NewElem.Mesh)
 		NewElem.Mesh->CreateMeshSection(2, Vertices, Triangles, TrianglesAlt, Normals, UV, UV1, UV2, UV_dummy, Color_dummy, Tangents, false);
 
 
 		Vertices.Empty();
 		//Triangles.Empty();
-		Triangles = MakeShared<FSWShareableIndexBuffer>();
-		TrianglesAlt = MakeShared<FSWShareableIndexBuffer>();
+		AcquireSectionIndices(3);
 		UV.Empty();
 		UV1.Empty();
 		UV2.Empty();
 
 		LocalOffset = FVector(-LocalExtent, -LocalExtent, 0.f) + ((LocalM - 1)) * NewElem.GridSpacing * FVector(1.f, 1.f, 0.f);
 
-		CreateGridMeshWelded(0,LocalM * 2 + 1, 2, Triangles, TrianglesAlt, Vertices, UV,UV1,UV2, NewElem.GridSpacing, LocalOffset,StichingProfile);
+		CreateGridMeshWelded(0,LocalM * 2 + 1, 2, Triangles, TrianglesAlt, Vertices, UV,UV1,UV2, NewElem.GridSpacing, LocalOffset,StichingProfile, bBuildIndices);
 
 		LocalOffset = FVector(-LocalExtent, -LocalExtent, 0.f) + ((LocalM - 1)) * NewElem.GridSpacing * FVector(1.f, 1.f, 0.f) + (1.0) * NewElem.GridSpacing * FVector(0.f, 1.f, 0.f)+ (LocalM *2 -1) * NewElem.GridSpacing * FVector(1.f, 0.f, 0.f);
 
-		CreateGridMeshWelded(0,2, LocalM * 2, Triangles, TrianglesAlt, Vertices, UV,UV1,UV2, NewElem.GridSpacing, LocalOffset,StichingProfile);
+		CreateGridMeshWelded(0,2, LocalM * 2, Triangles, TrianglesAlt, Vertices, UV,UV1,UV2, NewElem.GridSpacing, LocalOffset,StichingProfile, bBuildIndices);
 
 		Normals.Empty();
 		Normals.Init(FVector(0.f, 0.f, 1.f), Vertices.Num());
@@ -5980,25 +8495,26 @@ void AShaderWorldActor::InitiateWorld()
 		Tangents.Init(FGeoCProcMeshTangent(FVector(0.f, 0.f, 1.f), false), Vertices.Num());
 		
 		// topleft
+		ShareSectionIndices(3);
+
 		if(NewElem.Mesh)
 		NewElem.Mesh->CreateMeshSection(3, Vertices, Triangles, TrianglesAlt, Normals, UV, UV1, UV2, UV_dummy, Color_dummy, Tangents, false);
 
 
 		Vertices.Empty();
 		//Triangles.Empty();
-		Triangles = MakeShared<FSWShareableIndexBuffer>();
-		TrianglesAlt = MakeShared<FSWShareableIndexBuffer>();
+		AcquireSectionIndices(4);
 		UV.Empty();
 		UV1.Empty();
 		UV2.Empty();
 
 		LocalOffset = FVector(-LocalExtent, -LocalExtent, 0.f) + ((LocalM - 1)) * NewElem.GridSpacing * FVector(1.f, 1.f, 0.f);
 
-		CreateGridMeshWelded(0,2, LocalM * 2 + 1, Triangles, TrianglesAlt, Vertices, UV,UV1,UV2, NewElem.GridSpacing, LocalOffset,StichingProfile);
+		CreateGridMeshWelded(0,2, LocalM * 2 + 1, Triangles, TrianglesAlt, Vertices, UV,UV1,UV2, NewElem.GridSpacing, LocalOffset,StichingProfile, bBuildIndices);
 
 		LocalOffset = FVector(-LocalExtent, -LocalExtent, 0.f) + ((LocalM - 1)) * NewElem.GridSpacing * FVector(1.f, 1.f, 0.f) + (LocalM*2.0-1.0) * NewElem.GridSpacing * FVector(0.f, 1.f, 0.f)+ (1.0) * NewElem.GridSpacing * FVector(1.f, 0.f, 0.f);
 
-		CreateGridMeshWelded(0,LocalM * 2, 2, Triangles, TrianglesAlt, Vertices, UV,UV1,UV2, NewElem.GridSpacing, LocalOffset,StichingProfile);
+		CreateGridMeshWelded(0,LocalM * 2, 2, Triangles, TrianglesAlt, Vertices, UV,UV1,UV2, NewElem.GridSpacing, LocalOffset,StichingProfile, bBuildIndices);
 
 		Normals.Empty();
 		Normals.Init(FVector(0.f, 0.f, 1.f), Vertices.Num());
@@ -6006,25 +8522,26 @@ void AShaderWorldActor::InitiateWorld()
 		Tangents.Init(FGeoCProcMeshTangent(FVector(0.f, 0.f, 1.f), false), Vertices.Num());
 		
 		// botright
+		ShareSectionIndices(4);
+
 		if(NewElem.Mesh)
 		NewElem.Mesh->CreateMeshSection(4, Vertices, Triangles, TrianglesAlt, Normals, UV, UV1, UV2, UV_dummy, Color_dummy, Tangents, false);
 
 
 		Vertices.Empty();
 		//Triangles.Empty();
-		Triangles = MakeShared<FSWShareableIndexBuffer>();
-		TrianglesAlt = MakeShared<FSWShareableIndexBuffer>();
+		AcquireSectionIndices(5);
 		UV.Empty();
 		UV1.Empty();
 		UV2.Empty();
 
 		LocalOffset = FVector(-LocalExtent, -LocalExtent, 0.f) + ((LocalM - 1)) * NewElem.GridSpacing * FVector(1.f, 1.f, 0.f)+ (LocalM * 2.0 - 1.0) * NewElem.GridSpacing * FVector(1.f, 0.f, 0.f);
 
-		CreateGridMeshWelded(1,2, LocalM * 2 + 1, Triangles, TrianglesAlt, Vertices, UV,UV1,UV2, NewElem.GridSpacing, LocalOffset,StichingProfile);
+		CreateGridMeshWelded(1,2, LocalM * 2 + 1, Triangles, TrianglesAlt, Vertices, UV,UV1,UV2, NewElem.GridSpacing, LocalOffset,StichingProfile, bBuildIndices);
 
 		LocalOffset = FVector(-LocalExtent, -LocalExtent, 0.f) + ((LocalM - 1)) * NewElem.GridSpacing * FVector(1.f, 1.f, 0.f) + (LocalM * 2.0 - 1.0) * NewElem.GridSpacing * FVector(0.f, 1.f, 0.f);
 
-		CreateGridMeshWelded(1,LocalM * 2, 2, Triangles, TrianglesAlt, Vertices, UV,UV1,UV2, NewElem.GridSpacing, LocalOffset,StichingProfile);
+		CreateGridMeshWelded(1,LocalM * 2, 2, Triangles, TrianglesAlt, Vertices, UV,UV1,UV2, NewElem.GridSpacing, LocalOffset,StichingProfile, bBuildIndices);
 
 		Normals.Empty();
 		Normals.Init(FVector(0.f, 0.f, 1.f), Vertices.Num());
@@ -6032,6 +8549,8 @@ void AShaderWorldActor::InitiateWorld()
 		Tangents.Init(FGeoCProcMeshTangent(FVector(0.f, 0.f, 1.f), false), Vertices.Num());
 		
 		// topright
+		ShareSectionIndices(5);
+
 		if(NewElem.Mesh)
 		NewElem.Mesh->CreateMeshSection(5, Vertices, Triangles, TrianglesAlt, Normals, UV, UV1, UV2, UV_dummy, Color_dummy, Tangents, false);
 
@@ -8130,7 +10649,8 @@ void FSpawnableMesh::UpdateSpawnableData(FSWBiom& Biom,FSpawnableMeshElement& Me
 
 		//OPTION A : Compute collision from GPU readback
 
-		UMaterialInstanceDynamic* DynSpawnMat = MeshElem.ComputeSpawnTransformDyn ? MeshElem.ComputeSpawnTransformDyn : (UMaterialInstanceDynamic::Create(CustomSpawnablesMat.Get() ? CustomSpawnablesMat.Get() : (Biom.BiomDensitySpawner.Get() ? Biom.BiomDensitySpawner.Get() : Owner->SpawnablesMat), Owner));
+		// Only kept by MeshElem once fully set up from a clipmap level, otherwise given back to the pool after the draw
+		UMaterialInstanceDynamic* DynSpawnMat = MeshElem.ComputeSpawnTransformDyn ? MeshElem.ComputeSpawnTransformDyn : Owner->AcquireMaterialInstance(CustomSpawnablesMat.Get() ? CustomSpawnablesMat.Get() : (Biom.BiomDensitySpawner.Get() ? Biom.BiomDensitySpawner.Get() : Owner->SpawnablesMat));
 		
 		bool Segmented = Owner->UseSegmented();
 
@@ -8298,6 +10818,10 @@ void FSpawnableMesh::UpdateSpawnableData(FSWBiom& Biom,FSpawnableMeshElement& Me
 			else
 			{
 				UE_LOG(LogTemp, Warning, TEXT("Elem.IsSectionVisible(0)||Elem.IsSectionVisible(1)"));
+
+				if (DynSpawnMat != MeshElem.ComputeSpawnTransformDyn)
+					Owner->ReleaseMaterialInstance(DynSpawnMat);
+
 				return;
 
 			}
@@ -8336,6 +10860,10 @@ void FSpawnableMesh::UpdateSpawnableData(FSWBiom& Biom,FSpawnableMeshElement& Me
 			//if (Owner->SWorldSubsystem)
 			//	Owner->SWorldSubsystem->DrawMaterialToRT(Owner, DynSpawnMat, MeshElem.SpawnDensity);
 
+			// The draw is already enqueued, clearing the parameters on release is ordered after it
+			if (DynSpawnMat != MeshElem.ComputeSpawnTransformDyn)
+				Owner->ReleaseMaterialInstance(DynSpawnMat);
+
 
 			MeshElem.SpawnData = MakeShared<FSWColorRead, ESPMode::ThreadSafe>();
 			MeshElem.SpawnData->ReadData.Empty();
@@ -9302,6 +11830,8 @@ void FSpawnableMesh::CleanUp()
 		El.SpawnDensity = nullptr;
 		El.SpawnTransforms = nullptr;
 
+		if (IsValid(Owner))
+			Owner->ReleaseMaterialInstance(El.ComputeSpawnTransformDyn);
 		El.ComputeSpawnTransformDyn=nullptr;
 		El.LOD_usedLastUpdate=-1;
 
@@ -9424,6 +11954,12 @@ void FSpawnableMesh::CleanUp()
 	ProcessedRead.Reset();
 	ProcessedRead = nullptr;
 
+	if (DecodeCancellation.IsValid())
+		DecodeCancellation->Cancel();
+	DecodeCancellation = nullptr;
+
+	FinalizeBatchSize = 0;
+
 	InstanceIndexToHIMIndex->Indexes.Empty();
 	NumInstancePerHIM->Indexes.Empty();
 	InstanceIndexToIndexForHIM->Indexes.Empty();	
@@ -9497,6 +12033,8 @@ FSpawnableMesh::~FSpawnableMesh()
 		El.SpawnDensity = nullptr;
 		El.SpawnTransforms = nullptr;
 
+		if (Owner && IsValid(Owner))
+			Owner->ReleaseMaterialInstance(El.ComputeSpawnTransformDyn);
 		El.ComputeSpawnTransformDyn = nullptr;
 		El.LOD_usedLastUpdate = -1;
 
@@ -9622,6 +12160,12 @@ FSpawnableMesh::~FSpawnableMesh()
 	ProcessedRead.Reset();
 	ProcessedRead = nullptr;
 
+	if (DecodeCancellation.IsValid())
+		DecodeCancellation->Cancel();
+	DecodeCancellation = nullptr;
+
+	FinalizeBatchSize = 0;
+
 	InstanceIndexToHIMIndex->Indexes.Empty();
 	NumInstancePerHIM->Indexes.Empty();
 	InstanceIndexToIndexForHIM->Indexes.Empty();
@@ -32,6 +32,7 @@
 #include "SWStats.h"
 #include "Engine/TextureRenderTarget2D.h"
 #include "Kismet/KismetRenderingLibrary.h"
+#include "Engine/Canvas.h"
 #include "Components/BoxComponent.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "Actor/ShaderWorldActor.h"
@@ -508,8 +509,7 @@ void AShaderWorldBrush::ApplyBrushAt(UTextureRenderTarget2D* Destination_RT,UTex
 			LayerBrushMaterialDyn->SetScalarParameterValue("N", N);
 			LayerBrushMaterialDyn->SetScalarParameterValue("Collision", 0.f);
 			
-			UKismetRenderingLibrary::ClearRenderTarget2D(this, Destination_RT, FLinearColor::Black);
-			UKismetRenderingLibrary::DrawMaterialToRenderTarget(this, Destination_RT, LayerBrushMaterialDyn);
+			DrawBrushMaterial(LayerBrushMaterialDyn, Destination_RT, Source_RT);
 		}		
 
 		return;
@@ -670,17 +670,56 @@ void AShaderWorldBrush::ApplyBrushAt(UTextureRenderTarget2D* Destination_RT,UTex
 	BrushMaterialDyn->SetScalarParameterValue("CacheRes", CollisionMesh ? Source_RT->SizeX : Source_RT->SizeX - 2);
 	BrushMaterialDyn->SetScalarParameterValue("LocalGridScaling", GridScaling);
 	BrushMaterialDyn->SetScalarParameterValue("N", N);
-	
-	UKismetRenderingLibrary::ClearRenderTarget2D(this, Destination_RT, FLinearColor::Black);
 
 #if SW_COMPUTE_GENERATION
-
+	UKismetRenderingLibrary::ClearRenderTarget2D(this, Destination_RT, FLinearColor::Black);
 #else
-	UKismetRenderingLibrary::DrawMaterialToRenderTarget(this, Destination_RT, BrushMaterialDyn);
+	DrawBrushMaterial(BrushMaterialDyn, Destination_RT, Source_RT);
 #endif
 
 
 
+}
+
+void AShaderWorldBrush::DrawBrushMaterial(UMaterialInterface* Material, UTextureRenderTarget2D* Destination_RT, UTextureRenderTarget2D* Source_RT)
+{
+	const FIntPoint Size(Destination_RT->SizeX, Destination_RT->SizeY);
+
+	const bool bPartialDraw = Source_RT && Source_RT->SizeX == Size.X && Source_RT->SizeY == Size.Y
+							&& PendingDrawRects.Num() > 0 && !PendingDrawRects.Contains(FIntRect(FIntPoint::ZeroValue, Size));
+
+	if (bPartialDraw)
+	{
+		USWorldSubsystem* ShaderWorldSubsystem = GetWorld()->GetSubsystem<USWorldSubsystem>();
+
+		// The brush material outputs the source height outside of its influence: copy it, then only evaluate the touched texels
+		if (ShaderWorldSubsystem && ShaderWorldSubsystem->CopyAtoB(Source_RT, Destination_RT))
+		{
+			UCanvas* Canvas = nullptr;
+			FVector2D CanvasSize;
+			FDrawToRenderTargetContext Context;
+			UKismetRenderingLibrary::BeginDrawCanvasToRenderTarget(this, Destination_RT, Canvas, CanvasSize, Context);
+
+			if (Canvas)
+			{
+				for (const FIntRect& Rect : PendingDrawRects)
+				{
+					if (Rect.Area() <= 0)
+						continue;
+
+					const FVector2D RectMin(Rect.Min);
+					const FVector2D RectSize(Rect.Size());
+					Canvas->K2_DrawMaterial(Material, RectMin, RectSize, RectMin / FVector2D(Size), RectSize / FVector2D(Size));
+				}
+			}
+
+			UKismetRenderingLibrary::EndDrawCanvasToRenderTarget(this, Context);
+			return;
+		}
+	}
+
+	UKismetRenderingLibrary::ClearRenderTarget2D(this, Destination_RT, FLinearColor::Black);
+	UKismetRenderingLibrary::DrawMaterialToRenderTarget(this, Destination_RT, Material);
 }
 
 bool AShaderWorldBrush::IsValidBrush()
@@ -694,6 +733,17 @@ bool AShaderWorldBrush::IsValidBrush()
 	return false;
 }
 
+TSharedPtr<FSWCPUBrush, ESPMode::ThreadSafe> AShaderWorldBrush::CreateCPUBrush()
+{
+	// Material brushes can only be evaluated on GPU
+	return nullptr;
+}
+
+bool AShaderWorldBrush::PrepareCompositeDraw(const FVector& Origin, float LayerInfluence, float BrushInfluence, FSWCompositeBrushParameters& OutParameters)
+{
+	return false;
+}
+
 void AShaderWorldBrush::SetLastDrawnFootPrint(FBox2D& FootPrint)
 {
 	FootPrintWhenLastDrawn = FootPrint;
@@ -33,6 +33,18 @@
 #include "Engine/TextureRenderTarget2D.h"
 #include "Kismet/KismetRenderingLibrary.h"
 #include "Actor/ShaderWorldActor.h"
+#include "Storage/SWTileDiskCache.h"
+#include "Data/SWStructs.h"
+
+static TAutoConsoleVariable<int32> CVarSWBrushPartialDraw(
+	TEXT("sw.Brush.PartialDraw"),
+	1,
+	TEXT("Brushes only evaluate the texels their footprint touches, the rest of the render target is copied. 0: every brush redraws the whole render target."));
+
+static TAutoConsoleVariable<int32> CVarSWBrushBatchCompute(
+	TEXT("sw.Brush.BatchCompute"),
+	1,
+	TEXT("Consecutive analytic brushes of a stack are evaluated by a single compute dispatch. 0: one dispatch per brush."));
 
 // Sets default values
 AShaderWorldBrushManager::AShaderWorldBrushManager()
@@ -47,6 +59,8 @@ void AShaderWorldBrushManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
 	EndPlayCalled = true;
 
 	RuntimeDynamicBrushLayers.Empty();
+	BrushIndex.Empty();
+	bBrushIndexDirty = true;
 
 	Super::EndPlay(EndPlayReason);
 }
@@ -112,6 +126,9 @@ void AShaderWorldBrushManager::PostEditChangeProperty(FPropertyChangedEvent& Pro
 			return A.Brush->Priority <= B.Brush->Priority;
 		});
 	}
+
+	bBrushIndexDirty = true;
+
 	Super::PostEditChangeProperty(PropertyChangedEvent);
 }
 
@@ -133,6 +150,9 @@ void AShaderWorldBrushManager::ResetB()
 	ExogeneReDrawBox.Empty();
 	BPUpdateCounter = 0;
 
+	BrushIndex.Empty();
+	bBrushIndexDirty = true;
+
 	for (FBrushLayer& Layer : BrushLayers)
 	{		
 		for(int32 b_ID = Layer.Brushes.Num()-1; b_ID>=0; b_ID--)
@@ -149,7 +169,7 @@ void AShaderWorldBrushManager::ResetB()
 }
 }
 
-void AShaderWorldBrushManager::ApplyBrushStackToHeightMap(AShaderWorldActor* SourceWorld,int LOD, UTextureRenderTarget2D* Heightmap_RT, FVector RingLocation, int32 GridScaling, int& N,bool CollisionMesh, bool ReadBack, UTextureRenderTarget2D* Location_RT)
+void AShaderWorldBrushManager::ApplyBrushStackToHeightMap(AShaderWorldActor* SourceWorld,int LOD, UTextureRenderTarget2D* Heightmap_RT, FVector RingLocation, int32 GridScaling, int& N,bool CollisionMesh, bool ReadBack, UTextureRenderTarget2D* Location_RT, TConstArrayView<FIntRect> DirtyRects)
 {
 	if(!SourceWorld || !Heightmap_RT)
 	{
@@ -216,7 +236,7 @@ void AShaderWorldBrushManager::ApplyBrushStackToHeightMap(AShaderWorldActor* Sou
 		FBox2D FootPrintRT(Location - Size * FVector2D(1.f, 1.f), Location + Size * FVector2D(1.f, 1.f));
 
 		FString NoName = "";
-		ApplyStackForFootprint(FootPrintRT, Heightmap_RT, RingLocation, GridScaling, N, CollisionMesh,false,NoName,ReadBack,Location_RT);
+		ApplyStackForFootprint(FootPrintRT, Heightmap_RT, RingLocation, GridScaling, N, CollisionMesh,false,NoName,ReadBack,Location_RT,DirtyRects);
 		
 	}
 	else
@@ -225,7 +245,7 @@ void AShaderWorldBrushManager::ApplyBrushStackToHeightMap(AShaderWorldActor* Sou
 	}
 }
 
-void AShaderWorldBrushManager::ApplyBrushStackToLayer(AShaderWorldActor* SourceWorld, int LOD, UTextureRenderTarget2D* Layer_RT, FVector RingLocation, int32& GridScaling, int& N, FString& LayerName)
+void AShaderWorldBrushManager::ApplyBrushStackToLayer(AShaderWorldActor* SourceWorld, int LOD, UTextureRenderTarget2D* Layer_RT, FVector RingLocation, int32& GridScaling, int& N, FString& LayerName, TConstArrayView<FIntRect> DirtyRects)
 {
 	if (!SourceWorld || !Layer_RT)
 	{
@@ -271,12 +291,12 @@ void AShaderWorldBrushManager::ApplyBrushStackToLayer(AShaderWorldActor* SourceW
 
 		FBox2D FootPrintRT(Location - Size * FVector2D(1.f, 1.f), Location + Size * FVector2D(1.f, 1.f));
 
-		ApplyStackForFootprint(FootPrintRT, Layer_RT, RingLocation, GridScaling, N, false,true,LayerName);
+		ApplyStackForFootprint(FootPrintRT, Layer_RT, RingLocation, GridScaling, N, false,true,LayerName,false,nullptr,DirtyRects);
 
 	}
 }
 
-void AShaderWorldBrushManager::ApplyStackForFootprint(FBox2D FootPrint , UTextureRenderTarget2D* Heightmap_RT, FVector RingLocation, int32 GridScaling, int N,bool CollisionMesh, bool IsLayer, FString& LayerName, bool ReadBack, UTextureRenderTarget2D* Location_RT)
+void AShaderWorldBrushManager::ApplyStackForFootprint(FBox2D FootPrint , UTextureRenderTarget2D* Heightmap_RT, FVector RingLocation, int32 GridScaling, int N,bool CollisionMesh, bool IsLayer, FString& LayerName, bool ReadBack, UTextureRenderTarget2D* Location_RT, TConstArrayView<FIntRect> DirtyRects)
 {
 	if(!Heightmap_RT || CollisionMesh && !CollisionWorkRT|| (!CollisionMesh && !ReadBack && !WorkRT) || (ReadBack && !ReadBackRT) || IsLayer && !LayerRT)
 	{
@@ -285,55 +305,93 @@ void AShaderWorldBrushManager::ApplyStackForFootprint(FBox2D FootPrint , UTextur
 	}
 	
 
-	uint8 Altern = 0;
+	RebuildBrushIndexIfNeeded();
+
+	// Readback targets store sparse sample locations, not a grid covering FootPrint
+	const bool bDirtyRectsOnly = !ReadBack && DirtyRects.Num() > 0 && FootPrint.GetArea() > 0.0;
+	const bool bPartialDraw = bDirtyRectsOnly || !ReadBack && CVarSWBrushPartialDraw.GetValueOnGameThread() > 0 && FootPrint.GetArea() > 0.0;
+	const FIntPoint RTSize(Heightmap_RT->SizeX, Heightmap_RT->SizeY);
+	const FVector2D TexelPerUnit = FVector2D(RTSize) / FootPrint.GetSize();
+
+	// Texels touched by a brush are padded to cover the RT borders and bilinear taps
+	const int32 Margin = 2;
+
+	TSet<const AShaderWorldBrush*> Candidates;
 
-	for(FBrushLayer& Layer : BrushLayers)
+	if (bDirtyRectsOnly)
 	{
-		if(Layer.Enabled && Layer.Influence>0.001f)
-		{
-			if(Layer.BrushManagerOwner!=this)
-				Layer.BrushManagerOwner=this;
+		TSet<const AShaderWorldBrush*> RectCandidates;
 
-			for (FBrushElement& BrushEl : Layer.Brushes)
-			{
-				if(BrushEl.Brush)
-					BrushEl.Brush->RedrawNeed=false;
+		for (const FIntRect& Rect : DirtyRects)
+		{
+			const FBox2D RectFootPrint(FootPrint.Min + FVector2D(Rect.Min - FIntPoint(Margin)) / TexelPerUnit, FootPrint.Min + FVector2D(Rect.Max + FIntPoint(Margin)) / TexelPerUnit);
+			BrushIndex.Query(RectFootPrint, RectCandidates);
+			Candidates.Append(RectCandidates);
+		}
+	}
+	else
+	{
+		BrushIndex.Query(FootPrint, Candidates);
+	}
 
-				FBox2D BrushFootPrint(ForceInit);
+	if (Candidates.Num() == 0)
+		return;
 
-				if(BrushEl.Enabled && BrushEl.IsValid())
-					BrushFootPrint = BrushEl.Brush->GetBrushFootPrint();
+	SW_FCT_CYCLE()
 
-				if(BrushEl.Enabled && BrushEl.Influence>0.001f && BrushEl.IsValid() && FootPrint.Intersect(BrushFootPrint) && (!IsLayer || IsLayer && BrushEl.Brush->DrawToLayer && BrushEl.Brush->NameOfLayerTarget == LayerName))
-				{
-					if (BrushEl.BrushManagerOwner != this)
-						BrushEl.BrushManagerOwner = this;
+	UTextureRenderTarget2D* WorkTarget = IsLayer ? LayerRT : (CollisionMesh ? CollisionWorkRT : (ReadBack ? ReadBackRT : WorkRT));
 
-					UTextureRenderTarget2D* Dest = Altern == 0 ? (IsLayer?LayerRT:(CollisionMesh ? CollisionWorkRT : (ReadBack? ReadBackRT:WorkRT))) : Heightmap_RT;
-					UTextureRenderTarget2D* Src = Altern == 0 ? Heightmap_RT : (IsLayer?LayerRT:(CollisionMesh ? CollisionWorkRT : (ReadBack ? ReadBackRT : WorkRT)));
+	uint8 Altern = 0;
 
-					BrushEl.Brush->ApplyBrushAt(Dest, Src,Layer.Influence,BrushEl.Influence, RingLocation, GridScaling, N, CollisionMesh,IsLayer, ReadBack, Location_RT);
+	USWorldSubsystem* ShaderWorldSubsystem = GetWorld()->GetSubsystem<USWorldSubsystem>();
 
-					BrushEl.Brush->SetLastDrawnFootPrint(BrushFootPrint);
-					
-					Altern = Altern == 0 ? 1 : 0;				
-				}
+	// Run of consecutive analytic brushes, drawn by a single dispatch once a material brush or the end of the stack is reached
+	SWBrushStackComputeData CompositeRun;
+	const bool bBatchCompute = !IsLayer && ShaderWorldSubsystem && CVarSWBrushBatchCompute.GetValueOnGameThread() > 0;
 
-			}		
-		}
+	if (bBatchCompute)
+	{
+		CompositeRun.Locations = ReadBack ? Location_RT : nullptr;
+		CompositeRun.Origin = FVector2f(RingLocation.X, RingLocation.Y);
+		CompositeRun.Grid.Size = Heightmap_RT->SizeX;
+		CompositeRun.Grid.Margin = CollisionMesh ? 0 : 1;
+		CompositeRun.Grid.PatchFullSize = (N - 1) * GridScaling;
+
+		if (bDirtyRectsOnly)
+			CompositeRun.Rects.Append(DirtyRects.GetData(), FMath::Min(DirtyRects.Num(), SWBrushStackComputeData::MaxRects));
 	}
 
-	for (FBrushLayer& Layer : RuntimeDynamicBrushLayers)
+	auto FlushCompositeRun = [&]()
 	{
-		if (Layer.Enabled && Layer.Influence > 0.001f)
+		if (CompositeRun.Brushes.Num() == 0)
+			return;
+
+		CompositeRun.Source = Altern == 0 ? Heightmap_RT : WorkTarget;
+		CompositeRun.Destination = Altern == 0 ? WorkTarget : Heightmap_RT;
+
+		if (ShaderWorldSubsystem->ComposeBrushStack(CompositeRun))
+			Altern = Altern == 0 ? 1 : 0;
+
+		CompositeRun.Brushes.Reset();
+	};
+
+	// Same drawing order as before the index: layers in order, brushes in order
+	for (TArray<FBrushLayer>* Layers : { &BrushLayers, &RuntimeDynamicBrushLayers })
+	{
+		for (FBrushLayer& Layer : *Layers)
 		{
+			if (!Layer.Enabled || Layer.Influence <= 0.001f)
+				continue;
+
 			if (Layer.BrushManagerOwner != this)
 				Layer.BrushManagerOwner = this;
 
 			for (FBrushElement& BrushEl : Layer.Brushes)
 			{
-				if (BrushEl.Brush)
-						BrushEl.Brush->RedrawNeed = false;
+				if (!BrushEl.Brush || !Candidates.Contains(BrushEl.Brush))
+					continue;
+
+				BrushEl.Brush->RedrawNeed = false;
 
 				FBox2D BrushFootPrint(ForceInit);
 
@@ -342,31 +400,202 @@ void AShaderWorldBrushManager::ApplyStackForFootprint(FBox2D FootPrint , UTextur
 
 				if (BrushEl.Enabled && BrushEl.Influence > 0.001f && BrushEl.IsValid() && FootPrint.Intersect(BrushFootPrint) && (!IsLayer || IsLayer && BrushEl.Brush->DrawToLayer && BrushEl.Brush->NameOfLayerTarget == LayerName))
 				{
+					TArray<FIntRect, TInlineAllocator<4>> DrawRects;
+
+					if (bPartialDraw)
+					{
+						const FBox2D Overlap = FootPrint.Overlap(BrushFootPrint);
+
+						FIntRect BrushRect;
+						BrushRect.Min.X = FMath::Clamp(FMath::FloorToInt((Overlap.Min.X - FootPrint.Min.X) * TexelPerUnit.X) - Margin, 0, RTSize.X);
+						BrushRect.Min.Y = FMath::Clamp(FMath::FloorToInt((Overlap.Min.Y - FootPrint.Min.Y) * TexelPerUnit.Y) - Margin, 0, RTSize.Y);
+						BrushRect.Max.X = FMath::Clamp(FMath::CeilToInt((Overlap.Max.X - FootPrint.Min.X) * TexelPerUnit.X) + Margin, 0, RTSize.X);
+						BrushRect.Max.Y = FMath::Clamp(FMath::CeilToInt((Overlap.Max.Y - FootPrint.Min.Y) * TexelPerUnit.Y) + Margin, 0, RTSize.Y);
+
+						if (bDirtyRectsOnly)
+						{
+							for (const FIntRect& DirtyRect : DirtyRects)
+							{
+								FIntRect Clipped = BrushRect;
+								Clipped.Clip(DirtyRect);
+
+								if (Clipped.Area() > 0)
+									DrawRects.Add(Clipped);
+							}
+
+							// The brush only touches texels that are already up to date
+							if (DrawRects.Num() == 0)
+								continue;
+						}
+						else
+						{
+							DrawRects.Add(BrushRect);
+						}
+					}
+
 					if (BrushEl.BrushManagerOwner != this)
 						BrushEl.BrushManagerOwner = this;
 
-					UTextureRenderTarget2D* Dest = Altern == 0 ? (IsLayer ? LayerRT : (CollisionMesh ? CollisionWorkRT : (ReadBack ? ReadBackRT : WorkRT))) : Heightmap_RT;
-					UTextureRenderTarget2D* Src = Altern == 0 ? Heightmap_RT : (IsLayer ? LayerRT : (CollisionMesh ? CollisionWorkRT : (ReadBack ? ReadBackRT : WorkRT)));
+					if (bBatchCompute)
+					{
+						FSWCompositeBrushParameters Parameters;
+						if (BrushEl.Brush->PrepareCompositeDraw(RingLocation, Layer.Influence, BrushEl.Influence, Parameters))
+						{
+							CompositeRun.Brushes.Add(Parameters);
+							BrushEl.Brush->SetLastDrawnFootPrint(BrushFootPrint);
+							continue;
+						}
+
+						FlushCompositeRun();
+					}
+
+					UTextureRenderTarget2D* Dest = Altern == 0 ? WorkTarget : Heightmap_RT;
+					UTextureRenderTarget2D* Src = Altern == 0 ? Heightmap_RT : WorkTarget;
 
+					BrushEl.Brush->SetPendingDrawRects(DrawRects);
 					BrushEl.Brush->ApplyBrushAt(Dest, Src, Layer.Influence, BrushEl.Influence, RingLocation, GridScaling, N, CollisionMesh, IsLayer, ReadBack, Location_RT);
+					BrushEl.Brush->ClearPendingDrawRects();
 
 					BrushEl.Brush->SetLastDrawnFootPrint(BrushFootPrint);
 
 					Altern = Altern == 0 ? 1 : 0;
 				}
-				else
+			}
+		}
+	}
+
+	if (bBatchCompute)
+		FlushCompositeRun();
+
+	if (Altern == 1)
+	{
+		if (ShaderWorldSubsystem)
+			ShaderWorldSubsystem->CopyAtoB(WorkTarget, Heightmap_RT, 0);
+	}
+}
+
+int32 AShaderWorldBrushManager::CountStackBrushes() const
+{
+	int32 Count = 0;
+
+	for (const TArray<FBrushLayer>* Layers : { &BrushLayers, &RuntimeDynamicBrushLayers })
+	{
+		for (const FBrushLayer& Layer : *Layers)
+			Count += Layer.Brushes.Num();
+	}
+
+	return Count;
+}
+
+void AShaderWorldBrushManager::RebuildBrushIndexIfNeeded()
+{
+	const int32 BrushCount = CountStackBrushes();
+
+	if (!bBrushIndexDirty && BrushCount == IndexedBrushCount)
+		return;
+
+	SW_FCT_CYCLE()
+
+	bBrushIndexDirty = false;
+	IndexedBrushCount = BrushCount;
+
+	BrushIndex.Empty();
+
+	for (TArray<FBrushLayer>* Layers : { &BrushLayers, &RuntimeDynamicBrushLayers })
+	{
+		for (FBrushLayer& Layer : *Layers)
+		{
+			for (FBrushElement& BrushEl : Layer.Brushes)
+			{
+				if (BrushEl.IsValid())
+					BrushIndex.Update(BrushEl.Brush, BrushEl.Brush->GetBrushFootPrint());
+			}
+		}
+	}
+}
+
+bool AShaderWorldBrushManager::GatherCPUBrushStack(TArray<FSWCPUBrushStackElement>& OutStack)
+{
+	OutStack.Empty();
+
+	bool bStackComplete = true;
+
+	// Same order and conditions as ApplyStackForFootprint
+	for (TArray<FBrushLayer>* Layers : { &BrushLayers, &RuntimeDynamicBrushLayers })
+	{
+		for (FBrushLayer& Layer : *Layers)
+		{
+			if (!Layer.Enabled || Layer.Influence <= 0.001f)
+				continue;
+
+			for (FBrushElement& BrushEl : Layer.Brushes)
+			{
+				if (!BrushEl.Enabled || BrushEl.Influence <= 0.001f || !BrushEl.IsValid())
+					continue;
+
+				TSharedPtr<FSWCPUBrush, ESPMode::ThreadSafe> CPUBrush = BrushEl.Brush->CreateCPUBrush();
+
+				if (!CPUBrush.IsValid())
 				{
-					
+					bStackComplete = false;
+					continue;
 				}
 
+				CPUBrush->FootPrint = BrushEl.Brush->GetBrushFootPrint();
+
+				FSWCPUBrushStackElement& Element = OutStack.AddDefaulted_GetRef();
+				Element.Brush = CPUBrush;
+				Element.LayerInfluence = Layer.Influence;
+				Element.BrushInfluence = BrushEl.Influence;
 			}
 		}
 	}
 
-	if (Altern == 1)
+	return bStackComplete;
+}
+
+void AShaderWorldBrushManager::GatherBrushFootprintHashes(TArray<TPair<FBox2D, uint64>>& OutHashes)
+{
+	SW_FCT_CYCLE()
+
+	OutHashes.Empty();
+
+	// Same order and conditions as ApplyStackForFootprint
+	for (TArray<FBrushLayer>* Layers : { &BrushLayers, &RuntimeDynamicBrushLayers })
 	{
-		if (USWorldSubsystem* ShaderWorldSubsystem = GetWorld()->GetSubsystem<USWorldSubsystem>())
-			ShaderWorldSubsystem->CopyAtoB(IsLayer ? LayerRT : (CollisionMesh ? CollisionWorkRT : (ReadBack ? ReadBackRT : WorkRT)), Heightmap_RT, 0);
+		for (FBrushLayer& Layer : *Layers)
+		{
+			if (!Layer.Enabled || Layer.Influence <= 0.001f)
+				continue;
+
+			for (FBrushElement& BrushEl : Layer.Brushes)
+			{
+				if (!BrushEl.Enabled || BrushEl.Influence <= 0.001f || !BrushEl.IsValid())
+					continue;
+
+				AShaderWorldBrush* Brush = BrushEl.Brush;
+				const FBox2D FootPrint = Brush->GetBrushFootPrint();
+
+				FString Description = Brush->GetClass()->GetPathName();
+				Description += FString::Printf(TEXT("|%f|%f|%s|%s|%s|"), Layer.Influence, BrushEl.Influence, *FootPrint.ToString(),
+					*Brush->GetActorRotation().ToString(), *Brush->GetActorScale3D().ToString());
+
+				// Brush settings, whatever the brush type. Actor level properties do not change the brush output
+				for (TFieldIterator<FProperty> It(Brush->GetClass()); It; ++It)
+				{
+					const FProperty* Property = *It;
+
+					if (Property->HasAnyPropertyFlags(CPF_Transient) || !Property->GetOwnerClass() || !Property->GetOwnerClass()->IsChildOf(AShaderWorldBrush::StaticClass()))
+						continue;
+
+					Description += Property->GetName();
+					Property->ExportText_InContainer(0, Description, Brush, nullptr, Brush, PPF_None);
+					Description += TEXT("|");
+				}
+
+				OutHashes.Emplace(FootPrint, FSWTileDiskCache::HashBytes(*Description, Description.Len() * sizeof(TCHAR)));
+			}
+		}
 	}
 }
 
@@ -376,7 +605,8 @@ void AShaderWorldBrushManager::BeginPlay()
 	Super::BeginPlay();
 	
 	RuntimeDynamicBrushLayers.Empty();
-	
+
+	bBrushIndexDirty = true;
 }
 
 // Called every frame
@@ -397,6 +627,7 @@ void AShaderWorldBrushManager::Tick(float DeltaTime)
 					Layer.Brushes.RemoveAt(b_ID);
 			}
 		}
+		bBrushIndexDirty = true;
 	}
 
 	TimeAcuReorder+= DeltaTime;
@@ -438,6 +669,9 @@ void AShaderWorldBrushManager::Tick(float DeltaTime)
 
 		if (ShaderWorldOwner && (ShaderWorldOwner->GetMeshNum() <= 0))
 		{
+			// Footprints are not tracked while there is nothing to draw
+			bBrushIndexDirty = true;
+
 			for (FBrushLayer& Layer : BrushLayers)
 			{
 				if (Layer.BrushManagerOwner != this)
@@ -463,7 +697,12 @@ void AShaderWorldBrushManager::Tick(float DeltaTime)
 			bool WorldVisible = ShaderWorldOwner->HighestLOD_Visible();
 			
 			if(!WorldFootprint.bIsValid || !WorldVisible)
+			{
+				bBrushIndexDirty = true;
 				return;
+			}
+
+			RebuildBrushIndexIfNeeded();
 
 			bool RequireUpdate = false;
 			for (FBrushLayer& Layer : BrushLayers)
@@ -479,6 +718,7 @@ void AShaderWorldBrushManager::Tick(float DeltaTime)
 					if(BrushEl.IsValid())
 					{
 						FBox2D BrushFootPrint = BrushEl.Brush->GetBrushFootPrint();
+						BrushIndex.Update(BrushEl.Brush, BrushFootPrint);
 
 						//i need to check that the brush is within highest LOD boundaries otherwise it wont be processed and we re wasting time
 						if (WorldFootprint.Intersect(BrushFootPrint))
@@ -518,6 +758,7 @@ void AShaderWorldBrushManager::Tick(float DeltaTime)
 					if (BrushEl.IsValid())
 					{
 						FBox2D BrushFootPrint = BrushEl.Brush->GetBrushFootPrint();
+						BrushIndex.Update(BrushEl.Brush, BrushFootPrint);
 
 						//i need to check that the brush is within highest LOD boundaries otherwise it wont be processed and we re wasting time
 						if (WorldFootprint.Intersect(BrushFootPrint))
@@ -0,0 +1,292 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+#include "Brushes/ShaderWorldShapeBrush.h"
+
+#include "Components/BoxComponent.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "SWorldSubsystem.h"
+#include "SWStats.h"
+#include "Data/SWStructs.h"
+#include "Engine/World.h"
+#include "Math/RandomStream.h"
+#include "RenderingThread.h"
+#include "TextureResource.h"
+
+class FSWShapeCPUBrush : public FSWCPUBrush
+{
+public:
+	virtual double ApplyBrushAt(const FVector2D& Location, double SourceHeight, float LayerInfluence, float BrushInfluence) const override
+	{
+		FSWCompositeBrushParameters Brush = Parameters;
+		Brush.Influence = LayerInfluence * BrushInfluence;
+
+		return SWBrushCompositor::EvaluateBrush(Brush, FVector2f(Location - Center), SourceHeight);
+	}
+
+	/** Relative to Center */
+	FSWCompositeBrushParameters Parameters;
+	FVector2D Center = FVector2D::ZeroVector;
+};
+
+AShaderWorldShapeBrush::AShaderWorldShapeBrush(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryActorTick.bCanEverTick = false;
+}
+
+bool AShaderWorldShapeBrush::IsValidBrush()
+{
+	// No material required
+	return IsValid(this) && BoxBound && !DrawToLayer;
+}
+
+FVector AShaderWorldShapeBrush::GetShapeLocation() const
+{
+	return BoxBound->GetComponentLocation() + FVector(GetWorld()->OriginLocation);
+}
+
+FSWCompositeBrushParameters AShaderWorldShapeBrush::BuildParameters(const FVector& Origin) const
+{
+	const FVector Location = GetShapeLocation();
+	const FVector Extent = BoxBound->GetScaledBoxExtent();
+	const double Yaw = FMath::DegreesToRadians(BoxBound->GetComponentRotation().Yaw);
+
+	FSWCompositeBrushParameters Parameters;
+	Parameters.Center = FVector2f(Location.X - Origin.X, Location.Y - Origin.Y);
+	Parameters.Extent = FVector2f(Extent.X, Extent.Y);
+	Parameters.Axis = FVector2f(FMath::Cos(Yaw), FMath::Sin(Yaw));
+	Parameters.Height = BlendOp == ESWBrushBlendOp::Add ? Height : Location.Z + Height;
+	Parameters.FalloffWidth = FMath::Clamp(FalloffWidth, 0.f, 1.f);
+	Parameters.Exponent = FMath::Max(HeightCurveExponent, 0.01f);
+	Parameters.Influence = 1.f;
+	Parameters.Shape = (uint32)Shape;
+	Parameters.FalloffAndBlend = (uint32)Falloff | ((uint32)BlendOp << 8);
+
+	return Parameters;
+}
+
+bool AShaderWorldShapeBrush::NeedRedraw(bool LayerEnabled, bool BrushEnabled, float LayerInfluence, float BrushInfluence, bool IncludeBP)
+{
+	if (Super::NeedRedraw(LayerEnabled, BrushEnabled, LayerInfluence, BrushInfluence, IncludeBP))
+		return true;
+
+	if (!LayerEnabled || !BrushEnabled || !IsValidBrush() || !GetWorld())
+		return false;
+
+	// Shape settings are not material parameters, compare them with the last draw
+	const FSWCompositeBrushParameters Current = BuildParameters(GetShapeLocation());
+	return !bShapeDrawn || FMemory::Memcmp(&Current, &DrawnShape, sizeof(FSWCompositeBrushParameters)) != 0;
+}
+
+bool AShaderWorldShapeBrush::PrepareCompositeDraw(const FVector& Origin, float LayerInfluence, float BrushInfluence, FSWCompositeBrushParameters& OutParameters)
+{
+	if (!IsValidBrush() || !GetWorld())
+		return false;
+
+	OutParameters = BuildParameters(Origin);
+	OutParameters.Influence = LayerInfluence * BrushInfluence;
+
+	// Same bookkeeping as a material draw, compared by NeedRedraw
+	BrushLocation_Material = GetActorLocation() + FVector(GetWorld()->OriginLocation);
+	Influence_Layer_Material = LayerInfluence;
+	Influence_Brush_Material = BrushInfluence;
+	Layer_Enabled = true;
+	Brush_Enabled = true;
+
+	DrawnShape = BuildParameters(GetShapeLocation());
+	bShapeDrawn = true;
+
+	return true;
+}
+
+void AShaderWorldShapeBrush::ApplyBrushAt(UTextureRenderTarget2D* Destination_RT, UTextureRenderTarget2D* Source_RT, float LayerInfluence, float BrushInfluence, FVector RingLocation, int32 GridScaling, int N, bool CollisionMesh, bool IsLayer, bool IsReadback, UTextureRenderTarget2D* Location_RT)
+{
+	USWorldSubsystem* ShaderWorldSubsystem = GetWorld() ? GetWorld()->GetSubsystem<USWorldSubsystem>() : nullptr;
+
+	if (!ShaderWorldSubsystem || !Destination_RT || !Source_RT)
+		return;
+
+	// Drawn alone, when the brush manager did not batch it with its neighbors
+	SWBrushStackComputeData Data;
+	Data.Source = Source_RT;
+	Data.Destination = Destination_RT;
+	Data.Locations = IsReadback ? Location_RT : nullptr;
+	Data.Origin = FVector2f(RingLocation.X, RingLocation.Y);
+	Data.Grid.Size = Destination_RT->SizeX;
+	Data.Grid.Margin = (CollisionMesh || IsLayer) ? 0 : 1;
+	Data.Grid.PatchFullSize = (N - 1) * GridScaling;
+	Data.Rects = PendingDrawRects;
+
+	FSWCompositeBrushParameters& Parameters = Data.Brushes.AddDefaulted_GetRef();
+
+	// Shape brushes do not write to data layers: the destination still has to hold the source
+	if (IsLayer || !PrepareCompositeDraw(RingLocation, LayerInfluence, BrushInfluence, Parameters))
+	{
+		ShaderWorldSubsystem->CopyAtoB(Source_RT, Destination_RT);
+		return;
+	}
+
+	ShaderWorldSubsystem->ComposeBrushStack(Data);
+}
+
+TSharedPtr<FSWCPUBrush, ESPMode::ThreadSafe> AShaderWorldShapeBrush::CreateCPUBrush()
+{
+	if (!IsValidBrush() || !GetWorld())
+		return nullptr;
+
+	const FVector Location = GetShapeLocation();
+
+	TSharedPtr<FSWShapeCPUBrush, ESPMode::ThreadSafe> CPUBrush = MakeShared<FSWShapeCPUBrush, ESPMode::ThreadSafe>();
+	CPUBrush->Center = FVector2D(Location.X, Location.Y);
+	CPUBrush->Parameters = BuildParameters(Location);
+
+	return CPUBrush;
+}
+
+/*
+ * RGBA8 height encoding of the heightmaps, as FloatToRGBA8 / SW_HeightRead (ShaderWorldUtilities.ush):
+ * 24 bit signed integer height in R (high byte) G B, alpha left to the material index.
+ */
+static FColor SWEncodeHeightTexel(float Height, uint8 Alpha)
+{
+	const uint32 Value = static_cast<uint32>(FMath::RoundToInt32(Height));
+	return FColor(static_cast<uint8>(((Value & 0x80000000) >> 24) | ((Value >> 16) & 0x7F)), static_cast<uint8>((Value >> 8) & 0xFF), static_cast<uint8>(Value & 0xFF), Alpha);
+}
+
+static float SWDecodeHeightTexel(const FColor& Texel)
+{
+	const bool bPositive = (Texel.R & 0x80) == 0;
+	return static_cast<float>((int32)((bPositive ? 0x0 : 0xFF) << 24 | (Texel.R | (bPositive ? 0x0 : 0x80)) << 16 | Texel.G << 8 | Texel.B));
+}
+
+/*
+ * Dispatches BrushStackCS over a random heightmap and random brushes, reads the result back
+ * and compares it with SWBrushCompositor::ComposeGrid, the CPU reference used by the shape brush CPU mirror.
+ */
+static void ValidateBrushStackCompute(const TArray<FString>& Args, UWorld* World)
+{
+	USWorldSubsystem* ShaderWorldSubsystem = World ? World->GetSubsystem<USWorldSubsystem>() : nullptr;
+	if (!ShaderWorldSubsystem)
+		return;
+
+	const int32 NumBrushes = Args.Num() > 0 ? FMath::Clamp(FCString::Atoi(*Args[0]), 1, 256) : 16;
+	const int32 Size = Args.Num() > 1 ? FMath::Clamp(FCString::Atoi(*Args[1]), 4, 1024) : 128;
+	const int32 Seed = Args.Num() > 2 ? FCString::Atoi(*Args[2]) : 0;
+
+	FRandomStream RandomStream(Seed);
+
+	SWBrushStackComputeData Data;
+	Data.Grid.Size = Size;
+	Data.Grid.Margin = 1;
+	Data.Grid.PatchFullSize = 100000.f;
+
+	// Every shape, falloff and blend operation, overlapping each other
+	for (int32 BrushIndex = 0; BrushIndex < NumBrushes; BrushIndex++)
+	{
+		FSWCompositeBrushParameters& Brush = Data.Brushes.AddDefaulted_GetRef();
+		const float Yaw = RandomStream.FRandRange(0.f, 2.f * PI);
+
+		Brush.Center = FVector2f(RandomStream.FRandRange(-0.4f, 0.4f), RandomStream.FRandRange(-0.4f, 0.4f)) * Data.Grid.PatchFullSize;
+		Brush.Extent = FVector2f(RandomStream.FRandRange(0.05f, 0.4f), RandomStream.FRandRange(0.05f, 0.4f)) * Data.Grid.PatchFullSize;
+		Brush.Axis = FVector2f(FMath::Cos(Yaw), FMath::Sin(Yaw));
+		Brush.Height = RandomStream.FRandRange(-30000.f, 30000.f);
+		Brush.FalloffWidth = RandomStream.FRandRange(0.05f, 1.f);
+		Brush.Exponent = RandomStream.FRandRange(0.5f, 3.f);
+		Brush.Influence = RandomStream.FRandRange(0.2f, 1.f);
+		Brush.Shape = (uint32)(BrushIndex % 2 == 0 ? ESWBrushShape::Circle : ESWBrushShape::Box);
+		Brush.FalloffAndBlend = (uint32)(BrushIndex % 3) | (uint32)((BrushIndex / 2) % 4) << 8;
+	}
+
+	TArray<float> SourceHeights;
+	TArray<FColor> SourceTexels;
+	SourceHeights.SetNumUninitialized(Size * Size);
+	SourceTexels.SetNumUninitialized(Size * Size);
+	for (int32 Texel = 0; Texel < Size * Size; Texel++)
+	{
+		SourceHeights[Texel] = FMath::RoundToFloat(RandomStream.FRandRange(-50000.f, 50000.f));
+		SourceTexels[Texel] = SWEncodeHeightTexel(SourceHeights[Texel], static_cast<uint8>(Texel & 0xFF));
+	}
+
+	UTextureRenderTarget2D* SourceRT = nullptr;
+	UTextureRenderTarget2D* DestinationRT = nullptr;
+	SW_RT(SourceRT, World, Size, TF_Nearest, RTF_RGBA8)
+	SW_RT(DestinationRT, World, Size, TF_Nearest, RTF_RGBA8)
+	Data.Source = SourceRT;
+	Data.Destination = DestinationRT;
+
+	ENQUEUE_RENDER_COMMAND(SWBrushStackValidationUpload)(
+		[Resource = SourceRT->GameThread_GetRenderTargetResource(), Texels = SourceTexels, Size](FRHICommandListImmediate& RHICmdList)
+		{
+			RHIUpdateTexture2D(Resource->GetRenderTargetTexture(), 0, FUpdateTextureRegion2D(0, 0, 0, 0, Size, Size), Size * sizeof(FColor), reinterpret_cast<const uint8*>(Texels.GetData()));
+		});
+
+	if (!ShaderWorldSubsystem->ComposeBrushStack(Data))
+	{
+		UE_LOG(LogShaderWorld, Warning, TEXT("SW brush stack validation | render thread not ready, retry once the world is running"));
+		return;
+	}
+
+	TArray<FColor> GPUTexels;
+	FlushRenderingCommands();
+	DestinationRT->GameThread_GetRenderTargetResource()->ReadPixels(GPUTexels);
+
+	TArray<float> CPUHeights;
+	CPUHeights.SetNumUninitialized(Size * Size);
+	SWBrushCompositor::ComposeGrid(Data.Brushes, Data.Grid, SourceHeights, CPUHeights);
+
+	if (GPUTexels.Num() != Size * Size)
+	{
+		UE_LOG(LogShaderWorld, Warning, TEXT("SW brush stack validation | readback failed"));
+		return;
+	}
+
+	// Rounding of a height ending in .5 may differ by one unit between the shader and the CPU
+	int32 OffByOne = 0;
+	int32 Mismatches = 0;
+	int32 AlphaMismatches = 0;
+	float MaxError = 0.f;
+
+	for (int32 Texel = 0; Texel < Size * Size; Texel++)
+	{
+		const float Error = FMath::Abs(SWDecodeHeightTexel(GPUTexels[Texel]) - CPUHeights[Texel]);
+		MaxError = FMath::Max(MaxError, Error);
+		OffByOne += (Error > 0.f && Error <= 1.f) ? 1 : 0;
+		Mismatches += Error > 1.f ? 1 : 0;
+		AlphaMismatches += GPUTexels[Texel].A != SourceTexels[Texel].A ? 1 : 0;
+	}
+
+	UE_LOG(LogShaderWorld, Display, TEXT("SW brush stack validation | %d brushes over %dx%d texels | %d mismatches, %d off by one, max error %.0f | %d material index changes"),
+		NumBrushes, Size, Size, Mismatches, OffByOne, MaxError, AlphaMismatches);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs ValidateBrushStackComputeCmd(
+	TEXT("sw.Brush.ValidateCompute"),
+	TEXT("Dispatches the brush stack compute shader over random heights and brushes, and logs how its output compares with the CPU reference. Arguments: Brushes (16) Size (128) Seed (0)"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&ValidateBrushStackCompute)
+);
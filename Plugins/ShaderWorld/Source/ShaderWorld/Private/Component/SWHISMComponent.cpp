@@ -30,8 +30,10 @@
 #include "Component/SWHISMComponentSceneProxy.h"
 #include "NaniteSceneProxy.h"
 #include "PrimitiveInstanceUpdateCommand.h"
+#include "PrimitiveSceneInfo.h"
 #include "SWStats.h"
 #include "AI/NavigationSystemBase.h"
+#include "Algo/BinarySearch.h"
 #include "Async/Async.h"
 #include "Data/SWStructs.h"
 
@@ -434,6 +436,64 @@ void SWHISMComponentSceneProxy::ApplyWorldOffset(FVector InOffset)
 	}
 }
 
+void SWHISMComponentSceneProxy::UpdateRefittedInstances_RenderThread(const FSWHISMProxyInstanceUpdate& Update)
+{
+	check(IsInRenderingThread());
+
+	if (!Update.ClusterTree.IsValid() || Update.ClusterTree->Num() != ClusterTreePtr->Num() || !Update.InstanceSceneData.IsValid())
+		return;
+
+	// Same layout: copied into the array the traversal already references
+	*ClusterTreePtr = *Update.ClusterTree;
+
+	if (OcclusionBounds.Num() == 1 + LastOcclusionNode - FirstOcclusionNode)
+	{
+		const FMatrix XForm = GetLocalToWorld();
+		for (int32 Index = FirstOcclusionNode; Index <= LastOcclusionNode; Index++)
+		{
+			OcclusionBounds[Index - FirstOcclusionNode] = FBoxSphereBounds(FBox(ClusterTree[Index].BoundMin, ClusterTree[Index].BoundMax).TransformBy(XForm));
+		}
+	}
+
+	const TArray<FPrimitiveInstance, TInlineAllocator<1>>& NewSceneData = *Update.InstanceSceneData;
+	const bool bHasRandomID = Update.InstanceRandomID.IsValid() && InstanceRandomID.Num() == InstanceSceneData.Num() && Update.InstanceRandomID->Num() == NewSceneData.Num();
+
+	// Kept coherent for a later proxy recreation, GPU Scene instances are read from InstanceSceneData
+	FStaticMeshInstanceData* CPUInstanceData = InstancedRenderData.PerInstanceRenderData.IsValid() && InstancedRenderData.PerInstanceRenderData->InstanceBuffer.InstanceData.IsValid()
+		? InstancedRenderData.PerInstanceRenderData->InstanceBuffer.InstanceData.Get() : nullptr;
+	if (CPUInstanceData && CPUInstanceData->GetNumInstances() != NewSceneData.Num())
+		CPUInstanceData = nullptr;
+
+	for (const int32 RenderIndex : Update.RenderIndices)
+	{
+		if (!InstanceSceneData.IsValidIndex(RenderIndex) || !NewSceneData.IsValidIndex(RenderIndex))
+			continue;
+
+		InstanceSceneData[RenderIndex] = NewSceneData[RenderIndex];
+
+		float RandomID = 0.f;
+		if (bHasRandomID)
+		{
+			RandomID = (*Update.InstanceRandomID)[RenderIndex];
+			InstanceRandomID[RenderIndex] = RandomID;
+		}
+
+		if (CPUInstanceData)
+		{
+			if (!bHasRandomID)
+				CPUInstanceData->GetInstanceRandomID(RenderIndex, RandomID);
+
+			CPUInstanceData->SetInstance(RenderIndex, NewSceneData[RenderIndex].LocalToPrimitive.ToMatrix44f(), RandomID, FVector2D(-1.0f, -1.0f), FVector2D(-1.0f, -1.0f));
+		}
+	}
+
+	// Only this primitive's instances are uploaded again, its mesh draw commands and render resources are kept
+	if (FPrimitiveSceneInfo* SceneInfo = GetPrimitiveSceneInfo())
+	{
+		SceneInfo->RequestGPUSceneUpdate();
+	}
+}
+
 struct FFoliageRenderInstanceParams : public FOneFrameResource
 {
 	bool bNeedsSingleLODRuns;
@@ -1412,6 +1472,9 @@ void USWHISMComponent::ClearInstances()
 	 */
 	if(!IsAsyncBuilding())
 	{
+		SWDirtyInstanceRanges.Empty();
+		SWTreeBuildOrder.Reset();
+
 		Super::ClearInstances();
 	}
 	else
@@ -2081,6 +2144,39 @@ static TAutoConsoleVariable<int32> CVarSWSWMinOcclusionQueriesPerComponent(
 	6,
 	TEXT("Controls the granularity of occlusion culling. 2 should be the Min."));
 
+static TAutoConsoleVariable<int32> CVarSWSWParallelTreeBuild(
+	TEXT("SWfoliageSW.ParallelTreeBuild"),
+	1,
+	TEXT("0: build the foliage tree on a single thread.\n")
+	TEXT("1: split large ranges and reorder instances in parallel, the tree is identical to the single threaded one.\n")
+	TEXT("2: same, but order the top levels along a Morton curve with a parallel radix sort. Faster, the tree differs."));
+
+static TAutoConsoleVariable<int32> CVarSWSWParallelTreeBuildMinRange(
+	TEXT("SWfoliageSW.ParallelTreeBuildMinRange"),
+	16384,
+	TEXT("Ranges of more elements than this are split in parallel when building the foliage tree."));
+
+static TAutoConsoleVariable<int32> CVarSWSWTreeRefit(
+	TEXT("SWfoliageSW.TreeRefit"),
+	1,
+	TEXT("When only existing instances were rewritten (spawnable cells recycling their slots), refit the bounds of the affected clusters instead of rebuilding the whole tree."));
+
+static TAutoConsoleVariable<float> CVarSWSWTreeRefitRebuildThreshold(
+	TEXT("SWfoliageSW.TreeRefitRebuildThreshold"),
+	1.5f,
+	TEXT("A refit tree is discarded for a full rebuild once the summed bounds area of all its nodes, internal ones included, exceeds this ratio of the area measured at the last full build."));
+
+static TAutoConsoleVariable<int32> CVarSWSWDeltaUpdateMaxGap(
+	TEXT("SWfoliageSW.DeltaUpdateMaxGap"),
+	32,
+	TEXT("Batch updates only rewrite the instances whose transform changed, runs separated by at most this many unchanged instances are merged. -1: rewrite every instance."));
+
+static TAutoConsoleVariable<int32> CVarSWSWPartialInstanceUpload(
+	TEXT("SWfoliageSW.PartialInstanceUpload"),
+	1,
+	TEXT("1: a refitted tree sends only the rewritten instances to the existing render proxy, which requests a GPU Scene upload of its instances instead of being recreated with the whole instance buffer.\n")
+	TEXT("Full builds, Nanite meshes, per instance custom data and platforms without GPU Scene always recreate the proxy. 0: always recreate the proxy."));
+
 namespace SW_HISM
 {
 
@@ -2093,6 +2189,12 @@ struct FClusterTree
 	TArray<int32> InstanceReorderTable;
 	int32 OutOcclusionLayerNum = 0;
 
+	/** SortedInstances before BuildInstanceBuffer reorders the instance data, kept to refit the tree later on */
+	TSharedPtr < const TArray<int32>, ESPMode::ThreadSafe> BuildOrder;
+	/** Summed bounds area of every node, internal ones included, and the same measure at the last full build */
+	double TreeBoundsArea = 0.0;
+	double BaselineTreeBoundsArea = 0.0;
+
 	FClusterTree():Nodes(MakeShared<TArray<FClusterNode>, ESPMode::ThreadSafe>()){}
 };
 
@@ -2127,6 +2229,29 @@ protected:
 	TArray<float> CustomDataFloats;
 	int32 NumCustomDataFloats;
 
+	/** 0: single threaded, 1: parallel with the single threaded output, 2: parallel with Morton ordered top levels */
+	int32 ParallelMode = 0;
+	int32 ParallelMinRange = 0;
+public:
+	/** Replaces SWfoliageSW.ParallelTreeBuild when set, to compare the modes */
+	int32 ParallelModeOverride = INDEX_NONE;
+protected:
+
+	/*
+	 * Refit: the previous tree is kept as is and only the clusters holding the dirty instance ranges get their bounds recomputed.
+	 */
+
+	TArray<FClusterNode> PreviousNodes;
+	TSharedPtr < const TArray<int32>, ESPMode::ThreadSafe> PreviousBuildOrder;
+	int32 PreviousOcclusionLayerNum = 0;
+	double PreviousTreeBoundsArea = 0.0;
+	double PreviousBaselineTreeBoundsArea = 0.0;
+	float RebuildThreshold = 0.f;
+	TArray<FIntPoint> DirtyRanges;
+	/** Render indices of the dirty instances, sorted, filled by a successful refit */
+	TArray<int32> DirtyRenderIndices;
+	bool bRefitted = false;
+
 	struct FRunPair
 	{
 		int32 Start;
@@ -2157,11 +2282,80 @@ protected:
 	};
 	TArray<FSortPair> SortPairs;
 
+	static double GetBoundsArea(const FClusterNode& Node)
+	{
+		const FVector Size = (FVector)(Node.BoundMax - Node.BoundMin);
+		return Size.X * Size.Y + Size.Y * Size.Z + Size.Z * Size.X;
+	}
+
+	static double GetTreeBoundsArea(const TArray<FClusterNode>& Nodes)
+	{
+		double Area = 0.0;
+		for (const FClusterNode& Node : Nodes)
+		{
+			Area += GetBoundsArea(Node);
+		}
+		return Area;
+	}
+
+	void ComputeLeafBounds(FClusterNode& Node, const TArray<int32>& SortedInstances) const
+	{
+		Node.MinInstanceScale = FVector3f(MAX_flt);
+		Node.MaxInstanceScale = FVector3f(-MAX_flt);
+
+		FBox NodeBox(ForceInit);
+		for (int32 InstanceIndex = Node.FirstInstance; InstanceIndex <= Node.LastInstance; InstanceIndex++)
+		{
+			const FMatrix& ThisInstTrans = Transforms[SortedInstances[InstanceIndex]].Transform;
+			FBox ThisInstBox = InstBox.TransformBy(ThisInstTrans);
+			NodeBox += ThisInstBox;
+
+			if (GenerateInstanceScalingRange)
+			{
+				FVector3f CurrentScale(ThisInstTrans.GetScaleVector());
+
+				Node.MinInstanceScale = Node.MinInstanceScale.ComponentMin(CurrentScale);
+				Node.MaxInstanceScale = Node.MaxInstanceScale.ComponentMax(CurrentScale);
+			}
+		}
+		Node.BoundMin = (FVector3f)NodeBox.Min;
+		Node.BoundMax = (FVector3f)NodeBox.Max;
+	}
+
+	void ComputeInternalBounds(FClusterNode& Node) const
+	{
+		Node.MinInstanceScale = FVector3f(MAX_flt);
+		Node.MaxInstanceScale = FVector3f(-MAX_flt);
+
+		FBox NodeBox(ForceInit);
+		for (int32 ChildIndex = Node.FirstChild; ChildIndex <= Node.LastChild; ChildIndex++)
+		{
+			const FClusterNode& ChildNode = (*Result->Nodes.Get())[ChildIndex];
+			NodeBox += (FVector)ChildNode.BoundMin;
+			NodeBox += (FVector)ChildNode.BoundMax;
+
+			if (GenerateInstanceScalingRange)
+			{
+				Node.MinInstanceScale = Node.MinInstanceScale.ComponentMin(ChildNode.MinInstanceScale);
+				Node.MaxInstanceScale = Node.MaxInstanceScale.ComponentMax(ChildNode.MaxInstanceScale);
+			}
+		}
+		Node.BoundMin = (FVector3f)NodeBox.Min;
+		Node.BoundMax = (FVector3f)NodeBox.Max;
+	}
+
 	void Split(int32 InNum)
 	{
 		checkSlow(InNum);
 		Clusters.Reset();
-		Split(0, InNum - 1);
+		if (ParallelMode > 0 && InNum > FMath::Max(ParallelMinRange, BranchingFactor))
+		{
+			SplitParallel(InNum);
+		}
+		else
+		{
+			Split(0, InNum - 1, Clusters, SortPairs);
+		}
 		Clusters.Sort();
 		checkSlow(Clusters.Num() > 0);
 		int32 At = 0;
@@ -2173,7 +2367,184 @@ protected:
 		checkSlow(At == InNum);
 	}
 
-	void Split(int32 Start, int32 End)
+	void Split(int32 Start, int32 End, TArray<FRunPair>& OutClusters, TArray<FSortPair>& Pairs)
+	{
+		int32 NumRange = 1 + End - Start;
+		if (NumRange <= BranchingFactor)
+		{
+			OutClusters.Add(FRunPair(Start, NumRange));
+			return;
+		}
+
+		const int32 EndLeft = Partition(Start, End, Pairs);
+
+		Split(Start, EndLeft, OutClusters, Pairs);
+		Split(EndLeft + 1, End, OutClusters, Pairs);
+	}
+
+	/*
+	 * Breadth first: every range larger than ParallelMinRange is halved in parallel with its siblings,
+	 * the remaining ranges are then split recursively in parallel. Each range only touches its own span of SortIndex
+	 * and Clusters are sorted afterward, so the result matches the single threaded Split.
+	 */
+	void SplitParallel(int32 InNum)
+	{
+		const int32 MinRange = FMath::Max(ParallelMinRange, BranchingFactor);
+
+		TArray<FIntPoint> Initial;
+		if (ParallelMode > 1)
+		{
+			MortonRanges(InNum, MinRange, Initial);
+		}
+		else
+		{
+			Initial.Emplace(0, InNum - 1);
+		}
+
+		TArray<FIntPoint> Ranges;
+		TArray<FIntPoint> SerialRanges;
+		for (const FIntPoint& Range : Initial)
+		{
+			(1 + Range.Y - Range.X > MinRange ? Ranges : SerialRanges).Add(Range);
+		}
+
+		TArray<FIntPoint> Halves;
+		while (Ranges.Num() > 0)
+		{
+			Halves.SetNumUninitialized(Ranges.Num() * 2);
+			ParallelFor(Ranges.Num(), [this, &Ranges, &Halves](int32 RangeIndex)
+				{
+					TArray<FSortPair> Pairs;
+					const FIntPoint Range = Ranges[RangeIndex];
+					const int32 EndLeft = Partition(Range.X, Range.Y, Pairs);
+					Halves[2 * RangeIndex] = FIntPoint(Range.X, EndLeft);
+					Halves[2 * RangeIndex + 1] = FIntPoint(EndLeft + 1, Range.Y);
+				});
+
+			Ranges.Reset();
+			for (const FIntPoint& Half : Halves)
+			{
+				(1 + Half.Y - Half.X > MinRange ? Ranges : SerialRanges).Add(Half);
+			}
+		}
+
+		TArray<TArray<FRunPair>> RangeClusters;
+		RangeClusters.SetNum(SerialRanges.Num());
+		ParallelFor(SerialRanges.Num(), [this, &SerialRanges, &RangeClusters](int32 RangeIndex)
+			{
+				TArray<FSortPair> Pairs;
+				Split(SerialRanges[RangeIndex].X, SerialRanges[RangeIndex].Y, RangeClusters[RangeIndex], Pairs);
+			});
+
+		for (const TArray<FRunPair>& RangeCluster : RangeClusters)
+		{
+			Clusters.Append(RangeCluster);
+		}
+	}
+
+	static uint32 ExpandMortonBits(uint32 Value)
+	{
+		Value &= 0x3ff;
+		Value = (Value | (Value << 16)) & 0x030000FF;
+		Value = (Value | (Value << 8)) & 0x0300F00F;
+		Value = (Value | (Value << 4)) & 0x030C30C3;
+		Value = (Value | (Value << 2)) & 0x09249249;
+		return Value;
+	}
+
+	/** Stable LSD radix sort of Values by Keys, each pass histograms and scatters chunks in parallel */
+	static void ParallelRadixSort(TArray<uint32>& Keys, TArray<int32>& Values)
+	{
+		const int32 Count = Keys.Num();
+		const int32 NumChunks = FMath::Clamp(Count / 16384, 1, 64);
+		const int32 ChunkSize = FMath::DivideAndRoundUp(Count, NumChunks);
+
+		TArray<uint32> SortedKeys;
+		TArray<int32> SortedValues;
+		SortedKeys.SetNumUninitialized(Count);
+		SortedValues.SetNumUninitialized(Count);
+
+		TArray<int32> Offsets;
+		Offsets.SetNumUninitialized(NumChunks * 256);
+
+		for (uint32 Shift = 0; Shift < 32; Shift += 8)
+		{
+			ParallelFor(NumChunks, [&](int32 Chunk)
+				{
+					int32* ChunkOffsets = &Offsets[Chunk * 256];
+					FMemory::Memzero(ChunkOffsets, 256 * sizeof(int32));
+					for (int32 Index = Chunk * ChunkSize; Index < FMath::Min((Chunk + 1) * ChunkSize, Count); Index++)
+					{
+						ChunkOffsets[(Keys[Index] >> Shift) & 0xff]++;
+					}
+				});
+
+			// Digit major, chunk minor: keeps the sort stable
+			int32 Offset = 0;
+			for (int32 Digit = 0; Digit < 256; Digit++)
+			{
+				for (int32 Chunk = 0; Chunk < NumChunks; Chunk++)
+				{
+					const int32 DigitCount = Offsets[Chunk * 256 + Digit];
+					Offsets[Chunk * 256 + Digit] = Offset;
+					Offset += DigitCount;
+				}
+			}
+
+			ParallelFor(NumChunks, [&](int32 Chunk)
+				{
+					int32* ChunkOffsets = &Offsets[Chunk * 256];
+					for (int32 Index = Chunk * ChunkSize; Index < FMath::Min((Chunk + 1) * ChunkSize, Count); Index++)
+					{
+						const int32 Destination = ChunkOffsets[(Keys[Index] >> Shift) & 0xff]++;
+						SortedKeys[Destination] = Keys[Index];
+						SortedValues[Destination] = Values[Index];
+					}
+				});
+
+			Swap(Keys, SortedKeys);
+			Swap(Values, SortedValues);
+		}
+	}
+
+	/** Orders SortIndex along a Morton curve and cuts it in equally sized ranges, replacing the top levels of median splits */
+	void MortonRanges(int32 InNum, int32 MinRange, TArray<FIntPoint>& OutRanges)
+	{
+		FBox Bounds(ForceInit);
+		for (int32 Index = 0; Index < InNum; Index++)
+		{
+			Bounds += SortPoints[SortIndex[Index]];
+		}
+		const FVector Scale = FVector(1023.0) / Bounds.GetSize().ComponentMax(FVector(UE_KINDA_SMALL_NUMBER));
+
+		TArray<uint32> Keys;
+		TArray<int32> Values;
+		Keys.SetNumUninitialized(InNum);
+		Values.SetNumUninitialized(InNum);
+		ParallelFor(InNum, [&](int32 Index)
+			{
+				const FVector Cell = ((SortPoints[SortIndex[Index]] - Bounds.Min) * Scale).BoundToBox(FVector::ZeroVector, FVector(1023.0));
+				Keys[Index] = ExpandMortonBits((uint32)Cell.X) | (ExpandMortonBits((uint32)Cell.Y) << 1) | (ExpandMortonBits((uint32)Cell.Z) << 2);
+				Values[Index] = SortIndex[Index];
+			});
+
+		ParallelRadixSort(Keys, Values);
+		FMemory::Memcpy(SortIndex.GetData(), Values.GetData(), InNum * sizeof(int32));
+
+		const int32 NumRanges = FMath::Min<int32>(FMath::RoundUpToPowerOfTwo(FMath::DivideAndRoundUp(InNum, MinRange)), 1024);
+		for (int32 Range = 0; Range < NumRanges; Range++)
+		{
+			const int32 RangeStart = (int32)((int64)InNum * Range / NumRanges);
+			const int32 RangeEnd = (int32)((int64)InNum * (Range + 1) / NumRanges) - 1;
+			if (RangeEnd >= RangeStart)
+			{
+				OutRanges.Emplace(RangeStart, RangeEnd);
+			}
+		}
+	}
+
+	/** Sorts [Start, End] along its largest axis and returns the last index of the left half */
+	int32 Partition(int32 Start, int32 End, TArray<FSortPair>& Pairs)
 	{
 		int32 NumRange = 1 + End - Start;
 		FBox ClusterBounds(ForceInit);
@@ -2181,13 +2552,8 @@ protected:
 		{
 			ClusterBounds += SortPoints[SortIndex[Index]];
 		}
-		if (NumRange <= BranchingFactor)
-		{
-			Clusters.Add(FRunPair(Start, NumRange));
-			return;
-		}
 		checkSlow(NumRange >= 2);
-		SortPairs.Reset();
+		Pairs.Reset();
 		int32 BestAxis = -1;
 		float BestAxisValue = -1.0f;
 		for (int32 Axis = 0; Axis < 3; Axis++)
@@ -2205,12 +2571,12 @@ protected:
 
 			Pair.Index = SortIndex[Index];
 			Pair.d = SortPoints[Pair.Index][BestAxis];
-			SortPairs.Add(Pair);
+			Pairs.Add(Pair);
 		}
-		SortPairs.Sort();
+		Pairs.Sort();
 		for (int32 Index = Start; Index <= End; Index++)
 		{
-			SortIndex[Index] = SortPairs[Index - Start].Index;
+			SortIndex[Index] = Pairs[Index - Start].Index;
 		}
 
 		int32 Half = NumRange / 2;
@@ -2220,7 +2586,7 @@ protected:
 
 		if (NumRange & 1)
 		{
-			if (SortPairs[Half].d - SortPairs[Half - 1].d < SortPairs[Half + 1].d - SortPairs[Half].d)
+			if (Pairs[Half].d - Pairs[Half - 1].d < Pairs[Half + 1].d - Pairs[Half].d)
 			{
 				EndLeft++;
 			}
@@ -2233,8 +2599,7 @@ protected:
 		checkSlow(EndLeft >= Start);
 		checkSlow(End >= StartRight);
 
-		Split(Start, EndLeft);
-		Split(StartRight, End);
+		return EndLeft;
 	}
 
 	void BuildInstanceBuffer()
@@ -2350,16 +2715,31 @@ protected:
 
 		SortIndex.Empty(OriginalNum * DensityScaling);
 
-		for (int32 Index = 0; Index < OriginalNum; Index++)
-		{
-			SortPoints[Index] = Transforms[Index].Transform.GetOrigin();
+		ParallelMode = ParallelModeOverride != INDEX_NONE ? ParallelModeOverride : CVarSWSWParallelTreeBuild.GetValueOnAnyThread();
+		ParallelMinRange = FMath::Max(CVarSWSWParallelTreeBuildMinRange.GetValueOnAnyThread(), 2);
 
-			if (DensityScaling < 1.0f && DensityRand.GetFraction() > DensityScaling)
+		if (ParallelMode > 0 && DensityScaling >= 1.0f)
+		{
+			SortIndex.SetNumUninitialized(OriginalNum);
+			ParallelFor(OriginalNum, [this](int32 Index)
+				{
+					SortPoints[Index] = Transforms[Index].Transform.GetOrigin();
+					SortIndex[Index] = Index;
+				});
+		}
+		else
+		{
+			for (int32 Index = 0; Index < OriginalNum; Index++)
 			{
-				continue;
-			}
+				SortPoints[Index] = Transforms[Index].Transform.GetOrigin();
+
+				if (DensityScaling < 1.0f && DensityRand.GetFraction() > DensityScaling)
+				{
+					continue;
+				}
 
-			SortIndex.Add(Index);
+				SortIndex.Add(Index);
+			}
 		}
 
 		Num = SortIndex.Num();
@@ -2452,12 +2832,157 @@ public:
 		BuildTreeAndBuffer();
 	}
 
+	/** Reuse the tree of the previous build, DirtyRanges are instance ranges (Start, Num) rewritten since then */
+	void SetupRefit(const TArray<FClusterNode>& InNodes, const TSharedPtr < const TArray<int32>, ESPMode::ThreadSafe>& InBuildOrder, int32 InOcclusionLayerNum, double InTreeBoundsArea, double InBaselineTreeBoundsArea, float InRebuildThreshold, TArray<FIntPoint>&& InDirtyRanges)
+	{
+		PreviousNodes = InNodes;
+		PreviousBuildOrder = InBuildOrder;
+		PreviousOcclusionLayerNum = InOcclusionLayerNum;
+		PreviousTreeBoundsArea = InTreeBoundsArea;
+		PreviousBaselineTreeBoundsArea = InBaselineTreeBoundsArea;
+		RebuildThreshold = InRebuildThreshold;
+		DirtyRanges = MoveTemp(InDirtyRanges);
+	}
+
+	const TArray<FIntPoint>& GetDirtyRanges() const { return DirtyRanges; }
+	const TArray<int32>& GetDirtyRenderIndices() const { return DirtyRenderIndices; }
+	bool WasRefitted() const { return bRefitted; }
+
+	/** Time spent building or refitting the tree, instance buffer excluded */
+	double TreeUpdateSeconds = 0.0;
+
 	void BuildTreeAndBuffer()
 	{
-		BuildTree();
+		const double TreeStart = FPlatformTime::Seconds();
+		if (!RefitTree())
+		{
+			BuildTree();
+		}
+		TreeUpdateSeconds = FPlatformTime::Seconds() - TreeStart;
+
 		BuildInstanceBuffer();
 	}
 
+	/*
+	 * Spawnable cells own contiguous instance slots and rewrite them in place when recycled:
+	 * the tree layout remains valid, only the leaves holding rewritten slots and their parents need new bounds.
+	 * Returns false when a full build is required, either because the layout changed or because the refit bounds
+	 * of all nodes grew past RebuildThreshold compared to the last full build: leaves can keep a tight area while
+	 * their parents stretch over both the old and new location of a recycled cell.
+	 */
+	bool RefitTree()
+	{
+		bRefitted = false;
+		DirtyRenderIndices.Reset();
+
+		if (!PreviousBuildOrder.IsValid() || PreviousNodes.Num() == 0 || DirtyRanges.Num() == 0 || DensityScaling < 1.0f || PreviousBuildOrder->Num() != OriginalNum)
+		{
+			return false;
+		}
+
+		Result = MakeUnique<FClusterTree>();
+		TArray<FClusterNode>& Nodes = *Result->Nodes.Get();
+		Nodes = MoveTemp(PreviousNodes);
+		Result->SortedInstances = *PreviousBuildOrder;
+		Result->BuildOrder = PreviousBuildOrder;
+		Result->OutOcclusionLayerNum = PreviousOcclusionLayerNum;
+
+		TArray<int32>& SortedInstances = Result->SortedInstances;
+		Result->InstanceReorderTable.Init(INDEX_NONE, OriginalNum);
+		for (int32 Index = 0; Index < SortedInstances.Num(); Index++)
+		{
+			Result->InstanceReorderTable[SortedInstances[Index]] = Index;
+		}
+
+		// Children are always stored after their parent
+		TArray<int32> Parents;
+		Parents.Init(INDEX_NONE, Nodes.Num());
+		TArray<int32> Leaves;
+		for (int32 NodeIndex = 0; NodeIndex < Nodes.Num(); NodeIndex++)
+		{
+			const FClusterNode& Node = Nodes[NodeIndex];
+			if (Node.FirstChild < 0)
+			{
+				Leaves.Add(NodeIndex);
+				continue;
+			}
+			for (int32 ChildIndex = Node.FirstChild; ChildIndex <= Node.LastChild; ChildIndex++)
+			{
+				Parents[ChildIndex] = NodeIndex;
+			}
+		}
+		Leaves.Sort([&Nodes](const int32 A, const int32 B) { return Nodes[A].FirstInstance < Nodes[B].FirstInstance; });
+
+		TBitArray<> DirtyNodes(false, Nodes.Num());
+		for (const FIntPoint& Range : DirtyRanges)
+		{
+			const int32 RangeEnd = FMath::Min(Range.X + Range.Y, OriginalNum);
+			for (int32 InstanceIndex = FMath::Max(Range.X, 0); InstanceIndex < RangeEnd; InstanceIndex++)
+			{
+				const int32 RenderIndex = Result->InstanceReorderTable[InstanceIndex];
+				if (RenderIndex == INDEX_NONE)
+					continue;
+
+				DirtyRenderIndices.Add(RenderIndex);
+
+				const int32 LeafSlot = Algo::UpperBoundBy(Leaves, RenderIndex, [&Nodes](const int32 LeafIndex) { return Nodes[LeafIndex].FirstInstance; }) - 1;
+				if (Leaves.IsValidIndex(LeafSlot))
+				{
+					DirtyNodes[Leaves[LeafSlot]] = true;
+				}
+			}
+		}
+
+		double TreeBoundsArea = PreviousTreeBoundsArea;
+
+		for (int32 NodeIndex = Nodes.Num() - 1; NodeIndex >= 0; NodeIndex--)
+		{
+			if (!DirtyNodes[NodeIndex])
+				continue;
+
+			FClusterNode& Node = Nodes[NodeIndex];
+			TreeBoundsArea -= GetBoundsArea(Node);
+			if (Node.FirstChild < 0)
+			{
+				ComputeLeafBounds(Node, SortedInstances);
+			}
+			else
+			{
+				ComputeInternalBounds(Node);
+			}
+			TreeBoundsArea += GetBoundsArea(Node);
+
+			if (Parents[NodeIndex] != INDEX_NONE)
+			{
+				DirtyNodes[Parents[NodeIndex]] = true;
+			}
+		}
+
+		Result->TreeBoundsArea = TreeBoundsArea;
+		Result->BaselineTreeBoundsArea = PreviousBaselineTreeBoundsArea;
+
+		if (PreviousBaselineTreeBoundsArea > 0.0 && TreeBoundsArea > PreviousBaselineTreeBoundsArea * RebuildThreshold)
+		{
+			DirtyRenderIndices.Reset();
+			return false;
+		}
+
+		// Ranges rewritten twice before the build overlap
+		DirtyRenderIndices.Sort();
+		int32 NumUnique = 0;
+		for (int32 Index = 0; Index < DirtyRenderIndices.Num(); Index++)
+		{
+			if (NumUnique == 0 || DirtyRenderIndices[NumUnique - 1] != DirtyRenderIndices[Index])
+			{
+				DirtyRenderIndices[NumUnique++] = DirtyRenderIndices[Index];
+			}
+		}
+		DirtyRenderIndices.SetNum(NumUnique, false);
+
+		bRefitted = true;
+		return true;
+	}
+
 	void BuildTree()
 	{
 		Init();
@@ -2494,35 +3019,23 @@ public:
 		NumRoots = Clusters.Num();
 		Result->Nodes.Get()->Init(FClusterNode(), Clusters.Num());
 
-		for (int32 Index = 0; Index < NumRoots; Index++)
-		{
-			FClusterNode& Node = (*Result->Nodes.Get())[Index];
-			Node.FirstInstance = Clusters[Index].Start;
-			Node.LastInstance = Clusters[Index].Start + Clusters[Index].Num - 1;
-			FBox NodeBox(ForceInit);
-			for (int32 InstanceIndex = Node.FirstInstance; InstanceIndex <= Node.LastInstance; InstanceIndex++)
-			{
-				const FMatrix& ThisInstTrans = Transforms[SortedInstances[InstanceIndex]].Transform;
-				FBox ThisInstBox = InstBox.TransformBy(ThisInstTrans);
-				NodeBox += ThisInstBox;
+		const bool bSingleThreaded = ParallelMode == 0;
 
-				if (GenerateInstanceScalingRange)
-				{
-					FVector3f CurrentScale(ThisInstTrans.GetScaleVector());
+		ParallelFor(NumRoots, [this, &SortedInstances](int32 Index)
+			{
+				FClusterNode& Node = (*Result->Nodes.Get())[Index];
+				Node.FirstInstance = Clusters[Index].Start;
+				Node.LastInstance = Clusters[Index].Start + Clusters[Index].Num - 1;
+				ComputeLeafBounds(Node, SortedInstances);
+			}, bSingleThreaded);
 
-					Node.MinInstanceScale = Node.MinInstanceScale.ComponentMin(CurrentScale);
-					Node.MaxInstanceScale = Node.MaxInstanceScale.ComponentMax(CurrentScale);
-				}
-			}
-			Node.BoundMin = (FVector3f)NodeBox.Min;
-			Node.BoundMax = (FVector3f)NodeBox.Max;
-		}
 		TArray<int32> NodesPerLevel;
 		NodesPerLevel.Add(NumRoots);
 		int32 LOD = 0;
 
 		TArray<int32> InverseSortIndex;
 		TArray<int32> RemapSortIndex;
+		TArray<int32> RootOutIndex;
 		TArray<int32> InverseInstanceIndex;
 		TArray<int32> OldInstanceIndex;
 		TArray<int32> LevelStarts;
@@ -2566,21 +3079,31 @@ public:
 				// rearrange the instances to match the new order of the old roots
 				RemapSortIndex.Reset();
 				RemapSortIndex.AddUninitialized(Num);
+				RootOutIndex.Reset();
+				RootOutIndex.AddUninitialized(NumRoots);
 				int32 OutIndex = 0;
 				for (int32 Index = 0; Index < NumRoots; Index++)
 				{
-					FClusterNode& Node = (*Result->Nodes.Get())[SortIndex[Index]];
-					for (int32 InstanceIndex = Node.FirstInstance; InstanceIndex <= Node.LastInstance; InstanceIndex++)
-					{
-						RemapSortIndex[OutIndex++] = InstanceIndex;
-					}
+					const FClusterNode& Node = (*Result->Nodes.Get())[SortIndex[Index]];
+					RootOutIndex[Index] = OutIndex;
+					OutIndex += 1 + Node.LastInstance - Node.FirstInstance;
 				}
+				ParallelFor(NumRoots, [this, &RemapSortIndex, &RootOutIndex](int32 Index)
+					{
+						const FClusterNode& Node = (*Result->Nodes.Get())[SortIndex[Index]];
+						int32 RootOut = RootOutIndex[Index];
+						for (int32 InstanceIndex = Node.FirstInstance; InstanceIndex <= Node.LastInstance; InstanceIndex++)
+						{
+							RemapSortIndex[RootOut++] = InstanceIndex;
+						}
+					}, bSingleThreaded);
+
 				InverseInstanceIndex.Reset();
 				InverseInstanceIndex.AddUninitialized(Num);
-				for (int32 Index = 0; Index < Num; Index++)
-				{
-					InverseInstanceIndex[RemapSortIndex[Index]] = Index;
-				}
+				ParallelFor(Num, [&InverseInstanceIndex, &RemapSortIndex](int32 Index)
+					{
+						InverseInstanceIndex[RemapSortIndex[Index]] = Index;
+					}, bSingleThreaded);
 				for (int32 Index = 0; Index < (*Result->Nodes.Get()).Num(); Index++)
 				{
 					FClusterNode& Node = (*Result->Nodes.Get())[Index];
@@ -2590,10 +3113,10 @@ public:
 				OldInstanceIndex.Reset();
 				Swap(OldInstanceIndex, SortedInstances);
 				SortedInstances.AddUninitialized(Num);
-				for (int32 Index = 0; Index < Num; Index++)
-				{
-					SortedInstances[Index] = OldInstanceIndex[RemapSortIndex[Index]];
-				}
+				ParallelFor(Num, [&SortedInstances, &OldInstanceIndex, &RemapSortIndex](int32 Index)
+					{
+						SortedInstances[Index] = OldInstanceIndex[RemapSortIndex[Index]];
+					}, bSingleThreaded);
 			}
 			{
 				// rearrange the nodes to match the new order of the old roots
@@ -2682,21 +3205,7 @@ public:
 					Node.LastInstance = (*Result->Nodes.Get())[Node.LastChild].LastInstance;
 					InstanceTracker = Node.LastInstance + 1;
 					checkSlow(InstanceTracker <= Num);
-					FBox NodeBox(ForceInit);
-					for (int32 ChildIndex = Node.FirstChild; ChildIndex <= Node.LastChild; ChildIndex++)
-					{
-						FClusterNode& ChildNode = (*Result->Nodes.Get())[ChildIndex];
-						NodeBox += (FVector)ChildNode.BoundMin;
-						NodeBox += (FVector)ChildNode.BoundMax;
-
-						if (GenerateInstanceScalingRange)
-						{
-							Node.MinInstanceScale = Node.MinInstanceScale.ComponentMin(ChildNode.MinInstanceScale);
-							Node.MaxInstanceScale = Node.MaxInstanceScale.ComponentMax(ChildNode.MaxInstanceScale);
-						}
-					}
-					Node.BoundMin = (FVector3f)NodeBox.Min;
-					Node.BoundMax = (FVector3f)NodeBox.Max;
+					ComputeInternalBounds(Node);
 				}
 				NumRoots = Clusters.Num();
 				NodesPerLevel.Insert(NumRoots, 0);
@@ -2705,10 +3214,15 @@ public:
 
 		// Save inverse map
 		Result->InstanceReorderTable.Init(INDEX_NONE, OriginalNum);
-		for (int32 Index = 0; Index < Num; Index++)
-		{
-			Result->InstanceReorderTable[SortedInstances[Index]] = Index;
-		}
+		ParallelFor(Num, [this, &SortedInstances](int32 Index)
+			{
+				Result->InstanceReorderTable[SortedInstances[Index]] = Index;
+			}, bSingleThreaded);
+		Result->BuildOrder = MakeShared<TArray<int32>, ESPMode::ThreadSafe>(SortedInstances);
+
+		// Upper levels degrade first when refitted instances move away from their cluster
+		Result->TreeBoundsArea = GetTreeBoundsArea(*Result->Nodes.Get());
+		Result->BaselineTreeBoundsArea = Result->TreeBoundsArea;
 
 		// Output a general scale of 1 if we dont want the scaling range
 		if (!GenerateInstanceScalingRange)
@@ -2721,6 +3235,118 @@ public:
 
 
 };
+/** Nodes differing between two trees built from the same instances, -1 when the layouts differ */
+static int32 CountDifferingTreeNodes(const SW_HISM::FClusterTree& A, const SW_HISM::FClusterTree& B)
+{
+	const TArray<FClusterNode>& NodesA = *A.Nodes.Get();
+	const TArray<FClusterNode>& NodesB = *B.Nodes.Get();
+
+	if (NodesA.Num() != NodesB.Num() || A.OutOcclusionLayerNum != B.OutOcclusionLayerNum || A.InstanceReorderTable != B.InstanceReorderTable)
+		return INDEX_NONE;
+
+	int32 Differing = 0;
+	for (int32 NodeIndex = 0; NodeIndex < NodesA.Num(); NodeIndex++)
+	{
+		const FClusterNode& NodeA = NodesA[NodeIndex];
+		const FClusterNode& NodeB = NodesB[NodeIndex];
+
+		if (NodeA.FirstChild != NodeB.FirstChild || NodeA.LastChild != NodeB.LastChild
+			|| NodeA.FirstInstance != NodeB.FirstInstance || NodeA.LastInstance != NodeB.LastInstance
+			|| NodeA.BoundMin != NodeB.BoundMin || NodeA.BoundMax != NodeB.BoundMax
+			|| NodeA.MinInstanceScale != NodeB.MinInstanceScale || NodeA.MaxInstanceScale != NodeB.MaxInstanceScale)
+		{
+			Differing++;
+		}
+	}
+	return Differing;
+}
+
+/*
+ * Tree update cost against instance count: full build versus refit after a single spawnable cell recycled its slots.
+ * Cells hold 1024 contiguous instances on a 32m grid, the first cell is moved past the last column like a camera scroll would.
+ * The full build also runs single threaded, ParallelTreeBuild 1 must produce the very same tree node by node.
+ */
+static void BenchmarkTreeUpdate(const TArray<FString>& Args)
+{
+	const int32 MaxInstances = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 500000;
+	const int32 InstanceCounts[] = { 10000, 50000, 100000, 250000, 500000, 1000000 };
+
+	constexpr int32 InstancesPerCell = 1024;
+	constexpr int32 InstancesPerLeaf = 64;
+	constexpr double CellSize = 3200.0;
+	const FBox MeshBox(FVector(-50.0), FVector(50.0));
+	const float RebuildThreshold = CVarSWSWTreeRefitRebuildThreshold.GetValueOnGameThread();
+
+	for (const int32 NumInstances : InstanceCounts)
+	{
+		if (NumInstances > MaxInstances)
+			break;
+
+		TSharedPtr < FSWInstancedStaticMeshInstanceDatas, ESPMode::ThreadSafe > Data = MakeShared<FSWInstancedStaticMeshInstanceDatas, ESPMode::ThreadSafe>();
+		Data->PerInstanceSMData.SetNum(NumInstances);
+
+		const int32 NumCells = FMath::DivideAndRoundUp(NumInstances, InstancesPerCell);
+		const int32 CellsPerRow = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumCells)));
+
+		FRandomStream RandomStream(NumInstances);
+		auto FillCell = [&](int32 Cell, int32 CellX, int32 CellY)
+		{
+			const int32 End = FMath::Min((Cell + 1) * InstancesPerCell, NumInstances);
+			for (int32 InstanceIndex = Cell * InstancesPerCell; InstanceIndex < End; InstanceIndex++)
+			{
+				const FVector Location((CellX + RandomStream.FRand()) * CellSize, (CellY + RandomStream.FRand()) * CellSize, RandomStream.FRand() * 100.0);
+				Data->PerInstanceSMData[InstanceIndex].Transform = FTranslationMatrix(Location);
+			}
+		};
+
+		for (int32 Cell = 0; Cell < NumCells; Cell++)
+		{
+			FillCell(Cell, Cell % CellsPerRow, Cell / CellsPerRow);
+		}
+
+		auto MakeBuilder = [&](int32 ParallelMode)
+		{
+			TSharedRef<SW_HISM::FClusterBuilder, ESPMode::ThreadSafe> Builder = MakeShared<SW_HISM::FClusterBuilder, ESPMode::ThreadSafe>(TWeakObjectPtr<USWHISMComponent>(), Data, MakeShared<TArray<FPrimitiveInstance, TInlineAllocator<1>>, ESPMode::ThreadSafe>(), MakeShared<TArray<float>, ESPMode::ThreadSafe>(), Data->PerInstanceSMData, TArray<float>(), 0, MeshBox, InstancesPerLeaf, 1.f, 1, true, false);
+			Builder->ParallelModeOverride = ParallelMode;
+			return Builder;
+		};
+
+		TSharedRef<SW_HISM::FClusterBuilder, ESPMode::ThreadSafe> SingleThreadedBuild = MakeBuilder(0);
+		double Start = FPlatformTime::Seconds();
+		SingleThreadedBuild->BuildTreeAndBufferAsync(ENamedThreads::GameThread, FGraphEventRef());
+		const double SingleThreadedMs = (FPlatformTime::Seconds() - Start) * 1000.0;
+
+		TSharedRef<SW_HISM::FClusterBuilder, ESPMode::ThreadSafe> FullBuild = MakeBuilder(1);
+		Start = FPlatformTime::Seconds();
+		FullBuild->BuildTreeAndBufferAsync(ENamedThreads::GameThread, FGraphEventRef());
+		const double FullMs = (FPlatformTime::Seconds() - Start) * 1000.0;
+
+		const int32 DifferingNodes = CountDifferingTreeNodes(*SingleThreadedBuild->Result, *FullBuild->Result);
+		if (DifferingNodes != 0)
+		{
+			UE_LOG(LogStaticMesh, Error, TEXT("SW HISM tree update | %7d instances | ParallelTreeBuild 1 differs from the single threaded tree: %s"),
+				NumInstances, DifferingNodes == INDEX_NONE ? TEXT("layout or instance order") : *FString::Printf(TEXT("%d of %d nodes"), DifferingNodes, FullBuild->Result->Nodes->Num()));
+		}
+
+		FillCell(0, CellsPerRow, 0);
+
+		TSharedRef<SW_HISM::FClusterBuilder, ESPMode::ThreadSafe> Refit = MakeBuilder(1);
+		Refit->SetupRefit(*FullBuild->Result->Nodes, FullBuild->Result->BuildOrder, FullBuild->Result->OutOcclusionLayerNum, FullBuild->Result->TreeBoundsArea, FullBuild->Result->BaselineTreeBoundsArea, RebuildThreshold, { FIntPoint(0, FMath::Min(InstancesPerCell, NumInstances)) });
+		Start = FPlatformTime::Seconds();
+		Refit->BuildTreeAndBufferAsync(ENamedThreads::GameThread, FGraphEventRef());
+		const double RefitMs = (FPlatformTime::Seconds() - Start) * 1000.0;
+
+		UE_LOG(LogStaticMesh, Display, TEXT("SW HISM tree update | %7d instances | single threaded build %8.2fms (tree %8.2fms) | full build %8.2fms (tree %8.2fms) | cell refit %8.2fms (tree %8.2fms)%s"),
+			NumInstances, SingleThreadedMs, SingleThreadedBuild->TreeUpdateSeconds * 1000.0, FullMs, FullBuild->TreeUpdateSeconds * 1000.0, RefitMs, Refit->TreeUpdateSeconds * 1000.0, Refit->WasRefitted() ? TEXT("") : TEXT(" | fell back to full build"));
+	}
+}
+
+static FAutoConsoleCommand BenchmarkTreeUpdateCmd(
+	TEXT("SWfoliageSW.BenchmarkTreeUpdate"),
+	TEXT("Logs single threaded build, parallel build and single cell refit timings of the cluster tree for growing instance counts, and checks both builds match node by node. Optional argument: max instance count (default 500000)."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkTreeUpdate)
+);
+
 void USWHISMComponent::SWUpdateTree()
 {
 	if(SWPerInstanceSMData.IsValid())
@@ -3002,8 +3628,11 @@ bool USWHISMComponent::SWBatchUpdateInstancesDataInternal(int32 StartInstanceInd
 	return true;
 }
 
-bool USWHISMComponent::SWNewBatchUpdateCountInstanceData(int32 StartInstanceIndex, int32 NumInstances,	TArray<FInstancedStaticMeshInstanceData>& NewInstancesTransforms, bool bWorldSpace, bool bMarkRenderStateDirty,	bool bTeleport, int32 StartInstanceDataIndex)
+bool USWHISMComponent::SWNewBatchUpdateCountInstanceData(int32 StartInstanceIndex, int32 NumInstances,	TArray<FInstancedStaticMeshInstanceData>& NewInstancesTransforms, bool bWorldSpace, bool bMarkRenderStateDirty,	bool bTeleport, int32 StartInstanceDataIndex, int32* OutNumWritten)
 {
+	if (OutNumWritten)
+		*OutNumWritten = 0;
+
 	if(!SWPerInstanceSMData.IsValid())
 	{
 		return false;
@@ -3024,7 +3653,58 @@ bool USWHISMComponent::SWNewBatchUpdateCountInstanceData(int32 StartInstanceInde
 	 */
 	//Modify();
 
-	FMemory::Memcpy(&SWPerInstanceSMData->PerInstanceSMData[StartInstanceIndex], &StartInstanceData[StartInstanceDataIndex], NumInstances * sizeof(FMatrix));
+	// Cells recomputed in place (brush edits, position adjustments) mostly write back the transforms they already hold:
+	// only the runs of modified instances are copied, flagged for the tree refit and sent to physics
+	const int32 MaxUnchangedGap = CVarSWSWDeltaUpdateMaxGap.GetValueOnGameThread();
+
+	int32 RunStart = INDEX_NONE;
+	int32 RunEnd = INDEX_NONE;
+
+	for (int32 k = 0; k <= NumInstances; k++)
+	{
+		const bool bChanged = k < NumInstances && (MaxUnchangedGap < 0 || FMemory::Memcmp(&SWPerInstanceSMData->PerInstanceSMData[StartInstanceIndex + k], &StartInstanceData[StartInstanceDataIndex + k], sizeof(FMatrix)) != 0);
+
+		if (bChanged)
+		{
+			if (RunStart == INDEX_NONE)
+				RunStart = k;
+
+			RunEnd = k;
+			continue;
+		}
+
+		// Short unchanged gaps are copied along, to keep the number of ranges low
+		if (RunStart != INDEX_NONE && (k == NumInstances || k - RunEnd > MaxUnchangedGap))
+		{
+			SWNewUpdateInstanceRange(StartInstanceIndex + RunStart, RunEnd - RunStart + 1, &StartInstanceData[StartInstanceDataIndex + RunStart], bTeleport);
+
+			if (OutNumWritten)
+				*OutNumWritten += RunEnd - RunStart + 1;
+
+			RunStart = INDEX_NONE;
+		}
+	}
+
+	return true;
+}
+
+void USWHISMComponent::SWNewUpdateInstanceRange(int32 StartInstanceIndex, int32 NumInstances, const FInstancedStaticMeshInstanceData* SourceInstanceData, bool bTeleport)
+{
+	FMemory::Memcpy(&SWPerInstanceSMData->PerInstanceSMData[StartInstanceIndex], SourceInstanceData, NumInstances * sizeof(FMatrix));
+
+	// Slots rewritten in place: the next tree update only needs to refit the clusters holding them
+	if (SWDirtyInstanceRanges.Num() > 0 && (SWDirtyInstanceRanges.Last().X + SWDirtyInstanceRanges.Last().Y) == StartInstanceIndex)
+	{
+		SWDirtyInstanceRanges.Last().Y += NumInstances;
+	}
+	else
+	{
+		SWDirtyInstanceRanges.Add(FIntPoint(StartInstanceIndex, NumInstances));
+	}
+
+	bIsOutOfDate = true;
+	// invalidate the results of the current async build we need to modify the tree
+	bConcurrentChanges |= IsAsyncBuilding();
 
 	if (bPhysicsStateCreated)
 	{
@@ -3144,8 +3824,6 @@ bool USWHISMComponent::SWNewBatchUpdateCountInstanceData(int32 StartInstanceInde
 	{
 		MarkRenderStateDirty();
 	}*/
-
-	return true;
 }
 
 FVector USWHISMComponent::SWCalcTranslatedInstanceSpaceOrigin() const
@@ -3187,6 +3865,10 @@ void USWHISMComponent::SWNewApplyBuildTree(SW_HISM::FClusterBuilder& Builder)
 	{
 		//DrawClusterTree(*Builder.Result->Nodes, 0);
 
+		// Slots rewritten in place: update the current proxy rather than uploading every instance again
+		if (SWUpdateProxyInstances(Builder))
+			return;
+
 		if (!PerInstanceRenderData.IsValid())
 		{
 			InitPerInstanceRenderData(true, Builder.BuiltInstanceData.Get(), Builder.RequireCPUAccess/*, Inner.Builder->RequireCPUAccess*/);
@@ -3210,8 +3892,16 @@ void USWHISMComponent::SWNewApplyBuildTree(SW_HISM::FClusterBuilder& Builder)
 			InstanceReorderTable = MoveTemp(Builder.Result->InstanceReorderTable);
 			SortedInstances = MoveTemp(Builder.Result->SortedInstances);
 			CacheMeshExtendedBounds = GetStaticMesh()->GetBounds();
+
+			SWTreeBuildOrder = Builder.Result->BuildOrder;
+			SWTreeBoundsArea = Builder.Result->TreeBoundsArea;
+			SWTreeBaselineBoundsArea = Builder.Result->BaselineTreeBoundsArea;
 		}
 
+#if SWDEBUG
+		SW_LOG("%s tree of %d instances in %.2fms | %s", Builder.WasRefitted() ? TEXT("Refit") : TEXT("Built"), NumRenderInstances, Builder.TreeUpdateSeconds * 1000.0, *GetFName().ToString())
+#endif
+
 		AcceptPrebuiltTree(Builder.Result->InstanceData, *Builder.Result->Nodes.Get(), Builder.Result->OutOcclusionLayerNum, NumRenderInstances);
 
 		
@@ -3224,6 +3914,8 @@ void USWHISMComponent::SWNewApplyBuildTree(SW_HISM::FClusterBuilder& Builder)
 	}
 	else
 	{
+		SWTreeBuildOrder.Reset();
+
 		SW_LOG("Received Builder.Result->SortedInstances.Num() %d Builder.Result->Nodes->Num() %d", Builder.Result->SortedInstances.Num(), Builder.Result->Nodes->Num())
 	}
 
@@ -3231,6 +3923,69 @@ void USWHISMComponent::SWNewApplyBuildTree(SW_HISM::FClusterBuilder& Builder)
 
 }
 
+bool USWHISMComponent::SWUpdateProxyInstances(SW_HISM::FClusterBuilder& Builder)
+{
+	if (CVarSWSWPartialInstanceUpload.GetValueOnGameThread() <= 0 || !Builder.WasRefitted() || Builder.GetDirtyRenderIndices().Num() == 0)
+		return false;
+
+	// A pending recreation uploads everything anyway
+	if (!SceneProxy || IsRenderStateDirty() || !GetScene() || !PerInstanceRenderData.IsValid() || !ClusterTreePtr.IsValid())
+		return false;
+
+	if (ShouldCreateNaniteProxy() || NumCustomDataFloats > 0 || !UseGPUScene(GetScene()->GetShaderPlatform(), GetScene()->GetFeatureLevel()))
+		return false;
+
+	const int32 NumRenderInstances = Builder.Result->SortedInstances.Num();
+	if (NumRenderInstances != NumBuiltRenderInstances || Builder.Result->Nodes->Num() != ClusterTreePtr->Num() || Builder.Result->OutOcclusionLayerNum != OcclusionLayerNumNodes
+		|| !Builder.InstanceSceneData.IsValid() || Builder.InstanceSceneData->Num() != NumRenderInstances)
+		return false;
+
+	SW_FCT_CYCLE()
+
+	PerInstanceSMData.Empty();
+
+	SWInstanceSceneData = Builder.InstanceSceneData;
+	SWInstanceRandomID = Builder.InstanceRandomID;
+
+	NumBuiltInstances = Builder.Result->InstanceReorderTable.Num();
+	InstanceReorderTable = MoveTemp(Builder.Result->InstanceReorderTable);
+	SortedInstances = MoveTemp(Builder.Result->SortedInstances);
+
+	SWTreeBuildOrder = Builder.Result->BuildOrder;
+	SWTreeBoundsArea = Builder.Result->TreeBoundsArea;
+	SWTreeBaselineBoundsArea = Builder.Result->BaselineTreeBoundsArea;
+
+	// The proxy copies the nodes into its own array, this one is only read from now on
+	ClusterTreePtr = Builder.Result->Nodes;
+	BuiltInstanceBounds = GetClusterTreeBounds(*ClusterTreePtr, FVector::Zero());
+
+	FSWHISMProxyInstanceUpdate Update;
+	Update.ClusterTree = Builder.Result->Nodes;
+	Update.RenderIndices = Builder.GetDirtyRenderIndices();
+	Update.InstanceSceneData = Builder.InstanceSceneData;
+	Update.InstanceRandomID = Builder.InstanceRandomID;
+
+	SWHISMComponentSceneProxy* HISMProxy = static_cast<SWHISMComponentSceneProxy*>(SceneProxy);
+
+	ENQUEUE_RENDER_COMMAND(FSWHISMPartialInstanceUpdate)
+		([HISMProxy, Update = MoveTemp(Update)](FRHICommandListImmediate& RHICmdList)
+		{
+			HISMProxy->UpdateRefittedInstances_RenderThread(Update);
+		});
+
+#if SWDEBUG
+	SW_LOG("Refit tree of %d instances in %.2fms, %d instances sent to the proxy | %s", NumRenderInstances, Builder.TreeUpdateSeconds * 1000.0, Builder.GetDirtyRenderIndices().Num(), *GetFName().ToString())
+#endif
+
+	PostBuildStats();
+
+	// New bounds reach the render thread with the transform update
+	UpdateBounds();
+	MarkRenderTransformDirty();
+
+	return true;
+}
+
 void USWHISMComponent::SWNewApplyBuildTreeAsync(ENamedThreads::Type CurrentThread,
                                                 const FGraphEventRef& MyCompletionGraphEvent, TSharedRef<SW_HISM::FClusterBuilder, ESPMode::ThreadSafe> Builder,
                                                 double StartTime)
@@ -3267,6 +4022,17 @@ void USWHISMComponent::SWNewApplyBuildTreeAsync(ENamedThreads::Type CurrentThrea
 
 		UE_LOG(LogStaticMesh, Verbose, TEXT("Discarded foliage hierarchy of %d elements build due to concurrent removal (%.1fs)"), Builder->Result->InstanceReorderTable.Num(), (float)(FPlatformTime::Seconds() - StartTime));
 
+		// The discarded build consumed its dirty ranges, the next one still has to refit them against the applied tree.
+		// A discarded full build did not track them: the applied tree can not be refit anymore.
+		if (Builder->GetDirtyRanges().Num() > 0)
+		{
+			SWDirtyInstanceRanges.Insert(Builder->GetDirtyRanges(), 0);
+		}
+		else
+		{
+			SWTreeBuildOrder.Reset();
+		}
+
 		// There were changes while we were building, it's too slow to fix up the result now, so build async again.
 		SWNewBuildTreeAsync();
 
@@ -3356,10 +4122,34 @@ void USWHISMComponent::SWNewBuildTreeAsync()
 
 		TSharedRef<SW_HISM::FClusterBuilder, ESPMode::ThreadSafe> Builder(new SW_HISM::FClusterBuilder(TWeakObjectPtr<USWHISMComponent>(this), SWPerInstanceSMData, BuilderInstanceSceneData, BuilderInstanceRandomID, SWPerInstanceSMData->PerInstanceSMData, PerInstanceSMCustomData, NumCustomDataFloats, GetStaticMesh()->GetBounds().GetBox(), DesiredInstancesPerLeaf(), CurrentDensityScaling, InstancingRandomSeed, SWPerInstanceSMData->PerInstanceSMData.Num() > 0, bKeepInstanceBufferCPUCopy));
 
+		// Only rewritten slots since the applied tree: refit it, the builder falls back to a full build if the layout changed
+		const bool bCanRefit = CVarSWSWTreeRefit.GetValueOnGameThread() > 0
+			&& SWTreeBuildOrder.IsValid()
+			&& ClusterTreePtr.IsValid()
+			&& ClusterTreePtr->Num() > 0
+			&& CacheMeshExtendedBounds == GetStaticMesh()->GetBounds();
+
+		if (bCanRefit && SWDirtyInstanceRanges.Num() > 0)
+		{
+			Builder->SetupRefit(*ClusterTreePtr, SWTreeBuildOrder, OcclusionLayerNumNodes, SWTreeBoundsArea, SWTreeBaselineBoundsArea, CVarSWSWTreeRefitRebuildThreshold.GetValueOnGameThread(), MoveTemp(SWDirtyInstanceRanges));
+		}
+		SWDirtyInstanceRanges.Reset();
+
 		bIsAsyncBuilding = true;
 
-		FGraphEventRef BuildTreeAsyncResult(
-			FDelegateGraphTask::CreateAndDispatchWhenReady(FDelegateGraphTask::FDelegate::CreateRaw(&Builder.Get(), &SW_HISM::FClusterBuilder::BuildTreeAndBufferAsync), GET_STATID(STAT_SWFoliageBuildTime), NULL, ENamedThreads::GameThread, ENamedThreads::AnyBackgroundThreadNormalTask));
+		// Scheduled along the other Shader World jobs: counts against their concurrency cap, behind collision work
+		FGraphEventRef BuildTreeAsyncResult = FGraphEvent::CreateGraphEvent();
+
+		FSWTaskDesc BuildDesc;
+		BuildDesc.DebugName = TEXT("SWHISMTreeBuild");
+		BuildDesc.Stage = ESWTaskStage::Cook;
+		BuildDesc.Priority = ESWTaskPriority::Normal;
+
+		FSWTaskGraph::Get().Launch(BuildDesc, [Builder, BuildTreeAsyncResult]()
+			{
+				Builder->BuildTreeAndBufferAsync(ENamedThreads::AnyThread, FGraphEventRef());
+				BuildTreeAsyncResult->DispatchSubsequents();
+			});
 
 		BuildTreeAsyncTasks.Add(BuildTreeAsyncResult);
 
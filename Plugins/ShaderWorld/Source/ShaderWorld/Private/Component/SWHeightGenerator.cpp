@@ -0,0 +1,178 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+#include "Component/SWHeightGenerator.h"
+
+double FSWHeightEvaluator::ComputeHeight(const FVector2D& Location, uint16& MaterialIndice) const
+{
+	double Height = EvaluateGenerator(Location, MaterialIndice) * HeightScale;
+
+	for (const FSWCPUBrushStackElement& Element : BrushStack)
+	{
+		if (Element.Brush.IsValid() && Element.Brush->FootPrint.IsInside(Location))
+			Height = Element.Brush->ApplyBrushAt(Location, Height, Element.LayerInfluence, Element.BrushInfluence);
+	}
+
+	return Height;
+}
+
+void FSWHeightEvaluator::ComputeSpawnableTransforms(const FSWCPUSpawnableSettings& Settings, const FIntPoint& Cell, TArray<TArray<FTransform>>& OutTransforms) const
+{
+	const int32 NumVariants = FMath::Max(1, Settings.NumVariants);
+
+	OutTransforms.SetNum(NumVariants);
+	for (TArray<FTransform>& VariantTransforms : OutTransforms)
+		VariantTransforms.Reset();
+
+	if (Settings.InstanceCount <= 0 || Settings.GridSize <= 0.0)
+		return;
+
+	// Cells are centered on multiples of GridSize, like the GPU spawnable grid
+	const int32 Dim = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(Settings.InstanceCount)));
+	const double Slot = Settings.GridSize / Dim;
+	const FVector2D CellMin = FVector2D(Cell.X, Cell.Y) * Settings.GridSize - FVector2D(Settings.GridSize / 2.0);
+	const double NormalDelta = FMath::Max(Slot * 0.25, 10.0);
+
+	FRandomStream Stream(static_cast<int32>(HashCombine(HashCombine(GetTypeHash(Cell.X), GetTypeHash(Cell.Y)), Settings.Seed)));
+
+	for (int32 k = 0; k < Settings.InstanceCount; k++)
+	{
+		// Every candidate draws the same random numbers, rejected or not: placement does not depend on the terrain elsewhere
+		const double JitterX = Stream.GetFraction();
+		const double JitterY = Stream.GetFraction();
+		const float Yaw = Stream.FRandRange(0.f, 360.f);
+		const float Scale = Stream.FRandRange(Settings.ScaleRange.Min, Settings.ScaleRange.Max);
+		const float VerticalOffset = Stream.FRandRange(Settings.VerticalOffsetRange.Min, Settings.VerticalOffsetRange.Max);
+		const int32 Variant = Stream.RandHelper(NumVariants);
+
+		const FVector2D Location = CellMin + FVector2D(((k % Dim) + JitterX) * Slot, ((k / Dim) + JitterY) * Slot);
+
+		uint16 MaterialIndice = 0;
+		const double Altitude = Settings.GroundAltitude + ComputeHeight(Location, MaterialIndice);
+
+		if (Altitude < Settings.AltitudeRange.Min || Altitude > Settings.AltitudeRange.Max)
+			continue;
+
+		const double dHdX = ComputeHeight(Location + FVector2D(NormalDelta, 0.0), MaterialIndice) - ComputeHeight(Location - FVector2D(NormalDelta, 0.0), MaterialIndice);
+		const double dHdY = ComputeHeight(Location + FVector2D(0.0, NormalDelta), MaterialIndice) - ComputeHeight(Location - FVector2D(0.0, NormalDelta), MaterialIndice);
+		const FVector Normal = FVector(-dHdX, -dHdY, 2.0 * NormalDelta).GetSafeNormal();
+
+		const float SlopeAngle = FMath::RadiansToDegrees(FMath::Acos(FMath::Clamp(Normal.Z, -1.0, 1.0)));
+
+		if (SlopeAngle < Settings.GroundSlopeAngle.Min || SlopeAngle > Settings.GroundSlopeAngle.Max)
+			continue;
+
+		FQuat Rotation(FVector::UpVector, FMath::DegreesToRadians(Yaw));
+
+		if (Settings.bAlignToTerrainSlope && SlopeAngle > UE_KINDA_SMALL_NUMBER)
+		{
+			const float AlignAngle = FMath::Min(SlopeAngle, Settings.AlignMaxAngle);
+			const FQuat ToNormal = FQuat::Slerp(FQuat::Identity, FQuat::FindBetweenNormals(FVector::UpVector, Normal), AlignAngle / SlopeAngle);
+
+			Rotation = ToNormal * FQuat(FVector::UpVector, FMath::DegreesToRadians(Yaw + Settings.YawOffsetAlignToTerrainSlope));
+		}
+
+		OutTransforms[Variant].Add(FTransform(Rotation, FVector(Location.X, Location.Y, Altitude + VerticalOffset), FVector(Scale)));
+	}
+}
+
+class FSWNoiseHeightEvaluator : public FSWHeightEvaluator
+{
+public:
+	virtual double EvaluateGenerator(const FVector2D& Location, uint16& MaterialIndice) const override
+	{
+		double Height = 0.0;
+		double Frequency = BaseFrequency;
+		double Amplitude = BaseAmplitude;
+
+		for (int32 Octave = 0; Octave < Octaves; Octave++)
+		{
+			// PerlinNoise2D is 256-periodic: wrapping the domain is seamless and keeps float precision far from origin
+			const FVector2D Sample = Location * Frequency + SeedOffset * (Octave + 1);
+			Height += Amplitude * FMath::PerlinNoise2D(FVector2D(FMath::Fmod(Sample.X, 4096.0), FMath::Fmod(Sample.Y, 4096.0)));
+
+			Frequency *= Lacunarity;
+			Amplitude *= Persistence;
+		}
+
+		Height += BaseAltitude;
+
+		MaterialIndice = 0;
+
+		for (const FSWHeightMaterialBand& Band : MaterialBands)
+		{
+			if (Height >= Band.AltitudeMin)
+				MaterialIndice = static_cast<uint16>(Band.MaterialIndex);
+		}
+
+		return Height;
+	}
+
+	int32 Octaves = 6;
+	double BaseFrequency = 0.0;
+	double Lacunarity = 2.0;
+	double Persistence = 0.5;
+	double BaseAmplitude = 0.0;
+	double BaseAltitude = 0.0;
+	FVector2D SeedOffset = FVector2D(0.0);
+	// Sorted by ascending altitude
+	TArray<FSWHeightMaterialBand> MaterialBands;
+};
+
+TSharedPtr<FSWHeightEvaluator, ESPMode::ThreadSafe> USWNoiseHeightGenerator::CreateEvaluator(const FSWBagOfSeeds& Seeds) const
+{
+	TSharedPtr<FSWNoiseHeightEvaluator, ESPMode::ThreadSafe> Evaluator = MakeShared<FSWNoiseHeightEvaluator, ESPMode::ThreadSafe>();
+
+	float Seed = 0.f;
+
+	for (const FInstancedStruct& SeedStruct : Seeds.SeedsArray)
+	{
+		if (SeedStruct.IsValid() && SeedStruct.GetScriptStruct()->IsChildOf(FScalarSeed::StaticStruct()))
+		{
+			const FScalarSeed& TypedSeed = SeedStruct.Get<FScalarSeed>();
+			if (TypedSeed.SeedName == SeedName)
+			{
+				Seed = TypedSeed.Value;
+				break;
+			}
+		}
+	}
+
+	Evaluator->Octaves = Octaves;
+	// Frequency is expressed per meter, locations are in cm
+	Evaluator->BaseFrequency = Frequency / 100.0;
+	Evaluator->Lacunarity = Lacunarity;
+	Evaluator->Persistence = Persistence;
+	Evaluator->BaseAmplitude = Amplitude;
+	Evaluator->BaseAltitude = BaseAltitude;
+	Evaluator->SeedOffset = FVector2D(FMath::Fmod(Seed * 12.9898, 1024.0), FMath::Fmod(Seed * 78.233, 1024.0));
+	Evaluator->MaterialBands = MaterialBands;
+	Evaluator->MaterialBands.Sort([](const FSWHeightMaterialBand& A, const FSWHeightMaterialBand& B) { return A.AltitudeMin < B.AltitudeMin; });
+
+	return Evaluator;
+}
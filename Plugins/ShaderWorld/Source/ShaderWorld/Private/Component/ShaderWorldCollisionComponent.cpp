@@ -56,6 +56,16 @@
 #include "Actor/ShaderWorldActor.h"
 #include "Async/Async.h"
 #include "Chaos/TriangleMeshImplicitObject.h"
+#include "Chaos/HeightField.h"
+#include "Chaos/ImplicitObjectTransformed.h"
+#include "Chaos/ChaosArchive.h"
+#include "Physics/Experimental/ChaosCooking.h"
+#include "Serialization/MemoryWriter.h"
+#include "Physics/PhysicsInterfaceCore.h"
+#include "Physics/PhysicsFiltering.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
+#include "PhysicsProxy/SingleParticlePhysicsProxy.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
 
 //#include "RayTracingDefinitions.h"
 //#include "RayTracingInstance.h"
@@ -957,7 +967,7 @@ void UShaderWorldCollisionComponent::UpdateSectionTriMesh(TSharedPtr<FSWShareabl
 	UpdatesReceivedDuringCompute.Empty();
 	
 
-	bool EnsureSameBuffers = ProcMeshSections.Num() > 0 && ProcMeshSections[0].ProcVertexBuffer.Num() == Positions->Positions.Num();
+	bool EnsureSameBuffers = ProcMeshSections.Num() > 0 && ProcMeshSections[0].ProcVertexBuffer.Num() == Positions->Positions3f.Num();
 	if(!EnsureSameBuffers)
 	{
 #if SWDEBUG
@@ -1042,7 +1052,8 @@ void UShaderWorldCollisionComponent::CreateMeshSection(int32 SectionIndex, const
 	NewSection.IndexBuffer = Triangles;
 
 	// Copy data to vertex buffer
-	const int32 NumVerts = Vertices->Positions.Num();
+	// Float only position buffers leave the double precision positions empty
+	const int32 NumVerts = Vertices->Positions.Num() > 0 ? Vertices->Positions.Num() : Vertices->Positions3f.Num();
 	NewSection.ProcVertexBuffer.Reset();
 	NewSection.ProcVertexBuffer.AddDefaulted(NumVerts);
 	NewSection.MaterialIndices.Empty();
@@ -1373,7 +1384,7 @@ bool UShaderWorldCollisionComponent::GetTriMeshSizeEstimates(FTriMeshCollisionDa
 
 		if (Section.bEnableCollision && Section.PositionBuffer.IsValid() && (Section.PositionBuffer->MaterialIndices.Num() == Section.PositionBuffer->Positions3f.Num()) &&
 			Section.IndexBuffer.IsValid() && Section.IndexBuffer->Indices.Num() >= 3)
-			OutTriMeshEstimates.VerticeCount = Section.PositionBuffer->Positions.Num();
+			OutTriMeshEstimates.VerticeCount = Section.PositionBuffer->Positions3f.Num();
 	}
 	
 	return true;
@@ -1381,6 +1392,9 @@ bool UShaderWorldCollisionComponent::GetTriMeshSizeEstimates(FTriMeshCollisionDa
 
 bool UShaderWorldCollisionComponent::ContainsPhysicsTriMeshData(bool InUseAllTriData) const
 {
+	if (UsesHeightfieldCollision())
+		return false;
+
 	for (const FGeoCProcMeshSection& Section : ProcMeshSections)
 	{
 		if (Section.bEnableCollision && Section.PositionBuffer.IsValid() && (Section.PositionBuffer->MaterialIndices.Num() == Section.PositionBuffer->Positions3f.Num()) &&
@@ -1398,11 +1412,298 @@ void UShaderWorldCollisionComponent::SetUsedPhysicalMaterial(TArray<TObjectPtr<U
 
 }
 
+void UShaderWorldCollisionComponent::SetHeightfieldLayout(int32 NumX, int32 NumY, float Spacing)
+{
+	HeightfieldNumX = NumX;
+	HeightfieldNumY = NumY;
+	HeightfieldSpacing = Spacing;
+}
+
+bool UShaderWorldCollisionComponent::UsesHeightfieldCollision() const
+{
+	return bUseHeightfieldCollision && HeightfieldNumX >= 2 && HeightfieldNumY >= 2 && HeightfieldSpacing > 0.f &&
+		ProcMeshSections.Num() > 0 && ProcMeshSections[0].PositionBuffer.IsValid() &&
+		ProcMeshSections[0].PositionBuffer->Positions3f.Num() == HeightfieldNumX * HeightfieldNumY;
+}
+
 void UShaderWorldCollisionComponent::OnCreatePhysicsState()
 {
-	Super::OnCreatePhysicsState();
+	if (!UsesHeightfieldCollision())
+	{
+		Super::OnCreatePhysicsState();
+		return;
+	}
+
+	// The body is not described by a body setup, skip the primitive component implementation
+	USceneComponent::OnCreatePhysicsState();
+
+	if (!BodyInstance.IsValidBodyInstance())
+		CreateHeightfieldPhysicsState();
+}
+
+void UShaderWorldCollisionComponent::OnDestroyPhysicsState()
+{
+	UWorld* World = GetWorld();
+	if (FPhysScene* PhysScene = World ? World->GetPhysicsScene() : nullptr)
+	{
+		FPhysicsActorHandle& ActorHandle = BodyInstance.GetPhysicsActorHandle();
+		if (FPhysicsInterface::IsValid(ActorHandle))
+		{
+			PhysScene->RemoveFromComponentMaps(ActorHandle);
+		}
+		if (BodyInstance.bNotifyRigidBodyCollision)
+		{
+			PhysScene->UnRegisterForCollisionEvents(this);
+		}
+	}
+
+	Super::OnDestroyPhysicsState();
+}
+
+void UShaderWorldCollisionComponent::CreateHeightfieldPhysicsState()
+{
+	SW_FCT_CYCLE()
+
+	UWorld* World = GetWorld();
+	FPhysScene* PhysScene = World ? World->GetPhysicsScene() : nullptr;
+
+	if (!PhysScene || !ProcMeshSections[0].bEnableCollision)
+		return;
+
+	const FSWShareableVerticePositionBuffer& Samples = *ProcMeshSections[0].PositionBuffer;
+	const bool bHasMaterials = Samples.MaterialIndices.Num() == Samples.Positions3f.Num();
+
+	/*
+	 * Chaos splits a heightfield cell along its (0,0)-(1,1) diagonal, while our collision grid uses the (1,0)-(0,1) one.
+	 * Rotating the heightfield by a quarter turn around Z makes both triangulations identical:
+	 * heightfield column c maps to grid row i = c, heightfield row r maps to grid column j = NumX - 1 - r.
+	 */
+	const int32 NumRows = HeightfieldNumX;
+	const int32 NumCols = HeightfieldNumY;
+
+	TArray<Chaos::FReal> Heights;
+	Heights.SetNumUninitialized(NumRows * NumCols);
+
+	HeightfieldCellMaterials.SetNumUninitialized((NumRows - 1) * (NumCols - 1));
+
+	for (int32 r = 0; r < NumRows; r++)
+	{
+		const int32 j = HeightfieldNumX - 1 - r;
+
+		for (int32 c = 0; c < NumCols; c++)
+		{
+			Heights[r * NumCols + c] = Samples.Positions3f[j + c * HeightfieldNumX].Z;
+
+			if (r < NumRows - 1 && c < NumCols - 1)
+			{
+				uint8 CellMaterial = 0;
+
+				if (bHasMaterials)
+				{
+					// Same vote as the trimesh path, over the first triangle of the grid quad
+					const int32 idx = (j - 1) + c * HeightfieldNumX;
+					const uint16 mat1 = Samples.MaterialIndices[idx];
+					const uint16 mat2 = Samples.MaterialIndices[idx + HeightfieldNumX];
+					const uint16 mat3 = Samples.MaterialIndices[idx + 1];
+
+					const uint16 Voted = (mat1 == mat2 || mat1 == mat3) ? mat1 : (mat2 == mat3 ? mat2 : mat1);
+					CellMaterial = (uint8)FMath::Min<uint16>(Voted, MAX_uint8);
+				}
+
+				HeightfieldCellMaterials[r * (NumCols - 1) + c] = CellMaterial;
+			}
+		}
+	}
+
+	TArray<uint8> CellMaterials = HeightfieldCellMaterials;
+	TUniquePtr<Chaos::FImplicitObject> Heightfield = MakeUnique<Chaos::FHeightField>(MoveTemp(Heights), MoveTemp(CellMaterials), NumRows, NumCols, Chaos::FVec3(HeightfieldSpacing, HeightfieldSpacing, 1.f));
+
+	const FVector2D Extent = FVector2D(HeightfieldNumX - 1, HeightfieldNumY - 1) * HeightfieldSpacing / 2.0;
+	const Chaos::FRigidTransform3 HeightfieldToComponent(FVector(Extent.X, -Extent.Y, 0.0), FQuat(FVector::UpVector, UE_HALF_PI));
+
+	TUniquePtr<Chaos::FImplicitObject> Geometry = MakeUnique<Chaos::TImplicitObjectTransformed<Chaos::FReal, 3>>(MoveTemp(Heightfield), HeightfieldToComponent);
+
+	FActorCreationParams Params;
+	Params.InitialTM = FTransform(GetComponentQuat(), GetComponentLocation());
+	Params.bQueryOnly = false;
+	Params.bStatic = true;
+	Params.Scene = PhysScene;
+
+	FPhysicsActorHandle PhysHandle;
+	FPhysicsInterface::CreateActor(Params, PhysHandle);
+	Chaos::FRigidBodyHandle_External& Body_External = PhysHandle->GetGameThreadAPI();
+
+	TUniquePtr<Chaos::FPerShapeData> NewShape = Chaos::FPerShapeData::CreatePerShapeData(0, MakeSerializable(Geometry));
+
+	FCollisionFilterData QueryFilterData, SimFilterData;
+	CreateShapeFilterData(GetCollisionObjectType(), FMaskFilter(0), GetOwner() ? GetOwner()->GetUniqueID() : 0, GetCollisionResponseToChannels(),
+		GetUniqueID(), 0, QueryFilterData, SimFilterData, false, BodyInstance.bNotifyRigidBodyCollision, true);
+
+	// Heightfield stands for both simple and complex collision, as the trimesh does with bUseComplexAsSimpleCollision
+	QueryFilterData.Word3 |= (EPDF_SimpleCollision | EPDF_ComplexCollision);
+	SimFilterData.Word3 |= (EPDF_SimpleCollision | EPDF_ComplexCollision);
+
+	const ECollisionEnabled::Type CollisionEnabled = GetCollisionEnabled();
+	NewShape->SetQueryData(QueryFilterData);
+	NewShape->SetSimData(SimFilterData);
+	NewShape->SetQueryEnabled(CollisionEnabledHasQuery(CollisionEnabled));
+	NewShape->SetSimEnabled(CollisionEnabledHasPhysics(CollisionEnabled));
+
+	if (UPhysicalMaterial* PhysMat = BodyInstance.GetSimplePhysicalMaterial())
+	{
+		NewShape->SetMaterial(PhysMat->GetPhysicsMaterial());
+	}
+
+	Chaos::FShapesArray ShapeArray;
+	ShapeArray.Emplace(MoveTemp(NewShape));
+
+	Body_External.SetGeometry(MoveTemp(Geometry));
+
+	const Chaos::FRigidTransform3 WorldTransform(Body_External.X(), Body_External.R());
+	for (TUniquePtr<Chaos::FPerShapeData>& Shape : ShapeArray)
+	{
+		Shape->UpdateShapeBounds(WorldTransform);
+	}
+	Body_External.SetShapesArray(MoveTemp(ShapeArray));
+
+	BodyInstance.PhysicsUserData = FPhysicsUserData(&BodyInstance);
+	BodyInstance.OwnerComponent = this;
+	BodyInstance.ActorHandle = PhysHandle;
+
+	Body_External.SetUserData(&BodyInstance.PhysicsUserData);
+
+	TArray<FPhysicsActorHandle> Actors;
+	Actors.Add(PhysHandle);
+
+	FPhysicsCommand::ExecuteWrite(PhysScene, [&]()
+	{
+		PhysScene->AddActorsToScene_AssumesLocked(Actors, true);
+	});
+
+	PhysScene->AddToComponentMaps(this, PhysHandle);
+	if (BodyInstance.bNotifyRigidBodyCollision)
+	{
+		PhysScene->RegisterForCollisionEvents(this);
+	}
+}
+
+/*
+ * Heightfield against cooked trimesh for a single collision tile: build time and serialized size, which stands in for the memory footprint.
+ * Heights are a few octaves of sines plus noise, materials are all 0, the trimesh is cooked the way GetPhysicsTriMeshData asks for (fast cook).
+ */
+static void BenchmarkCollisionBackends(const TArray<FString>& Args)
+{
+	const int32 MaxVerticesPerSide = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 2) : 257;
+	const int32 Iterations = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 8;
+	const int32 VerticesPerSideList[] = { 33, 65, 129, 257, 513 };
+
+	constexpr float Spacing = 100.f;
+
+	auto SerializedSize = [](Chaos::FImplicitObject& Object)
+	{
+		TArray<uint8> Bytes;
+		FMemoryWriter Writer(Bytes);
+		Chaos::FChaosArchive Ar(Writer);
+		Object.Serialize(Ar);
+		return Bytes.Num();
+	};
+
+	for (const int32 N : VerticesPerSideList)
+	{
+		if (N > MaxVerticesPerSide)
+			break;
+
+		FRandomStream RandomStream(N);
+
+		TArray<float> Samples;
+		Samples.SetNumUninitialized(N * N);
+
+		for (int32 j = 0; j < N; j++)
+		{
+			for (int32 i = 0; i < N; i++)
+				Samples[i + j * N] = 2000.f * FMath::Sin(i * 0.05f) * FMath::Cos(j * 0.07f) + 300.f * FMath::Sin(i * 0.31f + j * 0.17f) + RandomStream.FRandRange(-20.f, 20.f);
+		}
+
+		double HeightfieldSeconds = 0.0;
+		int32 HeightfieldBytes = 0;
+
+		for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			TArray<Chaos::FReal> Heights;
+			Heights.SetNumUninitialized(N * N);
+			for (int32 k = 0; k < N * N; k++)
+				Heights[k] = Samples[k];
+
+			TArray<uint8> CellMaterials;
+			CellMaterials.SetNumZeroed((N - 1) * (N - 1));
+
+			const double Start = FPlatformTime::Seconds();
+			Chaos::FHeightField Heightfield(MoveTemp(Heights), MoveTemp(CellMaterials), N, N, Chaos::FVec3(Spacing, Spacing, 1.f));
+			HeightfieldSeconds += FPlatformTime::Seconds() - Start;
+
+			if (Iteration == 0)
+				HeightfieldBytes = SerializedSize(Heightfield);
+		}
+
+		FTriMeshCollisionData Desc;
+		Desc.bFastCook = true;
+		Desc.Vertices.SetNumUninitialized(N * N);
+
+		for (int32 j = 0; j < N; j++)
+		{
+			for (int32 i = 0; i < N; i++)
+				Desc.Vertices[i + j * N] = FVector3f(i * Spacing, j * Spacing, Samples[i + j * N]);
+		}
+
+		Desc.Indices.Reserve(2 * (N - 1) * (N - 1));
+
+		for (int32 j = 0; j < N - 1; j++)
+		{
+			for (int32 i = 0; i < N - 1; i++)
+			{
+				const int32 idx = i + j * N;
+
+				FTriIndices& First = Desc.Indices.AddDefaulted_GetRef();
+				First.v0 = idx;
+				First.v1 = idx + N;
+				First.v2 = idx + 1;
+
+				FTriIndices& Second = Desc.Indices.AddDefaulted_GetRef();
+				Second.v0 = idx + 1;
+				Second.v1 = idx + N;
+				Second.v2 = idx + N + 1;
+			}
+		}
+
+		Desc.MaterialIndices.SetNumZeroed(Desc.Indices.Num());
+
+		double TrimeshSeconds = 0.0;
+		int32 TrimeshBytes = 0;
+
+		for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			TArray<int32> FaceRemap;
+			TArray<int32> VertexRemap;
+
+			const double Start = FPlatformTime::Seconds();
+			auto Trimesh = Chaos::Cooking::BuildSingleTrimesh(Desc, FaceRemap, VertexRemap);
+			TrimeshSeconds += FPlatformTime::Seconds() - Start;
+
+			if (Iteration == 0 && Trimesh)
+				TrimeshBytes = SerializedSize(*Trimesh);
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("SW collision backends | %3dx%3d vertices | heightfield %8.3fms %8.1fKB | trimesh cook %8.3fms %8.1fKB"),
+			N, N, HeightfieldSeconds * 1000.0 / Iterations, HeightfieldBytes / 1024.0, TrimeshSeconds * 1000.0 / Iterations, TrimeshBytes / 1024.0);
+	}
 }
 
+static FAutoConsoleCommand BenchmarkCollisionBackendsCmd(
+	TEXT("sw.Collision.BenchmarkBackends"),
+	TEXT("Logs build time and serialized size of a heightfield against a cooked trimesh for growing collision tiles. Optional arguments: max vertices per side (default 257), iterations (default 8)."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkCollisionBackends)
+);
+
 UBodySetup* UShaderWorldCollisionComponent::CreateBodySetupHelper()
 {
 	// The body setup in a template needs to be public since the property is Tnstanced and thus is the archetype of the instance meaning there is a direct reference
@@ -1436,6 +1737,14 @@ void UShaderWorldCollisionComponent::UpdateCollision()
 		SW_LOG("No concurrent body update")
 		return;
 	}
+
+	if (UsesHeightfieldCollision())
+	{
+		// Nothing to cook, the heightfield is built while creating the physics state
+		MoveToPhysicDestination();
+		RecreatePhysicsState();
+		return;
+	}
 	
 	UWorld* World = GetWorld();
 	const bool bUseAsyncCook = true;//World && World->IsGameWorld() && bUseAsyncCooking;
@@ -1491,14 +1800,7 @@ void UShaderWorldCollisionComponent::FinishPhysicsAsyncCook(bool bSuccess, UBody
 	{
 		if (bSuccess)
 		{
-
-
-			if ((DestinationOnNextPhysicCook - GetComponentLocation()).SizeSquared() > 0.5f)
-			{
-				SetMobility(EComponentMobility::Movable);
-				SetWorldLocation(DestinationOnNextPhysicCook, false, nullptr, ETeleportType::TeleportPhysics);
-				SetMobility(EComponentMobility::Static);
-			}
+			MoveToPhysicDestination();
 			
 			/*
 			 * should be the same as we don't allow concurrent processing
@@ -1534,6 +1836,16 @@ void UShaderWorldCollisionComponent::FinishPhysicsAsyncCook(bool bSuccess, UBody
 	}
 }
 
+void UShaderWorldCollisionComponent::MoveToPhysicDestination()
+{
+	if ((DestinationOnNextPhysicCook - GetComponentLocation()).SizeSquared() > 0.5f)
+	{
+		SetMobility(EComponentMobility::Movable);
+		SetWorldLocation(DestinationOnNextPhysicCook, false, nullptr, ETeleportType::TeleportPhysics);
+		SetMobility(EComponentMobility::Static);
+	}
+}
+
 
 void UShaderWorldCollisionComponent::UpdateNavigation()
 {	
@@ -1556,7 +1868,20 @@ bool UShaderWorldCollisionComponent::DoCustomNavigableGeometryExport(FNavigableG
 
 			const int NumIndices = Section.IndexBuffer.IsValid() ? Section.IndexBuffer->Indices.Num():0;
 
-			GeomExport.ExportCustomMesh(Section.PositionBuffer->Positions.GetData(), NumOfVertex, (int32*)Section.IndexBuffer->Indices.GetData(), NumIndices, GetComponentTransform());
+			if (Section.PositionBuffer->Positions.Num() == NumOfVertex)
+			{
+				GeomExport.ExportCustomMesh(Section.PositionBuffer->Positions.GetData(), NumOfVertex, (int32*)Section.IndexBuffer->Indices.GetData(), NumIndices, GetComponentTransform());
+			}
+			else
+			{
+				// Tile only kept float positions
+				TArray<FVector> Positions;
+				Positions.Reserve(NumOfVertex);
+				for (const FVector3f& Position : Section.PositionBuffer->Positions3f)
+					Positions.Add(FVector(Position));
+
+				GeomExport.ExportCustomMesh(Positions.GetData(), NumOfVertex, (int32*)Section.IndexBuffer->Indices.GetData(), NumIndices, GetComponentTransform());
+			}
 			
 		}
 	}
@@ -1574,6 +1899,16 @@ UMaterialInterface* UShaderWorldCollisionComponent::GetMaterialFromCollisionFace
 	UMaterialInterface* Result = nullptr;
 	SectionIndex = 0;
 
+	if (UsesHeightfieldCollision())
+	{
+		// Chaos reports two faces per heightfield cell
+		const int32 CellIndex = FaceIndex / 2;
+		if (CellIndex >= 0 && CellIndex < HeightfieldCellMaterials.Num())
+			SectionIndex = HeightfieldCellMaterials[CellIndex];
+
+		return Result;
+	}
+
 	if(ProcMeshSections.Num()>0)
 	{
 		/*
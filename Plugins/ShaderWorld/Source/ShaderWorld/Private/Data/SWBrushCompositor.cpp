@@ -0,0 +1,95 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+#include "Data/SWBrushCompositor.h"
+
+#include "Async/ParallelFor.h"
+
+float SWBrushCompositor::EvaluateBrush(const FSWCompositeBrushParameters& Brush, const FVector2f& Location, float SourceHeight)
+{
+	const FVector2f Delta = Location - Brush.Center;
+	const FVector2f Local(Delta.X * Brush.Axis.X + Delta.Y * Brush.Axis.Y, Delta.Y * Brush.Axis.X - Delta.X * Brush.Axis.Y);
+	const FVector2f Scaled(FMath::Abs(Local.X) / FMath::Max(Brush.Extent.X, 1.f), FMath::Abs(Local.Y) / FMath::Max(Brush.Extent.Y, 1.f));
+
+	const float Distance = Brush.Shape == (uint32)ESWBrushShape::Box ? FMath::Max(Scaled.X, Scaled.Y) : Scaled.Size();
+
+	if (Distance >= 1.f)
+		return SourceHeight;
+
+	float T = FMath::Clamp((1.f - Distance) / FMath::Max(Brush.FalloffWidth, 0.0001f), 0.f, 1.f);
+
+	switch ((ESWBrushFalloff)(Brush.FalloffAndBlend & 0xFF))
+	{
+	case ESWBrushFalloff::Smooth:
+		T = T * T * (3.f - 2.f * T);
+		break;
+	case ESWBrushFalloff::Spherical:
+		T = FMath::Sqrt(1.f - (1.f - T) * (1.f - T));
+		break;
+	default:
+		break;
+	}
+
+	const float Weight = FMath::Pow(T, Brush.Exponent) * Brush.Influence;
+
+	switch ((ESWBrushBlendOp)((Brush.FalloffAndBlend >> 8) & 0xFF))
+	{
+	case ESWBrushBlendOp::Set:
+		return FMath::Lerp(SourceHeight, Brush.Height, Weight);
+	case ESWBrushBlendOp::Max:
+		return FMath::Lerp(SourceHeight, FMath::Max(SourceHeight, Brush.Height), Weight);
+	case ESWBrushBlendOp::Min:
+		return FMath::Lerp(SourceHeight, FMath::Min(SourceHeight, Brush.Height), Weight);
+	default:
+		return SourceHeight + Brush.Height * Weight;
+	}
+}
+
+float SWBrushCompositor::EvaluateStack(TConstArrayView<FSWCompositeBrushParameters> Stack, const FVector2f& Location, float SourceHeight)
+{
+	float Height = SourceHeight;
+
+	for (const FSWCompositeBrushParameters& Brush : Stack)
+		Height = EvaluateBrush(Brush, Location, Height);
+
+	return Height;
+}
+
+void SWBrushCompositor::ComposeGrid(TConstArrayView<FSWCompositeBrushParameters> Stack, const FSWBrushStackGridDesc& Grid, TConstArrayView<float> SourceHeights, TArrayView<float> OutHeights)
+{
+	check(SourceHeights.Num() == Grid.Size * Grid.Size && OutHeights.Num() == SourceHeights.Num());
+
+	ParallelFor(Grid.Size, [&](int32 Y)
+	{
+		for (int32 X = 0; X < Grid.Size; X++)
+		{
+			const int32 Texel = Y * Grid.Size + X;
+			OutHeights[Texel] = FMath::RoundToFloat(EvaluateStack(Stack, Grid.GetTexelLocation(X, Y), SourceHeights[Texel]));
+		}
+	});
+}
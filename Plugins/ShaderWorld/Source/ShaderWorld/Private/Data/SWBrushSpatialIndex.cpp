@@ -0,0 +1,172 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+#include "Data/SWBrushSpatialIndex.h"
+
+FSWBrushSpatialIndex::FSWBrushSpatialIndex(double InCellSize)
+	: CellSize(FMath::Max(InCellSize, 1.0))
+{
+}
+
+FIntRect FSWBrushSpatialIndex::GetCellRange(const FBox2D& Box) const
+{
+	// Inclusive range
+	return FIntRect(
+		FMath::FloorToInt(Box.Min.X / CellSize), FMath::FloorToInt(Box.Min.Y / CellSize),
+		FMath::FloorToInt(Box.Max.X / CellSize), FMath::FloorToInt(Box.Max.Y / CellSize));
+}
+
+void FSWBrushSpatialIndex::Link(const AShaderWorldBrush* Brush, const FEntry& Entry)
+{
+	if (Entry.bOversized)
+	{
+		Oversized.Add(Brush);
+		return;
+	}
+
+	for (int32 Y = Entry.Cells.Min.Y; Y <= Entry.Cells.Max.Y; Y++)
+		for (int32 X = Entry.Cells.Min.X; X <= Entry.Cells.Max.X; X++)
+			Cells.FindOrAdd(FIntPoint(X, Y)).Add(Brush);
+}
+
+void FSWBrushSpatialIndex::Unlink(const AShaderWorldBrush* Brush, const FEntry& Entry)
+{
+	if (Entry.bOversized)
+	{
+		Oversized.RemoveSingleSwap(Brush);
+		return;
+	}
+
+	for (int32 Y = Entry.Cells.Min.Y; Y <= Entry.Cells.Max.Y; Y++)
+	{
+		for (int32 X = Entry.Cells.Min.X; X <= Entry.Cells.Max.X; X++)
+		{
+			const FIntPoint Cell(X, Y);
+			if (auto* CellBrushes = Cells.Find(Cell))
+			{
+				CellBrushes->RemoveSingleSwap(Brush);
+				if (CellBrushes->Num() == 0)
+					Cells.Remove(Cell);
+			}
+		}
+	}
+}
+
+void FSWBrushSpatialIndex::Update(const AShaderWorldBrush* Brush, const FBox2D& FootPrint)
+{
+	if (!FootPrint.bIsValid)
+	{
+		Remove(Brush);
+		return;
+	}
+
+	FEntry* Existing = Entries.Find(Brush);
+
+	if (Existing && Existing->FootPrint == FootPrint)
+		return;
+
+	FEntry NewEntry;
+	NewEntry.FootPrint = FootPrint;
+	NewEntry.Cells = GetCellRange(FootPrint);
+	NewEntry.bOversized = (int64)(NewEntry.Cells.Width() + 1) * (NewEntry.Cells.Height() + 1) > MaxCellsPerEntry;
+
+	if (Existing)
+	{
+		// Small moves within the same cells only need the footprint update
+		if (Existing->Cells == NewEntry.Cells && Existing->bOversized == NewEntry.bOversized)
+		{
+			Existing->FootPrint = FootPrint;
+			return;
+		}
+
+		Unlink(Brush, *Existing);
+		*Existing = NewEntry;
+	}
+	else
+	{
+		Entries.Add(Brush, NewEntry);
+	}
+
+	Link(Brush, NewEntry);
+}
+
+void FSWBrushSpatialIndex::Remove(const AShaderWorldBrush* Brush)
+{
+	FEntry Entry;
+	if (Entries.RemoveAndCopyValue(Brush, Entry))
+		Unlink(Brush, Entry);
+}
+
+void FSWBrushSpatialIndex::Empty()
+{
+	Entries.Empty();
+	Cells.Empty();
+	Oversized.Empty();
+}
+
+void FSWBrushSpatialIndex::Query(const FBox2D& Box, TSet<const AShaderWorldBrush*>& OutBrushes) const
+{
+	OutBrushes.Reset();
+
+	if (!Box.bIsValid || Entries.Num() == 0)
+		return;
+
+	auto Test = [&](const AShaderWorldBrush* Brush)
+	{
+		if (const FEntry* Entry = Entries.Find(Brush); Entry && Entry->FootPrint.Intersect(Box))
+			OutBrushes.Add(Brush);
+	};
+
+	for (const AShaderWorldBrush* Brush : Oversized)
+		Test(Brush);
+
+	const FIntRect Range = GetCellRange(Box);
+
+	// Large queries over a sparse grid: visit the brushes rather than the cells
+	if ((int64)(Range.Width() + 1) * (Range.Height() + 1) > Entries.Num())
+	{
+		for (const TPair<const AShaderWorldBrush*, FEntry>& Entry : Entries)
+		{
+			if (!Entry.Value.bOversized && Entry.Value.FootPrint.Intersect(Box))
+				OutBrushes.Add(Entry.Key);
+		}
+		return;
+	}
+
+	for (int32 Y = Range.Min.Y; Y <= Range.Max.Y; Y++)
+	{
+		for (int32 X = Range.Min.X; X <= Range.Max.X; X++)
+		{
+			if (const auto* CellBrushes = Cells.Find(FIntPoint(X, Y)))
+			{
+				for (const AShaderWorldBrush* Brush : *CellBrushes)
+					Test(Brush);
+			}
+		}
+	}
+}
@@ -0,0 +1,179 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+
+#include "Data/SWGridTopologyCache.h"
+#include "Data/SWStructs.h"
+#include "Async/ParallelFor.h"
+
+void FSWGridTopology::Build(int32 InNumX, int32 InNumY, float InSpacing)
+{
+	NumX = InNumX;
+	NumY = InNumY;
+	Spacing = InSpacing;
+
+	Vertices = MakeShared<FSWShareableVerticePositionBuffer, ESPMode::ThreadSafe>();
+	Triangles = MakeShared<FSWShareableIndexBuffer, ESPMode::ThreadSafe>();
+	UVs.Empty();
+
+	Vertices->Bound = FBox(EForceInit::ForceInit);
+
+	if (NumX < 2 || NumY < 2)
+		return;
+
+	const int32 NumVertices = NumX * NumY;
+	const int32 NumQuads = (NumX - 1) * (NumY - 1);
+
+	Vertices->Positions.SetNumUninitialized(NumVertices);
+	Vertices->Positions3f.SetNumUninitialized(NumVertices);
+	Vertices->MaterialIndices.SetNumZeroed(NumVertices);
+	UVs.SetNumUninitialized(NumVertices);
+
+	Triangles->Indices.SetNumUninitialized(NumQuads * 6);
+	Triangles->Triangles_CollisionOnly.SetNumUninitialized(NumQuads * 2);
+
+	const FVector2D Extent = FVector2D((NumX - 1) * Spacing, (NumY - 1) * Spacing) / 2;
+
+	ParallelFor(NumY, [&](int32 i)
+		{
+			for (int j = 0; j < NumX; j++)
+			{
+				const int32 idx = j + (i * NumX);
+				const FVector Pos = FVector((float)j * Spacing - Extent.X, (float)i * Spacing - Extent.Y, 0);
+
+				Vertices->Positions[idx] = Pos;
+				Vertices->Positions3f[idx] = FVector3f(Pos);
+				UVs[idx] = FVector2f((float)j / ((float)NumX - 1), (float)i / ((float)NumY - 1));
+			}
+
+			if (i >= NumY - 1)
+				return;
+
+			for (int j = 0; j < NumX - 1; j++)
+			{
+				const int32 idx = j + (i * NumX);
+				const int32 Quad = j + (i * (NumX - 1));
+
+				uint32* Indices = &Triangles->Indices[Quad * 6];
+				Indices[0] = idx;
+				Indices[1] = idx + NumX;
+				Indices[2] = idx + 1;
+
+				Indices[3] = idx + 1;
+				Indices[4] = idx + NumX;
+				Indices[5] = idx + NumX + 1;
+
+				FTriIndices& First = Triangles->Triangles_CollisionOnly[Quad * 2];
+				First.v0 = Indices[0];
+				First.v1 = Indices[1];
+				First.v2 = Indices[2];
+
+				FTriIndices& Second = Triangles->Triangles_CollisionOnly[Quad * 2 + 1];
+				Second.v0 = Indices[3];
+				Second.v1 = Indices[4];
+				Second.v2 = Indices[5];
+			}
+		});
+
+	// Corners are enough for a flat grid
+	Vertices->Bound += Vertices->Positions[0];
+	Vertices->Bound += Vertices->Positions[NumVertices - 1];
+}
+
+FSWGridTopologyCache& FSWGridTopologyCache::Get()
+{
+	static FSWGridTopologyCache Cache;
+	return Cache;
+}
+
+void FSWGridTopologyCache::Prune()
+{
+	for (auto It = Grids.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().IsValid())
+			It.RemoveCurrent();
+	}
+
+	for (auto It = ClipMapSections.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().Triangles.IsValid() || !It.Value().TrianglesAlt.IsValid())
+			It.RemoveCurrent();
+	}
+}
+
+TSharedRef<const FSWGridTopology, ESPMode::ThreadSafe> FSWGridTopologyCache::FindOrCreateGrid(int32 NumX, int32 NumY, float Spacing)
+{
+	check(IsInGameThread());
+
+	// Spacing is a whole number of cm in practice, keep a mm precision in the key
+	const FIntVector Key(NumX, NumY, FMath::RoundToInt(Spacing * 10.f));
+
+	if (const TWeakPtr<const FSWGridTopology, ESPMode::ThreadSafe>* Found = Grids.Find(Key))
+	{
+		if (TSharedPtr<const FSWGridTopology, ESPMode::ThreadSafe> Topology = Found->Pin())
+			return Topology.ToSharedRef();
+	}
+
+	Prune();
+
+	TSharedRef<FSWGridTopology, ESPMode::ThreadSafe> NewTopology = MakeShared<FSWGridTopology, ESPMode::ThreadSafe>();
+	NewTopology->Build(NumX, NumY, Spacing);
+
+	Grids.Add(Key, NewTopology);
+
+	return NewTopology;
+}
+
+bool FSWGridTopologyCache::FindClipMapSection(int32 N, int32 Section, bool bAlternateTopology, TSharedPtr<FSWShareableIndexBuffer>& OutTriangles, TSharedPtr<FSWShareableIndexBuffer>& OutTrianglesAlt)
+{
+	check(IsInGameThread());
+
+	if (const FClipMapSectionIndices* Found = ClipMapSections.Find(FIntVector(N, Section, bAlternateTopology ? 1 : 0)))
+	{
+		TSharedPtr<FSWShareableIndexBuffer, ESPMode::ThreadSafe> Triangles = Found->Triangles.Pin();
+		TSharedPtr<FSWShareableIndexBuffer, ESPMode::ThreadSafe> TrianglesAlt = Found->TrianglesAlt.Pin();
+
+		if (Triangles.IsValid() && TrianglesAlt.IsValid())
+		{
+			OutTriangles = Triangles;
+			OutTrianglesAlt = TrianglesAlt;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void FSWGridTopologyCache::AddClipMapSection(int32 N, int32 Section, bool bAlternateTopology, const TSharedPtr<FSWShareableIndexBuffer>& Triangles, const TSharedPtr<FSWShareableIndexBuffer>& TrianglesAlt)
+{
+	check(IsInGameThread());
+
+	Prune();
+
+	ClipMapSections.Add(FIntVector(N, Section, bAlternateTopology ? 1 : 0), { Triangles, TrianglesAlt });
+}
@@ -52,17 +52,66 @@ void FSWTexture2DCacheGroup::UpdateReferencePoints(UWorld* World, double& Curren
 	}
 }
 
+void FSWTexture2DCacheGroup::UpdateManagerBudget()
+{
+	// Each cache element holds one texture per cache of the group
+	double ElementMemoryMB = 0.0;
+	for (const auto& Cache : PerLODCaches)
+		ElementMemoryMB += 4.0 * Cache.Value.Dimension * Cache.Value.Dimension / 1000000.0;
+
+	CacheManager.ElementMemoryMB = ElementMemoryMB;
+	CacheManager.MemoryBudgetMB = MemoryBudgetMB;
+}
+
 void FSWTexture2DCacheGroup::ReleaseOutOfRange()
 {
+	UpdateManagerBudget();
 	CacheManager.ReleaseBeyondRange(All_Cameras);
+
+	FreeTrimmedTextures();
+}
+
+void FSWTexture2DCacheGroup::FreeTrimmedTextures()
+{
+	for (const int32 DataIndex : CacheManager.DataToFree)
+	{
+		for (auto& Cache : PerLODCaches)
+		{
+			if (Cache.Value.TextureCache.IsValidIndex(DataIndex))
+				Cache.Value.TextureCache[DataIndex] = nullptr;
+		}
+
+		FreeTextureSlots.Add(DataIndex);
+	}
+
+	CacheManager.DataToFree.Empty();
 }
 
 void FSWTexture2DCacheGroup::GenerateWithinRange(UWorld* World)
 {
+	UpdateManagerBudget();
+
 	TArray<int32> Work = CacheManager.CollectWork(All_Cameras);
 
 	for (int32& UnInit : CacheManager.UnInitializedDataElem)
 	{
+		// Slots freed by the memory budget are refilled first
+		if (FreeTextureSlots.Num() > 0)
+		{
+			const int32 Slot = FreeTextureSlots.Pop(false);
+
+			for (auto& Cache : PerLODCaches)
+			{
+				UTextureRenderTarget2D* NewTexture = nullptr;
+				SW_RT(NewTexture, World, Cache.Value.Dimension, Cache.Value.LayerFiltering, Cache.Value.Format)
+
+				Cache.Value.TextureCache[Slot] = NewTexture;
+			}
+
+			CacheManager.AssignDataElement(UnInit, Slot);
+			continue;
+		}
+
 		int32 AddedLocation = -1;
 
 		/*
@@ -86,6 +135,8 @@ void FSWTexture2DCacheGroup::GenerateWithinRange(UWorld* World)
 		CacheManager.AssignDataElement(UnInit, AddedLocation);
 	}
 
+	CacheManager.UnInitializedDataElem.Empty();
+
 	for(int32 i = 0;i < Work.Num();i++)
 	{		
 		FSWRingCacheManager::FCacheElem& CacheElement = CacheManager.CacheElem[Work[i]];
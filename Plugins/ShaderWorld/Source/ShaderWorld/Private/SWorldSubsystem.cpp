@@ -44,6 +44,41 @@
 #include "GameFramework/PawnMovementComponent.h"
 #include "Kismet/KismetSystemLibrary.h"
 #include "Materials/MaterialInstanceDynamic.h"
+#include "EngineUtils.h"
+#include "Engine/Engine.h"
+#include "Utilities/SWTaskGraph.h"
+
+static TAutoConsoleVariable<int32> CVarSWMaterialInstancePoolMaxFree(
+	TEXT("sw.MaterialInstancePool.MaxFreePerParent"),
+	512,
+	TEXT("Released dynamic material instances kept for reuse per parent material, the others are left to the garbage collector."));
+
+static void StartRebuildSoakCommand(const TArray<FString>& Args, UWorld* World)
+{
+	if (USWorldSubsystem* Subsystem = World ? World->GetSubsystem<USWorldSubsystem>() : nullptr)
+	{
+		Subsystem->StartRebuildSoak(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 20, Args.Num() > 1 ? FCString::Atof(*Args[1]) : 5.f);
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs StartRebuildSoakCmd(
+	TEXT("sw.Soak.Rebuild"),
+	TEXT("Rebuilds every Shader World of the world repeatedly and logs UObject count, GC time and material instance pool usage. Arguments: Cycles (20) IntervalSeconds (5)"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&StartRebuildSoakCommand)
+);
+
+SW_DECLARE_COUNTER(MaterialInstancesPooled)
+SW_DECLARE_COUNTER(MaterialInstancesInUse)
+SW_DECLARE_COUNTER(MaterialInstancesCreated)
+SW_DECLARE_COUNTER(UObjectCount)
+SW_DECLARE_COUNTER(GarbageCollectUs)
+SW_DECLARE_COUNTER(TaskGraphWaiting)
+SW_DECLARE_COUNTER(TaskGraphQueued)
+SW_DECLARE_COUNTER(TaskGraphRunning)
+SW_DECLARE_COUNTER(TaskGraphCancelled)
+SW_DECLARE_COUNTER(TaskGraphReadbacks)
+SW_DECLARE_COUNTER(TaskGraphDecodes)
+SW_DECLARE_COUNTER(TaskGraphCooks)
 
 
 ETickableTickType USWorldSubsystem::GetTickableTickType() const
@@ -65,13 +100,140 @@ void USWorldSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
 	SW_Contexts.Empty();
+
+	PreGarbageCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &USWorldSubsystem::OnPreGarbageCollect);
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &USWorldSubsystem::OnPostGarbageCollect);
 }
 void USWorldSubsystem::Deinitialize()
 {
 	SW_Contexts.Empty();
+
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+
+	MaterialInstancePools.Empty();
+	MaterialInstancesPooled = 0;
+	MaterialInstancesInUse = 0;
+	SoakCyclesRemaining = 0;
+
 	Super::Deinitialize();
 }
 
+UMaterialInstanceDynamic* USWorldSubsystem::AcquireMaterialInstance(UMaterialInterface* Parent)
+{
+	if (!Parent)
+		return nullptr;
+
+	UMaterialInstanceDynamic* MID = nullptr;
+
+	if (FSWMaterialInstancePool* Pool = MaterialInstancePools.Find(Parent))
+	{
+		while (!MID && Pool->Free.Num() > 0)
+		{
+			UMaterialInstanceDynamic* Candidate = Pool->Free.Pop();
+			MaterialInstancesPooled--;
+
+			if (IsValid(Candidate))
+				MID = Candidate;
+		}
+	}
+
+	if (!MID)
+	{
+		MID = UMaterialInstanceDynamic::Create(Parent, this);
+		MaterialInstancesCreated++;
+	}
+
+	MaterialInstancesInUse++;
+
+	return MID;
+}
+
+void USWorldSubsystem::ReleaseMaterialInstance(UMaterialInstanceDynamic* MID)
+{
+	if (!MID || MID->GetOuter() != this)
+		return;
+
+	MaterialInstancesInUse = FMath::Max(MaterialInstancesInUse - 1, 0);
+
+	if (!IsValid(MID) || !MID->Parent)
+		return;
+
+	FSWMaterialInstancePool& Pool = MaterialInstancePools.FindOrAdd(MID->Parent);
+
+	if (Pool.Free.Num() >= CVarSWMaterialInstancePoolMaxFree.GetValueOnGameThread())
+		return;
+
+	MID->ClearParameterValues();
+	Pool.Free.Add(MID);
+	MaterialInstancesPooled++;
+}
+
+void USWorldSubsystem::OnPreGarbageCollect()
+{
+	GarbageCollectStart = FPlatformTime::Seconds();
+}
+
+void USWorldSubsystem::OnPostGarbageCollect()
+{
+	LastGarbageCollectMs = (FPlatformTime::Seconds() - GarbageCollectStart) * 1000.0;
+}
+
+void USWorldSubsystem::StartRebuildSoak(int32 Cycles, float IntervalSeconds)
+{
+	SoakCyclesRemaining = FMath::Max(Cycles, 0);
+	SoakInterval = FMath::Max(IntervalSeconds, 0.5f);
+	SoakTimer = 0.f;
+
+	UE_LOG(LogTemp, Display, TEXT("Shader World rebuild soak: %d cycles every %.1fs | UObjects %d"), SoakCyclesRemaining, SoakInterval, GUObjectArray.GetObjectArrayNumMinusAvailable());
+}
+
+void USWorldSubsystem::TickRebuildSoak(float DeltaTime)
+{
+	if (SoakCyclesRemaining <= 0)
+		return;
+
+	SoakTimer += DeltaTime;
+	if (SoakTimer < SoakInterval)
+		return;
+
+	SoakTimer = 0.f;
+	SoakCyclesRemaining--;
+
+	// Collect what the previous cycle released so that the logged GC time and object count reflect it
+	if (GEngine)
+		GEngine->ForceGarbageCollection(true);
+
+	UE_LOG(LogTemp, Display, TEXT("Shader World rebuild soak: %d cycles left | UObjects %d | last GC %.2fms | material instances: %d created, %d in use, %d pooled"),
+		SoakCyclesRemaining, GUObjectArray.GetObjectArrayNumMinusAvailable(), LastGarbageCollectMs, MaterialInstancesCreated, MaterialInstancesInUse, MaterialInstancesPooled);
+
+	if (SoakCyclesRemaining > 0)
+	{
+		for (TActorIterator<AShaderWorldActor> It(GetWorld()); It; ++It)
+		{
+			It->rebuild = true;
+		}
+	}
+}
+
+void USWorldSubsystem::ReportRuntimeStats()
+{
+	SW_SET_COUNTER(MaterialInstancesPooled, MaterialInstancesPooled)
+	SW_SET_COUNTER(MaterialInstancesInUse, MaterialInstancesInUse)
+	SW_SET_COUNTER(MaterialInstancesCreated, MaterialInstancesCreated)
+	SW_SET_COUNTER(UObjectCount, GUObjectArray.GetObjectArrayNumMinusAvailable())
+	SW_SET_COUNTER(GarbageCollectUs, LastGarbageCollectMs * 1000.0)
+
+	const FSWTaskGraph& TaskGraph = FSWTaskGraph::Get();
+	SW_SET_COUNTER(TaskGraphWaiting, TaskGraph.GetNumWaiting())
+	SW_SET_COUNTER(TaskGraphQueued, TaskGraph.GetNumQueued())
+	SW_SET_COUNTER(TaskGraphRunning, TaskGraph.GetNumRunning())
+	SW_SET_COUNTER(TaskGraphCancelled, TaskGraph.GetNumCancelled())
+	SW_SET_COUNTER(TaskGraphReadbacks, TaskGraph.GetNumCompleted(ESWTaskStage::Readback))
+	SW_SET_COUNTER(TaskGraphDecodes, TaskGraph.GetNumCompleted(ESWTaskStage::Decode))
+	SW_SET_COUNTER(TaskGraphCooks, TaskGraph.GetNumCompleted(ESWTaskStage::Cook))
+}
+
 bool USWorldSubsystem::IsContextRegistered(USWContextBase* SW_Context) const
 {
 	return SW_Contexts.Find(SW_Context) != INDEX_NONE;
@@ -173,6 +335,8 @@ void USWorldSubsystem::Tick(float DeltaTime)
 	TimeAcum += DeltaTime;
 
 	UpdateRenderAPI();
+	TickRebuildSoak(DeltaTime);
+	ReportRuntimeStats();
 
 	if (UWorld* World = GetWorld())
 	{
@@ -481,6 +645,17 @@ bool USWorldSubsystem::CopyAtoB(UTextureRenderTarget2D* A, UTextureRenderTarget2
 	return true;
 }
 
+bool USWorldSubsystem::ScrollAtoB(UTextureRenderTarget2D* A, UTextureRenderTarget2D* B, const FIntPoint& Offset)
+{
+	if(!RenderThreadResponded || !A || !B)
+		return false;
+
+	SWCopyData Copy(A, B, nullptr, 0, 0, FVector2D(), FVector2D(), 0.f, 0.f);
+	Copy.ScrollOffset = Offset;
+	SWToolBox->CopyAtoB(Copy);
+	return true;
+}
+
 bool USWorldSubsystem::ComputeSpawnables(TSharedPtr<FSWSpawnableRequirements>& SpawnConfig)
 {
 	if (!RenderThreadResponded)
@@ -496,12 +671,13 @@ bool USWorldSubsystem::ComputeSpawnables(TSharedPtr<FSWSpawnableRequirements>& S
 	return true;
 }
 
-bool USWorldSubsystem::ComputeNormalForHeightmap(UTextureRenderTarget2D* HeightM, UTextureRenderTarget2D* NormalM, int32& N, int32& LGC, float& HeightScale)
+bool USWorldSubsystem::ComputeNormalForHeightmap(UTextureRenderTarget2D* HeightM, UTextureRenderTarget2D* NormalM, int32& N, int32& LGC, float& HeightScale, const FIntRect& Rect)
 {
 	if (!RenderThreadResponded)
 		return false;
 
-	const SWNormalComputeData NCData(HeightM, NormalM, N, LGC, HeightScale);
+	SWNormalComputeData NCData(HeightM, NormalM, N, LGC, HeightScale);
+	NCData.Rect = Rect;
 	SWToolBox->ComputeNormalForHeightMap(NCData);
 	return true;
 }
@@ -516,3 +692,12 @@ bool USWorldSubsystem::LoadSampleLocationsInRT(UTextureRenderTarget2D* Locations
 	SWToolBox->RequestReadBackLoad(ReadBackData);
 	return true;
 }
+
+bool USWorldSubsystem::ComposeBrushStack(const SWBrushStackComputeData& Data)
+{
+	if (!RenderThreadResponded)
+		return false;
+
+	SWToolBox->ComposeBrushStack(Data);
+	return true;
+}
@@ -0,0 +1,321 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+#include "Misc/AutomationTest.h"
+#include "Data/SWCacheManager.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SWCacheManagerTests
+{
+	/*
+	 * Stands for FSWTexture2DCacheGroup: gives data to new elements and forgets trimmed data
+	 */
+	static void AssignPendingData(FSWRingCacheManager& Manager, int32& NextData)
+	{
+		for (const int32 ID : Manager.UnInitializedDataElem)
+			Manager.AssignDataElement(ID, NextData++);
+
+		Manager.UnInitializedDataElem.Empty();
+		Manager.DataToFree.Empty();
+	}
+
+	static bool SlotsAreConsistent(const FSWCacheManager& Manager)
+	{
+		for (int32 Slot = 0; Slot < Manager.UsedCacheElem.Num(); Slot++)
+		{
+			if (Manager.CacheElem[Manager.UsedCacheElem[Slot]].UsedSlot != Slot)
+				return false;
+		}
+
+		for (const int32 ID : Manager.AvailableCacheElem)
+		{
+			if (Manager.CacheElem[ID].UsedSlot != INDEX_NONE)
+				return false;
+		}
+
+		return Manager.UsedCacheElem.Num() + Manager.AvailableCacheElem.Num() + Manager.DatalessCacheElem.Num() == Manager.CacheElem.Num();
+	}
+
+	static int32 LRULength(const FSWCacheManager& Manager)
+	{
+		int32 Length = 0;
+		for (int32 ID = Manager.LRUHead; ID != INDEX_NONE; ID = Manager.CacheElem[ID].LRUNext)
+			Length++;
+
+		return Length;
+	}
+
+	static bool IsCached(const FSWCacheManager& Manager, const FIntVector& Center, int32 Ring)
+	{
+		for (int32 i = -Ring; i <= Ring; i++)
+		{
+			for (int32 j = -Ring; j <= Ring; j++)
+			{
+				if (!Manager.CacheLayout.Contains(Center + FIntVector(i, j, 0)))
+					return false;
+			}
+		}
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSWCacheManagerReleaseTest, "ShaderWorld.CacheManager.Release", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSWCacheManagerReleaseTest::RunTest(const FString& Parameters)
+{
+	FSWRingCacheManager Manager(1);
+
+	for (int32 Index = 0; Index < 64; Index++)
+	{
+		FSWCacheManager::FCacheElem& Elem = Manager.GetACacheElem();
+		Elem.Location = FIntVector(Index, 0, 0);
+		Manager.CacheLayout.Add(Elem.Location, Elem.ID);
+	}
+
+	FRandomStream RandomStream(64);
+
+	for (int32 Iteration = 0; Iteration < 32; Iteration++)
+	{
+		const int32 ID = Manager.UsedCacheElem[RandomStream.RandHelper(Manager.UsedCacheElem.Num())];
+		Manager.ReleaseCacheElem(ID);
+
+		TestFalse(TEXT("Released element left the layout"), Manager.CacheLayout.Contains(Manager.CacheElem[ID].Location));
+	}
+
+	TestEqual(TEXT("Used elements"), Manager.UsedCacheElem.Num(), 32);
+	TestEqual(TEXT("Available elements"), Manager.AvailableCacheElem.Num(), 32);
+	TestTrue(TEXT("Used slots match UsedCacheElem"), SWCacheManagerTests::SlotsAreConsistent(Manager));
+	TestEqual(TEXT("Only used elements are in the LRU list"), SWCacheManagerTests::LRULength(Manager), 32);
+
+	// Releasing twice is a no-op
+	const int32 Released = Manager.AvailableCacheElem.Last();
+	Manager.ReleaseCacheElem(Released);
+	TestEqual(TEXT("Available elements after double release"), Manager.AvailableCacheElem.Num(), 32);
+
+	// Available elements are reused before allocating
+	for (int32 Index = 0; Index < 32; Index++)
+		Manager.GetACacheElem();
+
+	TestEqual(TEXT("No allocation while elements are available"), Manager.CacheElem.Num(), 64);
+	TestTrue(TEXT("Used slots match UsedCacheElem after reuse"), SWCacheManagerTests::SlotsAreConsistent(Manager));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSWCacheManagerRingTest, "ShaderWorld.CacheManager.RingScroll", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSWCacheManagerRingTest::RunTest(const FString& Parameters)
+{
+	FSWRingCacheManager Manager(1);
+	int32 NextData = 0;
+
+	TSet<FIntVector> Viewer = { FIntVector(0, 0, 0) };
+
+	TArray<int32> Work = Manager.CollectWork(Viewer);
+	SWCacheManagerTests::AssignPendingData(Manager, NextData);
+
+	TestEqual(TEXT("First update generates the whole ring"), Work.Num(), 9);
+	TestEqual(TEXT("Misses"), (int32)Manager.Stats.Misses, 9);
+
+	// One cell to the right: the trailing column is released and reused for the leading one
+	Viewer = { FIntVector(1, 0, 0) };
+
+	Manager.ReleaseBeyondRange(Viewer);
+	TestEqual(TEXT("Trailing column released"), Manager.AvailableCacheElem.Num(), 3);
+
+	Work = Manager.CollectWork(Viewer);
+	SWCacheManagerTests::AssignPendingData(Manager, NextData);
+
+	TestEqual(TEXT("Leading column generated"), Work.Num(), 3);
+	TestEqual(TEXT("Hits"), (int32)Manager.Stats.Hits, 6);
+	TestEqual(TEXT("Released elements are reused"), Manager.CacheElem.Num(), 9);
+	TestEqual(TEXT("Reused elements keep their data"), NextData, 9);
+	TestTrue(TEXT("Used slots match UsedCacheElem"), SWCacheManagerTests::SlotsAreConsistent(Manager));
+
+	for (const int32 ID : Manager.UsedCacheElem)
+	{
+		const FIntVector Delta = Manager.CacheElem[ID].Location - FIntVector(1, 0, 0);
+		TestTrue(TEXT("Every used element is within the ring"), FMath::Max(FMath::Abs(Delta.X), FMath::Abs(Delta.Y)) <= 1);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSWCacheManagerBudgetTest, "ShaderWorld.CacheManager.MemoryBudget", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSWCacheManagerBudgetTest::RunTest(const FString& Parameters)
+{
+	FSWRingCacheManager Manager(1);
+	Manager.ElementMemoryMB = 1.0;
+	Manager.MemoryBudgetMB = 9.0;
+
+	int32 NextData = 0;
+
+	TSet<FIntVector> Viewer = { FIntVector(0, 0, 0) };
+
+	Manager.CollectWork(Viewer);
+	SWCacheManagerTests::AssignPendingData(Manager, NextData);
+
+	TestEqual(TEXT("Allocated memory"), Manager.AllocatedMemoryMB(), 9.0);
+
+	// Out of range elements are always released, even with a budget, and keep their data while within it
+	TSet<FIntVector> FarViewer = { FIntVector(100, 0, 0) };
+
+	Manager.ReleaseBeyondRange(FarViewer);
+
+	TestEqual(TEXT("Out of range elements released"), Manager.UsedCacheElem.Num(), 0);
+	TestEqual(TEXT("Released elements keep their data within budget"), Manager.AllocatedMemoryMB(), 9.0);
+	TestEqual(TEXT("Nothing to free within budget"), Manager.DataToFree.Num(), 0);
+
+	// Lowering the budget frees the data of released elements
+	Manager.MemoryBudgetMB = 4.0;
+	Manager.ReleaseBeyondRange(FarViewer);
+
+	TestEqual(TEXT("Data freed down to the budget"), Manager.DataToFree.Num(), 5);
+	TestEqual(TEXT("Allocated memory follows freed data"), Manager.AllocatedMemoryMB(), 4.0);
+	TestTrue(TEXT("Used slots match UsedCacheElem"), SWCacheManagerTests::SlotsAreConsistent(Manager));
+
+	Manager.DataToFree.Empty();
+
+	// Only the elements that still hold data can be handed out
+	const TArray<int32> Work = Manager.CollectWork(FarViewer);
+
+	TestEqual(TEXT("Generation stops at the budget"), Work.Num(), 4);
+	TestEqual(TEXT("No new data within a full budget"), Manager.UnInitializedDataElem.Num(), 0);
+	TestTrue(TEXT("Allocated memory within budget"), Manager.AllocatedMemoryMB() <= Manager.MemoryBudgetMB);
+
+	for (const int32 ID : Work)
+		TestTrue(TEXT("Handed out elements hold data"), Manager.CacheElem[ID].Data >= 0);
+
+	// Raising the budget again gives new data to the dataless elements rather than allocating new ones
+	Manager.MemoryBudgetMB = 9.0;
+	Manager.CollectWork(FarViewer);
+
+	TestEqual(TEXT("Dataless elements are reused"), Manager.CacheElem.Num(), 9);
+	TestEqual(TEXT("Dataless elements wait for data"), Manager.UnInitializedDataElem.Num(), 5);
+	TestEqual(TEXT("Allocated memory"), Manager.AllocatedMemoryMB(), 9.0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSWCacheManagerMultiViewerTest, "ShaderWorld.CacheManager.MultiViewer", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSWCacheManagerMultiViewerTest::RunTest(const FString& Parameters)
+{
+	// Two viewers whose rings do not overlap: updating for one must never evict the cells of the other
+	{
+		FSWRingCacheManager Manager(1);
+		int32 NextData = 0;
+
+		TSet<FIntVector> Viewers = { FIntVector(0, 0, 0), FIntVector(10, 0, 0) };
+
+		TArray<int32> Work = Manager.CollectWork(Viewers);
+		SWCacheManagerTests::AssignPendingData(Manager, NextData);
+
+		TestEqual(TEXT("Both rings generated"), Work.Num(), 18);
+		TestEqual(TEXT("Misses"), (int32)Manager.Stats.Misses, 18);
+		TestEqual(TEXT("Hits"), (int32)Manager.Stats.Hits, 0);
+
+		// Radius 0 turns DistanceToClosestRing into the distance to the closest viewer
+		const TMap<FIntVector, int32> ViewerCells = { { FIntVector(0, 0, 0), 0 }, { FIntVector(10, 0, 0), 0 } };
+
+		int32 PreviousDistance = 0;
+		for (const int32 ID : Work)
+		{
+			const int32 Distance = FSWRingCacheManager::DistanceToClosestRing(Manager.CacheElem[ID].Location, ViewerCells);
+			TestTrue(TEXT("Work ordered by distance to the closest viewer"), Distance >= PreviousDistance);
+			PreviousDistance = Distance;
+		}
+
+		// Same viewers: nothing released, nothing generated
+		Manager.ReleaseBeyondRange(Viewers);
+		Work = Manager.CollectWork(Viewers);
+
+		TestEqual(TEXT("No eviction while both viewers stand still"), (int32)Manager.Stats.Evictions, 0);
+		TestEqual(TEXT("Nothing to generate"), Work.Num(), 0);
+		TestEqual(TEXT("Every cell is a hit"), (int32)Manager.Stats.Hits, 18);
+		TestEqual(TEXT("No new miss"), (int32)Manager.Stats.Misses, 18);
+
+		// The second viewer moves by one cell: only its trailing column goes
+		Viewers = { FIntVector(0, 0, 0), FIntVector(11, 0, 0) };
+
+		Manager.ReleaseBeyondRange(Viewers);
+		Work = Manager.CollectWork(Viewers);
+		SWCacheManagerTests::AssignPendingData(Manager, NextData);
+
+		TestEqual(TEXT("Trailing column of the moving viewer evicted"), (int32)Manager.Stats.Evictions, 3);
+		TestEqual(TEXT("Leading column of the moving viewer generated"), Work.Num(), 3);
+		TestEqual(TEXT("Hits"), (int32)Manager.Stats.Hits, 33);
+		TestEqual(TEXT("Misses"), (int32)Manager.Stats.Misses, 21);
+		TestTrue(TEXT("Still viewer keeps its ring"), SWCacheManagerTests::IsCached(Manager, FIntVector(0, 0, 0), 1));
+		TestTrue(TEXT("Moving viewer has its ring"), SWCacheManagerTests::IsCached(Manager, FIntVector(11, 0, 0), 1));
+		TestTrue(TEXT("Used slots match UsedCacheElem"), SWCacheManagerTests::SlotsAreConsistent(Manager));
+	}
+
+	// A budget too small for both rings: the closest cells of any viewer come first
+	{
+		FSWRingCacheManager Manager(1);
+		Manager.ElementMemoryMB = 1.0;
+		Manager.MemoryBudgetMB = 5.0;
+
+		int32 NextData = 0;
+
+		const TMap<FIntVector, int32> Viewers = { { FIntVector(0, 0, 0), 1 }, { FIntVector(20, 0, 0), 2 } };
+		const TMap<FIntVector, int32> ViewerCells = { { FIntVector(0, 0, 0), 0 }, { FIntVector(20, 0, 0), 0 } };
+
+		TArray<int32> Work = Manager.CollectWork(Viewers);
+		SWCacheManagerTests::AssignPendingData(Manager, NextData);
+
+		TestEqual(TEXT("Generation stops at the budget"), Work.Num(), 5);
+		TestEqual(TEXT("Misses"), (int32)Manager.Stats.Misses, 5);
+		TestEqual(TEXT("Cells of this update are never evicted for this update"), (int32)Manager.Stats.Evictions, 0);
+
+		if (Work.Num() == 5)
+		{
+			TSet<FIntVector> Centers = { Manager.CacheElem[Work[0]].Location, Manager.CacheElem[Work[1]].Location };
+			TestTrue(TEXT("Both viewer cells first"), Centers.Contains(FIntVector(0, 0, 0)) && Centers.Contains(FIntVector(20, 0, 0)));
+
+			for (int32 Index = 2; Index < Work.Num(); Index++)
+				TestEqual(TEXT("Then the first ring of a viewer"), FSWRingCacheManager::DistanceToClosestRing(Manager.CacheElem[Work[Index]].Location, ViewerCells), 1);
+		}
+
+		// Next update with the same viewers: the budget is full and every cached cell is still wanted
+		Manager.ReleaseBeyondRange(Viewers);
+		Work = Manager.CollectWork(Viewers);
+
+		TestEqual(TEXT("No eviction of a viewer's cells"), (int32)Manager.Stats.Evictions, 0);
+		TestEqual(TEXT("Cached cells are hits"), (int32)Manager.Stats.Hits, 5);
+		TestEqual(TEXT("Nothing generated over the budget"), Work.Num(), 0);
+		TestTrue(TEXT("Allocated memory within budget"), Manager.AllocatedMemoryMB() <= Manager.MemoryBudgetMB);
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,218 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+#include "Misc/AutomationTest.h"
+#include "Component/SWHeightGenerator.h"
+#include "Actor/ShaderWorldBrushManager.h"
+#include "Brushes/ShaderWorldShapeBrush.h"
+
+#include "Async/ParallelFor.h"
+#include "Components/BoxComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SWHeightGeneratorTests
+{
+	static const int32 Octaves = 3;
+	static const float Frequency = 0.01f;
+	static const float Amplitude = 2000.f;
+	static const float BaseAltitude = 1000.f;
+	static const float HeightScale = 2.f;
+
+	static const float LayerInfluence = 0.5f;
+	static const float BrushHeight = 1000.f;
+	static const FVector BrushLocation = FVector(20000.0, 30000.0, 0.0);
+	static const FVector BrushExtent = FVector(3000.0, 3000.0, 500.0);
+
+	/*
+	 * Reference fBm, written from the USWNoiseHeightGenerator documentation rather than shared with it
+	 */
+	static double ReferenceHeight(const FVector2D& Location)
+	{
+		double Height = BaseAltitude;
+		double OctaveFrequency = Frequency / 100.0;
+		double OctaveAmplitude = Amplitude;
+
+		for (int32 Octave = 0; Octave < Octaves; Octave++)
+		{
+			Height += OctaveAmplitude * FMath::PerlinNoise2D(Location * OctaveFrequency);
+			OctaveFrequency *= 2.0;
+			OctaveAmplitude *= 0.5;
+		}
+
+		return Height;
+	}
+
+	static int32 ReferenceMaterial(double Height)
+	{
+		return Height >= 1200.0 ? 3 : Height >= 800.0 ? 2 : 1;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSWHeightGeneratorEvaluateTest, "ShaderWorld.HeightGenerator.Evaluate", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/*
+ * A noise generator with three octaves, material bands and a shape brush gathered by GatherCPUBrushStack.
+ * Noise is zero on the integer lattice of every octave, which gives known heights there; other locations are
+ * compared to a reference fBm. Evaluating from worker threads must give the exact same heights and materials.
+ */
+bool FSWHeightGeneratorEvaluateTest::RunTest(const FString& Parameters)
+{
+	using namespace SWHeightGeneratorTests;
+
+	if (!GEngine)
+	{
+		AddError(TEXT("No engine to create a world"));
+		return false;
+	}
+
+	USWNoiseHeightGenerator* Generator = NewObject<USWNoiseHeightGenerator>();
+	Generator->Octaves = Octaves;
+	Generator->Frequency = Frequency;
+	Generator->Lacunarity = 2.f;
+	Generator->Persistence = 0.5f;
+	Generator->Amplitude = Amplitude;
+	Generator->BaseAltitude = BaseAltitude;
+
+	// Out of order on purpose: the evaluator sorts the bands by altitude
+	Generator->MaterialBands.Add({ 1200.f, 3 });
+	Generator->MaterialBands.Add({ -100000.f, 1 });
+	Generator->MaterialBands.Add({ 800.f, 2 });
+
+	TSharedPtr<FSWHeightEvaluator, ESPMode::ThreadSafe> Evaluator = Generator->CreateEvaluator(FSWBagOfSeeds());
+
+	if (!TestTrue(TEXT("Evaluator created"), Evaluator.IsValid()))
+		return false;
+
+	Evaluator->HeightScale = HeightScale;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	// Spawned before the manager so OnConstruction does not register it, the layer is built below
+	AShaderWorldShapeBrush* Brush = World->SpawnActor<AShaderWorldShapeBrush>(BrushLocation, FRotator::ZeroRotator);
+	Brush->BoxBound->SetBoxExtent(BrushExtent, false);
+	Brush->Height = BrushHeight;
+
+	AShaderWorldBrushManager* BrushManager = World->SpawnActor<AShaderWorldBrushManager>();
+
+	FBrushLayer& Layer = BrushManager->BrushLayers.AddDefaulted_GetRef();
+	Layer.Influence = LayerInfluence;
+	Layer.Brushes.Add(FBrushElement(Brush, nullptr));
+
+	FBrushLayer& DisabledLayer = BrushManager->BrushLayers.AddDefaulted_GetRef();
+	DisabledLayer.Enabled = false;
+	DisabledLayer.Brushes.Add(FBrushElement(Brush, nullptr));
+
+	Evaluator->bBrushStackComplete = BrushManager->GatherCPUBrushStack(Evaluator->BrushStack);
+
+	TestTrue(TEXT("Brush stack complete"), Evaluator->MirrorsBrushStack());
+	TestEqual(TEXT("Disabled layers are not gathered"), Evaluator->BrushStack.Num(), 1);
+
+	const double Tolerance = 0.01;
+	uint16 Material = 0;
+
+	// Lattice points away from the brush: BaseAltitude, scaled by HeightScale
+	for (const FVector2D& Location : { FVector2D(0.0, 0.0), FVector2D(-10000.0, 40000.0), FVector2D(60000.0, 30000.0) })
+	{
+		TestEqual(*FString::Printf(TEXT("Generator at %s"), *Location.ToString()), Evaluator->EvaluateGenerator(Location, Material), (double)BaseAltitude, Tolerance);
+		TestEqual(*FString::Printf(TEXT("Material at %s"), *Location.ToString()), (int32)Material, 2);
+		TestEqual(*FString::Printf(TEXT("Height at %s"), *Location.ToString()), Evaluator->ComputeHeight(Location, Material), (double)(BaseAltitude * HeightScale), Tolerance);
+		TestEqual(*FString::Printf(TEXT("World height at %s"), *Location.ToString()), Evaluator->ComputeWorldHeight(Location, Material), (double)BaseAltitude, Tolerance);
+	}
+
+	// Brush center, also a lattice point: the whole brush height, weighted by the layer influence, in heightmap units
+	{
+		const FVector2D Center(BrushLocation.X, BrushLocation.Y);
+		TestEqual(TEXT("Height at brush center"), Evaluator->ComputeHeight(Center, Material), (double)(BaseAltitude * HeightScale + BrushHeight * LayerInfluence), Tolerance);
+		TestEqual(TEXT("Brushes do not change the material"), (int32)Material, 2);
+	}
+
+	// Off lattice, outside of the brush footprint
+	bool bSeveralMaterials = false;
+	for (int32 k = 0; k < 16; k++)
+	{
+		const FVector2D Location(-40000.0 + 1234.5 * k, -20000.0 + 877.25 * k);
+		const double Expected = ReferenceHeight(Location);
+
+		const double Height = Evaluator->ComputeWorldHeight(Location, Material);
+		TestEqual(*FString::Printf(TEXT("World height at %s"), *Location.ToString()), Height, Expected, Tolerance);
+
+		if (FMath::Abs(Expected - 800.0) > Tolerance && FMath::Abs(Expected - 1200.0) > Tolerance)
+			TestEqual(*FString::Printf(TEXT("Material at %s"), *Location.ToString()), (int32)Material, ReferenceMaterial(Expected));
+
+		bSeveralMaterials |= Material != 2;
+	}
+	TestTrue(TEXT("Samples cover more than one material band"), bSeveralMaterials);
+
+	// Same grid, covering the brush, serially then from worker threads
+	const int32 GridSize = 96;
+	const double Spacing = 137.0;
+	const FVector2D GridMin(BrushLocation.X - GridSize * Spacing / 2.0, BrushLocation.Y - GridSize * Spacing / 2.0);
+
+	TArray<double> SerialHeights;
+	TArray<uint16> SerialMaterials;
+	SerialHeights.SetNumUninitialized(GridSize * GridSize);
+	SerialMaterials.SetNumUninitialized(GridSize * GridSize);
+
+	for (int32 Index = 0; Index < GridSize * GridSize; Index++)
+		SerialHeights[Index] = Evaluator->ComputeHeight(GridMin + FVector2D(Index % GridSize, Index / GridSize) * Spacing, SerialMaterials[Index]);
+
+	TArray<double> ParallelHeights;
+	TArray<uint16> ParallelMaterials;
+	ParallelHeights.SetNumZeroed(GridSize * GridSize);
+	ParallelMaterials.SetNumZeroed(GridSize * GridSize);
+
+	const FSWHeightEvaluator& SharedEvaluator = *Evaluator;
+	ParallelFor(GridSize, [&](int32 Row)
+	{
+		for (int32 Column = 0; Column < GridSize; Column++)
+		{
+			const int32 Index = Column + Row * GridSize;
+			ParallelHeights[Index] = SharedEvaluator.ComputeHeight(GridMin + FVector2D(Column, Row) * Spacing, ParallelMaterials[Index]);
+		}
+	});
+
+	int32 NumDiffering = 0;
+	for (int32 Index = 0; Index < GridSize * GridSize; Index++)
+	{
+		if (SerialHeights[Index] != ParallelHeights[Index] || SerialMaterials[Index] != ParallelMaterials[Index])
+			NumDiffering++;
+	}
+	TestEqual(TEXT("Samples differing between serial and worker thread evaluation"), NumDiffering, 0);
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,135 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+
+#include "Misc/AutomationTest.h"
+#include "Utilities/SWStreamingHeightmapImporter.h"
+#include "Storage/SWTiledTerrainStorage.h"
+
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSWStreamingHeightmapImportTest, "ShaderWorld.HeightmapImport.StreamedRaw", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/*
+ * A tall .raw heightmap, not a multiple of the tile size, is streamed into a tiled terrain file.
+ * Every mip must match the whole grid path (FSWTiledTerrainWriter::WriteGrid) and the importer buffers must stay
+ * far below the size of the whole grid.
+ */
+bool FSWStreamingHeightmapImportTest::RunTest(const FString& Parameters)
+{
+	const int32 SizeX = 200;
+	const int32 SizeY = 1500;
+	const int32 TileSize = 32;
+
+	const FString Directory = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("ShaderWorld"));
+
+	TArray<uint16> Samples;
+	Samples.SetNumUninitialized(SizeX * SizeY);
+	for (int32 Y = 0; Y < SizeY; Y++)
+	{
+		for (int32 X = 0; X < SizeX; X++)
+			Samples[X + Y * SizeX] = static_cast<uint16>(32768 + 20000.f * FMath::Sin(X * 0.07f) * FMath::Cos(Y * 0.011f) + ((X * 7 + Y * 13) % 97));
+	}
+
+	FSWHeightmapImportSettings Settings;
+	Settings.SourceFile = FPaths::Combine(Directory, TEXT("StreamedImport.raw"));
+	Settings.RawDimensions = FIntPoint(SizeX, SizeY);
+	Settings.DestinationFile = FPaths::Combine(Directory, TEXT("StreamedImport.swts"));
+	Settings.TileSize = TileSize;
+
+	if (!TestTrue(TEXT("Source is written"), FFileHelper::SaveArrayToFile(TArrayView<const uint8>(reinterpret_cast<const uint8*>(Samples.GetData()), Samples.Num() * sizeof(uint16)), *Settings.SourceFile)))
+		return false;
+
+	FSWHeightmapImportStats Stats;
+	if (!TestTrue(TEXT("Import succeeds"), FSWStreamingHeightmapImporter::Import(Settings, Stats)))
+		return false;
+
+	// Reference: the same heights converted up front and written as a whole grid
+	TArray<float> Heights;
+	Heights.SetNumUninitialized(SizeX * SizeY);
+	for (int32 Texel = 0; Texel < Heights.Num(); Texel++)
+		Heights[Texel] = (static_cast<float>(Samples[Texel]) - 32768.f) * Settings.HeightScale + Settings.HeightOffset;
+
+	FSWTiledTerrainDesc ReferenceDesc;
+	ReferenceDesc.TileSize = TileSize;
+	ReferenceDesc.NumMips = 32;
+	ReferenceDesc.TexelSpacing = Settings.TexelSpacing;
+
+	const FString ReferenceFile = FPaths::Combine(Directory, TEXT("StreamedImportReference.swts"));
+	if (!TestTrue(TEXT("Reference is written"), FSWTiledTerrainWriter::WriteGrid(ReferenceFile, ReferenceDesc, SizeX, SizeY, Heights, TArray<uint8>())))
+		return false;
+
+	FSWTiledTerrainReader Imported;
+	FSWTiledTerrainReader Reference;
+	if (!TestTrue(TEXT("Files are opened"), Imported.Open(Settings.DestinationFile) && Reference.Open(ReferenceFile)))
+		return false;
+
+	const FSWTiledTerrainDesc& Desc = Imported.GetDesc();
+	TestEqual(TEXT("Dimensions"), Stats.Dimensions, FIntPoint(SizeX, SizeY));
+	TestEqual(TEXT("Tiles along X"), Desc.NumTilesX, Reference.GetDesc().NumTilesX);
+	TestEqual(TEXT("Tiles along Y"), Desc.NumTilesY, Reference.GetDesc().NumTilesY);
+	TestEqual(TEXT("Full mip chain"), Desc.NumMips, Reference.GetDesc().NumMips);
+	TestEqual(TEXT("Every tile is written once"), (int64)Stats.TilesWritten, Desc.GetNumTiles());
+
+	int32 Mismatches = 0;
+	TArray<float> ImportedHeights, ReferenceHeights;
+	TArray<uint8> ImportedMaterials, ReferenceMaterials;
+
+	for (int32 Mip = 0; Mip < Desc.NumMips; Mip++)
+	{
+		for (int32 TileY = 0; TileY < Desc.NumTilesYAtMip(Mip); TileY++)
+		{
+			for (int32 TileX = 0; TileX < Desc.NumTilesXAtMip(Mip); TileX++)
+			{
+				if (!Imported.ReadTile(Mip, TileX, TileY, ImportedHeights, ImportedMaterials) || !Reference.ReadTile(Mip, TileX, TileY, ReferenceHeights, ReferenceMaterials))
+				{
+					AddError(FString::Printf(TEXT("Mip %d tile %d %d can not be read"), Mip, TileX, TileY));
+					return false;
+				}
+
+				for (int32 Texel = 0; Texel < ImportedHeights.Num(); Texel++)
+				{
+					if (!FMath::IsNearlyEqual(ImportedHeights[Texel], ReferenceHeights[Texel], 0.01f))
+						Mismatches++;
+				}
+			}
+		}
+	}
+
+	TestEqual(TEXT("Streamed mips match the whole grid"), Mismatches, 0);
+
+	const uint64 WholeGridBytes = (uint64)SizeX * SizeY * (sizeof(float) + sizeof(uint8));
+	TestTrue(FString::Printf(TEXT("Importer buffers (%llu bytes) stay under a quarter of the whole grid (%llu bytes)"), Stats.PeakBufferBytes, WholeGridBytes), Stats.PeakBufferBytes * 4 < WholeGridBytes);
+
+	return true;
+}
+
+#endif
@@ -27,11 +27,12 @@
   */
 
 #include "Utilities/HeightMapImporter.h"
+#include "Utilities/SWStreamingHeightmapImporter.h"
 
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "Misc/MessageDialog.h"
 #include "Misc/FileHelper.h"
-#include "Containers/Map.h"
+#include "Async/ParallelFor.h"
 
 #include "IImageWrapper.h"
 #include "IImageWrapperModule.h"
@@ -79,9 +80,6 @@ void AHeightMapImporter::Tick(float DeltaTime)
 
 		bTriggerHeightmapImport = false;
 		ImportHeightmap();
-
-		UE_LOG(LogTemp, Warning, TEXT("SelectedData.Num() %d"), SelectedData.Num());
-
 	}
 	#endif
 
@@ -122,6 +120,31 @@ void AHeightMapImporter::Import()
 	bTriggerHeightmapImport=true;
 }
 
+void AHeightMapImporter::ImportToTerrainStorage()
+{
+	if (HeightMapToImport == "" || TerrainStorageFile == "")
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Invalid heightmap or terrain storage file path"));
+		return;
+	}
+
+	FSWHeightmapImportSettings Settings;
+	Settings.SourceFile = HeightMapToImport;
+	Settings.RawDimensions = HeightMapDimensionIfRaw;
+	Settings.DestinationFile = TerrainStorageFile;
+	Settings.TileSize = (int32)FMath::RoundUpToPowerOfTwo(FMath::Clamp(TerrainStorageTileSize, 16, 1024));
+	Settings.TexelSpacing = TerrainStorageTexelSpacing;
+
+	FSWHeightmapImportStats Stats;
+	if (!FSWStreamingHeightmapImporter::Import(Settings, Stats))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Heightmap import to %s failed"), *TerrainStorageFile);
+		return;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Heightmap %dx%d imported to %s: %d tiles in %.2fs, %.1f MB buffers"), Stats.Dimensions.X, Stats.Dimensions.Y, *TerrainStorageFile, Stats.TilesWritten, Stats.ImportSeconds, Stats.PeakBufferBytes / (1024.0 * 1024.0));
+}
+
 
 
 void AHeightMapImporter::ImportHeightmap()
@@ -142,7 +165,7 @@ void AHeightMapImporter::ImportHeightmap()
 	}
 
 
-	TArray<uint8> Data;
+	TArray64<uint8> Data;
 
 	FFileHelper::LoadFileToArray(Data, *HeightMapToImport);
 
@@ -211,7 +234,7 @@ void AHeightMapImporter::ImportHeightmap()
 			}
 			else
 			{
-				Data = RawData;
+				Data = MoveTemp(RawData);
 			}
 
 		}
@@ -221,7 +244,7 @@ void AHeightMapImporter::ImportHeightmap()
 	else if (ExtensionOfHeightMap == raw || ExtensionOfHeightMap == rawCap)
 	{
 		if (Data.Num() <= 0
-			|| Data.Num() != (HeightMapDimensionIfRaw.X * HeightMapDimensionIfRaw.Y * sizeof(uint16)))
+			|| Data.Num() != ((int64)HeightMapDimensionIfRaw.X * HeightMapDimensionIfRaw.Y * sizeof(uint16)))
 		{
 			FMessageDialog::Open(EAppMsgType::Ok, NSLOCTEXT("UnrealEd", "LandscapeImport_BadHeightmapSize", "File size does not match"));
 			return;
@@ -229,22 +252,14 @@ void AHeightMapImporter::ImportHeightmap()
 	}
 
 
-	Import(HeightMapDimensionIfRaw.X, HeightMapDimensionIfRaw.Y, (uint16*)Data.GetData());
+	Import(HeightMapDimensionIfRaw.X, HeightMapDimensionIfRaw.Y, (const uint16*)Data.GetData());
 }
 #endif
-void AHeightMapImporter::Import(int32 VertsX, int32 VertsY, uint16* HeightData)
+void AHeightMapImporter::Import(int32 VertsX, int32 VertsY, const uint16* HeightData)
 {
 #if WITH_EDITORONLY_DATA
 
-	for (int32 Y = 0; Y < VertsY; ++Y)
-	{
-		for (int32 X = 0; X < VertsX; ++X)
-		{
-			SelectedData.Add(FIntPoint(X, Y), HeightData[X + Y * VertsX]);
-		}
-	}
-
-	SampleData(VertsX, VertsY);
+	SampleData(VertsX, VertsY, HeightData);
 
 #endif
 }
@@ -252,7 +267,7 @@ void AHeightMapImporter::Import(int32 VertsX, int32 VertsY, uint16* HeightData)
 
 
 
-void AHeightMapImporter::SampleData(int32 SizeX, int32 SizeY)
+void AHeightMapImporter::SampleData(int32 SizeX, int32 SizeY, const uint16* HeightData)
 {
 #if WITH_EDITORONLY_DATA
 	HeightmapFolder.RemoveSpacesInline();
@@ -279,35 +294,24 @@ void AHeightMapImporter::SampleData(int32 SizeX, int32 SizeY)
 	
 
 
-	uint8* Pixels = new uint8[HeightMapDimensionIfRaw.X * HeightMapDimensionIfRaw.Y * 4];
-
-	uint16 MaxHeight = 0;
+	uint8* Pixels = new uint8[(int64)HeightMapDimensionIfRaw.X * HeightMapDimensionIfRaw.Y * 4];
 
-	for (int32 Y = 0; Y < SizeY; ++Y)
+	// Rows are independent, the height is split inline rather than through the shared convertFrom16To8 buffer
+	ParallelFor(SizeY, [&](int32 Y)
 	{
 		for (int32 X = 0; X < SizeX; ++X)
 		{
+			const uint16 ConvertedHeight = HeightData[X + Y * SizeX];
 
-			const uint16 ConvertedHeight = (uint16)*SelectedData.Find(FIntPoint(X, Y));
-
-			if(ConvertedHeight>MaxHeight)
-				MaxHeight=ConvertedHeight;
-
-			uint8* Converted = convertFrom16To8(ConvertedHeight);
-
-			uint8 Part1 = Converted[0];
-			uint8 Part2 = Converted[1];
-
-			int32 curPixelIndex = ((Y * HeightMapDimensionIfRaw.X) + X);
+			const int64 curPixelIndex = ((int64)Y * HeightMapDimensionIfRaw.X) + X;
 
 			//B8G8R8A8
 			Pixels[4 * curPixelIndex] = 0; //B
-			Pixels[4 * curPixelIndex + 1] = Converted[1]; // G
-			Pixels[4 * curPixelIndex + 2] = Converted[0]; // R
+			Pixels[4 * curPixelIndex + 1] = ConvertedHeight & 0x00FF; // G
+			Pixels[4 * curPixelIndex + 2] = (ConvertedHeight >> 8) & 0x00FF; // R
 			Pixels[4 * curPixelIndex + 3] = 0; // A
-
 		}
-	}
+	});
 
 	//Allocate first mipmap.
 	FTexture2DMipMap* Mip = new FTexture2DMipMap();
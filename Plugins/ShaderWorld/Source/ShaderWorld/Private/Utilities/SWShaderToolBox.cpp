@@ -48,6 +48,7 @@ DECLARE_GPU_STAT_NAMED(ShaderWorldCopy, TEXT("ShaderWorld Copy"));
 DECLARE_GPU_STAT_NAMED(ShaderWorldNormalmapCompute, TEXT("ShaderWorld Normalmap Compute"));
 DECLARE_GPU_STAT_NAMED(ShaderWorldSpawnableCompute, TEXT("ShaderWorld Spawnable Compute"));
 DECLARE_GPU_STAT_NAMED(ShaderWorldReadBack, TEXT("ShaderWorld ReadBack Process"));
+DECLARE_GPU_STAT_NAMED(ShaderWorldBrushStack, TEXT("ShaderWorld Brush Stack"));
 
 namespace ShaderWorldGPUTools
 {
@@ -59,6 +60,9 @@ namespace ShaderWorldGPUTools
 	IMPLEMENT_SHADER_TYPE(template<>, FSWNormalFromHeightmap_MobileCS, TEXT("/ShaderWorld/ShaderWorldUtilities.usf"), TEXT("NormalFromHeightMapCS"), SF_Compute);
 	IMPLEMENT_SHADER_TYPE(template<>, FSWComputeSpawnable_MobileCS, TEXT("/ShaderWorld/ShaderWorldUtilities.usf"), TEXT("ComputeSpawnableCS"), SF_Compute);
 
+	IMPLEMENT_SHADER_TYPE(template<>, FSWBrushStack_CS, TEXT("/ShaderWorld/ShaderWorldUtilities.usf"), TEXT("BrushStackCS"), SF_Compute);
+	IMPLEMENT_SHADER_TYPE(template<>, FSWBrushStack_MobileCS, TEXT("/ShaderWorld/ShaderWorldUtilities.usf"), TEXT("BrushStackCS"), SF_Compute);
+
 
 	IMPLEMENT_SHADER_TYPE(, FTopologyUpdate_CS, TEXT("/ShaderWorld/ShaderWorldUtilities.usf"), TEXT("TopologyUpdateCS"), SF_Compute);
 	IMPLEMENT_SHADER_TYPE(, FLoadReadBackLocations_CS, TEXT("/ShaderWorld/ShaderWorldUtilities.usf"), TEXT("SampleLocationLoaderCS"), SF_Compute);
@@ -120,6 +124,7 @@ namespace ShaderWorldGPUTools
 		PassParameters->DestinationTex = RT_UAV;
 		PassParameters->Border = Data.Border;
 		PassParameters->ChannelSelect = Data.ChannelSelect;
+		PassParameters->ScrollOffset = Data.ScrollOffset;
 		PassParameters->Pass.SourceTex = Data.A->GetResource()->TextureRHI;
 		PassParameters->Pass.SourceTexSampler = Data.A->GetResource()->SamplerStateRHI;
 		GraphBuilder.AddPass(
@@ -230,9 +235,16 @@ void SW_NormalForHeightMap_Typed(FRDGBuilder& GraphBuilder, const SWNormalComput
 	RDG_EVENT_SCOPE(GraphBuilder, "SWNormalMapCompute");
 	RDG_GPU_STAT_SCOPE(GraphBuilder, ShaderWorldNormalmapCompute);
 
+	const FIntRect FullRect(0, 0, Data.B->GetResource()->GetSizeX(), Data.B->GetResource()->GetSizeY());
+	FIntRect Rect = Data.Rect.Area() > 0 ? Data.Rect : FullRect;
+	Rect.Clip(FullRect);
+
+	if (Rect.Area() <= 0)
+		return;
+
 	FIntVector GroupCount;
-	GroupCount.X = FMath::DivideAndRoundUp((float)Data.B->GetResource()->GetSizeX(), (float)T::GetGroupSizeX());
-	GroupCount.Y = FMath::DivideAndRoundUp((float)Data.B->GetResource()->GetSizeY(), (float)T::GetGroupSizeY());
+	GroupCount.X = FMath::DivideAndRoundUp((float)Rect.Width(), (float)T::GetGroupSizeX());
+	GroupCount.Y = FMath::DivideAndRoundUp((float)Rect.Height(), (float)T::GetGroupSizeY());
 	GroupCount.Z = 1;
 
 	const FUnorderedAccessViewRHIRef RT_UAV = RHICreateUnorderedAccessView(Data.B->GetResource()->TextureRHI);
@@ -251,6 +263,8 @@ void SW_NormalForHeightMap_Typed(FRDGBuilder& GraphBuilder, const SWNormalComput
 	PassParameters->SWHeightmapScale = Data.SWHeightmapScale;
 	PassParameters->N = Data.N;
 	PassParameters->LocalGridScaling = Data.LocalGridScaling;
+	PassParameters->NormalRectMin = FUintVector2(Rect.Min.X, Rect.Min.Y);
+	PassParameters->NormalRectMax = FUintVector2(Rect.Max.X, Rect.Max.Y);
 
 	GraphBuilder.AddPass(
 		RDG_EVENT_NAME("SWShaderToolBox::ComputeNormal_CS"),
@@ -546,4 +560,89 @@ void SWShaderToolBox::RequestReadBackLoad_RT(FRHICommandListImmediate& RHICmdLis
 	GraphBuilder.Execute();
 
 }
+void SWShaderToolBox::ComposeBrushStack(const SWBrushStackComputeData& Data) const
+{
+	ENQUEUE_RENDER_COMMAND(ShaderTools_brush_stack)
+		([this, Data](FRHICommandListImmediate& RHICmdList)
+			{
+				ComposeBrushStack_RT(RHICmdList, Data);
+			}
+	);
+}
+
+template<typename T>
+void SW_BrushStack_Typed(FRDGBuilder& GraphBuilder, const SWBrushStackComputeData& Data)
+{
+	RDG_EVENT_SCOPE(GraphBuilder, "SWBrushStack");
+	RDG_GPU_STAT_SCOPE(GraphBuilder, ShaderWorldBrushStack);
+
+	const uint32 TexDim = Data.Destination->GetResource()->GetSizeX();
+
+	FIntVector GroupCount;
+	GroupCount.X = FMath::DivideAndRoundUp((float)TexDim, (float)T::GetGroupSizeX());
+	GroupCount.Y = FMath::DivideAndRoundUp((float)Data.Destination->GetResource()->GetSizeY(), (float)T::GetGroupSizeY());
+	GroupCount.Z = 1;
+
+	const FUnorderedAccessViewRHIRef RT_UAV = RHICreateUnorderedAccessView(Data.Destination->GetResource()->TextureRHI);
+
+	const FRDGBufferRef BrushBuffer = CreateStructuredBuffer(
+		GraphBuilder,
+		TEXT("SWBrushStack"),
+		sizeof(FSWCompositeBrushParameters),
+		Data.Brushes.Num(),
+		Data.Brushes.GetData(),
+		Data.Brushes.Num() * Data.Brushes.GetTypeSize()
+	);
+
+	typename T::FPermutationDomain PermutationVector;
+	TShaderMapRef<T> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel), PermutationVector);
+
+	typename T::FParameters* PassParameters = GraphBuilder.AllocParameters<typename T::FParameters>();
+	PassParameters->Pass.SourceTex = Data.Source->GetResource()->TextureRHI;
+	PassParameters->Pass.SourceTexSampler = Data.Source->GetResource()->SamplerStateRHI;
+
+	const bool bUseLocations = Data.Locations && Data.Locations->GetResource();
+	// Unused when sampling the grid, but has to be bound
+	PassParameters->BrushLocationsTex = bUseLocations ? Data.Locations->GetResource()->TextureRHI : Data.Source->GetResource()->TextureRHI;
+	PassParameters->BrushUseLocations = bUseLocations ? 1 : 0;
+
+	PassParameters->BrushStack = GraphBuilder.CreateSRV(BrushBuffer);
+	PassParameters->BrushCount = Data.Brushes.Num();
+	PassParameters->BrushTexDim = TexDim;
+	PassParameters->BrushMargin = Data.Grid.Margin;
+	PassParameters->BrushPatchFullSize = Data.Grid.PatchFullSize;
+	PassParameters->BrushOrigin = Data.Origin;
+	PassParameters->BrushRectCount = FMath::Min(Data.Rects.Num(), SWBrushStackComputeData::MaxRects);
+	for (uint32 RectIndex = 0; RectIndex < PassParameters->BrushRectCount; RectIndex++)
+	{
+		const FIntRect& Rect = Data.Rects[RectIndex];
+		PassParameters->BrushRects[RectIndex] = FUintVector4(FMath::Max(Rect.Min.X, 0), FMath::Max(Rect.Min.Y, 0), FMath::Max(Rect.Max.X, 0), FMath::Max(Rect.Max.Y, 0));
+	}
+	PassParameters->DestinationTex = RT_UAV;
+
+	GraphBuilder.AddPass(
+		RDG_EVENT_NAME("SWShaderToolBox::BrushStack_CS"),
+		PassParameters,
+		ERDGPassFlags::Compute |
+		ERDGPassFlags::NeverCull,
+		[PassParameters, ComputeShader, GroupCount](FRHICommandList& RHICmdList)
+		{
+			FComputeShaderUtils::Dispatch(RHICmdList, ComputeShader, *PassParameters, GroupCount);
+		});
+}
+
+void SWShaderToolBox::ComposeBrushStack_RT(FRHICommandListImmediate& RHICmdList, const SWBrushStackComputeData& Data) const
+{
+	if (!(Data.Source && Data.Source->GetResource() && Data.Destination && Data.Destination->GetResource()) || Data.Brushes.Num() == 0)
+		return;
+
+	FRDGBuilder GraphBuilder(RHICmdList);
+
+	if (GMaxRHIFeatureLevel > ERHIFeatureLevel::ES3_1)
+		SW_BrushStack_Typed< FSWBrushStack_CS>(GraphBuilder, Data);
+	else
+		SW_BrushStack_Typed< FSWBrushStack_MobileCS>(GraphBuilder, Data);
+
+	GraphBuilder.Execute();
+}
 }
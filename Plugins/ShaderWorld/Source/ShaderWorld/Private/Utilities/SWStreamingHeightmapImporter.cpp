@@ -0,0 +1,297 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+#include "Utilities/SWStreamingHeightmapImporter.h"
+
+#include "Storage/SWTiledTerrainStorage.h"
+#include "SWStats.h"
+
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+
+FSWStreamingHeightmapImporter::FSWStreamingHeightmapImporter(const FSWHeightmapImportSettings& InSettings, FSWTiledTerrainWriter& InWriter, int32 InSizeX, int32 InSizeY, int32 InNumMips)
+	: Settings(InSettings)
+	, Writer(InWriter)
+{
+	Strips.SetNum(InNumMips);
+
+	int32 MipSizeX = InSizeX;
+	for (FMipStrip& Strip : Strips)
+	{
+		Strip.SizeX = MipSizeX;
+		Strip.Heights.SetNumUninitialized(MipSizeX * Settings.TileSize);
+		Strip.Materials.SetNumZeroed(MipSizeX * Settings.TileSize);
+
+		MipSizeX = FMath::Max(1, FMath::DivideAndRoundUp(MipSizeX, 2));
+	}
+
+	TrackMemory();
+}
+
+void FSWStreamingHeightmapImporter::TrackMemory(uint64 TransientBytes)
+{
+	uint64 Bytes = TransientBytes;
+	for (const FMipStrip& Strip : Strips)
+		Bytes += Strip.Heights.GetAllocatedSize() + Strip.Materials.GetAllocatedSize();
+
+	PeakBufferBytes = FMath::Max(PeakBufferBytes, Bytes);
+}
+
+bool FSWStreamingHeightmapImporter::PushSourceRows(const uint16* Samples, int32 NumRows)
+{
+	const int32 SizeX = Strips[0].SizeX;
+
+	TArray<float> Heights;
+	Heights.SetNumUninitialized(SizeX * NumRows);
+
+	ParallelFor(NumRows, [&](int32 Row)
+	{
+		const uint16* Src = Samples + Row * SizeX;
+		float* Dst = Heights.GetData() + Row * SizeX;
+
+		for (int32 X = 0; X < SizeX; X++)
+			Dst[X] = (static_cast<float>(Src[X]) - 32768.f) * Settings.HeightScale + Settings.HeightOffset;
+	});
+
+	TrackMemory(Heights.GetAllocatedSize());
+
+	return AppendRows(0, Heights, TConstArrayView<uint8>(), NumRows);
+}
+
+bool FSWStreamingHeightmapImporter::AppendRows(int32 Mip, TConstArrayView<float> Heights, TConstArrayView<uint8> Materials, int32 NumRows)
+{
+	FMipStrip& Strip = Strips[Mip];
+	const int32 TileSize = Settings.TileSize;
+
+	int32 Consumed = 0;
+	while (Consumed < NumRows)
+	{
+		const int32 Take = FMath::Min(TileSize - Strip.Rows, NumRows - Consumed);
+
+		FMemory::Memcpy(Strip.Heights.GetData() + Strip.Rows * Strip.SizeX, Heights.GetData() + Consumed * Strip.SizeX, Take * Strip.SizeX * sizeof(float));
+
+		if (Materials.Num() > 0)
+			FMemory::Memcpy(Strip.Materials.GetData() + Strip.Rows * Strip.SizeX, Materials.GetData() + Consumed * Strip.SizeX, Take * Strip.SizeX);
+		else
+			FMemory::Memzero(Strip.Materials.GetData() + Strip.Rows * Strip.SizeX, Take * Strip.SizeX);
+
+		Strip.Rows += Take;
+		Consumed += Take;
+
+		if (Strip.Rows == TileSize && !EmitStrip(Mip))
+			return false;
+	}
+
+	return true;
+}
+
+bool FSWStreamingHeightmapImporter::EmitStrip(int32 Mip)
+{
+	FMipStrip& Strip = Strips[Mip];
+
+	if (Strip.Rows <= 0)
+		return true;
+
+	const FSWTiledTerrainDesc& Desc = Writer.GetDesc();
+	const int32 TileSize = Desc.TileSize;
+	const int32 TilesX = Desc.NumTilesXAtMip(Mip);
+
+	TArray<TArray<uint8>> Payloads;
+	TArray<FSWTiledTerrainTileEntry> Entries;
+	Payloads.SetNum(TilesX);
+	Entries.SetNum(TilesX);
+
+	ParallelFor(TilesX, [&](int32 TileX)
+	{
+		TArray<float> TileHeights;
+		TArray<uint8> TileMaterials;
+		TileHeights.SetNumUninitialized(Desc.TexelsPerTile());
+		TileMaterials.SetNumUninitialized(Desc.TexelsPerTile());
+
+		// Border tiles clamp to the last column / row of the source
+		for (int32 Y = 0; Y < TileSize; Y++)
+		{
+			const int32 StripY = FMath::Min(Y, Strip.Rows - 1);
+
+			for (int32 X = 0; X < TileSize; X++)
+			{
+				const int32 StripX = FMath::Min(TileX * TileSize + X, Strip.SizeX - 1);
+
+				TileHeights[X + Y * TileSize] = Strip.Heights[StripX + StripY * Strip.SizeX];
+				TileMaterials[X + Y * TileSize] = Strip.Materials[StripX + StripY * Strip.SizeX];
+			}
+		}
+
+		FSWTiledTerrainWriter::EncodeTile(Desc, TileHeights, TileMaterials, Payloads[TileX], Entries[TileX]);
+	});
+
+	for (int32 TileX = 0; TileX < TilesX; TileX++)
+	{
+		if (!Writer.WriteEncodedTile(Mip, TileX, Strip.NextTileY, Payloads[TileX], Entries[TileX]))
+			return false;
+
+		TilesWritten++;
+	}
+
+	Strip.NextTileY++;
+
+	TArray<float> HalfHeights;
+	TArray<uint8> HalfMaterials;
+	const int32 Rows = Strip.Rows;
+	const bool bHasNextMip = Strips.IsValidIndex(Mip + 1);
+
+	if (bHasNextMip)
+	{
+		FSWTiledTerrainWriter::DownsampleGrid(Strip.SizeX, Rows,
+			TConstArrayView<float>(Strip.Heights.GetData(), Strip.SizeX * Rows),
+			TConstArrayView<uint8>(Strip.Materials.GetData(), Strip.SizeX * Rows),
+			HalfHeights, HalfMaterials);
+	}
+
+	Strip.Rows = 0;
+	TrackMemory();
+
+	return !bHasNextMip || AppendRows(Mip + 1, HalfHeights, HalfMaterials, FMath::DivideAndRoundUp(Rows, 2));
+}
+
+bool FSWStreamingHeightmapImporter::Finish()
+{
+	// Flushing a mip may fill the next one, which is flushed right after
+	for (int32 Mip = 0; Mip < Strips.Num(); Mip++)
+	{
+		if (!EmitStrip(Mip))
+			return false;
+	}
+
+	return true;
+}
+
+bool FSWStreamingHeightmapImporter::Import(const FSWHeightmapImportSettings& Settings, FSWHeightmapImportStats& OutStats)
+{
+	const double StartTime = FPlatformTime::Seconds();
+	OutStats = FSWHeightmapImportStats();
+
+	if (Settings.TileSize < 2 || !FMath::IsPowerOfTwo(Settings.TileSize))
+		return false;
+
+	const FString Extension = FPaths::GetExtension(Settings.SourceFile).ToLower();
+
+	int32 SizeX = 0;
+	int32 SizeY = 0;
+
+	TUniquePtr<IFileHandle> RawFile;
+	TArray64<uint8> DecodedPNG;
+
+	if (Extension == TEXT("raw") || Extension == TEXT("r16"))
+	{
+		SizeX = Settings.RawDimensions.X;
+		SizeY = Settings.RawDimensions.Y;
+
+		RawFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Settings.SourceFile));
+
+		if (!RawFile.IsValid() || SizeX <= 0 || SizeY <= 0 || RawFile->Size() != (int64)SizeX * SizeY * sizeof(uint16))
+		{
+#if SWDEBUG
+			SW_LOG("Heightmap import: %s can not be read or does not match the given dimensions", *Settings.SourceFile)
+#endif
+			return false;
+		}
+	}
+	else if (Extension == TEXT("png"))
+	{
+		IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>("ImageWrapper");
+		TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+
+		{
+			TArray<uint8> Compressed;
+			if (!ImageWrapper.IsValid() || !FFileHelper::LoadFileToArray(Compressed, *Settings.SourceFile) || !ImageWrapper->SetCompressed(Compressed.GetData(), Compressed.Num()))
+				return false;
+		}
+
+		if (ImageWrapper->GetBitDepth() != 16 || !ImageWrapper->GetRaw(ERGBFormat::Gray, 16, DecodedPNG))
+			return false;
+
+		SizeX = ImageWrapper->GetWidth();
+		SizeY = ImageWrapper->GetHeight();
+	}
+	else
+	{
+		return false;
+	}
+
+	FSWTiledTerrainDesc Desc;
+	Desc.TileSize = Settings.TileSize;
+	Desc.NumTilesX = FMath::DivideAndRoundUp(SizeX, Settings.TileSize);
+	Desc.NumTilesY = FMath::DivideAndRoundUp(SizeY, Settings.TileSize);
+	Desc.TexelSpacing = Settings.TexelSpacing;
+	Desc.Compression = ESWTileCompression::Oodle;
+
+	const int32 FullMipCount = FSWTiledTerrainDesc::ComputeFullMipCount(Desc.NumTilesX, Desc.NumTilesY);
+	Desc.NumMips = Settings.NumMips > 0 ? FMath::Min(Settings.NumMips, FullMipCount) : FullMipCount;
+
+	FSWTiledTerrainWriter Writer;
+	if (!Writer.Open(Settings.DestinationFile, Desc))
+		return false;
+
+	FSWStreamingHeightmapImporter Importer(Settings, Writer, SizeX, SizeY, Desc.NumMips);
+
+	TArray<uint16> SourceRows;
+	SourceRows.SetNumUninitialized(SizeX * Settings.TileSize);
+
+	bool bSuccess = true;
+
+	for (int32 Y = 0; bSuccess && Y < SizeY; Y += Settings.TileSize)
+	{
+		const int32 NumRows = FMath::Min(Settings.TileSize, SizeY - Y);
+		const int64 Bytes = (int64)SizeX * NumRows * sizeof(uint16);
+
+		if (RawFile.IsValid())
+			bSuccess = RawFile->Read(reinterpret_cast<uint8*>(SourceRows.GetData()), Bytes);
+		else
+			FMemory::Memcpy(SourceRows.GetData(), DecodedPNG.GetData() + (int64)Y * SizeX * sizeof(uint16), Bytes);
+
+		bSuccess = bSuccess && Importer.PushSourceRows(SourceRows.GetData(), NumRows);
+	}
+
+	bSuccess = bSuccess && Importer.Finish();
+	bSuccess = Writer.Close() && bSuccess;
+
+	OutStats.ImportSeconds = FPlatformTime::Seconds() - StartTime;
+	OutStats.PeakBufferBytes = Importer.PeakBufferBytes + SourceRows.GetAllocatedSize() + DecodedPNG.GetAllocatedSize();
+	OutStats.PeakProcessBytes = FPlatformMemory::GetStats().PeakUsedPhysical;
+	OutStats.TilesWritten = Importer.TilesWritten;
+	OutStats.Dimensions = FIntPoint(SizeX, SizeY);
+
+	return bSuccess;
+}
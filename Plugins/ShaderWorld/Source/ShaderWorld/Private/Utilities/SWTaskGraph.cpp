@@ -0,0 +1,201 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+#include "Utilities/SWTaskGraph.h"
+#include "Async/TaskGraphInterfaces.h"
+
+static TAutoConsoleVariable<int32> CVarSWTaskGraphMaxConcurrentJobs(
+	TEXT("sw.TaskGraph.MaxConcurrentJobs"),
+	0,
+	TEXT("Maximum number of Shader World jobs running at once. 0: number of worker threads minus one."));
+
+static int32 GetMaxConcurrentJobs()
+{
+	const int32 Requested = CVarSWTaskGraphMaxConcurrentJobs.GetValueOnAnyThread();
+
+	if (Requested > 0)
+		return Requested;
+
+	return FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads() - 1);
+}
+
+static UE::Tasks::ETaskPriority ToTaskPriority(ESWTaskPriority Priority)
+{
+	switch (Priority)
+	{
+	case ESWTaskPriority::Critical:
+	case ESWTaskPriority::High:
+		return UE::Tasks::ETaskPriority::High;
+	case ESWTaskPriority::Normal:
+		return UE::Tasks::ETaskPriority::Normal;
+	default:
+		return UE::Tasks::ETaskPriority::BackgroundNormal;
+	}
+}
+
+void FSWTaskHandle::Wait() const
+{
+	if (Completion.IsValid())
+		Completion->Wait();
+}
+
+FSWTaskGraph& FSWTaskGraph::Get()
+{
+	static FSWTaskGraph Graph;
+	return Graph;
+}
+
+FSWTaskHandle FSWTaskGraph::Launch(const FSWTaskDesc& Desc, TUniqueFunction<void()>&& Work)
+{
+	FJobRef Job = MakeShared<FJob, ESPMode::ThreadSafe>();
+	Job->DebugName = Desc.DebugName;
+	Job->Stage = Desc.Stage;
+	Job->Priority = Desc.Priority;
+	Job->Cancellation = Desc.Cancellation;
+	Job->Work = MoveTemp(Work);
+	Job->Completion = MakeShared<UE::Tasks::FTaskEvent, ESPMode::ThreadSafe>(Desc.DebugName);
+
+	FSWTaskHandle Handle;
+	Handle.Completion = Job->Completion;
+
+	TArray<UE::Tasks::FTaskEvent, TInlineAllocator<4>> PendingPrerequisites;
+	for (const FSWTaskHandle& Prerequisite : Desc.Prerequisites)
+	{
+		if (Prerequisite.IsPending())
+			PendingPrerequisites.Add(*Prerequisite.Completion);
+	}
+
+	if (PendingPrerequisites.Num() == 0)
+	{
+		Enqueue(Job);
+		return Handle;
+	}
+
+	// The gate only moves the job to the ready queue, it does not count against the cap
+	NumWaiting++;
+	UE::Tasks::Launch(TEXT("SWTaskGraph.Gate"), [this, Job]()
+		{
+			NumWaiting--;
+			Enqueue(Job);
+		},
+		UE::Tasks::Prerequisites(PendingPrerequisites), UE::Tasks::ETaskPriority::High);
+
+	return Handle;
+}
+
+void FSWTaskGraph::Enqueue(const FJobRef& Job)
+{
+	{
+		FScopeLock Lock(&QueueLock);
+		Ready[static_cast<int32>(Job->Priority)].Add(Job);
+		NumQueued++;
+	}
+
+	Dispatch();
+}
+
+void FSWTaskGraph::Dispatch()
+{
+	while (true)
+	{
+		TSharedPtr<FJob, ESPMode::ThreadSafe> Job;
+		bool bTookSlot = false;
+
+		{
+			FScopeLock Lock(&QueueLock);
+
+			for (TArray<FJobRef>& Queue : Ready)
+			{
+				if (Queue.Num() == 0)
+					continue;
+
+				// Cancelled jobs never take a slot
+				if (!Queue[0]->Cancellation.IsValid() || !Queue[0]->Cancellation->IsCancelled())
+				{
+					if (NumRunning >= GetMaxConcurrentJobs())
+						return;
+
+					NumRunning++;
+					bTookSlot = true;
+				}
+
+				Job = Queue[0];
+				Queue.RemoveAt(0, 1, false);
+				NumQueued--;
+				break;
+			}
+		}
+
+		if (!Job.IsValid())
+			return;
+
+		FJobRef JobRef = Job.ToSharedRef();
+
+		// Jobs cancelled after taking a slot are skipped by Run, which releases the slot
+		if (!bTookSlot)
+		{
+			NumCancelled++;
+			Complete(JobRef);
+			continue;
+		}
+
+		UE::Tasks::Launch(JobRef->DebugName, [this, JobRef]()
+			{
+				Run(JobRef);
+			},
+			ToTaskPriority(JobRef->Priority));
+	}
+}
+
+void FSWTaskGraph::Run(const FJobRef& Job)
+{
+	// Cancelled while waiting for a worker
+	if (Job->Cancellation.IsValid() && Job->Cancellation->IsCancelled())
+		NumCancelled++;
+	else
+		Job->Work();
+
+	{
+		FScopeLock Lock(&QueueLock);
+		NumRunning--;
+	}
+
+	Complete(Job);
+
+	Dispatch();
+}
+
+void FSWTaskGraph::Complete(const FJobRef& Job)
+{
+	// Captures are released before dependents run
+	Job->Work = nullptr;
+
+	NumCompleted[static_cast<int32>(Job->Stage)]++;
+
+	Job->Completion->Trigger();
+}
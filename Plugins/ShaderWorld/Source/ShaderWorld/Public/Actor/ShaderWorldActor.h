@@ -62,6 +62,10 @@ class FSWShareableIndexBuffer;
 class FSWShareableVerticePositionBuffer;
 class FSWSimpleReadbackManager;
 class USWSeedGenerator;
+class USWHeightGenerator;
+class FSWHeightEvaluator;
+class FSWTileDiskCache;
+class FSWGridTopology;
 
 struct FGeoCProcMeshVertex;
 
@@ -115,15 +119,101 @@ public:
 	void TickReadBack();
 	void AddPendingReadBack(int32 InBlockSize, int32 InExtentX, int32 InExtentY, TSharedPtr<FRHIGPUTextureReadback>& InReadStage, TSharedPtr<FSWColorRead, ESPMode::ThreadSafe>& InDest, TSharedPtr < FThreadSafeBool, ESPMode::ThreadSafe>& InProc);
 
+	/*
+	 * Can be read from any thread, PendingReads itself is only accessed from the rendering thread
+	 */
+	int32 GetNumPendingReads() const { return NumPendingReads.GetValue(); }
+
 protected:
 
 	FCriticalSection MapLock;
 	TArray<FReadBackTask> PendingReads;
+	FThreadSafeCounter NumPendingReads;
 };
 
 
 DECLARE_DYNAMIC_DELEGATE_OneParam(FSWHeightRetrievalDelegate, const TArray<FVector3f>&, Locations);
 
+/*
+ * A RetrieveHeightAt request. Its samples can be spread over several batches, Callback is executed once all of them are read back.
+ */
+struct FSWHeightQuery
+{
+	TArray<FVector> Locations;
+	TArray<FVector3f> Results;
+	FSWHeightRetrievalDelegate Callback;
+	int32 NextLocationToDispatch = 0;
+	int32 PendingSamples = 0;
+};
+
+/** A fully decoded query, its callback runs once ReadbacksManagement is done with the batches */
+struct FSWCompletedHeightQuery
+{
+	FSWHeightRetrievalDelegate Callback;
+	TArray<FVector3f> Results;
+};
+
+struct FSWHeightQuerySampleRef
+{
+	uint32 QueryID = 0;
+	int32 LocationIndex = 0;
+	int32 SampleIndex = 0;
+};
+
+/*
+ * One in-flight GPU evaluation: unique sample locations of coalesced queries packed in a square location texture
+ */
+USTRUCT()
+struct FSWHeightQueryBatch
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Transient)
+		TObjectPtr < UTextureRenderTarget2D> LocationsRT = nullptr;
+	UPROPERTY(Transient)
+		TObjectPtr < UTextureRenderTarget2D> HeightmapRT = nullptr;
+	UPROPERTY(Transient)
+		TObjectPtr < UMaterialInstanceDynamic> GeneratorDyn = nullptr;
+
+	TSharedPtr<FSWShareableSamplePoints, ESPMode::ThreadSafe> Samples;
+	TSharedPtr<FSWColorRead, ESPMode::ThreadSafe> ReadData;
+	TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe> ReadCompletion;
+	TArray<FSWHeightQuerySampleRef> SampleRefs;
+
+	bool bInFlight = false;
+};
+
+/*
+ * Several collision tiles evaluated by a single generator draw and read back at once.
+ * Every atlas texel carries the world location of one collision vertex, tiles are laid out row by row.
+ */
+USTRUCT()
+struct FSWCollisionAtlasBatch
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Transient)
+		TObjectPtr < UTextureRenderTarget2D> LocationsRT = nullptr;
+	UPROPERTY(Transient)
+		TObjectPtr < UTextureRenderTarget2D> HeightmapRT = nullptr;
+	UPROPERTY(Transient)
+		TObjectPtr < UMaterialInstanceDynamic> GeneratorDyn = nullptr;
+
+	TSharedPtr<FSWShareableSamplePoints, ESPMode::ThreadSafe> Samples;
+	TSharedPtr<FSWColorRead, ESPMode::ThreadSafe> ReadData;
+	TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe> ReadCompletion;
+
+	/*
+	 * Per tile slot: destination of the tile heights and completion flag of the collision mesh
+	 */
+	TArray<TSharedPtr<FSWColorRead, ESPMode::ThreadSafe>> TileData;
+	TArray<TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe>> TileCompletion;
+
+	FBox BoundingBox = FBox(ForceInit);
+	int32 TilesPerSide = 0;
+	bool bInFlight = false;
+};
+
 UCLASS(hideCategories(Rendering, Input, Game, LOD, Replication, Networking, Cooking, HLOD,Collision), meta = (DisplayName = "Shader World Actor"), AutoCollapseCategories = ("Advanced"))
 class SHADERWORLD_API AShaderWorldActor : public AActor
 {
@@ -221,14 +311,20 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config", meta = (EditCondition = "UpdateHeightDataOverTime", UIMin = 1.0, UIMax = 1.6, ClampMin = 1.f, ClampMax = 1.6f))
 		float UpdateRateDegradationFactor = 1.35f;
 
-	UPROPERTY(/*EditAnywhere, BlueprintReadWrite, Category = "Config" */ )
+	/**
+	* Clipmap rings whose footprint falls outside of the world bounds are not drawn
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config")
 		bool WorldHasBounds = false;
 	/**
 	* 1.0 : WorldBounds in Meters
 	*/
-	UPROPERTY(/*EditAnywhere, BlueprintReadWrite, Category = "Config", meta = (EditCondition = "WorldHasBounds") */ )
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config", meta = (EditCondition = "WorldHasBounds"))
 		FVector2D WorldBounds = FVector2D(8000,8000);
-	UPROPERTY(/*EditAnywhere, BlueprintReadWrite, Category = "Config", meta = (EditCondition = "WorldHasBounds") */ )
+	/**
+	* Size in Meters of the finest bounded world quadtree leaves
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config", meta = (EditCondition = "WorldHasBounds", ClampMin = 1))
 		int32 TileSizeGeneration = 64;
 
 	UPROPERTY(Transient)
@@ -298,6 +394,11 @@ public:
 	*/
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Config")
 		float RendertargetMemoryBudgetMB = 0;
+	/**
+	* Hard memory limit of each transient cache group, 0 for unlimited. Once reached, least recently used tiles are recycled instead of allocating new ones
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Config", meta = (ClampMin = 0))
+		float TransientCacheMemoryBudgetMB = 0;
 	
 	/**
 	* Hard rebuild of the vegetation
@@ -348,6 +449,16 @@ public:
 		TArray<bool> ClipMapToUpdate;
 
 		FRenderCommandFence SegmentedFence;
+
+	/**
+	* Scratch render targets used to scroll the ring caches, per dimension
+	*/
+	UPROPERTY(Transient)
+		TMap<int32, UTextureRenderTarget2D*> ScrollScratchRT;
+
+	FVector ScheduleLastCamLocation = FVector(0.f);
+	double ScheduleLastTime = 0.0;
+	float ScheduleCameraSpeed = 0.f;
 	////////////////////////////////////////////////////////
 	// Segmented Updates End
 	///////////////////////////////////////////////////////
@@ -369,6 +480,14 @@ public:
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Instanced, Category = "World Settings")
 		USWSeedGenerator* SeedGenerator;
+	/**
+	* Optional CPU mirror of the Generator material. When set, collision tiles and height retrievals are evaluated on worker threads instead of GPU draws and readbacks.
+	* Has to produce the same heights as Generator, brushes without CPU mirror force the GPU path.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Instanced, Category = "World Settings")
+		USWHeightGenerator* HeightGenerator = nullptr;
+
+	TSharedPtr<FSWHeightEvaluator, ESPMode::ThreadSafe> HeightEvaluator;
 
 	UPROPERTY(Transient)
 		FSWBagOfSeeds CurrentSeedsArray;
@@ -398,6 +517,30 @@ public:
 	*/
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "World Collision")
 		int32 CollisionMaxDrawCallPerFrame = 3;
+	/**
+	*  Build collision patches as Chaos heightfields from the height samples, skipping trimesh cooking
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "World Collision")
+		bool bUseHeightfieldCollision = false;
+	/**
+	*  Evaluate collision tiles in batches: a single generator draw and readback per atlas of tiles (see sw.Collision.AtlasTilesPerSide)
+	*  CollisionMaxDrawCallPerFrame then limits atlases instead of tiles. Not used when exporting physical material IDs.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "World Collision")
+		bool bBatchCollisionGeneration = false;
+	/**
+	*  Keep generated collision tiles in Saved/ShaderWorld/TileCache, keyed on the generator, its seeds and the brushes over each tile.
+	*  Warm starts and revisited regions then skip the generation entirely.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "World Collision")
+		bool bUseTileDiskCache = false;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "World Collision", meta = (EditCondition = bUseTileDiskCache, ClampMin = 1))
+		int32 TileDiskCacheMaxSizeMB = 1024;
+	/**
+	*  Part of the cache keys: increase it after editing the generator material itself, which the keys can not track
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "World Collision", meta = (EditCondition = bUseTileDiskCache))
+		int32 TileDiskCacheVersion = 0;
 
 	
 	
@@ -415,6 +558,31 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "World Collision", meta = (EditCondition = bExportPhysicalMaterialID))
 		EDataMapChannel LayerChannelStoringID = EDataMapChannel::Red;
 
+	/**
+	*  Processes that can not render (dedicated servers, -nullrhi) generate collision tiles around every player pawn,
+	*  evaluated on CPU by the HeightGenerator. No render target is created. Budgets: sw.Server.*
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Server")
+		bool bHeadlessServerMode = false;
+	/**
+	*  Also place spawnables with collisions around each player pawn on headless processes.
+	*  Placement is the CPU jittered grid of the HeightGenerator, not the density material clients use: instances will not match the client ones.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Server", meta = (EditCondition = bHeadlessServerMode))
+		bool bHeadlessSpawnables = false;
+	/**
+	*  Spawnable grid cells placed around each player pawn cell, on headless processes
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Server", meta = (EditCondition = "bHeadlessServerMode && bHeadlessSpawnables", UIMin = 0, UIMax = 10, ClampMin = 0, ClampMax = 10))
+		int32 HeadlessSpawnableRings = 1;
+
+	UPROPERTY(Transient)
+		TArray<FSWHeadlessSpawnable> HeadlessSpawnables;
+
+	float HeadlessCollisionTileCredit = 0.f;
+	float HeadlessSpawnableCellCredit = 0.f;
+	bool bHeadlessGenerationUnavailable = false;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "")
 		TObjectPtr < USWorldRoot > RootComp;
 
@@ -517,17 +685,17 @@ public:
 	TQueue<FBox2D> CollisionUpdateRequest;
 
 	/*
-	 * Evaluate the generator function anywhere : 25 Samples per frame maximum
-	 * Doesn't take into account brushes for now, if you want to use it extensively you would need
-	 * A seperate actor or subsystem which would gather requestd from everyone, compute the answers and send them back when ready mostly through TOptional<FVector>
+	 * Evaluate the generator function anywhere, any amount of locations.
+	 * Requests are queued, coalesced and deduplicated into square batches of sw.HeightQuery.BatchDimension samples per side, sw.HeightQuery.MaxInFlight batches being evaluated at once.
+	 * If a HeightGenerator mirrors the generator and brushes, the callback is executed immediately from CPU evaluation.
 	 */
 	UFUNCTION(BlueprintCallable, Category = "HeightRetrieve")
 		bool RetrieveHeightAt(const TArray<FVector>& Locations, const FSWHeightRetrievalDelegate& Callback);
 
-	FSWHeightRetrievalDelegate HeightRetrieveDelegate;
-	FRenderCommandFence HeighRetrievalFence;
-	TSharedPtr < FThreadSafeBool, ESPMode::ThreadSafe> bProcessingHeightRetrieval;
-	TSharedPtr < FThreadSafeBool, ESPMode::ThreadSafe> bProcessingHeightRetrievalRT;
+	/*
+	 * CPU mirror of the generator, valid when HeightGenerator is set. Thread safe: can be evaluated from any thread (spawnables, gameplay)
+	 */
+	TSharedPtr<FSWHeightEvaluator, ESPMode::ThreadSafe> GetHeightEvaluator() const { return HeightEvaluator; }
 
 /*Allow other actors to access the landscape data, i.e ocean getting landscape heightmap*/
 	UFUNCTION(BlueprintCallable, Category = "WorldData")
@@ -584,6 +752,9 @@ public:
 	bool HighestLOD_Visible();
 
 	FVector GetCameraLocation(){return CamLocation;};
+
+	/** Seconds the ring of this LOD has been waiting for a deferred refresh, 0 when up to date or hidden */
+	float GetClipMapStaleness(int32 LOD) const;
 	bool UseSegmented();
 
 	//FORCEINLINE void TrackComponent(USW_CollisionComponent* ActorToTrack){if(ActorToTrack)External_Actors_Tracked.Add(ActorToTrack);};
@@ -596,7 +767,8 @@ protected:
 	UPROPERTY(Transient)
 		TArray<FClipMapPerLODCaches> LODCaches;
 
-	TSharedPtr < FThreadSafeBool, ESPMode::ThreadSafe> bPreprocessingCollisionUpdate;
+	/** CollisionCPU selection of the tiles to create, move or update */
+	FSWTaskHandle CollisionSelectTask;
 
 	UPROPERTY(Transient)
 		TArray<FCollisionMeshElement> CollisionMesh;
@@ -611,18 +783,43 @@ protected:
 
 
 	UPROPERTY(Transient)
-		TObjectPtr < UTextureRenderTarget2D> ReadRequestLocation = nullptr;
-	UPROPERTY(Transient)
-		TObjectPtr < UTextureRenderTarget2D> ReadRequestLocationHeightmap = nullptr;
+		TArray<FSWHeightQueryBatch> HeightQueryBatches;
+
+	TMap<uint32, FSWHeightQuery> HeightQueries;
+	/*
+	 * Queries with samples not yet assigned to a batch, oldest first
+	 */
+	TArray<uint32> HeightQueryDispatchQueue;
+	uint32 HeightQueryNextID = 0;
+
+	/*
+	 * Collision display material, shared by every collision mesh as they only differ by their geometry
+	 */
 	UPROPERTY(Transient)
-		TObjectPtr < UMaterialInstanceDynamic> GeneratorDynamicForReadBack = nullptr;
+		UMaterialInstanceDynamic* CollisionDisplayMaterial = nullptr;
+
+public:
+	/** Dynamic material instances of pool elements come from the subsystem pool, keyed by parent material */
+	UMaterialInstanceDynamic* AcquireMaterialInstance(UMaterialInterface* Parent);
+	/** Gives MID back to the subsystem pool and resets the pointer */
+	void ReleaseMaterialInstance(UMaterialInstanceDynamic*& MID);
+protected:
 
-	TArray<FVector3f> PositionsOfReadBacks;
+	UMaterialInstanceDynamic* CreateHeightReadBackMaterial(UTextureRenderTarget2D* LocationsRT);
+	bool DispatchHeightQueryBatch(FSWHeightQueryBatch& Batch);
+	void CompleteHeightQueryBatch(FSWHeightQueryBatch& Batch, TArray<FSWCompletedHeightQuery>& OutCompletedQueries);
 
-	TSharedPtr<FSWShareableSamplePoints, ESPMode::ThreadSafe> PointsPendingReadBacks;
-	TSharedPtr<FSWColorRead, ESPMode::ThreadSafe> ReadBackHeightData;
+	UPROPERTY(Transient)
+		TArray<FSWCollisionAtlasBatch> CollisionAtlasBatches;
+	/*
+	 * Atlas currently receiving collision tiles, INDEX_NONE if none
+	 */
+	int32 CollisionAtlasFillingBatch = INDEX_NONE;
 
-	FRenderCommandFence HeightReadBackFence;
+	bool UseCollisionAtlasBatching() const;
+	void AddTileToCollisionAtlas(FCollisionMeshElement& Mesh, const FVector& PatchLocation);
+	void FlushCollisionAtlas();
+	void CompleteCollisionAtlasBatch(FSWCollisionAtlasBatch& Batch);
 
 
 	FCollisionMeshElement& GetACollisionMesh();
@@ -650,8 +847,12 @@ protected:
 	void SetN();
 	void IncrementSpawnableDrawCounter();
 
-	void CreateGridMeshWelded(int offset, int32 NumX, int32 NumY, TSharedPtr<FSWShareableIndexBuffer>& Triangles, TSharedPtr<FSWShareableIndexBuffer>& TrianglesAlt, TArray<FVector3f>& Vertices, TArray<FVector2f>& UVs, TArray<FVector2f>& UV1s, TArray<FVector2f>& UV2s, int32& GridSpacing, FVector& Offset, uint8 StitchProfil);
+	/** Without bBuildIndices, only vertices and UVs are appended: Triangles / TrianglesAlt come from FSWGridTopologyCache */
+	void CreateGridMeshWelded(int offset, int32 NumX, int32 NumY, TSharedPtr<FSWShareableIndexBuffer>& Triangles, TSharedPtr<FSWShareableIndexBuffer>& TrianglesAlt, TArray<FVector3f>& Vertices, TArray<FVector2f>& UVs, TArray<FVector2f>& UV1s, TArray<FVector2f>& UV2s, int32& GridSpacing, FVector& Offset, uint8 StitchProfil, bool bBuildIndices = true);
 	void CreateGridMeshWelded(int32 NumX, int32 NumY, TSharedPtr<FSWShareableIndexBuffer>& Triangles, TSharedPtr<FSWShareableVerticePositionBuffer>& Vertices, TArray<FVector2f>& UVs, int32 GridSpac);
+
+	// Shared by every collision tile, keeps the cached topology alive
+	TSharedPtr<const FSWGridTopology, ESPMode::ThreadSafe> CollisionGridTopology;
 	void UpdateViewFrustum();
 	void UpdateCameraLocation();
 	float HeightToClosestCollisionMesh();
@@ -671,7 +872,23 @@ protected:
 	void ComputeNormalForClipMap(int index, bool bFromSegmented = false);
 	void ComputeSegmentedNormalForClipMap(int index);
 	void ComputeDataLayersForClipMap(int index);
+	/** DirtyRects: only draw those texels of the layer, the others are up to date */
+	void ComputeDataLayerForClipMap(int index, int LayerIndex, TConstArrayView<FIntRect> DirtyRects = TConstArrayView<FIntRect>());
 	void ComputeDataLayersSegmentedForClipMap(int index);
+	/**
+	* Moves the ring caches content from CacheLocation to Location and only generates the newly exposed texels.
+	* Returns false if the ring has to be fully recomputed instead.
+	*/
+	bool ScrollClipMapCaches(int index);
+	UTextureRenderTarget2D* GetScrollScratchRT(int32 Dimension);
+	/**
+	* Grants the time and brush driven ring refreshes by priority until the frame update budget is spent, the others are deferred.
+	* Camera moves are never deferred: nested rings have to move together.
+	*/
+	void ScheduleClipMapUpdates(float CameraHeight, double CurrentTime);
+	float ComputeClipMapPriority(const FClipMapMeshElement& Elem, float CameraHeight, double CurrentTime) const;
+	/** Texels written by a ring update, used as the GPU cost estimate of the update budget */
+	int64 EstimateClipMapUpdateTexels(int index, bool bMove) const;
 	void UpdateClipMap();
 	void FixNamingCollision(const UWorld* W, const FCollisionMeshElement& Mesh, const FString& WantedName);
 
@@ -680,6 +897,10 @@ protected:
 	bool CanUpdateSpawnables();
 
 	void FinalizeAsyncWork();
+	/** Spawnables by decreasing priority of their most urgent pending work, each work queue sorted the same way */
+	void GatherSpawnableFinalizeOrder(TArray<FSpawnableMesh*, TInlineAllocator<64>>& OutOrder);
+	/** Instances per segmented HISM update, sized so a batch costs a fraction of the finalize budget */
+	int32 ComputeSpawnableFinalizeBatchSize(const FSpawnableMesh& Spawn, double GameThreadBudget_ms) const;
 
 	bool UpdateSpawnableNew(FSWBiom& Biom, int indice, int Biomindice, bool MustBeInFrustum, int MaxRing = -1);
 	void UpdateSpawnablesNew();
@@ -688,7 +909,22 @@ protected:
 	void SpawnablesManagement(float& DeltaT);
 	void TerrainAndSpawnablesManagement(float& DeltaT);
 	void BoundedWorldUpdate(float& DeltaT);
-	void ProcessBoundedWorldVisit(const uint64 TreeID_, const TArray<TStaticArray<TSharedPtr < FSW_PointerTree<FSWQuadElement>::FPointerNode>, 4 >>& ToCreate, const TArray<TStaticArray<TSharedPtr < FSW_PointerTree<FSWQuadElement>::FPointerNode>, 4 >>& ToCleanUp);
+	void ProcessBoundedWorldVisit(const FSWBoundedWorldVisit& Visit);
+	/** Does the part of Ring not covered by InnerRing overlap a leaf of the bounded world */
+	bool IsClipMapRingInBoundedWorld(const FClipMapMeshElement& Ring, const FClipMapMeshElement* InnerRing) const;
+
+	/*
+	 * Headless processes: no rendering, CPU evaluation only
+	 */
+	bool IsHeadlessProcess() const;
+	void HeadlessTick(float DeltaT);
+	bool HeadlessSetup();
+	void UpdateHeadlessVisitors();
+	void InitiateHeadlessSpawnables();
+	void CleanUpHeadlessSpawnables();
+	void HeadlessSpawnablesManagement(float DeltaT);
+	void AddHeadlessSpawnableInstances(FSWHeadlessSpawnable& Spawnable, const TArray<TArray<FTransform>>& Transforms);
+	void RebuildHeadlessSpawnableInstances(FSWHeadlessSpawnable& Spawnable);
 
 	void CollisionManagement(float& DeltaT);
 	bool SetupCollisions();
@@ -701,12 +937,40 @@ protected:
 
 	void ReadbacksManagement();
 
+	/*
+	 * Queue depths and pending readbacks, emitted to CSV/trace captures
+	 */
+	void ReportRuntimeStats();
+
 	int32 SphericalProjection(FIntVector Destination);
 	inline static double GetHeightFromGPURead(uint8* ReadLoc,uint16& MaterialIndice);
 	static double GetHeightFromGPUReadOld(FColor& ReadLoc, uint16& MaterialIndice);
 
+	inline static void EncodeHeightForGPURead(double Height, uint16 MaterialIndice, uint8* WriteLoc);
+	// Vectorized GetHeightFromGPURead over Count consecutive texels
+	static void DecodeGPUReadTexels(const uint8* ReadLoc, int32 Count, float* OutHeights, uint16* OutMaterialIndices);
+
+	void UpdateHeightEvaluator();
+	bool CanUseCPUHeightEvaluation() const;
+	// WorldLocation is absolute (origin rebasing excluded), 0 without HeightGenerator
 	double ComputeWorldHeightAt(FVector WorldLocation);
-	void UpdateCollisionMeshData(FCollisionMeshElement& Mesh );
+	void UpdateCollisionMeshData(FCollisionMeshElement& Mesh, bool bAllowDiskCacheLoad = true);
+
+	/*
+	 * Collision tiles disk cache
+	 */
+	void SetupTileDiskCache();
+	uint64 ComputeTileDiskCacheWorldHash() const;
+	void UpdateBrushFootprintHashes();
+	uint64 GetCollisionTileDiskCacheKey(const FCollisionMeshElement& Mesh, const FVector& PatchLocation) const;
+	bool LoadCollisionTileFromDiskCache(FCollisionMeshElement& Mesh);
+
+	TSharedPtr<FSWTileDiskCache, ESPMode::ThreadSafe> TileDiskCache;
+	// World space brush footprints and their content hash, in drawing order
+	TArray<TPair<FBox2D, uint64>> BrushFootprintHashes;
+	uint64 TileDiskCacheWorldHash = 0;
+	// Set by external collision rebuild requests: the inputs they react to are not part of the keys
+	bool bBypassTileDiskCacheForUpdates = false;
 
 	static void GetLocalTransformOfSpawnable(FInstancedStaticMeshInstanceData& OutTransform, const FVector& CompLoc, FColor& LocX, FColor& LocY, FColor& LocZ, FColor& Rot,/*FColor& Scale, */ FInstancedStaticMeshInstanceData& FromT, const bool& IsAdjustement, const FFloatInterval& AtitudeRange, const FVector& MeshLoc);
 	bool UpdateSpawnableCollisions(FSpawnableMesh& Spawn, double& UpdateStartTime);
@@ -775,13 +1039,20 @@ protected:
 	{
 		int32 MeshID=-1;
 		TSharedPtr<FSWColorRead, ESPMode::ThreadSafe> Read;
+		// When valid, heights are read from here instead of Read
+		TSharedPtr<FSWHeightMaterialRead, ESPMode::ThreadSafe> Read32;
 		TSharedPtr<FSWShareableVerticePositionBuffer, ESPMode::ThreadSafe> SourceB;
 		TSharedPtr<FSWShareableVerticePositionBuffer, ESPMode::ThreadSafe> DestB;
+		// Non zero when the decoded tile has to be stored in the disk cache
+		uint64 DiskCacheKey = 0;
+		// Cancelled tiles are neither decoded nor applied
+		FSWTaskCancellationPtr Cancellation;
 
 		inline FCollisionProcessingWork(){}
-		inline FCollisionProcessingWork(const int32 ID, const TSharedPtr<FSWColorRead>& R, const TSharedPtr<FSWShareableVerticePositionBuffer>& S, const TSharedPtr<FSWShareableVerticePositionBuffer>& D)
+		inline FCollisionProcessingWork(const int32 ID, const TSharedPtr<FSWColorRead>& R, const TSharedPtr<FSWShareableVerticePositionBuffer>& S, const TSharedPtr<FSWShareableVerticePositionBuffer>& D, const TSharedPtr<FSWHeightMaterialRead>& R32 = nullptr)
 			:MeshID(ID),
 			Read(R),
+			Read32(R32),
 			SourceB(S),
 			DestB(D)
 		{}
@@ -790,7 +1061,10 @@ protected:
 	TArray<FCollisionProcessingWork> CollisionWorkQueue;
 
 	/** Allows skipping processing, if another one is already in progress */
-	TSharedPtr < FThreadSafeBool, ESPMode::ThreadSafe> bProcessingGroundCollision;
+	FSWTaskHandle CollisionDecodeTask;
+
+	/** Height jobs of the tiles in CollisionWorkQueue still running: the decode waits for them instead of the game thread */
+	TArray<FSWTaskHandle> CollisionDecodePrerequisites;
 
 	FThreadSafeBool BoundedWorldVisitorProcessing = false;
 
@@ -820,8 +1094,25 @@ protected:
 
 public:
 
+	/** sw.Spawnables.BenchmarkDecode: single threaded against chunked decode of synthetic spawnable readbacks */
+	static void BenchmarkSpawnableDecode(const TArray<FString>& Args);
+	/** sw.Collision.BenchmarkDecode: per texel and vectorized decode of synthetic collision readbacks against the R32F + R8 copy */
+	static void BenchmarkCollisionDecode(const TArray<FString>& Args);
+	/** sw.BoundedWorld.BenchmarkTree: flat arena quadtree against a shared pointer node quadtree */
+	static void BenchmarkBoundedWorldTree(const TArray<FString>& Args);
+
 	TSharedPtr<FSW_PointerTree<FSWQuadElement>> BoundedWorldTree = nullptr;
 	uint64 TreeID = 0;
+	uint64 NextQuadID = 0;
+
+	TSharedPtr<FSWBoundedWorldVisit, ESPMode::ThreadSafe> BoundedWorldVisit;
+	/** Viewers, split distance and tree revision the last visit was launched with: no new visit until one changes */
+	TArray<FVector> BoundedWorldVisitViewers;
+	float BoundedWorldVisitSplitDistance = 0.f;
+	int64 BoundedWorldVisitRevision = INDEX_NONE;
+	/** XY bounds of the current leaves, consumed by the clipmap LOD selection */
+	TArray<FBox2D> BoundedWorldLeafBounds;
+	int64 BoundedWorldLeafRevision = INDEX_NONE;
 
 private:
 
@@ -31,6 +31,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Engine/VolumeTexture.h"
+#include "Data/SWBrushCompositor.h"
 #include "ShaderWorldBrush.generated.h"
 
 class UBoxComponent;
@@ -123,6 +124,28 @@ struct FVolumeTextureBrushParameter
 
 	bool IsValidParameter() { return Texture3D_value ? true : false; };
 };
+
+/**
+ * Immutable CPU mirror of a brush, evaluated from worker threads to produce the same result as the brush material.
+ * Locations are absolute world locations.
+ */
+class SHADERWORLD_API FSWCPUBrush
+{
+public:
+	virtual ~FSWCPUBrush() = default;
+
+	virtual double ApplyBrushAt(const FVector2D& Location, double SourceHeight, float LayerInfluence, float BrushInfluence) const = 0;
+
+	FBox2D FootPrint = FBox2D(ForceInit);
+};
+
+struct FSWCPUBrushStackElement
+{
+	TSharedPtr<FSWCPUBrush, ESPMode::ThreadSafe> Brush;
+	float LayerInfluence = 1.f;
+	float BrushInfluence = 1.f;
+};
+
 UCLASS(hideCategories(Rendering, HLOD, NetWorking, Physics, Collision, Input, Game, LOD, Replication, Cooking))
 class SHADERWORLD_API AShaderWorldBrush : public AActor
 {
@@ -225,10 +248,27 @@ public:
 	virtual void ApplyBrushAt(UTextureRenderTarget2D* Destination_RT,UTextureRenderTarget2D* Source_RT,float LayerInfluence,float BrushInfluence, FVector RingLocation, int32 GridScaling, int N,bool CollisionMesh, bool IsLayer, bool IsReadback=false, UTextureRenderTarget2D* Location_RT=nullptr);
 	
 	virtual bool IsValidBrush();
+	/**
+	* For c++ brushes override this function to allow CPU evaluation of the terrain (collision, height queries)
+	* Called on game thread, returned mirror must not reference the brush actor. nullptr if the brush has no CPU mirror.
+	*/
+	virtual TSharedPtr<FSWCPUBrush, ESPMode::ThreadSafe> CreateCPUBrush();
+	/**
+	* For c++ brushes override this function if the brush can be evaluated by the brush stack compute shader instead of a material draw.
+	* Called right before the brush is drawn, Origin is the absolute world location Parameters are relative to. Returns false to use ApplyBrushAt.
+	*/
+	virtual bool PrepareCompositeDraw(const FVector& Origin, float LayerInfluence, float BrushInfluence, FSWCompositeBrushParameters& OutParameters);
 
 	void SetLastDrawnFootPrint(FBox2D& FootPrint);
 
 	FBox2D& GetLastDrawFootprint(){return FootPrintWhenLastDrawn;}
+
+	/**
+	* Set by the brush manager around ApplyBrushAt: texels of the destination the brush can modify.
+	* No rect means the whole render target.
+	*/
+	void SetPendingDrawRects(TConstArrayView<FIntRect> Rects){PendingDrawRects = Rects;}
+	void ClearPendingDrawRects(){PendingDrawRects.Reset();}
 	
 protected:
 	// Called when the game starts or when spawned
@@ -236,6 +276,14 @@ protected:
 
 	bool	EndPlayTriggered=false;
 
+	/**
+	* Evaluates Material over PendingDrawRects of Destination_RT, the remaining texels are copied from Source_RT.
+	* Clears then draws the whole render target if there is no pending rect.
+	*/
+	void DrawBrushMaterial(UMaterialInterface* Material, UTextureRenderTarget2D* Destination_RT, UTextureRenderTarget2D* Source_RT);
+
+	TArray<FIntRect, TInlineAllocator<4>> PendingDrawRects;
+
 	bool	Layer_Enabled=true;
 	bool	Brush_Enabled=true;
 
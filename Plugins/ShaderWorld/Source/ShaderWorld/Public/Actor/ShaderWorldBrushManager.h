@@ -31,6 +31,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Actor/ShaderWorldBrush.h"
+#include "Data/SWBrushSpatialIndex.h"
 #include "ShaderWorldBrushManager.generated.h"
 
 class AShaderWorldActor;
@@ -164,13 +165,29 @@ public:
 
 	void ResetB();
 
-	void ApplyBrushStackToHeightMap(AShaderWorldActor* SourceWorld,int level, UTextureRenderTarget2D* Heightmap_RT, FVector RingLocation, int32 GridScaling, int& N, bool CollisionMesh, bool ReadBack=false, UTextureRenderTarget2D* Location_RT = nullptr);
-	void ApplyBrushStackToLayer(AShaderWorldActor* SourceWorld,int level, UTextureRenderTarget2D* Layer_RT, FVector RingLocation, int32& GridScaling, int& N, FString& LayerName);
+	/**
+	* DirtyRects: when not empty, only those texels of the target are drawn by the brushes.
+	* The other texels are expected to already hold the brush stack result, as when scrolling a ring cache.
+	*/
+	void ApplyBrushStackToHeightMap(AShaderWorldActor* SourceWorld,int level, UTextureRenderTarget2D* Heightmap_RT, FVector RingLocation, int32 GridScaling, int& N, bool CollisionMesh, bool ReadBack=false, UTextureRenderTarget2D* Location_RT = nullptr, TConstArrayView<FIntRect> DirtyRects = TConstArrayView<FIntRect>());
+	void ApplyBrushStackToLayer(AShaderWorldActor* SourceWorld,int level, UTextureRenderTarget2D* Layer_RT, FVector RingLocation, int32& GridScaling, int& N, FString& LayerName, TConstArrayView<FIntRect> DirtyRects = TConstArrayView<FIntRect>());
 
-	void ApplyStackForFootprint(FBox2D FootPrint, UTextureRenderTarget2D* Heightmap_RT, FVector RingLocation, int32 GridScaling, int N, bool CollisionMesh, bool IsLayer, FString& LayerName, bool ReadBack = false, UTextureRenderTarget2D* Location_RT = nullptr);
+	void ApplyStackForFootprint(FBox2D FootPrint, UTextureRenderTarget2D* Heightmap_RT, FVector RingLocation, int32 GridScaling, int N, bool CollisionMesh, bool IsLayer, FString& LayerName, bool ReadBack = false, UTextureRenderTarget2D* Location_RT = nullptr, TConstArrayView<FIntRect> DirtyRects = TConstArrayView<FIntRect>());
 
 	void AddExogeneReDrawBox(FBox2D Box){ExogeneReDrawBox.Add(Box);};
 
+	/**
+	* Snapshot the CPU mirrors of the active brushes, in drawing order.
+	* Returns false if an active brush has no CPU mirror.
+	*/
+	bool GatherCPUBrushStack(TArray<FSWCPUBrushStackElement>& OutStack);
+
+	/**
+	* Footprint and content hash of each active brush, in drawing order. Footprints are in world space, ignoring origin rebasing.
+	* Hashes only depend on the brush settings and placement, they are stable across sessions.
+	*/
+	void GatherBrushFootprintHashes(TArray<TPair<FBox2D, uint64>>& OutHashes);
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
@@ -180,6 +197,17 @@ private:
 	TArray<FBox2D> ExogeneReDrawBox;
 	uint8 BPUpdateCounter = 0;
 
+	/**
+	* Footprints of the brushes of both layer stacks. Kept up to date by the redraw checks of Tick,
+	* rebuilt whenever the stacks change.
+	*/
+	FSWBrushSpatialIndex BrushIndex;
+	bool bBrushIndexDirty = true;
+	int32 IndexedBrushCount = INDEX_NONE;
+
+	int32 CountStackBrushes() const;
+	void RebuildBrushIndexIfNeeded();
+
 public:
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
@@ -0,0 +1,91 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Actor/ShaderWorldBrush.h"
+#include "ShaderWorldShapeBrush.generated.h"
+
+/**
+ * Analytic brush: a shape fading out toward its border, blended into the terrain height.
+ * No material involved: consecutive shape brushes of a stack are evaluated by a single compute dispatch,
+ * and the brush has a CPU mirror for collision and height queries.
+ * The shape covers the XY extent of BoxBound and follows its yaw.
+ */
+UCLASS(hideCategories(Collision, Input, Actor, Game, LOD, Replication, Cooking))
+class SHADERWORLD_API AShaderWorldShapeBrush : public AShaderWorldBrush
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Shape")
+		ESWBrushShape Shape = ESWBrushShape::Circle;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Shape")
+		ESWBrushFalloff Falloff = ESWBrushFalloff::Smooth;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Shape")
+		ESWBrushBlendOp BlendOp = ESWBrushBlendOp::Add;
+
+	/**
+	* Add: height offset in cm. Set/Max/Min: target height, relative to the brush location.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Shape")
+		float Height = 1000.f;
+
+	/**
+	* Part of the shape, from its border, over which the brush fades out
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Shape", meta = (UIMin = 0.f, UIMax = 1.f, ClampMin = 0.f, ClampMax = 1.f))
+		float FalloffWidth = 0.5f;
+
+	/**
+	* Height curve: the falloff weight is raised to this power
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Shape", meta = (UIMin = 0.1f, UIMax = 8.f, ClampMin = 0.01f, ClampMax = 64.f))
+		float HeightCurveExponent = 1.f;
+
+	virtual bool IsValidBrush() override;
+	virtual bool NeedRedraw(bool LayerEnabled, bool BrushEnabled, float LayerInfluence, float BrushInfluence, bool IncludeBP) override;
+	virtual void ApplyBrushAt(UTextureRenderTarget2D* Destination_RT, UTextureRenderTarget2D* Source_RT, float LayerInfluence, float BrushInfluence, FVector RingLocation, int32 GridScaling, int N, bool CollisionMesh, bool IsLayer, bool IsReadback = false, UTextureRenderTarget2D* Location_RT = nullptr) override;
+	virtual TSharedPtr<FSWCPUBrush, ESPMode::ThreadSafe> CreateCPUBrush() override;
+	virtual bool PrepareCompositeDraw(const FVector& Origin, float LayerInfluence, float BrushInfluence, FSWCompositeBrushParameters& OutParameters) override;
+
+protected:
+
+	/** Absolute world location of the brush */
+	FVector GetShapeLocation() const;
+	/** Influence is left to 1 */
+	FSWCompositeBrushParameters BuildParameters(const FVector& Origin) const;
+
+	/** Parameters relative to the brush location when last drawn */
+	FSWCompositeBrushParameters DrawnShape;
+	bool bShapeDrawn = false;
+};
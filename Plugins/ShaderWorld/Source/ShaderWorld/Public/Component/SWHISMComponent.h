@@ -95,7 +95,8 @@ public:
 
 	void DrawClusterTree(TArray<FClusterNode>& Nodes, int32 NodeIndice);
 	virtual bool SWNewAddInstances(int32 PoolIndex, TSharedPtr < FSWInstanceIndexesInHISM, ESPMode::ThreadSafe>& InstancesIndexes, TSharedPtr < FSWSpawnableTransforms, ESPMode::ThreadSafe>& InstancesTransforms, bool bWorldSpace = false);
-	virtual bool SWNewBatchUpdateCountInstanceData(int32 StartInstanceIndex, int32 NumInstances, TArray<FInstancedStaticMeshInstanceData>& NewInstancesTransforms, bool bWorldSpace = false, bool bMarkRenderStateDirty = false, bool bTeleport = false, int32 StartNewInstanceIndex = 0);
+	/** OutNumWritten: instances actually copied, changed ones plus the merged unchanged gaps */
+	virtual bool SWNewBatchUpdateCountInstanceData(int32 StartInstanceIndex, int32 NumInstances, TArray<FInstancedStaticMeshInstanceData>& NewInstancesTransforms, bool bWorldSpace = false, bool bMarkRenderStateDirty = false, bool bTeleport = false, int32 StartNewInstanceIndex = 0, int32* OutNumWritten = nullptr);
 	void SWNewUpdateTree();
 
 	static void BuildTreeAnyThread(TArray<FMatrix>& InstanceTransforms, TArray<float>& InstanceCustomDataFloats, int32 NumCustomDataFloats, const FBox& MeshBox, TArray<FClusterNode>& OutClusterTree, TArray<int32>& OutSortedInstances, TArray<int32>& OutInstanceReorderTable, int32& OutOcclusionLayerNum, int32 MaxInstancesPerLeaf, bool InGenerateInstanceScalingRange);
@@ -128,4 +129,22 @@ protected:
 
 	bool PendingClearInstances = false;
 	bool bKeepInstanceBufferCPUCopy = false;
+
+	/*
+	 * Incremental tree maintenance: spawnable cells recycle their instance slots in place,
+	 * the clusters holding rewritten slots are refit instead of rebuilding the whole tree.
+	 */
+	/** Instance ranges (Start, Num) rewritten since the last tree build was dispatched */
+	TArray<FIntPoint> SWDirtyInstanceRanges;
+	/** Instance order of the applied tree, invalid when the next build has to be a full one */
+	TSharedPtr < const TArray<int32>, ESPMode::ThreadSafe > SWTreeBuildOrder;
+	/** Summed bounds area of every node of the applied tree, and at its last full build, to detect a degraded tree */
+	double SWTreeBoundsArea = 0.0;
+	double SWTreeBaselineBoundsArea = 0.0;
+
+	/** Copies a run of modified instances, records it as dirty and updates the bodies of those instances */
+	void SWNewUpdateInstanceRange(int32 StartInstanceIndex, int32 NumInstances, const FInstancedStaticMeshInstanceData* SourceInstanceData, bool bTeleport);
+
+	/** Sends the instances rewritten by a refit to the current render proxy, false when the proxy has to be recreated instead */
+	bool SWUpdateProxyInstances(SW_HISM::FClusterBuilder& Builder);
 };
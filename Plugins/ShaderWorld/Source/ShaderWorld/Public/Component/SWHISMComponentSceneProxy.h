@@ -30,6 +30,17 @@ struct FFoliageOcclusionResults
 	}
 };
 
+/** Instances rewritten in place by a tree refit: the layout and instance count of the proxy remain valid */
+struct FSWHISMProxyInstanceUpdate
+{
+	/** Refitted tree, same layout as the proxy one */
+	TSharedPtr<TArray<FClusterNode>, ESPMode::ThreadSafe> ClusterTree;
+	/** Sorted render indices to update */
+	TArray<int32> RenderIndices;
+	TSharedPtr < TArray<FPrimitiveInstance, TInlineAllocator<1>>, ESPMode::ThreadSafe > InstanceSceneData;
+	TSharedPtr < TArray<float>, ESPMode::ThreadSafe > InstanceRandomID;
+};
+
 class SHADERWORLD_API SWHISMComponentSceneProxy final : public FInstancedStaticMeshSceneProxy
 {
 	TSharedRef<TArray<FClusterNode>, ESPMode::ThreadSafe> ClusterTreePtr;
@@ -92,6 +103,9 @@ public:
 
 	virtual void ApplyWorldOffset(FVector InOffset) override;
 
+	/** Copies the rewritten instances and the refitted cluster bounds, then requests a GPU Scene upload of this primitive only */
+	void UpdateRefittedInstances_RenderThread(const FSWHISMProxyInstanceUpdate& Update);
+
 	void FillDynamicMeshElements(FMeshElementCollector& Collector, const FFoliageElementParams& ElementParams, const FFoliageRenderInstanceParams& Instances) const;
 
 	template<bool TUseVector>
@@ -0,0 +1,153 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "Data/SWStructs.h"
+#include "Actor/ShaderWorldBrush.h"
+#include "SWHeightGenerator.generated.h"
+
+/**
+ * Immutable CPU snapshot of a terrain generator, safe to evaluate from any thread.
+ * Locations are absolute world locations, the ones the generator material receives.
+ */
+class SHADERWORLD_API FSWHeightEvaluator
+{
+public:
+	virtual ~FSWHeightEvaluator() = default;
+
+	/**
+	* Generator output alone, in world units
+	*/
+	virtual double EvaluateGenerator(const FVector2D& Location, uint16& MaterialIndice) const = 0;
+
+	/**
+	* Generator scaled by HeightScale then the brush stack: the same value the GPU writes into a heightmap texel
+	*/
+	double ComputeHeight(const FVector2D& Location, uint16& MaterialIndice) const;
+
+	/**
+	* Height in world units, divided by HeightScale like any heightmap readback
+	*/
+	double ComputeWorldHeight(const FVector2D& Location, uint16& MaterialIndice) const { return ComputeHeight(Location, MaterialIndice) / HeightScale; }
+
+	/**
+	* False when at least one active brush has no CPU mirror: results then differ from the GPU within that brush footprint
+	*/
+	bool MirrorsBrushStack() const { return bBrushStackComplete; }
+
+	/**
+	* Spawnable placement within the grid cell Cell, a jittered grid filtered by altitude and ground slope.
+	* Deterministic for a given cell and seed. Transforms are absolute world transforms, one array per variant.
+	*/
+	void ComputeSpawnableTransforms(const FSWCPUSpawnableSettings& Settings, const FIntPoint& Cell, TArray<TArray<FTransform>>& OutTransforms) const;
+
+	float HeightScale = 1.f;
+	bool bBrushStackComplete = true;
+	TArray<FSWCPUBrushStackElement> BrushStack;
+};
+
+/**
+ * CPU counterpart of the Generator material of a Shader World.
+ * When provided, collision tiles and height queries are evaluated on worker threads instead of requiring a GPU draw and readback.
+ */
+UCLASS(Abstract, BlueprintType, EditInlineNew, CollapseCategories, hidecategories = (Object))
+class SHADERWORLD_API USWHeightGenerator : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	* Game thread only: snapshot the generator settings and seeds into a thread safe evaluator
+	*/
+	virtual TSharedPtr<FSWHeightEvaluator, ESPMode::ThreadSafe> CreateEvaluator(const FSWBagOfSeeds& Seeds) const PURE_VIRTUAL(USWHeightGenerator::CreateEvaluator, return nullptr;);
+};
+
+USTRUCT(BlueprintType)
+struct SHADERWORLD_API FSWHeightMaterialBand
+{
+	GENERATED_BODY()
+
+	/**
+	* Band is used from this altitude (cm) up to the next band
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Default")
+		float AltitudeMin = 0.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Default", meta = (UIMin = 0, UIMax = 255, ClampMin = 0, ClampMax = 255))
+		int32 MaterialIndex = 0;
+};
+
+/**
+ * Fractal perlin noise (fBm), to be matched by the generator material it mirrors.
+ */
+UCLASS(BlueprintType, EditInlineNew, CollapseCategories, hidecategories = (Object), meta = (DisplayName = "Noise Height Generator"))
+class SHADERWORLD_API USWNoiseHeightGenerator : public USWHeightGenerator
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	* Name of a scalar seed from the seed generator offsetting the noise domain. Ignored if not found.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Noise")
+		FName SeedName = "Seed";
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Noise", meta = (UIMin = 1, UIMax = 16, ClampMin = 1, ClampMax = 16))
+		int32 Octaves = 6;
+	/**
+	* Frequency of the first octave, in cycles per meter
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Noise", meta = (ClampMin = 0.f))
+		float Frequency = 0.0005f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Noise", meta = (ClampMin = 1.f))
+		float Lacunarity = 2.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Noise", meta = (UIMin = 0.f, UIMax = 1.f, ClampMin = 0.f, ClampMax = 1.f))
+		float Persistence = 0.5f;
+	/**
+	* Amplitude of the first octave, in cm
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Noise")
+		float Amplitude = 50000.f;
+	/**
+	* Altitude (cm) added to the noise
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Noise")
+		float BaseAltitude = 0.f;
+	/**
+	* Material index (exported to collision as physical material ID) by altitude, same mapping as the generator alpha output
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bioms")
+		TArray<FSWHeightMaterialBand> MaterialBands;
+
+	virtual TSharedPtr<FSWHeightEvaluator, ESPMode::ThreadSafe> CreateEvaluator(const FSWBagOfSeeds& Seeds) const override;
+};
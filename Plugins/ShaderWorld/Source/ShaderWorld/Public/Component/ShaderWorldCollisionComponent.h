@@ -223,6 +223,18 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Procedural Mesh")
 	bool bUseAsyncCooking=true;
 
+	/**
+	*	Build Chaos heightfield geometry straight from the decoded samples instead of cooking a trimesh.
+	*	Only used once SetHeightfieldLayout described a grid matching the position buffer, trimesh cooking remains the fallback.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Procedural Mesh")
+	bool bUseHeightfieldCollision = false;
+
+	/** Describe the regular grid followed by the position buffers: NumX * NumY samples, X major, spaced by Spacing and centered on the component */
+	void SetHeightfieldLayout(int32 NumX, int32 NumY, float Spacing);
+
+	bool UsesHeightfieldCollision() const;
+
 	/** Collision data */
 	UPROPERTY(Instanced)
 		class UBodySetup* ProcMeshBodySetup;
@@ -377,6 +389,10 @@ private:
 	void UpdateCollision();
 	/** Once async physics cook is done, create needed state */
 	void FinishPhysicsAsyncCook(bool bSuccess, UBodySetup* FinishedBodySetup);
+	/** Move to DestinationOnNextPhysicCook if needed, once new collision geometry is ready */
+	void MoveToPhysicDestination();
+	/** Build the heightfield from the current samples and register the physics actor using it */
+	void CreateHeightfieldPhysicsState();
 
 	/** Update Navigation data */
 	void UpdateNavigation();
@@ -391,6 +407,7 @@ public:
 
 protected:
 		virtual void OnCreatePhysicsState() override;
+		virtual void OnDestroyPhysicsState() override;
 
 private:
 	/** Helper to create new body setup objects */
@@ -435,6 +452,13 @@ private:
 
 	TArray<TSharedPtr<FSWShareableVerticePositionBuffer, ESPMode::ThreadSafe>> UpdatesReceivedDuringCompute;
 
+	int32 HeightfieldNumX = 0;
+	int32 HeightfieldNumY = 0;
+	float HeightfieldSpacing = 0.f;
+
+	/** Per cell material of the current heightfield, used to resolve hit face indices */
+	TArray<uint8> HeightfieldCellMaterials;
+
 	friend class FShaderWProceduralMeshSceneProxy;
 	friend class FSWClipMapCollisionBuffersHolder;
 
@@ -0,0 +1,89 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Data/SWEnums.h"
+
+/**
+ * Parameter block of an analytic brush, as read by SWBrushStackCS (ShaderWorldUtilities.usf). Layout must match FSWCompositeBrush.
+ * Center is relative to the origin of the draw, heights are in heightmap units.
+ */
+struct FSWCompositeBrushParameters
+{
+	FVector2f Center = FVector2f::ZeroVector;
+	/** Half size of the shape */
+	FVector2f Extent = FVector2f::UnitVector;
+	/** Cos/Sin of the brush yaw */
+	FVector2f Axis = FVector2f(1.f, 0.f);
+	/** Offset for Add, target height for Set/Max/Min */
+	float Height = 0.f;
+	/** Part of the shape, from its border, over which the brush fades out */
+	float FalloffWidth = 0.5f;
+	float Exponent = 1.f;
+	/** Layer influence x Brush influence */
+	float Influence = 1.f;
+	uint32 Shape = 0;
+	/** ESWBrushFalloff | ESWBrushBlendOp << 8 */
+	uint32 FalloffAndBlend = 0;
+};
+static_assert(sizeof(FSWCompositeBrushParameters) == 48, "FSWCompositeBrushParameters is uploaded as is");
+
+/**
+ * Texel to location mapping of a brush stack dispatch: texel T covers ((T - Margin) / (Size - 1 - 2 * Margin) - 0.5) * PatchFullSize.
+ * Ring heightmaps have a one texel margin, collision heightmaps none.
+ */
+struct FSWBrushStackGridDesc
+{
+	int32 Size = 0;
+	int32 Margin = 0;
+	float PatchFullSize = 0.f;
+
+	FVector2f GetTexelLocation(int32 X, int32 Y) const
+	{
+		const float Denominator = FMath::Max(Size - 1 - 2 * Margin, 1);
+		return (FVector2f(X - Margin, Y - Margin) / Denominator - FVector2f(0.5f, 0.5f)) * PatchFullSize;
+	}
+};
+
+/**
+ * CPU reference of the brush stack compute shader, same math in the same precision.
+ */
+namespace SWBrushCompositor
+{
+	SHADERWORLD_API float EvaluateBrush(const FSWCompositeBrushParameters& Brush, const FVector2f& Location, float SourceHeight);
+
+	SHADERWORLD_API float EvaluateStack(TConstArrayView<FSWCompositeBrushParameters> Stack, const FVector2f& Location, float SourceHeight);
+
+	/**
+	 * Evaluates the stack over a Grid.Size x Grid.Size row major grid of heights, as a dispatch would.
+	 * Results are rounded like the RGBA8 height encoding.
+	 */
+	SHADERWORLD_API void ComposeGrid(TConstArrayView<FSWCompositeBrushParameters> Stack, const FSWBrushStackGridDesc& Grid, TConstArrayView<float> SourceHeights, TArrayView<float> OutHeights);
+}
@@ -0,0 +1,75 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AShaderWorldBrush;
+
+/*
+ * Hashed uniform grid over brush footprints.
+ * Moving a brush only touches the cells of its previous and new footprint. Footprints spanning too many cells are kept
+ * aside and tested on every query. Brushes are only used as keys, never dereferenced.
+ */
+class SHADERWORLD_API FSWBrushSpatialIndex
+{
+public:
+	explicit FSWBrushSpatialIndex(double InCellSize = 25600.0);
+
+	/** Inserts or moves a brush, no-op if its footprint did not change */
+	void Update(const AShaderWorldBrush* Brush, const FBox2D& FootPrint);
+	void Remove(const AShaderWorldBrush* Brush);
+	void Empty();
+
+	/** Brushes whose indexed footprint intersects Box */
+	void Query(const FBox2D& Box, TSet<const AShaderWorldBrush*>& OutBrushes) const;
+
+	int32 Num() const { return Entries.Num(); }
+
+	/** Past this, a footprint is not added to the cells it covers but kept aside */
+	static constexpr int32 MaxCellsPerEntry = 64;
+
+private:
+
+	struct FEntry
+	{
+		FBox2D FootPrint = FBox2D(ForceInit);
+		FIntRect Cells;
+		bool bOversized = false;
+	};
+
+	FIntRect GetCellRange(const FBox2D& Box) const;
+	void Link(const AShaderWorldBrush* Brush, const FEntry& Entry);
+	void Unlink(const AShaderWorldBrush* Brush, const FEntry& Entry);
+
+	double CellSize;
+	TMap<const AShaderWorldBrush*, FEntry> Entries;
+	TMap<FIntPoint, TArray<const AShaderWorldBrush*, TInlineAllocator<4>>> Cells;
+	TArray<const AShaderWorldBrush*> Oversized;
+};
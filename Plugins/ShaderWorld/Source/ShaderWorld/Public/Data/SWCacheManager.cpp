@@ -3,12 +3,12 @@
 
 bool FSWRingCacheManager::WithinBudget()
 {
-	return true;
+	return CanAllocateWithinMemoryBudget();
 }
 
 FSWTexture2DCacheManager::~FSWTexture2DCacheManager(){}
 
-bool FSWTexture2DCacheManager::WithinBudget() { return true; }
+bool FSWTexture2DCacheManager::WithinBudget() { return CanAllocateWithinMemoryBudget(); }
 
 /*
 void FSWTexture2DCacheManager::CleanUpElement(FCacheElem& Element) {}
@@ -16,6 +16,18 @@ public:
 		FIntVector Location = FIntVector(0, 0, 0);
 		int32 Data = -1;
 
+		/*
+		 * Position within UsedCacheElem, INDEX_NONE when available
+		 */
+		int32 UsedSlot = INDEX_NONE;
+
+		/*
+		 * Intrusive LRU links, from most (LRUHead) to least (LRUTail) recently used
+		 */
+		int32 LRUPrev = INDEX_NONE;
+		int32 LRUNext = INDEX_NONE;
+		uint32 LastUsedEpoch = 0;
+
 		bool operator ==(const FCacheElem& Rhs) const{
 			return ID == Rhs.ID;
 		}
@@ -29,8 +41,38 @@ public:
 	inline void ReleaseCacheElem(int ID);
 	inline void AssignDataElement(int ID, int DataID) { CacheElem[ID].Data = DataID;}
 
+	/*
+	 * Marks the element as used during the current epoch, moving it to the head of the LRU list
+	 */
+	inline void TouchCacheElem(int ID);
+
+	/*
+	 * Releases the least recently used element, unless it was touched during the current epoch.
+	 * Returns false if nothing could be evicted.
+	 */
+	inline bool EvictLeastRecentlyUsed();
+
+	/*
+	 * Frees the data of available elements, evicting cold used elements if needed, until AllocatedMemoryMB fits MemoryBudgetMB.
+	 * Freed data indices are queued in DataToFree for the owner to release. Returns the number of used elements evicted.
+	 */
+	inline int32 TrimToMemoryBudget();
+
 	virtual bool WithinBudget() = 0;
-	
+
+	/*
+	 * Memory held by elements with data: released elements keep their data for reuse until trimmed
+	 */
+	double AllocatedMemoryMB() const { return (CacheElem.Num() - DatalessCacheElem.Num()) * ElementMemoryMB; }
+
+	/*
+	 * True if a new element can be handed out without exceeding MemoryBudgetMB, either by reusing
+	 * an available element and its data or by allocating new data.
+	 */
+	bool CanAllocateWithinMemoryBudget() const
+	{
+		return MemoryBudgetMB <= 0.0 || AvailableCacheElem.Num() > 0 || AllocatedMemoryMB() + ElementMemoryMB <= MemoryBudgetMB;
+	}
 
 	inline virtual void CleanUp();
 
@@ -54,37 +96,177 @@ public:
 	TArray<FCacheElem> CacheElem;
 	TArray<int> AvailableCacheElem;
 	TArray<int> UsedCacheElem;
+	/*
+	 * Available elements whose data was freed, they get new data once reacquired
+	 */
+	TArray<int> DatalessCacheElem;
 
+	/*
+	 * Elements waiting for the owner to assign them data (AssignDataElement), consumed by the owner
+	 */
 	TArray<int32> UnInitializedDataElem;
+	/*
+	 * Data of trimmed elements, consumed by the owner which releases it
+	 */
+	TArray<int32> DataToFree;
+
+	int32 LRUHead = INDEX_NONE;
+	int32 LRUTail = INDEX_NONE;
+
+	/*
+	 * Incremented by the owner on each update. Elements touched during the current epoch are never evicted
+	 */
+	uint32 CurrentEpoch = 1;
+
+	/*
+	 * Hard memory budget, 0 for unlimited. Once reached, cold elements are evicted instead of allocating new ones
+	 */
+	double MemoryBudgetMB = 0.0;
+	double ElementMemoryMB = 0.0;
+
+private:
+
+	inline void LRULinkFront(int ID);
+	inline void LRUUnlink(int ID);
 };
 
+void FSWCacheManager::LRULinkFront(int ID)
+{
+	FCacheElem& Elem = CacheElem[ID];
+	Elem.LRUPrev = INDEX_NONE;
+	Elem.LRUNext = LRUHead;
+
+	if (LRUHead != INDEX_NONE)
+		CacheElem[LRUHead].LRUPrev = ID;
+	else
+		LRUTail = ID;
+
+	LRUHead = ID;
+}
+
+void FSWCacheManager::LRUUnlink(int ID)
+{
+	FCacheElem& Elem = CacheElem[ID];
+
+	if (Elem.LRUPrev != INDEX_NONE)
+		CacheElem[Elem.LRUPrev].LRUNext = Elem.LRUNext;
+	else if (LRUHead == ID)
+		LRUHead = Elem.LRUNext;
+
+	if (Elem.LRUNext != INDEX_NONE)
+		CacheElem[Elem.LRUNext].LRUPrev = Elem.LRUPrev;
+	else if (LRUTail == ID)
+		LRUTail = Elem.LRUPrev;
+
+	Elem.LRUPrev = INDEX_NONE;
+	Elem.LRUNext = INDEX_NONE;
+}
+
 typename FSWCacheManager::FCacheElem& FSWCacheManager::GetACacheElem()
 {
+	int32 ID = INDEX_NONE;
+
 	if (AvailableCacheElem.Num() > 0)
 	{
-		FCacheElem& Elem = CacheElem[AvailableCacheElem[AvailableCacheElem.Num() - 1]];
-		UsedCacheElem.Add(Elem.ID);
-		AvailableCacheElem.RemoveAt(AvailableCacheElem.Num() - 1);
-		return Elem;
+		ID = AvailableCacheElem.Pop(false);
 	}
+	else if (DatalessCacheElem.Num() > 0)
+	{
+		ID = DatalessCacheElem.Pop(false);
 
-	FCacheElem& NewElem = CacheElem.AddDefaulted_GetRef();
-	NewElem.ID = CacheElem.Num() - 1;
+		UnInitializedDataElem.Add(ID);
+	}
+	else
+	{
+		FCacheElem& NewElem = CacheElem.AddDefaulted_GetRef();
+		NewElem.ID = CacheElem.Num() - 1;
+		ID = NewElem.ID;
 
-	UnInitializedDataElem.Add(NewElem.ID);
+		UnInitializedDataElem.Add(NewElem.ID);
+	}
 
-	UsedCacheElem.Add(NewElem.ID);
+	FCacheElem& Elem = CacheElem[ID];
+	Elem.UsedSlot = UsedCacheElem.Add(ID);
+	Elem.LastUsedEpoch = CurrentEpoch;
+	LRULinkFront(ID);
 
-	return NewElem;
+	return Elem;
 }
 
 void FSWCacheManager::ReleaseCacheElem(int ID)
 {
 	check(ID < CacheElem.Num())
 
+	FCacheElem& Elem = CacheElem[ID];
+
+	if (Elem.UsedSlot == INDEX_NONE)
+		return;
+
+	const int32 Slot = Elem.UsedSlot;
+	UsedCacheElem.RemoveAtSwap(Slot, 1, false);
+	if (Slot < UsedCacheElem.Num())
+		CacheElem[UsedCacheElem[Slot]].UsedSlot = Slot;
+
+	Elem.UsedSlot = INDEX_NONE;
+	LRUUnlink(ID);
+
 	AvailableCacheElem.Add(ID);
-	UsedCacheElem.Remove(ID);
-	CacheLayout.Remove(CacheElem[ID].Location);
+
+	if (const int32* LayoutID = CacheLayout.Find(Elem.Location); LayoutID && *LayoutID == ID)
+		CacheLayout.Remove(Elem.Location);
+}
+
+void FSWCacheManager::TouchCacheElem(int ID)
+{
+	FCacheElem& Elem = CacheElem[ID];
+	Elem.LastUsedEpoch = CurrentEpoch;
+
+	if (LRUHead == ID)
+		return;
+
+	LRUUnlink(ID);
+	LRULinkFront(ID);
+}
+
+bool FSWCacheManager::EvictLeastRecentlyUsed()
+{
+	if (LRUTail == INDEX_NONE || CacheElem[LRUTail].LastUsedEpoch == CurrentEpoch)
+		return false;
+
+	ReleaseCacheElem(LRUTail);
+	return true;
+}
+
+int32 FSWCacheManager::TrimToMemoryBudget()
+{
+	int32 NumEvicted = 0;
+
+	if (MemoryBudgetMB <= 0.0)
+		return NumEvicted;
+
+	while (AllocatedMemoryMB() > MemoryBudgetMB)
+	{
+		if (AvailableCacheElem.Num() <= 0)
+		{
+			if (!EvictLeastRecentlyUsed())
+				break;
+
+			NumEvicted++;
+		}
+
+		const int32 ID = AvailableCacheElem.Pop(false);
+		FCacheElem& Elem = CacheElem[ID];
+
+		if (Elem.Data >= 0)
+			DataToFree.Add(Elem.Data);
+		else
+			UnInitializedDataElem.RemoveSwap(ID, false);
+
+		Elem.Data = -1;
+		DatalessCacheElem.Add(ID);
+	}
+
+	return NumEvicted;
 }
 
 void FSWCacheManager::CleanUp()
@@ -94,7 +276,12 @@ void FSWCacheManager::CleanUp()
 	CacheElem.Empty();
 	AvailableCacheElem.Empty();
 	UsedCacheElem.Empty();
+	DatalessCacheElem.Empty();
+	DataToFree.Empty();
 	CacheLayout.Empty();
+
+	LRUHead = INDEX_NONE;
+	LRUTail = INDEX_NONE;
 }
 
 /*
@@ -108,91 +295,156 @@ struct FSWRingCacheManager : public FSWCacheManager
 		, RingCount(InRingCount)
 	{}
 
+	/*
+	 * Default ring radius, used for reference points given without an explicit radius.
+	 * FSWTexture2DCacheGroup only gives such points, so all its viewers share this radius.
+	 */
 	int32 RingCount = 0;
 
+	/*
+	 * Thrashing counters: a hit is a desired cell already cached, a miss a cell that had to be (re)generated
+	 */
+	struct FRingCacheStats
+	{
+		uint64 Hits = 0;
+		uint64 Misses = 0;
+		uint64 Evictions = 0;
+	};
+
+	FRingCacheStats Stats;
+
+	void ResetStats() { Stats = FRingCacheStats(); }
+
 	virtual bool WithinBudget() override;
 
+	/*
+	 * Chebyshev distance, in cells, to the closest reference point relative to its ring radius.
+	 * Negative or zero when Location lies within at least one ring.
+	 */
+	static int32 DistanceToClosestRing(const FIntVector& Location, const TMap<FIntVector, int32>& ReferencePoints)
+	{
+		int32 Closest = MAX_int32;
+		for (const auto& Pt : ReferencePoints)
+		{
+			const FIntVector Delta = Location - Pt.Key;
+			const int32 Distance = FMath::Max3(FMath::Abs(Delta.X), FMath::Abs(Delta.Y), FMath::Abs(Delta.Z)) - Pt.Value;
+			Closest = FMath::Min(Closest, Distance);
+		}
+		return Closest;
+	}
+
 	void ReleaseBeyondRange(TSet< FIntVector >& ReferencePoints)
+	{
+		TMap<FIntVector, int32> RingPerPoint;
+		RingPerPoint.Reserve(ReferencePoints.Num());
+		for (const auto& Pt : ReferencePoints)
+			RingPerPoint.Add(Pt, RingCount);
+
+		ReleaseBeyondRange(RingPerPoint);
+	}
+
+	/*
+	 * Releases every element outside the rings of all reference points. ReferencePoints maps a point to its ring radius.
+	 * Released elements keep their data for reuse, then with a memory budget the data is trimmed down to the budget.
+	 */
+	void ReleaseBeyondRange(const TMap< FIntVector, int32 >& ReferencePoints)
 	{
 		if (ReferencePoints.Num() <= 0)
 			return;
 
-		FIntVector RefPoint(0);
-		for(const auto& Pt : ReferencePoints)
-		{
-			RefPoint = Pt;
-			break;
-		}
-
 		for (int i = this->UsedCacheElem.Num() - 1; i >= 0; --i)
 		{
 			FCacheElem& El = this->CacheElem[this->UsedCacheElem[i]];
 
-			FVector ToCacheElement = FVector(El.Location - RefPoint);
-
-			if (FMath::Abs(ToCacheElement.X) > (RingCount + 0.1f) ||
-				FMath::Abs(ToCacheElement.Y) > (RingCount + 0.1f) ||
-				FMath::Abs(ToCacheElement.Z) > (RingCount + 0.1f) )
+			if (DistanceToClosestRing(El.Location, ReferencePoints) > 0)
 			{
 				this->ReleaseCacheElem(El.ID);
+				Stats.Evictions++;
 			}
 		}
+
+		Stats.Evictions += TrimToMemoryBudget();
 	}
 
 	TArray<int32> CollectWork(TSet< FIntVector >& ReferencePoints)
+	{
+		TMap<FIntVector, int32> RingPerPoint;
+		RingPerPoint.Reserve(ReferencePoints.Num());
+		for (const auto& Pt : ReferencePoints)
+			RingPerPoint.Add(Pt, RingCount);
+
+		return CollectWork(RingPerPoint);
+	}
+
+	/*
+	 * Merges the rings of all reference points into a single desired set, and allocates the missing cells
+	 * closest to a viewer first, until the budget is exhausted.
+	 */
+	TArray<int32> CollectWork(const TMap< FIntVector, int32 >& ReferencePoints)
 	{
 		TArray<int32> Work;
 
-		if (ReferencePoints.Num() > 0)
-		{
-			FIntVector RefPoint(0);
-			for (const auto& Pt : ReferencePoints)
-			{
-				RefPoint = Pt;
-				break;
-			}
+		if (ReferencePoints.Num() <= 0)
+			return MoveTemp(Work);
 
-			bool InterruptUpdate = false;
+		CurrentEpoch++;
 
-			for (int r = 0; r <= RingCount; r++)
-			{
-				if (InterruptUpdate)
-					break;
+		/*
+		 * Missing cell -> distance in rings to the closest viewer
+		 */
+		TMap<FIntVector, int32> Missing;
+
+		for (const auto& Pt : ReferencePoints)
+		{
+			const FIntVector& RefPoint = Pt.Key;
+			const int32 Ring = Pt.Value;
 
-				for (int i = -r; i <= r; i++)
+			for (int i = -Ring; i <= Ring; i++)
+			{
+				for (int j = -Ring; j <= Ring; j++)
 				{
-					if (InterruptUpdate)
-						break;
+					const FIntVector CacheLocation = RefPoint + FIntVector(i, j, 0);
+					const int32 Distance = FMath::Max(FMath::Abs(i), FMath::Abs(j));
 
-					for (int j = -r; j <= r; j++)
+					if (const int32* CachedID = CacheLayout.Find(CacheLocation))
 					{
-						if (abs(j) != r && abs(i) != r)
-							continue;
-
-						FIntVector CacheLocation = RefPoint + FIntVector(i, j, 0);
-
-						if (!CacheLayout.Contains(CacheLocation))
-						{							
-							if (WithinBudget())
-							{
-								FSWCacheManager::FCacheElem& Elem = GetACacheElem();
-
-								Elem.Location = CacheLocation;
-
-								Work.Add(Elem.ID);
-								CacheLayout.Add(CacheLocation, Elem.ID);
-							}
-							else
-							{
-								InterruptUpdate = true;
-								break;
-							}							
+						if (CacheElem[*CachedID].LastUsedEpoch != CurrentEpoch)
+						{
+							TouchCacheElem(*CachedID);
+							Stats.Hits++;
 						}
+						continue;
 					}
+
+					if (int32* Known = Missing.Find(CacheLocation))
+						*Known = FMath::Min(*Known, Distance);
+					else
+						Missing.Add(CacheLocation, Distance);
 				}
 			}
 		}
 
+		Missing.ValueStableSort([](const int32& A, const int32& B) { return A < B; });
+
+		for (const auto& Cell : Missing)
+		{
+			if (!WithinBudget())
+			{
+				if (!EvictLeastRecentlyUsed())
+					break;
+
+				Stats.Evictions++;
+			}
+
+			FSWCacheManager::FCacheElem& Elem = GetACacheElem();
+
+			Elem.Location = Cell.Key;
+
+			Work.Add(Elem.ID);
+			CacheLayout.Add(Cell.Key, Elem.ID);
+			Stats.Misses++;
+		}
+
 		return MoveTemp(Work);
 	}
 };
@@ -216,7 +468,9 @@ struct FSWTexture2DCacheManager : public FSWRingCacheManager
 {
 	FSWTexture2DCacheManager(int32 RingCount, int32 Dimensions, TEnumAsByte<enum TextureFilter> LayerFiltering, TEnumAsByte<ETextureRenderTargetFormat> Format)
 		:FSWRingCacheManager(RingCount)
-	{}
+	{
+		ElementMemoryMB = 4.0 * Dimensions * Dimensions / 1000000.0;
+	}
 
 	
 	virtual ~FSWTexture2DCacheManager() override;
@@ -0,0 +1,89 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FSWShareableIndexBuffer;
+class FSWShareableVerticePositionBuffer;
+
+/*
+ * Welded NumX x NumY grid centered on the origin: vertices, UVs and triangles.
+ * Immutable once built, shared by every mesh of the same shape.
+ */
+class SHADERWORLD_API FSWGridTopology
+{
+public:
+	int32 NumX = 0;
+	int32 NumY = 0;
+	float Spacing = 0.f;
+
+	TSharedPtr<FSWShareableVerticePositionBuffer, ESPMode::ThreadSafe> Vertices;
+	/** Triangles_CollisionOnly is filled as well */
+	TSharedPtr<FSWShareableIndexBuffer, ESPMode::ThreadSafe> Triangles;
+	TArray<FVector2f> UVs;
+
+	/** Presized arrays, vertex rows and triangle rows are filled in parallel */
+	void Build(int32 InNumX, int32 InNumY, float InSpacing);
+};
+
+/*
+ * Process wide cache of grid topologies and clipmap section index buffers.
+ * Entries are weak: a topology lives as long as one mesh references it, and is shared with every other mesh of the same shape meanwhile.
+ * Game thread only.
+ */
+class SHADERWORLD_API FSWGridTopologyCache
+{
+public:
+	static FSWGridTopologyCache& Get();
+
+	/** Collision grids */
+	TSharedRef<const FSWGridTopology, ESPMode::ThreadSafe> FindOrCreateGrid(int32 NumX, int32 NumY, float Spacing);
+
+	/**
+	 * Clipmap sections: indices only depend on the vertex count N and the alternate (diamond) topology, not on the LOD grid spacing.
+	 * Returns false if the section has to be built, then registered with AddClipMapSection.
+	 */
+	bool FindClipMapSection(int32 N, int32 Section, bool bAlternateTopology, TSharedPtr<FSWShareableIndexBuffer>& OutTriangles, TSharedPtr<FSWShareableIndexBuffer>& OutTrianglesAlt);
+	void AddClipMapSection(int32 N, int32 Section, bool bAlternateTopology, const TSharedPtr<FSWShareableIndexBuffer>& Triangles, const TSharedPtr<FSWShareableIndexBuffer>& TrianglesAlt);
+
+private:
+
+	struct FClipMapSectionIndices
+	{
+		TWeakPtr<FSWShareableIndexBuffer, ESPMode::ThreadSafe> Triangles;
+		TWeakPtr<FSWShareableIndexBuffer, ESPMode::ThreadSafe> TrianglesAlt;
+	};
+
+	/** Drops entries no mesh references anymore */
+	void Prune();
+
+	TMap<FIntVector, TWeakPtr<const FSWGridTopology, ESPMode::ThreadSafe>> Grids;
+	TMap<FIntVector, FClipMapSectionIndices> ClipMapSections;
+};
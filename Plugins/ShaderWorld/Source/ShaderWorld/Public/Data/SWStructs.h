@@ -40,6 +40,8 @@
 #include "HAL/ThreadSafeBool.h"
 
 #include "SWCacheManager.h"
+#include "Data/SWBrushCompositor.h"
+#include "Utilities/SWTaskGraph.h"
 
 #include "StructView.h"
 #include "InstancedStruct.h"
@@ -57,7 +59,19 @@ class UFoliageType;
 
 struct FSWQuadElement
 {
-	uint64 QuadID;
+	uint64 QuadID = 0;
+};
+
+/*
+ * Result of an asynchronous LOD selection over AShaderWorldActor::BoundedWorldTree, as node indices of the tree
+ */
+struct FSWBoundedWorldVisit
+{
+	uint64 TreeID = 0;
+	uint32 TreeRevision = 0;
+	TArray<int32> ToSubdivide;
+	TArray<int32> ToCollapse;
+	FThreadSafeBool Completed = false;
 };
 
 USTRUCT()
@@ -104,10 +118,23 @@ struct FSWTexture2DCacheGroup
 	UPROPERTY(Transient)
 		double CamerasUpdateTime = -0.5;
 
+	/*
+	 * Hard memory budget of the group, 0 for unlimited
+	 */
+	UPROPERTY()
+		float MemoryBudgetMB = 0.f;
+
 	FSWRingCacheManager CacheManager = {1};
 
+	/*
+	 * Texture indices, shared by every cache of the group, whose render targets were freed by the memory budget
+	 */
+	TArray<int32> FreeTextureSlots;
+
 	void UpdateReferencePoints(UWorld* World, double& CurrentTime, TArray<FVector>& ReferenceSources);
+	void UpdateManagerBudget();
 	void ReleaseOutOfRange();
+	void FreeTrimmedTextures();
 	void GenerateWithinRange(UWorld* World);
 
 	void DrawDebugPartition(UWorld* World);
@@ -293,6 +320,24 @@ struct FClipMapMeshElement
 	uint8 NeedComponentLocationUpdate = 0;
 	FIntVector LocationLastMove;
 
+	/**
+	* Location the HeightMap, NormalMap and LandLayers content was generated for.
+	* While valid, a move scrolls the caches and only generates the newly exposed texels.
+	*/
+	FIntVector CacheLocation = FIntVector(0, 0, 0);
+	bool bCacheLocationValid = false;
+
+	/**
+	* Update scheduling: time and brush driven refreshes wait since StaleSince (0 when up to date) for their turn,
+	* granted by priority within the frame update budget.
+	*/
+	double StaleSince = 0.0;
+	float UpdatePriority = 0.f;
+	bool bPendingBrushRefresh = false;
+	bool bRefreshGranted = false;
+	/** Not drawn: above its altitude range or outside of the bounded world. Its staleness clock is held */
+	bool bHidden = false;
+
 	bool IsSectionVisible(int SectionID, bool ToSegmentedCacheIfEnabled = false);
 	void SetSectionVisible(int SectionID, bool NewVisibility, bool ToSegmentedCacheIfEnabled = false);
 };
@@ -408,6 +453,7 @@ public:
 class FSWShareableVerticePositionBuffer
 {
 public:
+	//Can be left empty for collision tiles, see sw.Collision.DoublePrecisionPositions. Positions3f is always filled
 	TArray<FVector> Positions;
 	//Dirty but prevent further loops of copying over
 	TArray<FVector3f> Positions3f;
@@ -478,6 +524,19 @@ class FSWColorRead
 	TArray<FColor> ReadData;
 };
 
+/*
+ * Height samples kept as R32F heights and R8 material indices rather than packed in a FSWColorRead
+ */
+class FSWHeightMaterialRead
+{
+	public:
+		FSWHeightMaterialRead(){};
+		~FSWHeightMaterialRead() {};
+
+	TArray<float> Heights;
+	TArray<uint8> MaterialIndices;
+};
+
 class FSWShareableIndexes
 {
 public:
@@ -536,6 +595,7 @@ public:
 		CollisionMeshData.Empty();
 		AvailableCollisionMesh.Empty();
 		UsedCollisionMesh.Empty();
+		UsedCollisionMeshSlot.Empty();
 		CollisionReadToProcess.Empty();
 		GroundCollisionLayout.Empty();
 		MultipleCamera.Empty();
@@ -552,13 +612,62 @@ public:
 
 	TArray<int32> AvailableCollisionMesh;
 	TArray<int32> UsedCollisionMesh;
+	/**
+	* Position of each collision mesh ID within UsedCollisionMesh, INDEX_NONE when the mesh is not in use
+	*/
+	TArray<int32> UsedCollisionMeshSlot;
 	TArray<int32> CollisionReadToProcess;
 	TMap<FIntVector, int32> GroundCollisionLayout;
 
 	TMap<FIntVector, FVector> MultipleCamera;
 	TMap<FIntVector, FVector> LocRefs;
 
-	void ReleaseCollisionMesh(int32 ID){ AvailableCollisionMesh.Add(ID); }
+	/**
+	* Pops a mesh ID from the available free-list, INDEX_NONE if the pool is exhausted
+	*/
+	inline int32 AcquireCollisionMesh()
+	{
+		if (AvailableCollisionMesh.Num() <= 0)
+			return INDEX_NONE;
+
+		const int32 ID = AvailableCollisionMesh.Pop(false);
+		AddUsedCollisionMesh(ID);
+		return ID;
+	}
+
+	inline void AddUsedCollisionMesh(int32 ID)
+	{
+		if (UsedCollisionMeshSlot.Num() <= ID)
+		{
+			const int32 PreviousNum = UsedCollisionMeshSlot.Num();
+			UsedCollisionMeshSlot.SetNumUninitialized(ID + 1);
+			for (int32 Index = PreviousNum; Index <= ID; Index++)
+				UsedCollisionMeshSlot[Index] = INDEX_NONE;
+		}
+
+		if (UsedCollisionMeshSlot[ID] != INDEX_NONE)
+			return;
+
+		UsedCollisionMeshSlot[ID] = UsedCollisionMesh.Add(ID);
+	}
+
+	/**
+	* Swap-removes the mesh from the dense used array and pushes it back on the free-list
+	*/
+	inline void ReleaseCollisionMesh(int32 ID)
+	{
+		const int32 Slot = UsedCollisionMeshSlot.IsValidIndex(ID) ? UsedCollisionMeshSlot[ID] : INDEX_NONE;
+		if (Slot == INDEX_NONE)
+			return;
+
+		const int32 LastID = UsedCollisionMesh.Last();
+		UsedCollisionMesh.RemoveAtSwap(Slot, 1, false);
+		if (LastID != ID)
+			UsedCollisionMeshSlot[LastID] = Slot;
+
+		UsedCollisionMeshSlot[ID] = INDEX_NONE;
+		AvailableCollisionMesh.Add(ID);
+	}
 
 
 	//
@@ -609,8 +718,27 @@ struct FCollisionMeshElement
 	* Stores the read back data computed from the AShaderWorldActor::CollisionMat_HeightRead applied to CollisionRT
 	*/
 	TSharedPtr<FSWColorRead, ESPMode::ThreadSafe> HeightData;
+	/**
+	* Float height data, written by CPU height evaluation. Used instead of HeightData when bFloatHeightData is set
+	*/
+	TSharedPtr<FSWHeightMaterialRead, ESPMode::ThreadSafe> HeightData32;
+
+	bool bFloatHeightData = false;
+	/**
+	* Tile disk cache key of the last update, 0 when the cache is not used. bFromDiskCache if HeightData32 is being loaded from it
+	*/
+	uint64 DiskCacheKey = 0;
+	bool bFromDiskCache = false;
 
 	TSharedPtr < FThreadSafeBool, ESPMode::ThreadSafe> ReadBackCompletion;
+	/**
+	* Valid while the heights are produced by a FSWTaskGraph job (CPU evaluation, disk cache load), invalid for GPU read backs
+	*/
+	FSWTaskHandle ReadBackTask;
+	/**
+	* Cancelled when the tile is relocated or the collisions rebuilt: pending jobs of its previous update are skipped
+	*/
+	FSWTaskCancellationPtr Cancellation;
 
 	inline bool operator==(const FCollisionMeshElement& Other) const
 	{
@@ -1173,6 +1301,8 @@ struct FSpawnableMesh
 		TArray<int> SpawnablesElemReadToProcess;
 
 	TSharedPtr <FSWShareableIndexesCompletion, ESPMode::ThreadSafe> ProcessedRead;
+	/** Cancelled by CleanUp: a decode still queued for the previous setup is skipped */
+	FSWTaskCancellationPtr DecodeCancellation;
 
 	struct FSpawnableProcessingWork
 	{
@@ -1194,11 +1324,20 @@ struct FSpawnableMesh
 		TSharedPtr <FSWShareableIndexes, ESPMode::ThreadSafe> InstanceIndexToIndexForHIM;
 
 		TSharedPtr<FSWShareableVerticePositionBuffer, ESPMode::ThreadSafe> DestB;
+
+		/** Approximate screen coverage of the cell, work is sent to the HISM highest first */
+		double FinalizePriority = 0.0;
+
 		inline FSpawnableProcessingWork() {}
 	};
 
 	TArray<FSpawnableProcessingWork> SpawnableWorkQueue;
 
+	/** Smoothed game thread seconds per instance written to the HISM, 0 until measured */
+	double FinalizeSecondsPerInstance = 0.0;
+	/** Instances per segmented HISM update. Fixed while a work queue is sent: segmented updates resume from it */
+	int32 FinalizeBatchSize = 0;
+
 	/** Allows skipping processing, if another one is already in progress */
 	//TAtomic<bool> bProcessingSpawnablesData;
 
@@ -1348,6 +1487,63 @@ struct FSWBiom
 		TArray<int> SortedSpawnables_Collision;
 			
 };
+
+/**
+* CPU placement settings of a spawnable, snapshot of a FSpawnableMesh safe to use from any thread
+*/
+struct FSWCPUSpawnableSettings
+{
+	/** Side of a placement grid cell, in cm */
+	double GridSize = 15000.0;
+	/** Candidates per grid cell, laid out on a jittered square grid */
+	int32 InstanceCount = 0;
+	int32 NumVariants = 1;
+	uint32 Seed = 0;
+	/** Altitude of the terrain zero, collision tiles are offset by the same amount */
+	double GroundAltitude = 0.0;
+	FFloatInterval AltitudeRange = FFloatInterval(-10000000.f, 10000000.f);
+	FFloatInterval GroundSlopeAngle = FFloatInterval(0.f, 45.f);
+	FFloatInterval ScaleRange = FFloatInterval(.75f, 1.25f);
+	FFloatInterval VerticalOffsetRange = FFloatInterval(0.f, 0.f);
+	bool bAlignToTerrainSlope = false;
+	float YawOffsetAlignToTerrainSlope = 0.f;
+	float AlignMaxAngle = 90.f;
+};
+
+/**
+* Spawnable transforms of a set of grid cells, computed on worker threads
+*/
+class FSWHeadlessSpawnableBatch
+{
+public:
+	TArray<FIntPoint> Cells;
+	/** Per cell, per variant */
+	TArray<TArray<TArray<FTransform>>> Transforms;
+	FThreadSafeBool bCompleted = false;
+	int32 NextCellToApply = 0;
+};
+
+/**
+* Headless processes: spawnable with collisions, placed on CPU around every player.
+* Components only hold the instances of the placed cells: new cells are appended, releasing a cell rebuilds the components.
+*/
+USTRUCT()
+struct FSWHeadlessSpawnable
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Transient)
+		TArray<USWHISMComponent*> Components;
+
+	FSWCPUSpawnableSettings Settings;
+
+	/** Absolute transforms of each placed cell, per variant */
+	TMap<FIntPoint, TArray<TArray<FTransform>>> CellTransforms;
+	bool bRebuildInstances = false;
+
+	TSharedPtr<FSWHeadlessSpawnableBatch, ESPMode::ThreadSafe> Batch;
+};
+
 class SHADERWORLD_API SWStructs
 {
 public:
@@ -1385,6 +1581,8 @@ struct SWCopyData
 	FVector2D DestWSLocation;
 	float DestWorldSize;
 
+	/** Texel of A read by texel (0,0) of B, used to scroll a cache by a whole number of texels */
+	FIntPoint ScrollOffset = FIntPoint::ZeroValue;
 	
 	SWCopyData(UTextureRenderTarget2D* A_, UTextureRenderTarget2D* B_, UTextureRenderTarget2D* BDup, int32 Border_, uint32 Channel_, FVector2D SL, FVector2D DL,float SDim,float DDim )
 	: A(A_)
@@ -1409,6 +1607,8 @@ struct SWNormalComputeData
 	uint32 N = 15;
 	float LocalGridScaling = 1.f;
 	float SWHeightmapScale = 1.f;
+	/** Texels of B to compute, an empty rect computes the whole normal map */
+	FIntRect Rect;
 
 	SWNormalComputeData(UTextureRenderTarget2D* A_, UTextureRenderTarget2D* B_, uint32 N_,float LocalGridScaling_, float SWHeightmapScale_) :A(A_), B(B_), N(N_), LocalGridScaling(LocalGridScaling_), SWHeightmapScale(SWHeightmapScale_){};
 
@@ -1416,6 +1616,25 @@ struct SWNormalComputeData
 	~SWNormalComputeData() {};
 };
 
+struct SWBrushStackComputeData
+{
+	UTextureRenderTarget2D* Source = nullptr;
+	UTextureRenderTarget2D* Destination = nullptr;
+	/** Readback draws: absolute world location of each texel, Grid is then ignored */
+	UTextureRenderTarget2D* Locations = nullptr;
+	FVector2f Origin = FVector2f::ZeroVector;
+
+	FSWBrushStackGridDesc Grid;
+	TArray<FSWCompositeBrushParameters> Brushes;
+
+	static constexpr int32 MaxRects = 4;
+	/** Texels the brushes are evaluated in, the others are copied from Source. Empty evaluates the whole target */
+	TArray<FIntRect, TInlineAllocator<MaxRects>> Rects;
+
+	SWBrushStackComputeData() {};
+	~SWBrushStackComputeData() {};
+};
+
 struct SWSampleRequestComputeData
 {
 	UTextureRenderTarget2D* SamplesXY = nullptr;
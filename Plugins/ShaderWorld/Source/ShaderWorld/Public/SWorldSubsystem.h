@@ -42,6 +42,18 @@ class UTextureRenderTarget2D;
 class FSWShareableSamplePoints;
 class USW_CollisionComponent;
 class FSWSpawnableRequirements;
+class UMaterialInterface;
+class UMaterialInstanceDynamic;
+
+USTRUCT()
+struct FSWMaterialInstancePool
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Transient)
+		TArray<UMaterialInstanceDynamic*> Free;
+};
+
 /**
  * 
  */
@@ -81,11 +93,47 @@ public:
 	//Shader helper
 	bool CopyAtoB(UTextureRenderTarget2D* A, UTextureRenderTarget2D* B, UTextureRenderTarget2D* B_dup=nullptr, int32 Border=0, uint32 Channel=0, FVector2D SL = FVector2D(), FVector2D DL= FVector2D(), float SDim = 0.f, float DDim = 0.f);
 	bool ComputeSpawnables(TSharedPtr<FSWSpawnableRequirements, ESPMode::ThreadSafe>& SpawnConfig);
-	bool ComputeNormalForHeightmap(UTextureRenderTarget2D* HeightM, UTextureRenderTarget2D* NormalM, int32& N, int32& LGC, float& HeightScale);
+	/** Texel (x,y) of B receives texel (x,y) + Offset of A */
+	bool ScrollAtoB(UTextureRenderTarget2D* A, UTextureRenderTarget2D* B, const FIntPoint& Offset);
+	bool ComputeNormalForHeightmap(UTextureRenderTarget2D* HeightM, UTextureRenderTarget2D* NormalM, int32& N, int32& LGC, float& HeightScale, const FIntRect& Rect = FIntRect());
 
 	bool LoadSampleLocationsInRT(UTextureRenderTarget2D* LocationsRequestedRT, TSharedPtr<FSWShareableSamplePoints>& Samples);
+	/** Evaluates a stack of analytic brushes from Data.Source into Data.Destination in a single dispatch */
+	bool ComposeBrushStack(const SWBrushStackComputeData& Data);
+
+	/*
+	 * Material instance pool, keyed by parent material.
+	 * Pool elements and world rebuilds reuse dynamic material instances instead of allocating new UObjects.
+	 */
+	UMaterialInstanceDynamic* AcquireMaterialInstance(UMaterialInterface* Parent);
+	/** Clears the parameters of MID and keeps it for the next acquisition of the same parent */
+	void ReleaseMaterialInstance(UMaterialInstanceDynamic* MID);
+
+	/** Soak benchmark: rebuilds every Shader World Cycles times, logging UObject count, GC time and pool usage in between */
+	void StartRebuildSoak(int32 Cycles, float IntervalSeconds);
 
 private:
+	void OnPreGarbageCollect();
+	void OnPostGarbageCollect();
+	void TickRebuildSoak(float DeltaTime);
+	void ReportRuntimeStats();
+
+	UPROPERTY(Transient)
+		TMap<UMaterialInterface*, FSWMaterialInstancePool> MaterialInstancePools;
+
+	int32 MaterialInstancesPooled = 0;
+	int32 MaterialInstancesInUse = 0;
+	int32 MaterialInstancesCreated = 0;
+
+	double GarbageCollectStart = 0.0;
+	double LastGarbageCollectMs = 0.0;
+	FDelegateHandle PreGarbageCollectHandle;
+	FDelegateHandle PostGarbageCollectHandle;
+
+	int32 SoakCyclesRemaining = 0;
+	float SoakInterval = 0.f;
+	float SoakTimer = 0.f;
+
 	TArray<USWContextBase*> SW_Contexts;
 	TArray<FVector> Visitors;
 	TArray<USW_CollisionComponent*> Tracked_Components;
@@ -59,6 +59,9 @@ public:
 		void LocateHeightmapFile();
 	UFUNCTION(BlueprintCallable, CallInEditor, Category = "3) Import")
 		void Import();
+	/** Streams the heightmap into a tiled terrain file (.swts), without going through a texture */
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "3) Import")
+		void ImportToTerrainStorage();
 
 		void ImportHeightmap();
 #endif
@@ -79,13 +82,17 @@ public:
 	UPROPERTY(EditAnywhere, Category = "2) Import Settings")
 		FString HeightmapName;
 
-	TMap<FIntPoint, uint16> SelectedData;
-
-	
+	/** Destination of ImportToTerrainStorage, see USWStorageBase::GetTerrainFilePath */
+	UPROPERTY(EditAnywhere, Category = "2) Import Settings")
+		FString TerrainStorageFile;
+	UPROPERTY(EditAnywhere, Category = "2) Import Settings", meta = (ClampMin = "16", ClampMax = "1024"))
+		int32 TerrainStorageTileSize = 128;
+	UPROPERTY(EditAnywhere, Category = "2) Import Settings")
+		float TerrainStorageTexelSpacing = 100.f;
 
-	void Import(int32 VertsX, int32 VertsY, uint16* HeightData);
+	void Import(int32 VertsX, int32 VertsY, const uint16* HeightData);
 
-	void SampleData(int32 SizeX, int32 SizeY);
+	void SampleData(int32 SizeX, int32 SizeY, const uint16* HeightData);
 
 	static uint16 convertFrom8To16(uint8 dataFirst, uint8 dataSecond);
 	static uint8* convertFrom16To8(uint16 dataAll);
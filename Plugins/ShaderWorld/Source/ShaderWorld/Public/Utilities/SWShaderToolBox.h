@@ -46,6 +46,7 @@ struct SWDrawMaterialToRTData;
 struct SWCopyData;
 struct SWNormalComputeData;
 struct SWSampleRequestComputeData;
+struct SWBrushStackComputeData;
 
 // Those Computer Shaders work on OpenGL ES 3.1/Vulkan/Metal/DX11/DX12 
 
@@ -72,6 +73,9 @@ namespace ShaderWorldGPUTools
 
 		void RequestReadBackLoad(const SWSampleRequestComputeData& Data) const;
 		void RequestReadBackLoad_RT(FRHICommandListImmediate& RHICmdList, const SWSampleRequestComputeData& Data) const;
+
+		void ComposeBrushStack(const SWBrushStackComputeData& Data) const;
+		void ComposeBrushStack_RT(FRHICommandListImmediate& RHICmdList, const SWBrushStackComputeData& Data) const;
 		
 	};
 
@@ -130,6 +134,7 @@ namespace ShaderWorldGPUTools
 			SHADER_PARAMETER(float, SourceWorldSize)
 			SHADER_PARAMETER(FVector2f, DestinationLoc)
 			SHADER_PARAMETER(float, DestWorldSize)
+			SHADER_PARAMETER(FIntPoint, ScrollOffset)
 			SHADER_PARAMETER_TEXTURE(Texture2D, DestTexDuplicate)
 			SHADER_PARAMETER_UAV(RWTexture2D<float4>, DestinationTex)
 			END_SHADER_PARAMETER_STRUCT()
@@ -184,6 +189,8 @@ namespace ShaderWorldGPUTools
 			SHADER_PARAMETER(uint32, N)
 			SHADER_PARAMETER(float, LocalGridScaling)
 			SHADER_PARAMETER(float, SWHeightmapScale)
+			SHADER_PARAMETER(FUintVector2, NormalRectMin)
+			SHADER_PARAMETER(FUintVector2, NormalRectMax)
 			END_SHADER_PARAMETER_STRUCT()
 	};
 
@@ -262,6 +269,59 @@ namespace ShaderWorldGPUTools
 	using FSWComputeSpawnable_CS = FComputeSpawnable_CS<false>;
 	using FSWComputeSpawnable_MobileCS = FComputeSpawnable_CS<true>;
 
+	template <bool bIsMobileRenderer>
+	class FBrushStack_CS : public FGlobalShader
+	{
+	public:
+
+		using FPermutationDomain = TShaderPermutationDomain<>;
+
+		DECLARE_EXPORTED_SHADER_TYPE(FBrushStack_CS, Global, SHADERWORLD_API);
+		SHADER_USE_PARAMETER_STRUCT(FBrushStack_CS, FGlobalShader);
+
+		static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+		{
+			return true;
+		}
+
+		static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+		{
+
+			FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+			OutEnvironment.SetDefine(TEXT("SW_COMPUTE"), 1);
+			OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZEX"), bIsMobileRenderer ? SW_MobileLowSharedMemory_GroupSizeX : FComputeShaderUtils::kGolden2DGroupSize);
+			OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZEY"), bIsMobileRenderer ? SW_MobileLowSharedMemory_GroupSizeY : FComputeShaderUtils::kGolden2DGroupSize);
+			OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZEZ"), 1);
+		}
+
+		static int32 GetGroupSizeX()
+		{
+			return bIsMobileRenderer ? SW_MobileLowSharedMemory_GroupSizeX : FComputeShaderUtils::kGolden2DGroupSize;
+		}
+		static int32 GetGroupSizeY()
+		{
+			return bIsMobileRenderer ? SW_MobileLowSharedMemory_GroupSizeY : FComputeShaderUtils::kGolden2DGroupSize;
+		}
+
+		BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+			SHADER_PARAMETER_STRUCT_INCLUDE(FSWShaderToolTextureRead, Pass)
+			SHADER_PARAMETER_TEXTURE(Texture2D, BrushLocationsTex)
+			SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<FSWCompositeBrush>, BrushStack)
+			SHADER_PARAMETER(uint32, BrushCount)
+			SHADER_PARAMETER(uint32, BrushTexDim)
+			SHADER_PARAMETER(uint32, BrushMargin)
+			SHADER_PARAMETER(uint32, BrushUseLocations)
+			SHADER_PARAMETER(float, BrushPatchFullSize)
+			SHADER_PARAMETER(FVector2f, BrushOrigin)
+			SHADER_PARAMETER(uint32, BrushRectCount)
+			SHADER_PARAMETER_ARRAY(FUintVector4, BrushRects, [4])
+			SHADER_PARAMETER_UAV(RWTexture2D<float4>, DestinationTex)
+		END_SHADER_PARAMETER_STRUCT()
+	};
+
+	using FSWBrushStack_CS = FBrushStack_CS<false>;
+	using FSWBrushStack_MobileCS = FBrushStack_CS<true>;
+
 	BEGIN_SHADER_PARAMETER_STRUCT(FSWShaderToolTopologyUpdateParameters, )
 	SHADER_PARAMETER(uint32, IndexLength)
 	SHADER_PARAMETER(float, NValue)
@@ -0,0 +1,111 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FSWTiledTerrainWriter;
+
+struct SHADERWORLD_API FSWHeightmapImportSettings
+{
+	/** 16 bit grayscale .png or little endian .raw */
+	FString SourceFile;
+	/** Required for .raw files, read from the header for .png */
+	FIntPoint RawDimensions = FIntPoint(0, 0);
+
+	/** Tiled terrain file (.swts) to write */
+	FString DestinationFile;
+
+	/** Power of two */
+	int32 TileSize = 128;
+	/** 0 for a full mip chain */
+	int32 NumMips = 0;
+	/** Distance between two texels, in cm */
+	float TexelSpacing = 100.f;
+
+	/** Height = (Value - 32768) * HeightScale + HeightOffset, in cm. Defaults to the landscape convention */
+	float HeightScale = 100.f / 128.f;
+	float HeightOffset = 0.f;
+};
+
+struct SHADERWORLD_API FSWHeightmapImportStats
+{
+	double ImportSeconds = 0.0;
+	/** Peak bytes held by the importer buffers: one strip per mip, the source strip and its conversion */
+	uint64 PeakBufferBytes = 0;
+	/** Process peak physical memory at the end of the import */
+	uint64 PeakProcessBytes = 0;
+	int32 TilesWritten = 0;
+	FIntPoint Dimensions = FIntPoint(0, 0);
+};
+
+/*
+ * Out of core heightmap import into the tiled terrain storage.
+ * Raw files are read by strips of TileSize rows, each strip is converted and split in tiles in parallel,
+ * written right away, and downsampled into the next mip strip. Memory stays bounded to one strip per mip,
+ * plus the source strip being converted. PNG files have to be decoded as a whole first.
+ */
+class SHADERWORLD_API FSWStreamingHeightmapImporter
+{
+public:
+
+	static bool Import(const FSWHeightmapImportSettings& Settings, FSWHeightmapImportStats& OutStats);
+
+private:
+
+	FSWStreamingHeightmapImporter(const FSWHeightmapImportSettings& InSettings, FSWTiledTerrainWriter& InWriter, int32 InSizeX, int32 InSizeY, int32 InNumMips);
+
+	/** Appends rows of 16 bit samples to mip 0 */
+	bool PushSourceRows(const uint16* Samples, int32 NumRows);
+	/** Flushes the partial strips of every mip, once the source is exhausted */
+	bool Finish();
+
+	bool AppendRows(int32 Mip, TConstArrayView<float> Heights, TConstArrayView<uint8> Materials, int32 NumRows);
+	bool EmitStrip(int32 Mip);
+
+	/** TransientBytes: buffers alive only during the current step */
+	void TrackMemory(uint64 TransientBytes = 0);
+
+	struct FMipStrip
+	{
+		int32 SizeX = 0;
+		int32 Rows = 0;
+		int32 NextTileY = 0;
+		TArray<float> Heights;
+		TArray<uint8> Materials;
+	};
+
+	const FSWHeightmapImportSettings& Settings;
+	FSWTiledTerrainWriter& Writer;
+	TArray<FMipStrip> Strips;
+
+public:
+	uint64 PeakBufferBytes = 0;
+	int32 TilesWritten = 0;
+};
@@ -0,0 +1,159 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Tasks/Task.h"
+
+#include <atomic>
+
+/** Pipeline stage a job belongs to, used for stats */
+enum class ESWTaskStage : uint8
+{
+	/** Select the tiles to update */
+	Select,
+	/** Produce the raw data of a tile: CPU evaluation, disk cache load */
+	Readback,
+	/** Turn raw data into positions / transforms */
+	Decode,
+	/** Build acceleration structures from decoded data */
+	Cook,
+	Num
+};
+
+/** Ready jobs are started highest priority first, FIFO within a priority */
+enum class ESWTaskPriority : uint8
+{
+	/** Gates every other stage of its pipeline */
+	Critical,
+	/** Collision, the player can walk on it */
+	High,
+	/** Visual only */
+	Normal,
+	Low,
+	Num
+};
+
+/*
+ * Cancellation token shared by the jobs of a tile.
+ * Cancelled once the tile went out of range or got relocated: jobs not started yet are skipped, running ones may poll it.
+ */
+class SHADERWORLD_API FSWTaskCancellation
+{
+public:
+	void Cancel() { bCancelled.AtomicSet(true); }
+	bool IsCancelled() const { return bCancelled; }
+
+private:
+	FThreadSafeBool bCancelled;
+};
+
+using FSWTaskCancellationPtr = TSharedPtr<FSWTaskCancellation, ESPMode::ThreadSafe>;
+
+/** Completes once the job ran, or was skipped because it got cancelled */
+class SHADERWORLD_API FSWTaskHandle
+{
+public:
+	bool IsValid() const { return Completion.IsValid(); }
+	bool IsCompleted() const { return !Completion.IsValid() || Completion->IsCompleted(); }
+	/** Launched and not completed yet */
+	bool IsPending() const { return !IsCompleted(); }
+	void Wait() const;
+	void Reset() { Completion.Reset(); }
+
+private:
+	friend class FSWTaskGraph;
+
+	TSharedPtr<UE::Tasks::FTaskEvent, ESPMode::ThreadSafe> Completion;
+};
+
+struct FSWTaskDesc
+{
+	const TCHAR* DebugName = TEXT("SWTask");
+	ESWTaskStage Stage = ESWTaskStage::Decode;
+	ESWTaskPriority Priority = ESWTaskPriority::Normal;
+	/** Optional, the job is skipped if cancelled before it started */
+	FSWTaskCancellationPtr Cancellation;
+	/** The job is only queued once every prerequisite completed */
+	TArray<FSWTaskHandle, TInlineAllocator<4>> Prerequisites;
+};
+
+/*
+ * Process wide scheduler of Shader World jobs, built on UE::Tasks.
+ * Jobs wait for their prerequisites, then for a slot: at most sw.TaskGraph.MaxConcurrentJobs run at once, whatever the number of worlds.
+ * Jobs may still use ParallelFor internally, the cap bounds how many pipelines compete for the workers.
+ * Launch / Cancel can be called from any thread.
+ */
+class SHADERWORLD_API FSWTaskGraph
+{
+public:
+	static FSWTaskGraph& Get();
+
+	FSWTaskHandle Launch(const FSWTaskDesc& Desc, TUniqueFunction<void()>&& Work);
+
+	int32 GetNumQueued() const { return NumQueued; }
+	int32 GetNumRunning() const { return NumRunning; }
+	int32 GetNumWaiting() const { return NumWaiting; }
+
+	/** Since startup. Cancelled jobs are counted as completed as well */
+	int32 GetNumCancelled() const { return NumCancelled; }
+	int32 GetNumCompleted(ESWTaskStage Stage) const { return NumCompleted[static_cast<int32>(Stage)]; }
+
+private:
+	struct FJob
+	{
+		const TCHAR* DebugName = nullptr;
+		ESWTaskStage Stage = ESWTaskStage::Decode;
+		ESWTaskPriority Priority = ESWTaskPriority::Normal;
+		FSWTaskCancellationPtr Cancellation;
+		TUniqueFunction<void()> Work;
+		TSharedPtr<UE::Tasks::FTaskEvent, ESPMode::ThreadSafe> Completion;
+	};
+
+	using FJobRef = TSharedRef<FJob, ESPMode::ThreadSafe>;
+
+	void Enqueue(const FJobRef& Job);
+	/** Starts ready jobs while slots are available */
+	void Dispatch();
+	void Run(const FJobRef& Job);
+	void Complete(const FJobRef& Job);
+
+	FCriticalSection QueueLock;
+	TArray<FJobRef> Ready[static_cast<int32>(ESWTaskPriority::Num)];
+
+	/** Waiting for prerequisites */
+	std::atomic<int32> NumWaiting{ 0 };
+	std::atomic<int32> NumQueued{ 0 };
+	/** Taken by Dispatch and released by Run, both under QueueLock */
+	std::atomic<int32> NumRunning{ 0 };
+
+	std::atomic<int32> NumCancelled{ 0 };
+	std::atomic<int32> NumCompleted[static_cast<int32>(ESWTaskStage::Num)] = {};
+};
@@ -28,6 +28,7 @@
 
 #include "SWStats.h"
 
+CSV_DEFINE_CATEGORY_MODULE(SHADERWORLDCORE_API, ShaderWorld, true);
 
 
 FString SWGetNameOfFunction(const FString& Function)
@@ -31,6 +31,7 @@
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "Misc/MessageDialog.h"
 #include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
 #include "Containers/Map.h"
 
 
@@ -48,3 +49,18 @@
 #if WITH_EDITOR
 
 #endif
+
+FString USWStorageBase::GetTerrainFilePath() const
+{
+	return FPaths::Combine(DestinationPath.Path, TerrainFileName);
+}
+
+TSharedPtr<FSWTiledTerrainReader, ESPMode::ThreadSafe> USWStorageBase::OpenTerrainStorage() const
+{
+	TSharedPtr<FSWTiledTerrainReader, ESPMode::ThreadSafe> Reader = MakeShared<FSWTiledTerrainReader, ESPMode::ThreadSafe>();
+
+	if (!Reader->Open(GetTerrainFilePath()))
+		return nullptr;
+
+	return Reader;
+}
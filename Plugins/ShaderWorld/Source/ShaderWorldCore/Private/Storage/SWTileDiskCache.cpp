@@ -0,0 +1,306 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+#include "Storage/SWTileDiskCache.h"
+
+#include "SWStats.h"
+#include "Hash/CityHash.h"
+#include "HAL/FileManager.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+FSWTileDiskCache::FSWTileDiskCache(const FString& InDirectory, int64 InMaxSizeMB)
+	: Directory(InDirectory)
+	, MaxSize(FMath::Max<int64>(InMaxSizeMB, 1) * 1024 * 1024)
+{
+}
+
+uint64 FSWTileDiskCache::HashBytes(const void* Data, int64 Size, uint64 Seed)
+{
+	uint64 Hash = Seed;
+
+	// CityHash takes 32 bit lengths
+	const char* Bytes = static_cast<const char*>(Data);
+	do
+	{
+		const uint32 ChunkSize = static_cast<uint32>(FMath::Min<int64>(Size, MAX_uint32));
+		Hash = CityHash64WithSeed(Bytes, ChunkSize, Hash);
+		Bytes += ChunkSize;
+		Size -= ChunkSize;
+	}
+	while (Size > 0);
+
+	return Hash;
+}
+
+uint64 FSWTileDiskCache::HashCombine(uint64 A, uint64 B)
+{
+	return CityHash128to64(Uint128_64(A, B));
+}
+
+FString FSWTileDiskCache::GetEntryPath(uint64 Key) const
+{
+	const FString KeyString = FString::Printf(TEXT("%016llx"), Key);
+	return FPaths::Combine(Directory, KeyString.Left(2), KeyString + TEXT(".swtc"));
+}
+
+void FSWTileDiskCache::Initialize()
+{
+	SW_FCT_CYCLE()
+
+	struct FFoundEntry
+	{
+		uint64 Key;
+		int64 Size;
+		FDateTime Time;
+	};
+	TArray<FFoundEntry> Found;
+
+	IFileManager::Get().IterateDirectoryStatRecursively(*Directory, [&Found](const TCHAR* Filename, const FFileStatData& StatData)
+	{
+		const FString Name(Filename);
+		if (StatData.bIsDirectory || !Name.EndsWith(TEXT(".swtc")))
+			return true;
+
+		const FString KeyString = FPaths::GetBaseFilename(Name);
+		if (KeyString.Len() != 16)
+			return true;
+
+		Found.Add({ FParse::HexNumber64(*KeyString), StatData.FileSize, StatData.ModificationTime });
+		return true;
+	});
+
+	// Oldest first, so that stamps follow the last use across sessions
+	Found.Sort([](const FFoundEntry& A, const FFoundEntry& B) { return A.Time < B.Time; });
+
+	{
+		FScopeLock Lock(&EntriesLock);
+
+		Found.RemoveAll([this](const FFoundEntry& F) { return Entries.Contains(F.Key); });
+
+		// Entries stored or loaded while listing are the most recent: they move above the ones found on disk
+		const uint64 NumFound = Found.Num();
+		for (TPair<uint64, FEntry>& Entry : Entries)
+			Entry.Value.Stamp += NumFound;
+		NextStamp += NumFound;
+
+		uint64 Stamp = 0;
+		for (const FFoundEntry& F : Found)
+		{
+			Entries.Add(F.Key, { F.Size, Stamp++ });
+			TotalSize += F.Size;
+		}
+	}
+
+	PruneIfNeeded();
+
+	bInitialized = true;
+}
+
+bool FSWTileDiskCache::Contains(uint64 Key) const
+{
+	FScopeLock Lock(&EntriesLock);
+	return Entries.Contains(Key);
+}
+
+bool FSWTileDiskCache::Probe(uint64 Key)
+{
+	if (Contains(Key))
+		return true;
+
+	NumMisses.Increment();
+	return false;
+}
+
+bool FSWTileDiskCache::Load(uint64 Key, TArray<uint8>& OutPayload)
+{
+	SW_FCT_CYCLE()
+
+	OutPayload.Reset();
+
+	if (!Contains(Key))
+	{
+		NumMisses.Increment();
+		return false;
+	}
+
+	const FString Path = GetEntryPath(Key);
+
+	TArray<uint8> Bytes;
+	bool bValid = FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent) && Bytes.Num() >= sizeof(FSWTileDiskCacheHeader);
+
+	FSWTileDiskCacheHeader Header;
+	if (bValid)
+	{
+		FMemory::Memcpy(&Header, Bytes.GetData(), sizeof(Header));
+
+		bValid = Header.Magic == FSWTileDiskCacheHeader::MagicNumber
+			&& Header.Version == FSWTileDiskCacheHeader::CurrentVersion
+			&& Header.Key == Key
+			&& (int64)sizeof(Header) + Header.StoredSize == Bytes.Num();
+	}
+
+	if (bValid)
+	{
+		const uint8* Stored = Bytes.GetData() + sizeof(Header);
+
+		if (Header.StoredSize == Header.UncompressedSize)
+		{
+			OutPayload.Append(Stored, Header.StoredSize);
+		}
+		else
+		{
+			OutPayload.SetNumUninitialized(Header.UncompressedSize);
+			bValid = FCompression::UncompressMemory(NAME_Oodle, OutPayload.GetData(), Header.UncompressedSize, Stored, Header.StoredSize);
+		}
+
+		bValid = bValid && HashBytes(OutPayload.GetData(), OutPayload.Num()) == Header.PayloadHash;
+	}
+
+	if (!bValid)
+	{
+		OutPayload.Reset();
+		Remove(Key);
+		NumMisses.Increment();
+		return false;
+	}
+
+	{
+		FScopeLock Lock(&EntriesLock);
+		if (FEntry* Entry = Entries.Find(Key))
+			Entry->Stamp = NextStamp++;
+	}
+
+	// Keeps the recency across sessions
+	IFileManager::Get().SetTimeStamp(*Path, FDateTime::UtcNow());
+
+	NumHits.Increment();
+	return true;
+}
+
+bool FSWTileDiskCache::Store(uint64 Key, TConstArrayView<uint8> Payload)
+{
+	SW_FCT_CYCLE()
+
+	FSWTileDiskCacheHeader Header;
+	Header.Key = Key;
+	Header.PayloadHash = HashBytes(Payload.GetData(), Payload.Num());
+	Header.UncompressedSize = Payload.Num();
+
+	TArray<uint8> Bytes;
+	Bytes.SetNumUninitialized(sizeof(Header));
+
+	int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Oodle, Payload.Num());
+	TArray<uint8> Compressed;
+	Compressed.SetNumUninitialized(CompressedSize);
+
+	// Keep the raw payload if compression fails or does not pay off
+	if (FCompression::CompressMemory(NAME_Oodle, Compressed.GetData(), CompressedSize, Payload.GetData(), Payload.Num()) && CompressedSize < Payload.Num())
+		Bytes.Append(Compressed.GetData(), CompressedSize);
+	else
+		Bytes.Append(Payload.GetData(), Payload.Num());
+
+	Header.StoredSize = Bytes.Num() - sizeof(Header);
+	FMemory::Memcpy(Bytes.GetData(), &Header, sizeof(Header));
+
+	// Write then move, readers never see a partial entry
+	const FString Path = GetEntryPath(Key);
+	const FString TempPath = Path + FString::Printf(TEXT(".%u.tmp"), FPlatformTLS::GetCurrentThreadId());
+
+	if (!FFileHelper::SaveArrayToFile(Bytes, *TempPath) || !IFileManager::Get().Move(*Path, *TempPath, true, true, false, true))
+	{
+		IFileManager::Get().Delete(*TempPath, false, false, true);
+		return false;
+	}
+
+	{
+		FScopeLock Lock(&EntriesLock);
+
+		FEntry& Entry = Entries.FindOrAdd(Key);
+		TotalSize += Bytes.Num() - Entry.Size;
+		Entry.Size = Bytes.Num();
+		Entry.Stamp = NextStamp++;
+	}
+
+	NumWrites.Increment();
+
+	PruneIfNeeded();
+
+	return true;
+}
+
+void FSWTileDiskCache::Remove(uint64 Key)
+{
+	{
+		FScopeLock Lock(&EntriesLock);
+
+		FEntry Entry;
+		if (!Entries.RemoveAndCopyValue(Key, Entry))
+			return;
+
+		TotalSize -= Entry.Size;
+	}
+
+	IFileManager::Get().Delete(*GetEntryPath(Key), false, false, true);
+}
+
+void FSWTileDiskCache::PruneIfNeeded()
+{
+	TArray<uint64> ToDelete;
+
+	{
+		FScopeLock Lock(&EntriesLock);
+
+		if (TotalSize <= MaxSize)
+			return;
+
+		TArray<TPair<uint64, FEntry>> Sorted;
+		Sorted.Reserve(Entries.Num());
+		for (const TPair<uint64, FEntry>& Entry : Entries)
+			Sorted.Add(Entry);
+
+		Sorted.Sort([](const TPair<uint64, FEntry>& A, const TPair<uint64, FEntry>& B) { return A.Value.Stamp < B.Value.Stamp; });
+
+		// Prune below the limit, so that the next stores do not prune again right away
+		const int64 Target = MaxSize - MaxSize / 10;
+
+		for (const TPair<uint64, FEntry>& Entry : Sorted)
+		{
+			if (TotalSize <= Target)
+				break;
+
+			TotalSize -= Entry.Value.Size;
+			Entries.Remove(Entry.Key);
+			ToDelete.Add(Entry.Key);
+		}
+	}
+
+	for (uint64 Key : ToDelete)
+		IFileManager::Get().Delete(*GetEntryPath(Key), false, false, true);
+}
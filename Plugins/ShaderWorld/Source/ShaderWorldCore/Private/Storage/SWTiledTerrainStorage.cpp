@@ -0,0 +1,504 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+#include "Storage/SWTiledTerrainStorage.h"
+
+#include "SWStats.h"
+#include "Async/MappedFileHandle.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+
+namespace SWTiledTerrain
+{
+	static FName GetCompressionFormat(ESWTileCompression Compression)
+	{
+		return Compression == ESWTileCompression::Oodle ? NAME_Oodle : NAME_None;
+	}
+}
+
+int64 FSWTiledTerrainDesc::GetNumTiles() const
+{
+	int64 NumTiles = 0;
+	for (int32 Mip = 0; Mip < NumMips; Mip++)
+		NumTiles += (int64)NumTilesXAtMip(Mip) * NumTilesYAtMip(Mip);
+
+	return NumTiles;
+}
+
+bool FSWTiledTerrainDesc::IsValid() const
+{
+	if (TileSize <= 0 || TileSize > MaxTileSize)
+		return false;
+
+	if (NumTilesX <= 0 || NumTilesY <= 0 || NumTilesX > MaxTilesPerSide || NumTilesY > MaxTilesPerSide)
+		return false;
+
+	// Bounding the mips first also bounds the shifts of NumTilesXAtMip
+	if (NumMips <= 0 || NumMips > ComputeFullMipCount(NumTilesX, NumTilesY))
+		return false;
+
+	return GetNumTiles() <= MAX_int32;
+}
+
+int32 FSWTiledTerrainDesc::GetTileIndex(int32 Mip, int32 TileX, int32 TileY) const
+{
+	if (Mip < 0 || Mip >= NumMips)
+		return INDEX_NONE;
+
+	const int32 MipTilesX = NumTilesXAtMip(Mip);
+	const int32 MipTilesY = NumTilesYAtMip(Mip);
+
+	if (TileX < 0 || TileY < 0 || TileX >= MipTilesX || TileY >= MipTilesY)
+		return INDEX_NONE;
+
+	int32 Index = 0;
+	for (int32 PreviousMip = 0; PreviousMip < Mip; PreviousMip++)
+		Index += NumTilesXAtMip(PreviousMip) * NumTilesYAtMip(PreviousMip);
+
+	return Index + TileX + TileY * MipTilesX;
+}
+
+int32 FSWTiledTerrainDesc::ComputeFullMipCount(int32 NumTilesX, int32 NumTilesY)
+{
+	int32 NumMips = 1;
+	while ((1 << (NumMips - 1)) < FMath::Max(NumTilesX, NumTilesY))
+		NumMips++;
+
+	return NumMips;
+}
+
+/*
+ * Writer
+ */
+
+FSWTiledTerrainWriter::~FSWTiledTerrainWriter()
+{
+	if (File.IsValid())
+		Close();
+}
+
+bool FSWTiledTerrainWriter::Open(const FString& Filename, const FSWTiledTerrainDesc& InDesc)
+{
+	if (!InDesc.IsValid())
+		return false;
+
+	Desc = InDesc;
+	File.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*Filename));
+
+	if (!File.IsValid())
+	{
+#if SWDEBUG
+		SW_LOG("Tiled terrain storage: can not open %s for writing", *Filename)
+#endif
+		return false;
+	}
+
+	Directory.Empty();
+	Directory.SetNum((int32)Desc.GetNumTiles());
+
+	// Header is patched by Close, once the directory location is known
+	FSWTiledTerrainHeader Header;
+	return File->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+}
+
+void FSWTiledTerrainWriter::EncodeTile(const FSWTiledTerrainDesc& Desc, TConstArrayView<float> Heights, TConstArrayView<uint8> Materials, TArray<uint8>& OutPayload, FSWTiledTerrainTileEntry& OutEntry)
+{
+	const int32 TexelCount = Desc.TexelsPerTile();
+	check(Heights.Num() >= TexelCount);
+
+	float MinHeight = Heights[0];
+	float MaxHeight = Heights[0];
+	for (int32 Texel = 1; Texel < TexelCount; Texel++)
+	{
+		MinHeight = FMath::Min(MinHeight, Heights[Texel]);
+		MaxHeight = FMath::Max(MaxHeight, Heights[Texel]);
+	}
+
+	const int32 RawSize = TexelCount * (sizeof(uint16) + sizeof(uint8));
+	TArray<uint8> Raw;
+	Raw.SetNumUninitialized(RawSize);
+
+	uint16* QuantizedHeights = reinterpret_cast<uint16*>(Raw.GetData());
+	uint8* MaterialIndices = Raw.GetData() + TexelCount * sizeof(uint16);
+
+	const float Range = MaxHeight - MinHeight;
+	const float Scale = Range > 0.f ? 65535.f / Range : 0.f;
+
+	for (int32 Texel = 0; Texel < TexelCount; Texel++)
+	{
+		QuantizedHeights[Texel] = static_cast<uint16>(FMath::Clamp(FMath::RoundToInt((Heights[Texel] - MinHeight) * Scale), 0, 65535));
+		MaterialIndices[Texel] = Materials.Num() >= TexelCount ? Materials[Texel] : 0;
+	}
+
+	OutEntry.MinHeight = MinHeight;
+	OutEntry.MaxHeight = MaxHeight;
+	OutEntry.UncompressedSize = RawSize;
+
+	const FName Format = SWTiledTerrain::GetCompressionFormat(Desc.Compression);
+
+	if (!Format.IsNone())
+	{
+		int32 CompressedSize = FCompression::CompressMemoryBound(Format, RawSize);
+		OutPayload.SetNumUninitialized(CompressedSize);
+
+		// Keep the raw payload if compression fails or does not pay off
+		if (FCompression::CompressMemory(Format, OutPayload.GetData(), CompressedSize, Raw.GetData(), RawSize) && CompressedSize < RawSize)
+		{
+			OutPayload.SetNum(CompressedSize, false);
+			OutEntry.CompressedSize = CompressedSize;
+			return;
+		}
+	}
+
+	OutPayload = MoveTemp(Raw);
+	OutEntry.CompressedSize = RawSize;
+}
+
+bool FSWTiledTerrainWriter::WriteEncodedTile(int32 Mip, int32 TileX, int32 TileY, const TArray<uint8>& Payload, const FSWTiledTerrainTileEntry& Entry)
+{
+	const int32 TileIndex = Desc.GetTileIndex(Mip, TileX, TileY);
+	if (!File.IsValid() || TileIndex == INDEX_NONE)
+		return false;
+
+	FSWTiledTerrainTileEntry& DirectoryEntry = Directory[TileIndex];
+	DirectoryEntry = Entry;
+	DirectoryEntry.Offset = File->Tell();
+
+	return File->Write(Payload.GetData(), Payload.Num());
+}
+
+bool FSWTiledTerrainWriter::WriteTile(int32 Mip, int32 TileX, int32 TileY, TConstArrayView<float> Heights, TConstArrayView<uint8> Materials)
+{
+	if (Heights.Num() < Desc.TexelsPerTile())
+		return false;
+
+	TArray<uint8> Payload;
+	FSWTiledTerrainTileEntry Entry;
+	EncodeTile(Desc, Heights, Materials, Payload, Entry);
+
+	return WriteEncodedTile(Mip, TileX, TileY, Payload, Entry);
+}
+
+bool FSWTiledTerrainWriter::Close()
+{
+	if (!File.IsValid())
+		return false;
+
+	FSWTiledTerrainHeader Header;
+	Header.TileSize = Desc.TileSize;
+	Header.NumTilesX = Desc.NumTilesX;
+	Header.NumTilesY = Desc.NumTilesY;
+	Header.NumMips = Desc.NumMips;
+	Header.TexelSpacing = Desc.TexelSpacing;
+	Header.Compression = Desc.Compression;
+
+	// Directory is read in place from the mapped file: keep it aligned
+	const int64 PayloadEnd = File->Tell();
+	const uint8 Padding[8] = { 0 };
+	bool bSuccess = File->Write(Padding, Align(PayloadEnd, 8) - PayloadEnd);
+
+	Header.DirectoryOffset = File->Tell();
+
+	bSuccess = bSuccess && File->Write(reinterpret_cast<const uint8*>(Directory.GetData()), Directory.Num() * sizeof(FSWTiledTerrainTileEntry));
+	bSuccess = bSuccess && File->Seek(0);
+	bSuccess = bSuccess && File->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+	bSuccess = bSuccess && File->Flush();
+
+	File.Reset();
+	Directory.Empty();
+
+	return bSuccess;
+}
+
+void FSWTiledTerrainWriter::DownsampleGrid(int32 SizeX, int32 SizeY, TConstArrayView<float> Heights, TConstArrayView<uint8> Materials, TArray<float>& OutHeights, TArray<uint8>& OutMaterials)
+{
+	const int32 HalfX = FMath::Max(1, FMath::DivideAndRoundUp(SizeX, 2));
+	const int32 HalfY = FMath::Max(1, FMath::DivideAndRoundUp(SizeY, 2));
+	const bool bHasMaterials = Materials.Num() >= SizeX * SizeY;
+
+	OutHeights.SetNumUninitialized(HalfX * HalfY);
+	OutMaterials.SetNumZeroed(bHasMaterials ? HalfX * HalfY : 0);
+
+	ParallelFor(HalfY, [&](int32 Y)
+	{
+		const int32 Y0 = FMath::Min(2 * Y, SizeY - 1);
+		const int32 Y1 = FMath::Min(2 * Y + 1, SizeY - 1);
+
+		for (int32 X = 0; X < HalfX; X++)
+		{
+			const int32 X0 = FMath::Min(2 * X, SizeX - 1);
+			const int32 X1 = FMath::Min(2 * X + 1, SizeX - 1);
+
+			OutHeights[X + Y * HalfX] = 0.25f * (Heights[X0 + Y0 * SizeX] + Heights[X1 + Y0 * SizeX] + Heights[X0 + Y1 * SizeX] + Heights[X1 + Y1 * SizeX]);
+
+			if (bHasMaterials)
+				OutMaterials[X + Y * HalfX] = Materials[X0 + Y0 * SizeX];
+		}
+	});
+}
+
+bool FSWTiledTerrainWriter::WriteGrid(const FString& Filename, FSWTiledTerrainDesc Desc, int32 SizeX, int32 SizeY, TConstArrayView<float> Heights, TConstArrayView<uint8> Materials)
+{
+	if (SizeX <= 0 || SizeY <= 0 || Heights.Num() < SizeX * SizeY || Desc.TileSize <= 0)
+		return false;
+
+	Desc.NumTilesX = FMath::DivideAndRoundUp(SizeX, Desc.TileSize);
+	Desc.NumTilesY = FMath::DivideAndRoundUp(SizeY, Desc.TileSize);
+	Desc.NumMips = FMath::Clamp(Desc.NumMips, 1, FSWTiledTerrainDesc::ComputeFullMipCount(Desc.NumTilesX, Desc.NumTilesY));
+
+	FSWTiledTerrainWriter Writer;
+	if (!Writer.Open(Filename, Desc))
+		return false;
+
+	TArray<float> MipHeights(Heights.GetData(), SizeX * SizeY);
+	TArray<uint8> MipMaterials;
+	if (Materials.Num() >= SizeX * SizeY)
+		MipMaterials = TArray<uint8>(Materials.GetData(), SizeX * SizeY);
+
+	int32 MipSizeX = SizeX;
+	int32 MipSizeY = SizeY;
+
+	for (int32 Mip = 0; Mip < Desc.NumMips; Mip++)
+	{
+		const int32 MipTilesX = Desc.NumTilesXAtMip(Mip);
+		const int32 MipTilesY = Desc.NumTilesYAtMip(Mip);
+		const int32 TileSize = Desc.TileSize;
+
+		TArray<TArray<uint8>> Payloads;
+		TArray<FSWTiledTerrainTileEntry> Entries;
+		Payloads.SetNum(MipTilesX * MipTilesY);
+		Entries.SetNum(MipTilesX * MipTilesY);
+
+		ParallelFor(MipTilesX * MipTilesY, [&](int32 TileIndex)
+		{
+			const int32 TileX = TileIndex % MipTilesX;
+			const int32 TileY = TileIndex / MipTilesX;
+
+			TArray<float> TileHeights;
+			TArray<uint8> TileMaterials;
+			TileHeights.SetNumUninitialized(Desc.TexelsPerTile());
+			TileMaterials.SetNumZeroed(Desc.TexelsPerTile());
+
+			for (int32 Y = 0; Y < TileSize; Y++)
+			{
+				const int32 GridY = FMath::Min(TileY * TileSize + Y, MipSizeY - 1);
+
+				for (int32 X = 0; X < TileSize; X++)
+				{
+					const int32 GridX = FMath::Min(TileX * TileSize + X, MipSizeX - 1);
+
+					TileHeights[X + Y * TileSize] = MipHeights[GridX + GridY * MipSizeX];
+					if (MipMaterials.Num() > 0)
+						TileMaterials[X + Y * TileSize] = MipMaterials[GridX + GridY * MipSizeX];
+				}
+			}
+
+			EncodeTile(Desc, TileHeights, TileMaterials, Payloads[TileIndex], Entries[TileIndex]);
+		});
+
+		for (int32 TileIndex = 0; TileIndex < Payloads.Num(); TileIndex++)
+		{
+			if (!Writer.WriteEncodedTile(Mip, TileIndex % MipTilesX, TileIndex / MipTilesX, Payloads[TileIndex], Entries[TileIndex]))
+				return false;
+		}
+
+		if (Mip + 1 < Desc.NumMips)
+		{
+			TArray<float> NextHeights;
+			TArray<uint8> NextMaterials;
+			DownsampleGrid(MipSizeX, MipSizeY, MipHeights, MipMaterials, NextHeights, NextMaterials);
+
+			MipHeights = MoveTemp(NextHeights);
+			MipMaterials = MoveTemp(NextMaterials);
+			MipSizeX = FMath::Max(1, FMath::DivideAndRoundUp(MipSizeX, 2));
+			MipSizeY = FMath::Max(1, FMath::DivideAndRoundUp(MipSizeY, 2));
+		}
+	}
+
+	return Writer.Close();
+}
+
+/*
+ * Reader
+ */
+
+FSWTiledTerrainReader::~FSWTiledTerrainReader()
+{
+	// Region must be released before its file handle
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+bool FSWTiledTerrainReader::Open(const FString& Filename)
+{
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	LoadedFile.Empty();
+	Data = nullptr;
+	DataSize = 0;
+	Directory = nullptr;
+
+	MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+
+	if (MappedFile.IsValid() && MappedFile->GetFileSize() > 0)
+		MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+
+	if (MappedRegion.IsValid())
+	{
+		Data = MappedRegion->GetMappedPtr();
+		DataSize = MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		MappedFile.Reset();
+
+		if (!FFileHelper::LoadFileToArray(LoadedFile, *Filename, FILEREAD_Silent))
+			return false;
+
+		Data = LoadedFile.GetData();
+		DataSize = LoadedFile.Num();
+	}
+
+	FSWTiledTerrainHeader Header;
+	if (DataSize < (int64)sizeof(Header))
+	{
+		Data = nullptr;
+		return false;
+	}
+
+	FMemory::Memcpy(&Header, Data, sizeof(Header));
+
+	Desc.TileSize = Header.TileSize;
+	Desc.NumTilesX = Header.NumTilesX;
+	Desc.NumTilesY = Header.NumTilesY;
+	Desc.NumMips = Header.NumMips;
+	Desc.TexelSpacing = Header.TexelSpacing;
+	Desc.Compression = Header.Compression;
+
+	bool bValidHeader = Header.Magic == FSWTiledTerrainHeader::MagicNumber && Header.Version == FSWTiledTerrainHeader::CurrentVersion && Desc.IsValid();
+
+	// The directory is read in place: it must fit in the file and be aligned for FSWTiledTerrainTileEntry
+	if (bValidHeader)
+	{
+		const int64 DirectorySize = Desc.GetNumTiles() * (int64)sizeof(FSWTiledTerrainTileEntry);
+
+		bValidHeader = Header.DirectoryOffset >= sizeof(FSWTiledTerrainHeader)
+			&& Header.DirectoryOffset <= (uint64)DataSize
+			&& DirectorySize <= DataSize - (int64)Header.DirectoryOffset
+			&& (Header.DirectoryOffset % alignof(FSWTiledTerrainTileEntry)) == 0
+			&& IsAligned(Data, alignof(FSWTiledTerrainTileEntry));
+	}
+
+	if (!bValidHeader)
+	{
+#if SWDEBUG
+		SW_LOG("Tiled terrain storage: %s is not a valid tiled terrain file", *Filename)
+#endif
+		Data = nullptr;
+		return false;
+	}
+
+	Directory = reinterpret_cast<const FSWTiledTerrainTileEntry*>(Data + Header.DirectoryOffset);
+	return true;
+}
+
+const FSWTiledTerrainTileEntry* FSWTiledTerrainReader::FindEntry(int32 Mip, int32 TileX, int32 TileY) const
+{
+	if (!IsValid())
+		return nullptr;
+
+	const int32 TileIndex = Desc.GetTileIndex(Mip, TileX, TileY);
+	if (TileIndex == INDEX_NONE)
+		return nullptr;
+
+	const FSWTiledTerrainTileEntry* Entry = &Directory[TileIndex];
+	if (Entry->CompressedSize == 0 || Entry->Offset > (uint64)DataSize || Entry->CompressedSize > (uint64)DataSize - Entry->Offset)
+		return nullptr;
+
+	return Entry;
+}
+
+bool FSWTiledTerrainReader::HasTile(int32 Mip, int32 TileX, int32 TileY) const
+{
+	return FindEntry(Mip, TileX, TileY) != nullptr;
+}
+
+bool FSWTiledTerrainReader::GetTileHeightRange(int32 Mip, int32 TileX, int32 TileY, float& OutMin, float& OutMax) const
+{
+	const FSWTiledTerrainTileEntry* Entry = FindEntry(Mip, TileX, TileY);
+	if (!Entry)
+		return false;
+
+	OutMin = Entry->MinHeight;
+	OutMax = Entry->MaxHeight;
+	return true;
+}
+
+bool FSWTiledTerrainReader::ReadTile(int32 Mip, int32 TileX, int32 TileY, TArray<float>& OutHeights, TArray<uint8>& OutMaterials) const
+{
+	const FSWTiledTerrainTileEntry* Entry = FindEntry(Mip, TileX, TileY);
+	if (!Entry)
+		return false;
+
+	const int32 TexelCount = Desc.TexelsPerTile();
+	if (Entry->UncompressedSize != TexelCount * (sizeof(uint16) + sizeof(uint8)))
+		return false;
+
+	const uint8* Payload = Data + Entry->Offset;
+
+	TArray<uint8> Decompressed;
+	if (Entry->CompressedSize != Entry->UncompressedSize)
+	{
+		const FName Format = SWTiledTerrain::GetCompressionFormat(Desc.Compression);
+		Decompressed.SetNumUninitialized(Entry->UncompressedSize);
+
+		if (Format.IsNone() || !FCompression::UncompressMemory(Format, Decompressed.GetData(), Entry->UncompressedSize, Payload, Entry->CompressedSize))
+			return false;
+
+		Payload = Decompressed.GetData();
+	}
+
+	OutHeights.SetNumUninitialized(TexelCount);
+	OutMaterials.SetNumUninitialized(TexelCount);
+
+	const uint16* QuantizedHeights = reinterpret_cast<const uint16*>(Payload);
+	const float Scale = (Entry->MaxHeight - Entry->MinHeight) / 65535.f;
+
+	for (int32 Texel = 0; Texel < TexelCount; Texel++)
+	{
+		uint16 Quantized;
+		FMemory::Memcpy(&Quantized, &QuantizedHeights[Texel], sizeof(uint16));
+		OutHeights[Texel] = Entry->MinHeight + Quantized * Scale;
+	}
+
+	FMemory::Memcpy(OutMaterials.GetData(), Payload + TexelCount * sizeof(uint16), TexelCount);
+
+	return true;
+}
@@ -0,0 +1,89 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+
+#include "Misc/AutomationTest.h"
+#include "Storage/SWTileDiskCache.h"
+
+#include "HAL/FileManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSWTileDiskCacheRecencyTest, "ShaderWorld.TileDiskCache.Recency", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/*
+ * An entry stored while Initialize() has not listed the disk yet is more recent than every entry found on disk:
+ * when the listing overflows the size limit, the oldest entries on disk are pruned first.
+ */
+bool FSWTileDiskCacheRecencyTest::RunTest(const FString& Parameters)
+{
+	const FString Directory = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("ShaderWorld"), TEXT("TileDiskCacheRecency"));
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+
+	// Incompressible payloads: 3 fit in the 1MB limit, 4 do not
+	TArray<uint8> Payload;
+	Payload.SetNumUninitialized(300 * 1024);
+	FRandomStream RandomStream(7);
+	for (uint8& Byte : Payload)
+		Byte = static_cast<uint8>(RandomStream.RandHelper(256));
+
+	{
+		FSWTileDiskCache PreviousSession(Directory, 1);
+		PreviousSession.Initialize();
+
+		// Last used one minute apart, key 1 first
+		for (uint64 Key = 1; Key <= 3; Key++)
+		{
+			TestTrue(TEXT("Previous session entry is stored"), PreviousSession.Store(Key, Payload));
+			IFileManager::Get().SetTimeStamp(*PreviousSession.GetEntryPath(Key), FDateTime::UtcNow() - FTimespan::FromMinutes(10 - Key));
+		}
+	}
+
+	FSWTileDiskCache Cache(Directory, 1);
+
+	TestFalse(TEXT("Unknown entry before listing"), Cache.Probe(1));
+	TestEqual(TEXT("Probe counts the miss"), Cache.GetNumMisses(), 1);
+
+	TestTrue(TEXT("Entry is stored before listing"), Cache.Store(4, Payload));
+	Cache.Initialize();
+
+	TestTrue(TEXT("Entry stored before listing is kept"), Cache.Contains(4));
+	TestFalse(TEXT("Oldest entry on disk is pruned"), Cache.Contains(1));
+	TestTrue(TEXT("Recent entries on disk are kept"), Cache.Contains(2) && Cache.Contains(3));
+
+	TArray<uint8> Loaded;
+	TestTrue(TEXT("Kept entry loads"), Cache.Load(4, Loaded) && Loaded == Payload);
+
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,279 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+#include "Misc/AutomationTest.h"
+#include "Storage/SWTiledTerrainStorage.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SWTiledTerrainStorageTests
+{
+	static FString GetTestFilename(const TCHAR* Name)
+	{
+		return FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("ShaderWorld"), FString(Name) + TEXT(".swts"));
+	}
+
+	/** Smooth hills with a few sharp steps, materials banded by height */
+	static void MakeGrid(int32 SizeX, int32 SizeY, TArray<float>& OutHeights, TArray<uint8>& OutMaterials)
+	{
+		OutHeights.SetNumUninitialized(SizeX * SizeY);
+		OutMaterials.SetNumUninitialized(SizeX * SizeY);
+
+		for (int32 Y = 0; Y < SizeY; Y++)
+		{
+			for (int32 X = 0; X < SizeX; X++)
+			{
+				const float Height = 2000.f * FMath::Sin(X * 0.05f) * FMath::Cos(Y * 0.03f) + ((X / 37 + Y / 53) % 3) * 150.f;
+				OutHeights[X + Y * SizeX] = Height;
+				OutMaterials[X + Y * SizeX] = static_cast<uint8>(FMath::Clamp(FMath::FloorToInt((Height + 2500.f) / 500.f), 0, 255));
+			}
+		}
+	}
+
+	/** Overwrites the serialized header of an existing file */
+	static bool PatchHeader(const FString& Filename, TFunctionRef<void(FSWTiledTerrainHeader&)> Patch)
+	{
+		TArray<uint8> File;
+		if (!FFileHelper::LoadFileToArray(File, *Filename) || File.Num() < (int32)sizeof(FSWTiledTerrainHeader))
+			return false;
+
+		FSWTiledTerrainHeader Header;
+		FMemory::Memcpy(&Header, File.GetData(), sizeof(Header));
+		Patch(Header);
+		FMemory::Memcpy(File.GetData(), &Header, sizeof(Header));
+
+		return FFileHelper::SaveArrayToFile(File, *Filename);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSWTiledTerrainRoundTripTest, "ShaderWorld.TiledTerrainStorage.RoundTrip", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSWTiledTerrainRoundTripTest::RunTest(const FString& Parameters)
+{
+	using namespace SWTiledTerrainStorageTests;
+
+	const int32 SizeX = 300;
+	const int32 SizeY = 200;
+	TArray<float> Heights;
+	TArray<uint8> Materials;
+	MakeGrid(SizeX, SizeY, Heights, Materials);
+
+	for (const ESWTileCompression Compression : { ESWTileCompression::None, ESWTileCompression::Oodle })
+	{
+		const FString Filename = GetTestFilename(Compression == ESWTileCompression::None ? TEXT("RoundTripRaw") : TEXT("RoundTripOodle"));
+
+		FSWTiledTerrainDesc Desc;
+		Desc.TileSize = 64;
+		Desc.NumMips = 16;
+		Desc.Compression = Compression;
+
+		if (!TestTrue(TEXT("Grid is written"), FSWTiledTerrainWriter::WriteGrid(Filename, Desc, SizeX, SizeY, Heights, Materials)))
+			return false;
+
+		FSWTiledTerrainReader Reader;
+		if (!TestTrue(TEXT("File is opened"), Reader.Open(Filename)))
+			return false;
+
+		const FSWTiledTerrainDesc& ReadDesc = Reader.GetDesc();
+		TestEqual(TEXT("Tile size"), ReadDesc.TileSize, 64);
+		TestEqual(TEXT("Tiles along X"), ReadDesc.NumTilesX, 5);
+		TestEqual(TEXT("Tiles along Y"), ReadDesc.NumTilesY, 4);
+		TestEqual(TEXT("Mips are clamped to a single tile"), ReadDesc.NumMips, FSWTiledTerrainDesc::ComputeFullMipCount(5, 4));
+
+		// Mip 0 texels match the source within the 16bit quantization step of their tile
+		TArray<float> TileHeights;
+		TArray<uint8> TileMaterials;
+		float MaxError = 0.f;
+		int32 MaterialMismatches = 0;
+
+		for (int32 TileY = 0; TileY < ReadDesc.NumTilesY; TileY++)
+		{
+			for (int32 TileX = 0; TileX < ReadDesc.NumTilesX; TileX++)
+			{
+				float MinHeight = 0.f;
+				float MaxHeight = 0.f;
+				if (!TestTrue(TEXT("Tile is read"), Reader.ReadTile(0, TileX, TileY, TileHeights, TileMaterials) && Reader.GetTileHeightRange(0, TileX, TileY, MinHeight, MaxHeight)))
+					return false;
+
+				const float Step = (MaxHeight - MinHeight) / 65535.f;
+
+				for (int32 Y = 0; Y < ReadDesc.TileSize; Y++)
+				{
+					for (int32 X = 0; X < ReadDesc.TileSize; X++)
+					{
+						const int32 GridX = FMath::Min(TileX * ReadDesc.TileSize + X, SizeX - 1);
+						const int32 GridY = FMath::Min(TileY * ReadDesc.TileSize + Y, SizeY - 1);
+						const int32 Texel = X + Y * ReadDesc.TileSize;
+
+						MaxError = FMath::Max(MaxError, FMath::Abs(TileHeights[Texel] - Heights[GridX + GridY * SizeX]) - Step);
+						MaterialMismatches += TileMaterials[Texel] != Materials[GridX + GridY * SizeX] ? 1 : 0;
+					}
+				}
+			}
+		}
+
+		TestTrue(TEXT("Heights within a quantization step"), MaxError <= KINDA_SMALL_NUMBER * 100.f);
+		TestEqual(TEXT("Materials are lossless"), MaterialMismatches, 0);
+
+		// Every mip tile exists, a single one covers the last mip
+		const int32 LastMip = ReadDesc.NumMips - 1;
+		TestEqual(TEXT("Last mip is a single tile"), ReadDesc.NumTilesXAtMip(LastMip) * ReadDesc.NumTilesYAtMip(LastMip), 1);
+		for (int32 Mip = 0; Mip < ReadDesc.NumMips; Mip++)
+		{
+			TestTrue(FString::Printf(TEXT("Mip %d first tile"), Mip), Reader.HasTile(Mip, 0, 0));
+			TestTrue(FString::Printf(TEXT("Mip %d last tile"), Mip), Reader.HasTile(Mip, ReadDesc.NumTilesXAtMip(Mip) - 1, ReadDesc.NumTilesYAtMip(Mip) - 1));
+		}
+
+		TestFalse(TEXT("Out of range tile"), Reader.HasTile(0, ReadDesc.NumTilesX, 0));
+		TestFalse(TEXT("Out of range mip"), Reader.HasTile(ReadDesc.NumMips, 0, 0));
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSWTiledTerrainCorruptedHeaderTest, "ShaderWorld.TiledTerrainStorage.CorruptedHeader", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSWTiledTerrainCorruptedHeaderTest::RunTest(const FString& Parameters)
+{
+	using namespace SWTiledTerrainStorageTests;
+
+	TArray<float> Heights;
+	TArray<uint8> Materials;
+	MakeGrid(128, 128, Heights, Materials);
+
+	FSWTiledTerrainDesc Desc;
+	Desc.TileSize = 32;
+	Desc.NumMips = 3;
+	Desc.Compression = ESWTileCompression::None;
+
+	const FString Filename = GetTestFilename(TEXT("CorruptedHeader"));
+
+	struct FCorruption
+	{
+		const TCHAR* Name;
+		TFunction<void(FSWTiledTerrainHeader&)> Patch;
+	};
+
+	const FCorruption Corruptions[] =
+	{
+		{ TEXT("No tile along X"), [](FSWTiledTerrainHeader& Header) { Header.NumTilesX = 0; } },
+		{ TEXT("Negative tiles along Y"), [](FSWTiledTerrainHeader& Header) { Header.NumTilesY = -4; } },
+		{ TEXT("Tile count overflowing int32"), [](FSWTiledTerrainHeader& Header) { Header.NumTilesX = MAX_int32; Header.NumTilesY = MAX_int32; } },
+		{ TEXT("More mips than a single tile needs"), [](FSWTiledTerrainHeader& Header) { Header.NumMips = 40; } },
+		{ TEXT("Oversized tiles"), [](FSWTiledTerrainHeader& Header) { Header.TileSize = 1 << 20; } },
+		{ TEXT("Misaligned directory"), [](FSWTiledTerrainHeader& Header) { Header.DirectoryOffset += 4; } },
+		{ TEXT("Directory past the end of file"), [](FSWTiledTerrainHeader& Header) { Header.DirectoryOffset = MAX_uint64 - 7; } },
+		{ TEXT("Directory over the header"), [](FSWTiledTerrainHeader& Header) { Header.DirectoryOffset = 0; } },
+	};
+
+	for (const FCorruption& Corruption : Corruptions)
+	{
+		if (!TestTrue(TEXT("Grid is written"), FSWTiledTerrainWriter::WriteGrid(Filename, Desc, 128, 128, Heights, Materials)))
+			return false;
+
+		{
+			// Released before patching: a mapped file can not be written on every platform
+			FSWTiledTerrainReader UntouchedReader;
+			TestTrue(FString::Printf(TEXT("%s: untouched file is opened"), Corruption.Name), UntouchedReader.Open(Filename));
+		}
+
+		if (!TestTrue(TEXT("Header is patched"), PatchHeader(Filename, Corruption.Patch)))
+			return false;
+
+		FSWTiledTerrainReader Reader;
+		TestFalse(FString::Printf(TEXT("%s: file is rejected"), Corruption.Name), Reader.Open(Filename));
+		TestFalse(FString::Printf(TEXT("%s: reader is invalid"), Corruption.Name), Reader.IsValid());
+	}
+
+	FSWTiledTerrainDesc InvalidDesc = Desc;
+	InvalidDesc.NumTilesX = 0;
+	FSWTiledTerrainWriter Writer;
+	TestFalse(TEXT("Writer refuses an empty terrain"), Writer.Open(Filename, InvalidDesc));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSWTiledTerrainThroughputTest, "ShaderWorld.TiledTerrainStorage.Throughput", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSWTiledTerrainThroughputTest::RunTest(const FString& Parameters)
+{
+	using namespace SWTiledTerrainStorageTests;
+
+	const int32 Size = 2048;
+	TArray<float> Heights;
+	TArray<uint8> Materials;
+	MakeGrid(Size, Size, Heights, Materials);
+
+	for (const ESWTileCompression Compression : { ESWTileCompression::None, ESWTileCompression::Oodle })
+	{
+		const FString Filename = GetTestFilename(Compression == ESWTileCompression::None ? TEXT("ThroughputRaw") : TEXT("ThroughputOodle"));
+
+		FSWTiledTerrainDesc Desc;
+		Desc.TileSize = 128;
+		Desc.NumMips = 1;
+		Desc.Compression = Compression;
+
+		double Start = FPlatformTime::Seconds();
+		if (!TestTrue(TEXT("Grid is written"), FSWTiledTerrainWriter::WriteGrid(Filename, Desc, Size, Size, Heights, Materials)))
+			return false;
+		const double WriteSeconds = FPlatformTime::Seconds() - Start;
+
+		FSWTiledTerrainReader Reader;
+		if (!TestTrue(TEXT("File is opened"), Reader.Open(Filename)))
+			return false;
+
+		const FSWTiledTerrainDesc& ReadDesc = Reader.GetDesc();
+		TArray<float> TileHeights;
+		TArray<uint8> TileMaterials;
+		int32 TilesRead = 0;
+
+		Start = FPlatformTime::Seconds();
+		for (int32 TileY = 0; TileY < ReadDesc.NumTilesY; TileY++)
+		{
+			for (int32 TileX = 0; TileX < ReadDesc.NumTilesX; TileX++)
+				TilesRead += Reader.ReadTile(0, TileX, TileY, TileHeights, TileMaterials) ? 1 : 0;
+		}
+		const double ReadSeconds = FPlatformTime::Seconds() - Start;
+
+		TestEqual(TEXT("Every tile is read"), TilesRead, ReadDesc.NumTilesX * ReadDesc.NumTilesY);
+
+		const double TexelsMillion = (double)Size * Size / 1e6;
+		AddInfo(FString::Printf(TEXT("%s | %dx%d texels, %lld bytes | write %.1f MTexels/s | read %.1f MTexels/s"),
+			Compression == ESWTileCompression::None ? TEXT("Raw") : TEXT("Oodle"), Size, Size, IFileManager::Get().FileSize(*Filename),
+			WriteSeconds > 0.0 ? TexelsMillion / WriteSeconds : 0.0, ReadSeconds > 0.0 ? TexelsMillion / ReadSeconds : 0.0));
+	}
+
+	return true;
+}
+
+#endif
@@ -122,6 +122,34 @@ enum class ESpawnableType : uint8
 };
 
 
+/**
+* Analytic brushes evaluated by the brush stack compute shader
+*/
+UENUM(BlueprintType)
+enum class ESWBrushShape : uint8
+{
+	Circle UMETA(DisplayName = "Circle"),
+	Box UMETA(DisplayName = "Box"),
+};
+
+UENUM(BlueprintType)
+enum class ESWBrushFalloff : uint8
+{
+	Linear UMETA(DisplayName = "Linear"),
+	Smooth UMETA(DisplayName = "Smooth"),
+	Spherical UMETA(DisplayName = "Spherical"),
+};
+
+UENUM(BlueprintType)
+enum class ESWBrushBlendOp : uint8
+{
+	Add UMETA(DisplayName = "Add"),
+	Set UMETA(DisplayName = "Set"),
+	Max UMETA(DisplayName = "Max"),
+	Min UMETA(DisplayName = "Min"),
+};
+
+
 class SHADERWORLDCORE_API SWEnums
 {
 public:
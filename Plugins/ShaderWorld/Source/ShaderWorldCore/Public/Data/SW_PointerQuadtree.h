@@ -29,6 +29,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "ConvexVolume.h"
 
 struct FVisitor
 {
@@ -43,8 +44,13 @@ public:
 	{};
 };
 
+/*
+ * Quadtree stored as a flat node arena: children of a node are 4 contiguous nodes, addressed by index.
+ * The tree is mutated on a single thread (Subdivide/Collapse); worker threads query an immutable copy
+ * obtained through MakeSnapshot(), so reads never take a lock.
+ */
 template<typename DataType>
-class FSW_PointerTree : public TSharedFromThis<FSW_PointerTree<DataType>>
+class FSW_PointerTree : public TSharedFromThis<FSW_PointerTree<DataType>, ESPMode::ThreadSafe>
 {
 public:
 	
@@ -59,78 +65,239 @@ public:
 		:Extent(InExtent.X)
 		{};
 	};
-	struct FPointerNode : public TSharedFromThis<FSW_PointerTree<DataType>::FPointerNode>
-	{
-	public:
-		FSW_PointerTree<DataType>* Owner = nullptr;
-		TSharedPtr < FPointerNode> Parent;
-		TStaticArray< TSharedPtr<FPointerNode>,4> Children;
 
-		uint8 Depth = 0;
+	struct FNode
+	{
+		FBox Bounds = FBox(ForceInit);
 		FVector Center = FVector(0);
-		FBox Bounds;
-
-		DataType Data;
-
-		~FPointerNode()
-		{
-			for (uint8 Child = 0; Child < 4; Child++)
-			{
-				if(Children[Child].IsValid())
-					Children[Child]=nullptr;
-			}				
-		};
-
-		FPointerNode(FSW_PointerTree<DataType>* Owner_,TSharedPtr < FPointerNode> Parent_ = nullptr, FVector Center_= FVector(0))
-		: Owner(Owner_? Owner_:Parent_->Owner)
-		, Parent(Parent_)
-		, Depth(Parent_ ? Parent_->Depth + 1 : 0)
-		, Center(Center_)		
-		, Bounds(FBox(Center - Owner->SharedData[Depth].Extent*FVector(1.f), Center + Owner->SharedData[Depth].Extent * FVector(1.f)))
-		{
-			for (uint8 Child = 0; Child < 4; Child++)
-			{
-				Children[Child] = nullptr;
-			}
-		};
-
-		bool IsLeaf(){return !Children[0].IsValid();}
+		int32 Parent = INDEX_NONE;
+		/** First of the 4 contiguous children, INDEX_NONE for leaves */
+		int32 FirstChild = INDEX_NONE;
+		uint8 Depth = 0;
 
-		DataType& GetData(){return Data;};
+		FORCEINLINE bool IsLeaf() const { return FirstChild == INDEX_NONE; }
 	};
 
+	static constexpr int32 RootIndex = 0;
+
 	FSW_PointerTree() = delete;
 
 	FSW_PointerTree(double Extent_, uint8 Depth_, FVector TreeLocation_)
 		: TreeLocation(TreeLocation_)
 		, MaxDepth(Depth_)
 	{
+		check(Depth_ > 0);
+
 		SharedData.AddDefaulted(Depth_);
 		for (int32 LOD = 0; LOD < Depth_; LOD++)
 		{
 			SharedData[LOD].Extent = Extent_ * (1.0 / (1 << LOD));
 		}
 
-		RootNode = MakeShared <FPointerNode>(this);
+		FNode& Root = Nodes.AddDefaulted_GetRef();
+		Root.Center = TreeLocation;
+		Root.Bounds = MakeBounds(Root.Center, 0);
+		Data.AddDefaulted();
 	};
 
-	~FSW_PointerTree()
+	~FSW_PointerTree() = default;
+
+	FORCEINLINE FVector GetTreeLocation() const {return TreeLocation;}
+	FORCEINLINE uint8 GetMaxDepth() const { return MaxDepth; }
+	FORCEINLINE uint32 GetRevision() const { return Revision; }
+
+	FORCEINLINE bool IsValidNode(int32 NodeIndex) const { return Nodes.IsValidIndex(NodeIndex) && (NodeIndex == RootIndex || Nodes[NodeIndex].Parent != INDEX_NONE); }
+	FORCEINLINE const FNode& GetNode(int32 NodeIndex) const { return Nodes[NodeIndex]; }
+	FORCEINLINE DataType& GetData(int32 NodeIndex) { return Data[NodeIndex]; }
+	FORCEINLINE const DataType& GetData(int32 NodeIndex) const { return Data[NodeIndex]; }
+
+	/** Number of nodes currently part of the tree, excluding recycled ones */
+	FORCEINLINE int32 NumNodes() const { return Nodes.Num() - FreeBlocks.Num() * 4; }
+
+	TSharedRef<const FSW_PointerTree<DataType>, ESPMode::ThreadSafe> MakeSnapshot() const
 	{
-		RootNode = nullptr;
-	};
+		return MakeShared<FSW_PointerTree<DataType>, ESPMode::ThreadSafe>(*this);
+	}
+
+	/*
+	 * Splits a leaf in 4 children. Returns false if the node is not a leaf or already at max depth.
+	 */
+	bool Subdivide(int32 NodeIndex)
+	{
+		if (!IsValidNode(NodeIndex) || !Nodes[NodeIndex].IsLeaf() || Nodes[NodeIndex].Depth + 1 >= MaxDepth)
+			return false;
+
+		int32 Block = INDEX_NONE;
+		if (FreeBlocks.Num() > 0)
+		{
+			Block = FreeBlocks.Pop(false);
+		}
+		else
+		{
+			Block = Nodes.Num();
+			Nodes.AddDefaulted(4);
+			Data.AddDefaulted(4);
+		}
+
+		// Nodes may have been reallocated: no reference taken before this point
+		FNode& Node = Nodes[NodeIndex];
+		Node.FirstChild = Block;
+
+		const uint8 ChildDepth = Node.Depth + 1;
+		const double ChildExtent = SharedData[ChildDepth].Extent;
+
+		for (int32 Child = 0; Child < 4; Child++)
+		{
+			FNode& ChildNode = Nodes[Block + Child];
+			ChildNode.Parent = NodeIndex;
+			ChildNode.FirstChild = INDEX_NONE;
+			ChildNode.Depth = ChildDepth;
+			ChildNode.Center = Node.Center + ChildExtent * FVector((Child & 1) ? 1.0 : -1.0, (Child & 2) ? 1.0 : -1.0, 0.0);
+			ChildNode.Bounds = MakeBounds(ChildNode.Center, ChildDepth);
+			Data[Block + Child] = DataType();
+		}
+
+		Revision++;
+		return true;
+	}
+
+	/*
+	 * Releases every descendant of the node, which becomes a leaf. Released blocks are recycled by Subdivide.
+	 */
+	void Collapse(int32 NodeIndex)
+	{
+		if (!IsValidNode(NodeIndex) || Nodes[NodeIndex].IsLeaf())
+			return;
+
+		TArray<int32, TInlineAllocator<64>> Stack;
+		Stack.Add(NodeIndex);
+
+		while (Stack.Num() > 0)
+		{
+			const int32 Current = Stack.Pop(false);
+			const int32 Block = Nodes[Current].FirstChild;
+
+			if (Block == INDEX_NONE)
+				continue;
+
+			for (int32 Child = 0; Child < 4; Child++)
+			{
+				Stack.Add(Block + Child);
+				Nodes[Block + Child].Parent = INDEX_NONE;
+			}
 
-	FORCEINLINE FVector GetTreeLocation(){return TreeLocation;}
-	FORCEINLINE uint8 GetMaxDepth() { return MaxDepth; }
+			Nodes[Current].FirstChild = INDEX_NONE;
+			FreeBlocks.Add(Block);
+		}
+
+		Revision++;
+	}
+
+	/*
+	 * Depth first traversal. Visitor(int32 NodeIndex, const FNode& Node) returns true to visit the children of Node.
+	 */
+	template<typename VisitorType>
+	void Traverse(VisitorType&& Visitor) const
+	{
+		TArray<int32, TInlineAllocator<64>> Stack;
+		Stack.Add(RootIndex);
+
+		while (Stack.Num() > 0)
+		{
+			const int32 Current = Stack.Pop(false);
+			const FNode& Node = Nodes[Current];
 
-	/** Used for thread safety between rendering and asset operations. */
-	mutable FCriticalSection DataLock;
+			if (Visitor(Current, Node) && !Node.IsLeaf())
+			{
+				for (int32 Child = 3; Child >= 0; Child--)
+					Stack.Add(Node.FirstChild + Child);
+			}
+		}
+	}
+
+	/*
+	 * Gathers the leaves whose bounds pass Predicate(const FBox&), pruning subtrees failing it.
+	 */
+	template<typename PredicateType>
+	void QueryLeaves(PredicateType&& Predicate, TArray<int32>& OutLeaves) const
+	{
+		Traverse([&](int32 NodeIndex, const FNode& Node)
+		{
+			if (!Predicate(Node.Bounds))
+				return false;
+
+			if (Node.IsLeaf())
+				OutLeaves.Add(NodeIndex);
+
+			return true;
+		});
+	}
+
+	void QueryBox(const FBox& Box, TArray<int32>& OutLeaves) const
+	{
+		QueryLeaves([&Box](const FBox& Bounds) { return Bounds.Intersect(Box); }, OutLeaves);
+	}
+
+	void QueryRadius(const FVector& Location, double Radius, TArray<int32>& OutLeaves) const
+	{
+		const double RadiusSquared = Radius * Radius;
+		QueryLeaves([&](const FBox& Bounds) { return Bounds.ComputeSquaredDistanceToPoint(Location) <= RadiusSquared; }, OutLeaves);
+	}
+
+	void QueryFrustum(const FConvexVolume& Frustum, TArray<int32>& OutLeaves) const
+	{
+		QueryLeaves([&Frustum](const FBox& Bounds) { return Frustum.IntersectBox(Bounds.GetCenter(), Bounds.GetExtent()); }, OutLeaves);
+	}
+
+	/*
+	 * Best first search of the leaf closest to Location, INDEX_NONE only if the tree is empty.
+	 */
+	int32 FindNearestLeaf(const FVector& Location) const
+	{
+		struct FCandidate
+		{
+			double DistanceSquared;
+			int32 NodeIndex;
+			bool operator<(const FCandidate& Rhs) const { return DistanceSquared < Rhs.DistanceSquared; }
+		};
+
+		TArray<FCandidate, TInlineAllocator<64>> Heap;
+		Heap.HeapPush({ Nodes[RootIndex].Bounds.ComputeSquaredDistanceToPoint(Location), RootIndex });
+
+		while (Heap.Num() > 0)
+		{
+			FCandidate Best;
+			Heap.HeapPop(Best, false);
+
+			const FNode& Node = Nodes[Best.NodeIndex];
+			if (Node.IsLeaf())
+				return Best.NodeIndex;
+
+			for (int32 Child = 0; Child < 4; Child++)
+			{
+				const int32 ChildIndex = Node.FirstChild + Child;
+				Heap.HeapPush({ Nodes[ChildIndex].Bounds.ComputeSquaredDistanceToPoint(Location), ChildIndex });
+			}
+		}
+
+		return INDEX_NONE;
+	}
 
 protected:
+
+	FORCEINLINE FBox MakeBounds(const FVector& Center, uint8 Depth) const
+	{
+		return FBox(Center - SharedData[Depth].Extent * FVector(1.f), Center + SharedData[Depth].Extent * FVector(1.f));
+	}
+
 	TArray<FSharedLODData> SharedData;
 	FVector TreeLocation = FVector(0);
 	uint8 MaxDepth=0;
 
-	TSharedPtr<FPointerNode> RootNode;
+	TArray<FNode> Nodes;
+	TArray<DataType> Data;
+	/** First index of each recycled block of 4 nodes */
+	TArray<int32> FreeBlocks;
 
-	friend struct FPointerNode;
+	uint32 Revision = 0;
 };
@@ -30,6 +30,9 @@
 
 #include "CoreMinimal.h"
 #include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
 
 #ifndef SWDEBUG
 #define SWDEBUG 0
@@ -129,6 +132,33 @@ SW_FUNCTION_CYCLE_DECLARE(SWStatDescTCHAR_##SWStatName, SWStatNameTCHAR_##SWStat
 #define SW_FCT_CYCLE(...) IF_SW_ENABLE_DEBUG(SW_STAT_SET_NAME_DESC(SW_FUNCTION_NAME, SW_STAT_BEST_DESC(__VA_ARGS__),__COUNTER__))
 
 
+/*
+ * Runtime stats, independent from SWDEBUG so they remain available in test builds.
+ * They are emitted to the CSV profiler (category "ShaderWorld") and as Unreal Insights trace counters,
+ * and compile out whenever the engine disables CSV_PROFILER / COUNTERSTRACE_ENABLED. Shipping builds only
+ * keep the CSV stats, and only when the target defines CSV_PROFILER_ENABLE_IN_SHIPPING=1 (ConquerTheLand.Target.cs does).
+ */
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(SHADERWORLDCORE_API, ShaderWorld);
+
+/** Times the enclosing scope as a stage of the Shader World update. */
+#define SW_STAGE_SCOPE(StageName) \
+	CSV_SCOPED_TIMING_STAT(ShaderWorld, StageName); \
+	TRACE_CPUPROFILER_EVENT_SCOPE(ShaderWorld_##StageName);
+
+/** Declares a counter at file scope, to be used with SW_SET_COUNTER / SW_INC_COUNTER. */
+#define SW_DECLARE_COUNTER(CounterName) \
+	TRACE_DECLARE_INT_COUNTER(SWCounter_##CounterName, TEXT("ShaderWorld/") TEXT(#CounterName));
+
+#define SW_SET_COUNTER(CounterName, Value) \
+	CSV_CUSTOM_STAT(ShaderWorld, CounterName, static_cast<int32>(Value), ECsvCustomStatOp::Set); \
+	TRACE_COUNTER_SET(SWCounter_##CounterName, Value);
+
+/** Per frame in CSV captures, cumulative in trace captures. */
+#define SW_INC_COUNTER(CounterName) \
+	CSV_CUSTOM_STAT(ShaderWorld, CounterName, 1, ECsvCustomStatOp::Accumulate); \
+	TRACE_COUNTER_INCREMENT(SWCounter_##CounterName);
+
+
 
 
 
@@ -29,6 +29,7 @@
 
 #include "CoreMinimal.h"
 #include "Data/SW_PointerQuadtree.h"
+#include "Storage/SWTiledTerrainStorage.h"
 #include "UObject/NoExportTypes.h"
 #include "SWStorageBase.generated.h"
 
@@ -50,6 +51,18 @@ public:
 	UPROPERTY(Transient)
 		bool bTriggerHeightmapExport = false;
 
+	/** Tiled terrain file (.swts) within DestinationPath */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Import Settings")
+		FString TerrainFileName = TEXT("Terrain.swts");
+
+	FString GetTerrainFilePath() const;
+
+	/**
+	 * Memory maps the tiled terrain file. The returned reader can be shared with worker threads.
+	 * Null if the file is missing or invalid.
+	 */
+	TSharedPtr<FSWTiledTerrainReader, ESPMode::ThreadSafe> OpenTerrainStorage() const;
+
 public:
 
 	class TerrainStorage
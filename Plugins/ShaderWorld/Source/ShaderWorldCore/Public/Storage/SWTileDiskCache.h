@@ -0,0 +1,111 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+ * Content addressed cache of generated tiles on disk.
+ *
+ * Keys hash every input a tile depends on: when an input changes, so does the key, and stale entries are simply never
+ * read again. They are pruned least recently used first once the cache grows beyond its size limit.
+ *
+ * <Directory>/<2 first hex digits of the key>/<key>.swtc : FSWTileDiskCacheHeader | payload, Oodle compressed when it pays off
+ */
+
+struct FSWTileDiskCacheHeader
+{
+	static constexpr uint32 MagicNumber = 0x43545753; // 'SWTC'
+	static constexpr uint32 CurrentVersion = 1;
+
+	uint32 Magic = MagicNumber;
+	uint32 Version = CurrentVersion;
+	uint64 Key = 0;
+	/** Hash of the uncompressed payload */
+	uint64 PayloadHash = 0;
+	uint32 UncompressedSize = 0;
+	/** Equals UncompressedSize when stored raw */
+	uint32 StoredSize = 0;
+};
+static_assert(sizeof(FSWTileDiskCacheHeader) == 32, "FSWTileDiskCacheHeader is serialized as is");
+
+/*
+ * Every method can be called concurrently from any thread.
+ */
+class SHADERWORLDCORE_API FSWTileDiskCache
+{
+public:
+	FSWTileDiskCache(const FString& InDirectory, int64 InMaxSizeMB);
+
+	/** Lists the entries already on disk and prunes them down to the size limit. Blocking, meant to run on a worker thread */
+	void Initialize();
+	bool IsInitialized() const { return bInitialized; }
+
+	bool Contains(uint64 Key) const;
+	/** Contains, counting a miss when the entry is absent */
+	bool Probe(uint64 Key);
+	/** Returns false on a miss. Corrupted entries are deleted */
+	bool Load(uint64 Key, TArray<uint8>& OutPayload);
+	bool Store(uint64 Key, TConstArrayView<uint8> Payload);
+	void Remove(uint64 Key);
+
+	const FString& GetDirectory() const { return Directory; }
+	FString GetEntryPath(uint64 Key) const;
+
+	int32 GetNumHits() const { return NumHits.GetValue(); }
+	int32 GetNumMisses() const { return NumMisses.GetValue(); }
+	int32 GetNumWrites() const { return NumWrites.GetValue(); }
+
+	static uint64 HashBytes(const void* Data, int64 Size, uint64 Seed = 0);
+	static uint64 HashCombine(uint64 A, uint64 B);
+
+private:
+
+	struct FEntry
+	{
+		int64 Size = 0;
+		/** Recency, higher is more recent */
+		uint64 Stamp = 0;
+	};
+
+	void PruneIfNeeded();
+
+	FString Directory;
+	int64 MaxSize = 0;
+
+	mutable FCriticalSection EntriesLock;
+	TMap<uint64, FEntry> Entries;
+	int64 TotalSize = 0;
+	uint64 NextStamp = 0;
+
+	FThreadSafeBool bInitialized = false;
+	FThreadSafeCounter NumHits;
+	FThreadSafeCounter NumMisses;
+	FThreadSafeCounter NumWrites;
+};
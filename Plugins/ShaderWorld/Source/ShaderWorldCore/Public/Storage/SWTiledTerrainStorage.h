@@ -0,0 +1,181 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+class IFileHandle;
+
+/*
+ * Tiled terrain storage (.swts)
+ *
+ * Header | tiles payloads | directory
+ *
+ * Each mip level is split in TileSize x TileSize tiles. A mip N tile covers 2^N x 2^N tiles of mip 0.
+ * A tile payload holds TileSize^2 uint16 heights, quantized between the tile min and max height,
+ * followed by TileSize^2 uint8 material indices, optionally compressed as a whole.
+ * The directory lists every tile of every mip, mip 0 first then row major.
+ */
+
+enum class ESWTileCompression : uint32
+{
+	None = 0,
+	Oodle = 1,
+};
+
+struct FSWTiledTerrainHeader
+{
+	static constexpr uint32 MagicNumber = 0x53545753; // 'SWTS'
+	static constexpr uint32 CurrentVersion = 1;
+
+	uint32 Magic = MagicNumber;
+	uint32 Version = CurrentVersion;
+	int32 TileSize = 0;
+	/** Tile count of mip 0 */
+	int32 NumTilesX = 0;
+	int32 NumTilesY = 0;
+	int32 NumMips = 0;
+	/** Distance between two texels of mip 0, in cm */
+	float TexelSpacing = 100.f;
+	ESWTileCompression Compression = ESWTileCompression::None;
+	uint64 DirectoryOffset = 0;
+	uint64 Reserved = 0;
+};
+static_assert(sizeof(FSWTiledTerrainHeader) == 48, "FSWTiledTerrainHeader is serialized as is");
+
+struct FSWTiledTerrainTileEntry
+{
+	uint64 Offset = 0;
+	/** 0 when the tile was never written. Equal to UncompressedSize when stored raw */
+	uint32 CompressedSize = 0;
+	uint32 UncompressedSize = 0;
+	float MinHeight = 0.f;
+	float MaxHeight = 0.f;
+};
+static_assert(sizeof(FSWTiledTerrainTileEntry) == 24, "FSWTiledTerrainTileEntry is serialized as is");
+
+struct SHADERWORLDCORE_API FSWTiledTerrainDesc
+{
+	/** Limits keeping every texel, tile and directory index within int32 */
+	static constexpr int32 MaxTileSize = 4096;
+	static constexpr int32 MaxTilesPerSide = 1 << 20;
+
+	int32 TileSize = 128;
+	int32 NumTilesX = 0;
+	int32 NumTilesY = 0;
+	int32 NumMips = 1;
+	float TexelSpacing = 100.f;
+	ESWTileCompression Compression = ESWTileCompression::Oodle;
+
+	FORCEINLINE int32 NumTilesXAtMip(int32 Mip) const { return FMath::DivideAndRoundUp(NumTilesX, 1 << Mip); }
+	FORCEINLINE int32 NumTilesYAtMip(int32 Mip) const { return FMath::DivideAndRoundUp(NumTilesY, 1 << Mip); }
+	FORCEINLINE int32 TexelsPerTile() const { return TileSize * TileSize; }
+
+	/** Index of the tile within the directory, INDEX_NONE if out of range */
+	int32 GetTileIndex(int32 Mip, int32 TileX, int32 TileY) const;
+	int64 GetNumTiles() const;
+
+	/** Dimensions are positive, within limits, and NumMips does not exceed ComputeFullMipCount */
+	bool IsValid() const;
+
+	/** Number of mips until a single tile covers the whole terrain */
+	static int32 ComputeFullMipCount(int32 NumTilesX, int32 NumTilesY);
+};
+
+/*
+ * Sequential writer: tiles can be written in any order, the directory is written by Close().
+ */
+class SHADERWORLDCORE_API FSWTiledTerrainWriter
+{
+public:
+	FSWTiledTerrainWriter() = default;
+	~FSWTiledTerrainWriter();
+
+	bool Open(const FString& Filename, const FSWTiledTerrainDesc& InDesc);
+
+	/** Heights and Materials hold Desc.TexelsPerTile() row major texels. Materials may be empty. */
+	bool WriteTile(int32 Mip, int32 TileX, int32 TileY, TConstArrayView<float> Heights, TConstArrayView<uint8> Materials);
+
+	bool Close();
+
+	const FSWTiledTerrainDesc& GetDesc() const { return Desc; }
+
+	/** Builds every tile and mip of Desc from a SizeX x SizeY row major grid, border texels are clamped */
+	static bool WriteGrid(const FString& Filename, FSWTiledTerrainDesc Desc, int32 SizeX, int32 SizeY, TConstArrayView<float> Heights, TConstArrayView<uint8> Materials);
+
+	/** Halves a SizeX x SizeY grid: heights are averaged, materials point sampled */
+	static void DownsampleGrid(int32 SizeX, int32 SizeY, TConstArrayView<float> Heights, TConstArrayView<uint8> Materials, TArray<float>& OutHeights, TArray<uint8>& OutMaterials);
+
+	/** Quantizes and compresses a tile, thread safe */
+	static void EncodeTile(const FSWTiledTerrainDesc& Desc, TConstArrayView<float> Heights, TConstArrayView<uint8> Materials, TArray<uint8>& OutPayload, FSWTiledTerrainTileEntry& OutEntry);
+
+	bool WriteEncodedTile(int32 Mip, int32 TileX, int32 TileY, const TArray<uint8>& Payload, const FSWTiledTerrainTileEntry& Entry);
+
+private:
+	FSWTiledTerrainDesc Desc;
+	TUniquePtr<IFileHandle> File;
+	TArray<FSWTiledTerrainTileEntry> Directory;
+};
+
+/*
+ * Memory mapped reader. Once opened, every const method can be called concurrently from any thread.
+ */
+class SHADERWORLDCORE_API FSWTiledTerrainReader
+{
+public:
+	FSWTiledTerrainReader() = default;
+	~FSWTiledTerrainReader();
+
+	bool Open(const FString& Filename);
+	bool IsValid() const { return Data != nullptr; }
+
+	const FSWTiledTerrainDesc& GetDesc() const { return Desc; }
+
+	bool HasTile(int32 Mip, int32 TileX, int32 TileY) const;
+	bool GetTileHeightRange(int32 Mip, int32 TileX, int32 TileY, float& OutMin, float& OutMax) const;
+
+	/** Decodes a tile in OutHeights / OutMaterials (Desc.TexelsPerTile() each). Returns false if the tile is missing or corrupted. */
+	bool ReadTile(int32 Mip, int32 TileX, int32 TileY, TArray<float>& OutHeights, TArray<uint8>& OutMaterials) const;
+
+private:
+	const FSWTiledTerrainTileEntry* FindEntry(int32 Mip, int32 TileX, int32 TileY) const;
+
+	FSWTiledTerrainDesc Desc;
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	/** Used when the platform can not memory map the file */
+	TArray64<uint8> LoadedFile;
+
+	const uint8* Data = nullptr;
+	int64 DataSize = 0;
+	const FSWTiledTerrainTileEntry* Directory = nullptr;
+};
@@ -0,0 +1,72 @@
+﻿/*
+ * ShaderWorld: A procedural framework.
+ * Website : https://www.shader.world/
+ * Copyright (c) 2021-2023 MONSIEUR MAXIME DUPART
+ *
+ * This content is provided under the license of :
+ * Epic Content License Agreement - https://www.unrealengine.com/en-US/eula/content
+ *
+ * You may not Distribute Licensed Content in source format to third parties except to employees,
+ * affiliates, and contractors who are utilizing the Licensed Content in good faith to develop a Project
+ * on your behalf. Those employees, affiliates, and contractors you share Licensed Content
+ * with are not permitted to further Distribute the Licensed Content (including as incorporated in a Project)
+ * and must delete the Licensed Content once it is no longer needed for developing a Project on your behalf.
+ * You are responsible for ensuring that any employees, affiliates, or contractors you share Licensed Content
+ * with comply with the terms of this Agreement.
+ *
+ * General Restrictions - You may not:
+ * i. attempt to reverse engineer, decompile, translate, disassemble, or derive source code from Licensed Content;
+ * ii. sell, rent, lease, or transfer Licensed Content on a “stand-alone basis”
+ * (Projects must reasonably add value beyond the value of the Licensed Content,
+ * and the Licensed Content must be merely a component of the Project and not the primary focus of the Project);
+ *
+ */
+
+ /*
+  * Main authors: Maxime Dupart (https://twitter.com/Max_Dupt)
+  */
+
+#include "SWHeightmapImportCommandlet.h"
+
+#include "Utilities/SWStreamingHeightmapImporter.h"
+
+USWHeightmapImportCommandlet::USWHeightmapImportCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 USWHeightmapImportCommandlet::Main(const FString& Params)
+{
+	FSWHeightmapImportSettings Settings;
+
+	if (!FParse::Value(*Params, TEXT("source="), Settings.SourceFile) || !FParse::Value(*Params, TEXT("dest="), Settings.DestinationFile))
+	{
+		UE_LOG(LogTemp, Error, TEXT("SWHeightmapImport: -source= and -dest= are required"));
+		return 1;
+	}
+
+	FParse::Value(*Params, TEXT("width="), Settings.RawDimensions.X);
+	FParse::Value(*Params, TEXT("height="), Settings.RawDimensions.Y);
+	FParse::Value(*Params, TEXT("tilesize="), Settings.TileSize);
+	FParse::Value(*Params, TEXT("mips="), Settings.NumMips);
+	FParse::Value(*Params, TEXT("spacing="), Settings.TexelSpacing);
+	FParse::Value(*Params, TEXT("heightscale="), Settings.HeightScale);
+	FParse::Value(*Params, TEXT("heightoffset="), Settings.HeightOffset);
+
+	FSWHeightmapImportStats Stats;
+	if (!FSWStreamingHeightmapImporter::Import(Settings, Stats))
+	{
+		UE_LOG(LogTemp, Error, TEXT("SWHeightmapImport: failed to import %s into %s"), *Settings.SourceFile, *Settings.DestinationFile);
+		return 1;
+	}
+
+	constexpr double MB = 1024.0 * 1024.0;
+
+	UE_LOG(LogTemp, Display, TEXT("SWHeightmapImport: %dx%d heightmap, %d tiles written to %s"), Stats.Dimensions.X, Stats.Dimensions.Y, Stats.TilesWritten, *Settings.DestinationFile);
+	UE_LOG(LogTemp, Display, TEXT("SWHeightmapImport: import time %.3fs, peak importer buffers %.1f MB, peak process memory %.1f MB"), Stats.ImportSeconds, Stats.PeakBufferBytes / MB, Stats.PeakProcessBytes / MB);
+
+	return 0;
+}
@@ -11,5 +11,12 @@ public class ConquerTheLandTarget : TargetRules
 		DefaultBuildSettings = BuildSettingsVersion.V2;
 
 		ExtraModuleNames.AddRange( new string[] { "ConquerTheLand" } );
+
+		// Keeps the ShaderWorld CSV stats (SWStats.h) in shipping builds, for -csvCaptureFrames on dedicated servers
+		if (Target.Configuration == UnrealTargetConfiguration.Shipping)
+		{
+			BuildEnvironment = TargetBuildEnvironment.Unique;
+			GlobalDefinitions.Add("CSV_PROFILER_ENABLE_IN_SHIPPING=1");
+		}
 	}
 }